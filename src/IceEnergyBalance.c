@@ -62,7 +62,7 @@ static char vcid[] = "$Id$";
 double IceEnergyBalance(double TSurf, va_list ap)
 {
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   const char *Routine = "IceEnergyBalance";
 
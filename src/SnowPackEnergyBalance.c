@@ -88,7 +88,7 @@ static char vcid[] = "$Id$";
 double SnowPackEnergyBalance(double TSurf, va_list ap)
 {
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   const char *Routine = "SnowPackEnergyBalance";
 
@@ -38,7 +38,7 @@ void alloc_atmos(int nrecs, atmos_data_struct **atmos)
 
 *******************************************************************/
 {
-  extern param_set_struct param_set;
+  extern THREAD_LOCAL param_set_struct param_set;
 
   int i;
 
@@ -0,0 +1,93 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <vicNl.h>
+
+static char vcid[] = "$Id$";
+
+/**********************************************************************
+  alloc_count					October 2026
+
+  Allocation counter, which shows whether the time steps of the model
+  allocate heap memory.  It is only active in vicNl_alloc, built with
+  "make vicNl_alloc" (or run by "make bench_alloc"): there this file is
+  compiled with ALLOC_COUNT = TRUE and linked with --wrap for malloc(),
+  calloc() and realloc(), so that every call of these by VIC's own code
+  passes through the counting wrappers below.  (Allocations made inside
+  the C and zlib libraries are not counted.)
+
+  run_cell() marks the calls of full_energy() and put_data() of each
+  time step with alloc_count_phase(ALLOC_TIME_STEP); everything else,
+  including the work of the prefetch and output writer threads, is
+  counted as setup.  print_alloc_count() prints the totals at the end
+  of the run, which run_bench.py reports.
+
+  In the normal build (ALLOC_COUNT not defined), alloc_count_phase()
+  and print_alloc_count() do nothing.
+**********************************************************************/
+
+#ifndef ALLOC_COUNT
+#define ALLOC_COUNT FALSE
+#endif
+
+#if ALLOC_COUNT
+
+static THREAD_LOCAL int alloc_phase = ALLOC_SETUP;
+static long             alloc_calls[2];     /* per ALLOC_ phase */
+static long             alloc_steps;        /* time steps counted */
+
+void *__real_malloc(size_t);
+void *__real_calloc(size_t, size_t);
+void *__real_realloc(void *, size_t);
+
+void *__wrap_malloc(size_t size)
+{
+  __sync_fetch_and_add(&alloc_calls[alloc_phase], 1);
+  return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size)
+{
+  __sync_fetch_and_add(&alloc_calls[alloc_phase], 1);
+  return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+  __sync_fetch_and_add(&alloc_calls[alloc_phase], 1);
+  return __real_realloc(ptr, size);
+}
+
+#endif /* ALLOC_COUNT */
+
+void alloc_count_phase(int phase)
+/**********************************************************************
+  alloc_count_phase				October 2026
+
+  Counts the calling thread's following allocations as made in phase
+  (ALLOC_SETUP or ALLOC_TIME_STEP); each switch to ALLOC_TIME_STEP
+  counts one time step.
+**********************************************************************/
+{
+#if ALLOC_COUNT
+  alloc_phase = phase;
+  if (phase == ALLOC_TIME_STEP)
+    __sync_fetch_and_add(&alloc_steps, 1);
+#endif
+}
+
+void print_alloc_count()
+/**********************************************************************
+  print_alloc_count				October 2026
+
+  Prints the numbers of heap allocations made during setup and during
+  the time steps of the run.  Each process of an NPROCS run prints its
+  own.
+**********************************************************************/
+{
+#if ALLOC_COUNT
+  fprintf(stderr, "\nHeap allocations: %ld in setup, %ld in %ld time steps (%.3f per time step)\n",
+          alloc_calls[ALLOC_SETUP], alloc_calls[ALLOC_TIME_STEP], alloc_steps,
+          alloc_steps > 0
+          ? (double)alloc_calls[ALLOC_TIME_STEP] / alloc_steps : 0.);
+#endif
+}
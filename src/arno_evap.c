@@ -72,7 +72,7 @@ double arno_evap(layer_data_struct *layer,
 		 double             moist_resid,
 		 double            *frost_fract)
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   int    num_term;
   int    i;
@@ -23,7 +23,7 @@ void calc_Nscale_factors(char        NscaleFlag,
 
 **********************************************************************/
 {  
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   dmy_struct dmy_tmp;
   double coszen_noon;
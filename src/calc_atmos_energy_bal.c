@@ -65,9 +65,12 @@ double calc_atmos_energy_bal(double  InOverSensible,
 	      of root_brent, error_print_atmos_energy_bal and
 	      solve_atmos_energy_bal.					TJB
   2013-Dec-26 Moved CLOSE_ENERGY from compile-time to run-time options.	TJB
+  2026-Oct-18 The inputs of func_atmos_energy_bal() are now filled in
+	      once, in an atmos_energy_bal_args_struct, and Tcanopy is
+	      found by root_solve(), starting from Tair.
 ************************************************************************/
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   double AtmosLatent;
   double F; // canopy closure fraction, not currently used by VIC
@@ -81,6 +84,8 @@ double calc_atmos_energy_bal(double  InOverSensible,
   double VP_upper;
   double gamma;
   char ErrorString[MAXSTRING];
+  atmos_energy_bal_args_struct atmos_args;
+  int    Nevals;
   
   F = 1;
 
@@ -106,6 +111,15 @@ double calc_atmos_energy_bal(double  InOverSensible,
     Find Canopy Air Temperature
   ******************************/
 
+  // inputs of the atmospheric energy balance
+  atmos_args.LatentHeat    = (*LatentHeat) + (*LatentHeatSub);
+  atmos_args.NetRadiation  = NetRadiation;
+  atmos_args.Ra            = Ra;
+  atmos_args.Tair          = Tair;
+  atmos_args.atmos_density = atmos_density;
+  atmos_args.InSensible    = InSensible;
+  atmos_args.SensibleHeat  = SensibleHeat;
+
   if (options.CLOSE_ENERGY) {
 
     /* initialize Tcanopy_fbflag */
@@ -116,10 +130,8 @@ double calc_atmos_energy_bal(double  InOverSensible,
     T_upper = (Tair) + CANOPY_DT;
 
     // iterate for canopy air temperature
-    Tcanopy = root_brent(T_lower, T_upper, ErrorString, func_atmos_energy_bal, 
-		         (*LatentHeat) + (*LatentHeatSub), 
-		         NetRadiation, Ra, Tair, atmos_density, InSensible, 
-		         SensibleHeat);
+    Tcanopy = root_solve(Tair, T_lower, T_upper, ErrorString,
+                         func_atmos_energy_bal, &atmos_args, &Nevals);
 
     if ( Tcanopy <= -998 ) {
       if (options.TFALLBACK) {
@@ -144,9 +156,7 @@ double calc_atmos_energy_bal(double  InOverSensible,
   }
 
   // compute variables based on final temperature
-  (*Error) = solve_atmos_energy_bal(Tcanopy, (*LatentHeat) + (*LatentHeatSub), 
-				    NetRadiation, Ra, Tair, atmos_density, 
-				    InSensible, SensibleHeat);
+  (*Error) = func_atmos_energy_bal(Tcanopy, &atmos_args);
 
   /*****************************
     Find Canopy Vapor Pressure
@@ -185,20 +195,6 @@ double calc_atmos_energy_bal(double  InOverSensible,
 
 }
 
-double solve_atmos_energy_bal(double Tcanopy, ...) {
-
-  va_list ap;
-
-  double error;
-
-  va_start(ap, Tcanopy);
-  error = func_atmos_energy_bal(Tcanopy, ap);
-  va_end(ap);
-
-  return error;
-
-}
-
 double error_calc_atmos_energy_bal(double Tcanopy, ...) {
 
   va_list ap;
@@ -24,7 +24,7 @@ void calc_longwave(double *longwave,
   2013-Dec-26 Removed LWAVE_COR.					TJB
 ***************************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   double emissivity;
   double emissivity_clear;
   double cloudfactor;
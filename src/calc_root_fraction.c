@@ -21,7 +21,7 @@ void calc_root_fractions(veg_con_struct  *veg_con,
   2013-Jul-26 Fix to previous fix, avoids overstepping bounds of zone_depth[] array.			TJB
 **********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   char   ErrStr[MAXSTRING];
   int    Nveg;
@@ -172,10 +172,14 @@ double calc_surf_energy_bal(double             Le,
   2014-Mar-28 Removed DIST_PRCP option.					TJB
   2014-Apr-25 Added non-climatological LAI.				TJB
   2014-May-05 Added non-climatological vegcover fraction.		TJB
+  2026-Oct-18 The inputs of func_surf_energy_bal() are now filled in
+	      once, in a surf_energy_bal_args_struct, and the surface
+	      temperature is found by root_solve(), starting from the
+	      previous surface temperature.
 ***************************************************************/
 {
-  extern veg_lib_struct *veg_lib;
-  extern option_struct   options;
+  extern THREAD_LOCAL veg_lib_struct *veg_lib;
+  extern THREAD_LOCAL option_struct   options;
 
   int      FIRST_SOLN[2];
   int      VEG;
@@ -238,6 +242,8 @@ double calc_surf_energy_bal(double             Le,
   double   TmpNetShortSnow;
   double   old_swq, old_depth;
   char ErrorString[MAXSTRING];
+  surf_energy_bal_args_struct surf_args;
+  int      Nevals;
 
   /**************************************************
     Set All Variables For Use
@@ -327,8 +333,111 @@ double calc_surf_energy_bal(double             Le,
   Zsum_node      = soil_con->Zsum_node;   
   ice_node       = energy->ice;
 
+  /* inputs of the surface energy balance */
+  surf_args.rec             = rec;
+  surf_args.nrecs           = nrecs;
+  surf_args.month           = dmy->month;
+  surf_args.VEG             = VEG;
+  surf_args.veg_class       = veg_class;
+  surf_args.iveg            = iveg;
+  surf_args.delta_t         = delta_t;
+  surf_args.Cs1             = Cs1;
+  surf_args.Cs2             = Cs2;
+  surf_args.D1              = D1;
+  surf_args.D2              = D2;
+  surf_args.T1_old          = T1_old;
+  surf_args.T2              = T2;
+  surf_args.Ts_old          = Ts_old;
+  surf_args.Told_node       = energy->T;
+  surf_args.bubble          = bubble;
+  surf_args.dp              = dp;
+  surf_args.expt            = expt;
+  surf_args.ice0            = ice0;
+  surf_args.kappa1          = kappa1;
+  surf_args.kappa2          = kappa2;
+  surf_args.max_moist       = max_moist;
+  surf_args.moist           = moist;
+  surf_args.root            = root;
+  surf_args.CanopLayerBnd   = CanopLayerBnd;
+  surf_args.UnderStory      = UnderStory;
+  surf_args.overstory       = overstory;
+  surf_args.NetShortBare    = NetShortBare;
+  surf_args.NetShortGrnd    = NetShortGrnd;
+  surf_args.NetShortSnow    = TmpNetShortSnow;
+  surf_args.Tair            = Tair;
+  surf_args.atmos_density   = atmos_density;
+  surf_args.atmos_pressure  = atmos_pressure;
+  surf_args.emissivity      = emissivity;
+  surf_args.LongBareIn      = LongBareIn;
+  surf_args.LongSnowIn      = LongSnowIn;
+  surf_args.surf_atten      = surf_atten;
+  surf_args.vp              = VPcanopy;
+  surf_args.vpd             = VPDcanopy;
+  surf_args.shortwave       = atmos_shortwave;
+  surf_args.Catm            = atmos_Catm;
+  surf_args.dryFrac         = dryFrac;
+  surf_args.Wdew            = &Wdew;
+  surf_args.displacement    = displacement;
+  surf_args.ra              = aero_resist;
+  surf_args.Ra_used         = aero_resist_used;
+  surf_args.rainfall        = rainfall;
+  surf_args.ref_height      = ref_height;
+  surf_args.roughness       = roughness;
+  surf_args.wind            = wind;
+  surf_args.Le              = Le;
+  surf_args.Advection       = energy->advection;
+  surf_args.OldTSurf        = OldTSurf;
+  surf_args.TPack           = snow->pack_temp;
+  surf_args.Tsnow_surf      = Tsnow_surf;
+  surf_args.kappa_snow      = kappa_snow;
+  surf_args.melt_energy     = melt_energy;
+  surf_args.snow_coverage   = snow_coverage;
+  surf_args.snow_density    = snow->density;
+  surf_args.snow_swq        = snow->swq;
+  surf_args.snow_water      = snow->surf_water;
+  surf_args.deltaCC         = &energy->deltaCC;
+  surf_args.refreeze_energy = &energy->refreeze_energy;
+  surf_args.vapor_flux      = &snow->vapor_flux;
+  surf_args.blowing_flux    = &snow->blowing_flux;
+  surf_args.surface_flux    = &snow->surface_flux;
+  surf_args.Nnodes          = Nnodes;
+  surf_args.Cs_node         = Cs_node;
+  surf_args.T_node          = T_node;
+  surf_args.Tnew_node       = Tnew_node;
+  surf_args.Tnew_fbflag     = Tnew_fbflag;
+  surf_args.Tnew_fbcount    = Tnew_fbcount;
+  surf_args.alpha           = alpha;
+  surf_args.beta            = beta;
+  surf_args.bubble_node     = bubble_node;
+  surf_args.Zsum_node       = Zsum_node;
+  surf_args.expt_node       = expt_node;
+  surf_args.gamma           = gamma;
+  surf_args.ice_node        = ice_node;
+  surf_args.kappa_node      = kappa_node;
+  surf_args.max_moist_node  = max_moist_node;
+  surf_args.moist_node      = moist_node;
+  surf_args.soil_con        = soil_con;
+  surf_args.layer           = layer;
+  surf_args.veg_var         = veg_var;
+  surf_args.INCLUDE_SNOW    = INCLUDE_SNOW;
+  surf_args.NOFLUX          = options.NOFLUX;
+  surf_args.EXP_TRANS       = options.EXP_TRANS;
+  surf_args.SNOWING         = snow->snow;
+  surf_args.FIRST_SOLN      = FIRST_SOLN;
+  surf_args.NetLongBare     = &NetLongBare;
+  surf_args.NetLongSnow     = &TmpNetLongSnow;
+  surf_args.T1              = &T1;
+  surf_args.deltaH          = &energy->deltaH;
+  surf_args.fusion          = &energy->fusion;
+  surf_args.grnd_flux       = &energy->grnd_flux;
+  surf_args.latent_heat     = &energy->latent;
+  surf_args.latent_heat_sub = &energy->latent_sub;
+  surf_args.sensible_heat   = &energy->sensible;
+  surf_args.snow_flux       = &energy->snow_flux;
+  surf_args.store_error     = &energy->error;
+
   /**************************************************
-    Find Surface Temperature Using Root Brent Method
+    Find Surface Temperature Using Root Solver
   **************************************************/
   if(options.FULL_ENERGY) {
 
@@ -357,35 +466,9 @@ double calc_surf_energy_bal(double             Le,
       tmpNnodes = Nnodes;
     }
 
-    Tsurf = root_brent(T_lower, T_upper, ErrorString, func_surf_energy_bal,
-		       rec, nrecs, dmy->month, VEG, veg_class, iveg, delta_t,
-		       Cs1, Cs2, D1, D2,
-		       T1_old, T2, Ts_old, energy->T, bubble, dp, 
-		       expt, ice0, kappa1, kappa2, 
-		       max_moist, moist, root, CanopLayerBnd,
-		       UnderStory, overstory, NetShortBare, NetShortGrnd, 
-		       TmpNetShortSnow, Tair, atmos_density, 
-		       atmos_pressure,
-		       emissivity, LongBareIn, LongSnowIn, surf_atten, 
-		       VPcanopy, VPDcanopy, 
-		       atmos_shortwave, atmos_Catm, dryFrac,
-		       &Wdew, displacement, aero_resist, aero_resist_used, 
-		       rainfall, ref_height, roughness, wind, Le, 
-		       energy->advection, OldTSurf, snow->pack_temp, 
-		       Tsnow_surf, kappa_snow, melt_energy, 
-		       snow_coverage, 
-		       snow->density, snow->swq, snow->surf_water,
-		       &energy->deltaCC, &energy->refreeze_energy, 
-		       &snow->vapor_flux, &snow->blowing_flux, &snow->surface_flux,
-		       tmpNnodes, Cs_node, T_node, Tnew_node, Tnew_fbflag, Tnew_fbcount,
-		       alpha, beta, bubble_node, Zsum_node, expt_node, gamma, 
-		       ice_node, kappa_node, max_moist_node, moist_node, 
-		       soil_con, layer, veg_var, 
-		       INCLUDE_SNOW, options.NOFLUX, options.EXP_TRANS, snow->snow, 
-		       FIRST_SOLN, &NetLongBare, &TmpNetLongSnow, &T1, 
-		       &energy->deltaH, &energy->fusion, &energy->grnd_flux, 
-		       &energy->latent, &energy->latent_sub, 
-		       &energy->sensible, &energy->snow_flux, &energy->error);
+    surf_args.Nnodes = tmpNnodes;
+    Tsurf = root_solve(Ts_old, T_lower, T_upper, ErrorString,
+		       func_surf_energy_bal, &surf_args, &Nevals);
  
     if(Tsurf <= -998 ) {  
       if (options.TFALLBACK) {
@@ -449,34 +532,9 @@ double calc_surf_energy_bal(double             Le,
       tmpNnodes = Nnodes;
       FIRST_SOLN[0] = TRUE;
       
-      Tsurf = root_brent(T_lower, T_upper, ErrorString, func_surf_energy_bal,
-			 rec, nrecs, dmy->month, VEG, veg_class, iveg, delta_t,
-			 Cs1, Cs2, D1, D2, 
-			 T1_old, T2, Ts_old, energy->T, bubble, dp, 
-			 expt, ice0, kappa1, kappa2, 
-			 max_moist, moist, root, CanopLayerBnd,
-			 UnderStory, overstory, NetShortBare, NetShortGrnd, 
-			 TmpNetShortSnow, Tair, atmos_density, atmos_pressure, 
-			 emissivity, LongBareIn, LongSnowIn, surf_atten, 
-			 VPcanopy, VPDcanopy, 
-		         atmos_shortwave, atmos_Catm, dryFrac,
-			 &Wdew, displacement, aero_resist, aero_resist_used, 
-			 rainfall, ref_height, roughness, wind, Le, 
-			 energy->advection, OldTSurf, snow->pack_temp, 
-			 Tsnow_surf, kappa_snow, melt_energy, 
-			 snow_coverage, 
-			 snow->density, snow->swq, snow->surf_water,
-			 &energy->deltaCC, &energy->refreeze_energy, 
-			 &snow->vapor_flux, &snow->blowing_flux, &snow->surface_flux,
-			 tmpNnodes, Cs_node, T_node, Tnew_node, Tnew_fbflag, Tnew_fbcount,
-			 alpha, beta, bubble_node, Zsum_node, expt_node, gamma, 
-			 ice_node, kappa_node, max_moist_node, moist_node, 
-			 soil_con, layer, veg_var, 
-			 INCLUDE_SNOW, options.NOFLUX, options.EXP_TRANS, snow->snow, 
-			 FIRST_SOLN, &NetLongBare, &TmpNetLongSnow, &T1, 
-			 &energy->deltaH, &energy->fusion, &energy->grnd_flux, 
-			 &energy->latent, &energy->latent_sub, 
-			 &energy->sensible, &energy->snow_flux, &energy->error);
+      surf_args.Nnodes = tmpNnodes;
+      Tsurf = root_solve(Tsurf, T_lower, T_upper, ErrorString,
+			 func_surf_energy_bal, &surf_args, &Nevals);
       
       if(Tsurf <=  -998 ) {  
         if (options.TFALLBACK) {
@@ -545,34 +603,8 @@ double calc_surf_energy_bal(double             Le,
     // Reset model so that it solves thermal fluxes for full soil column
     FIRST_SOLN[0] = TRUE;
   
-  error = solve_surf_energy_bal(Tsurf, 
-				rec, nrecs, dmy->month, VEG, veg_class, iveg, delta_t,
-			        Cs1, Cs2, D1, D2, 
-				T1_old, T2, Ts_old, energy->T, bubble, dp, 
-				expt, ice0, kappa1, kappa2, 
-				max_moist, moist, root, CanopLayerBnd,
-				UnderStory, overstory, NetShortBare, NetShortGrnd, 
-				TmpNetShortSnow, Tair, atmos_density, atmos_pressure,
-				emissivity, LongBareIn, LongSnowIn, surf_atten, 
-				VPcanopy, VPDcanopy, 
-				atmos_shortwave, atmos_Catm, dryFrac,
-				&Wdew, displacement, aero_resist, aero_resist_used, 
-				rainfall, ref_height, roughness, wind, Le, 
-				energy->advection, OldTSurf, snow->pack_temp, 
-				Tsnow_surf, kappa_snow, melt_energy, 
-				snow_coverage, 
-				snow->density, snow->swq, snow->surf_water,
-				&energy->deltaCC, &energy->refreeze_energy, 
-				&snow->vapor_flux, &snow->blowing_flux, &snow->surface_flux,
-				Nnodes, Cs_node, T_node, Tnew_node, Tnew_fbflag, Tnew_fbcount,
-				alpha, beta, bubble_node, Zsum_node, expt_node, gamma, 
-				ice_node, kappa_node, max_moist_node, moist_node, 
-				soil_con, layer, veg_var, 
-				INCLUDE_SNOW, options.NOFLUX, options.EXP_TRANS, snow->snow, 
-				FIRST_SOLN, &NetLongBare, &TmpNetLongSnow, &T1, 
-				&energy->deltaH, &energy->fusion, &energy->grnd_flux, 
-				&energy->latent, &energy->latent_sub, 
-				&energy->sensible, &energy->snow_flux, &energy->error);
+  surf_args.Nnodes = Nnodes;
+  error = func_surf_energy_bal(Tsurf, &surf_args);
   if(error == ERROR)
     return(ERROR);
   else
@@ -743,20 +775,6 @@ double calc_surf_energy_bal(double             Le,
     
 }
 
-double solve_surf_energy_bal(double Tsurf, ...) {
-
-  va_list ap;
-
-  double error;
-
-  va_start(ap, Tsurf);
-  error = func_surf_energy_bal(Tsurf, ap);
-  va_end(ap);
-
-  return error;
-
-}
-
 double error_calc_surf_energy_bal(double Tsurf, ...) {
 
   va_list ap;
@@ -779,7 +797,7 @@ double error_print_surf_energy_bal(double Ts, va_list ap) {
   2012-Jan-28 Added Told_node array.					TJB
 **********************************************************************/
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   /* Define imported variables */
 
@@ -18,11 +18,11 @@ double calc_water_balance_error(int    rec,
   2007-Aug-22 Added error as return value.  JCA
 ***************************************************************/
 
-  static double last_storage;
-  static double cum_error;
-  static double max_error;
-  static int    error_cnt;
-  static int    Nrecs;
+  static THREAD_LOCAL double last_storage;
+  static THREAD_LOCAL double cum_error;
+  static THREAD_LOCAL double max_error;
+  static THREAD_LOCAL int    error_cnt;
+  static THREAD_LOCAL int    Nrecs;
 
   double error;
 
@@ -73,9 +73,9 @@ double calc_energy_balance_error(int    rec,
 	      parent function for tracking purposes.		CL via TJB
 ***************************************************************/
 
-  static double cum_error;
-  static double max_error;
-  static int    Nrecs;
+  static THREAD_LOCAL double cum_error;
+  static THREAD_LOCAL double max_error;
+  static THREAD_LOCAL int    Nrecs;
 
   double error;
 
@@ -39,7 +39,8 @@
 
   programmer: Ted Bohn
   date      : October 20, 2006
-  changes   :
+  changes   : 2026-Oct-18 CiLayer is now stored on the stack instead of
+              being allocated on every call.
   references: 
 ********************************************************************************/
 
@@ -74,12 +75,12 @@ void canopy_assimilation(char    Ctype,
                          double *Raut,
                          double *NPP)
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   double  h;
   double  pz;
   int     cidx;
   double  dLAI;
-  double *CiLayer;
+  double  CiLayer[MAX_CANOPY];
   double  AgrossLayer;
   double  RdarkLayer;
   double  RphotoLayer;
@@ -92,7 +93,7 @@ void canopy_assimilation(char    Ctype,
      temperature is equal air_temp */
   pz = PS_PM * exp(-(double)elevation/h);
 
-  CiLayer = (double*)calloc(options.Ncanopy,sizeof(double));
+  memset(CiLayer, 0, options.Ncanopy*sizeof(double));
 
   if (!strcasecmp(mode,"ci")) {
 
@@ -200,7 +201,5 @@ void canopy_assimilation(char    Ctype,
   *Raut = *Rmaint + *Rgrowth;
   *NPP = *GPP - *Raut;
 
-  free((char*)CiLayer);
-
 }
 
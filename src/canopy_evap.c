@@ -108,8 +108,8 @@ double canopy_evap(layer_data_struct *layer,
 {
 
   /** declare global variables **/
-  extern veg_lib_struct *veg_lib; 
-  extern option_struct options;
+  extern THREAD_LOCAL veg_lib_struct *veg_lib; 
+  extern THREAD_LOCAL option_struct options;
 
   /** declare local variables **/
   int                i;
@@ -246,10 +246,12 @@ void transpiration(layer_data_struct *layer,
   2013-Jul-25 Save dryFrac for use elsewhere.				TJB
   2013-Jul-25 Added photosynthesis terms.				TJB
   2014-Apr-25 Switched LAI from veg_lib to veg_var.			TJB
+  2026-Oct-18 gsLayer is now stored on the stack instead of being
+	      allocated on every call.
 **********************************************************************/
 {
-  extern veg_lib_struct *veg_lib;
-  extern option_struct options;
+  extern THREAD_LOCAL veg_lib_struct *veg_lib;
+  extern THREAD_LOCAL option_struct options;
 
   int    i;
   int    frost_area;
@@ -262,7 +264,7 @@ void transpiration(layer_data_struct *layer,
   double avail_moist[MAX_LAYERS];         /* moisture available for trans */
   double ice[MAX_LAYERS];
   double gc;
-  double *gsLayer;
+  double gsLayer[MAX_CANOPY];
   int    cidx;
 
   /********************************************************************** 
@@ -408,7 +410,6 @@ void transpiration(layer_data_struct *layer,
     /* Initialize conductances for aggregation over soil layers */
     gc =  0;
     if (options.CARBON) {
-      gsLayer = (double *)calloc(options.Ncanopy, sizeof(double));
       for (cidx=0; cidx<options.Ncanopy; cidx++) {
         gsLayer[cidx] = 0;
       }
@@ -498,8 +499,6 @@ void transpiration(layer_data_struct *layer,
       }
     }
 
-    if (options.CARBON) free((char *)gsLayer);
-
   }
 
   /****************************************************************
@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vicNl.h>
+
+static char vcid[] = "$Id$";
+
+/**********************************************************************
+  cell_arena					October 2026
+
+  Memory arena for the structures that live exactly as long as one grid
+  cell's run: the veg_hist array filled by prepare_cell() and the
+  all_vars model state made by simulate_cell().  Instead of thousands
+  of calloc()/free() pairs per cell (alloc_veg_hist() alone makes
+  3*nrecs*Nveg small allocations), these structures are carved out of
+  large blocks owned by the arena, and all of them are released at once
+  by reset_cell_arena() when the cell is done.
+
+  Each thread that runs cells (the main program, each worker thread,
+  and each buffer of the PREFETCH pipeline) owns one arena, which is
+  reused for all of its cells.  When a cell needs more than the arena's
+  first block, further blocks are added; on the next reset they are
+  merged into a single block big enough for that cell, so that after
+  the largest cell has been run the arena no longer calls malloc() at
+  all, and long runs do not fragment the heap.
+
+  The memory taken from the arena by the current cell is reported by
+  cell_arena_used() (and written to the cell timing log).  If the
+  arena was made with a limit (CELL_MEMORY_LIMIT), a cell that needs
+  more than the limit stops the run with an error.
+**********************************************************************/
+
+#define ARENA_ALIGN      16          /* alignment of every allocation */
+#define ARENA_BLOCK_SIZE (1 << 20)   /* minimum size of a block (bytes) */
+
+typedef struct arena_block {
+  struct arena_block *next;          /* previously filled block */
+  size_t              size;          /* bytes available in data */
+  size_t              used;          /* bytes handed out from data */
+  char               *data;
+} arena_block_struct;
+
+struct cell_arena_struct {
+  arena_block_struct *block;         /* block being filled */
+  size_t              limit;         /* max. bytes per cell; 0 = no limit */
+  size_t              used;          /* bytes handed out for the current cell */
+  size_t              peak;          /* largest "used" of any cell */
+};
+
+static arena_block_struct *new_block(size_t size)
+{
+  arena_block_struct *block;
+
+  if (size < ARENA_BLOCK_SIZE) size = ARENA_BLOCK_SIZE;
+  block = (arena_block_struct *)malloc(sizeof(arena_block_struct));
+  if (block == NULL || (block->data = (char *)malloc(size)) == NULL)
+    nrerror("Memory allocation error in cell_arena.");
+  block->next = NULL;
+  block->size = size;
+  block->used = 0;
+
+  return block;
+
+}
+
+static void free_blocks(arena_block_struct *block)
+{
+  arena_block_struct *next;
+
+  while (block != NULL) {
+    next = block->next;
+    free(block->data);
+    free((char *)block);
+    block = next;
+  }
+
+}
+
+cell_arena_struct *make_cell_arena(size_t limit)
+/**********************************************************************
+  make_cell_arena				October 2026
+
+  Makes an empty arena.  limit is the maximum number of bytes that one
+  cell may take from the arena, or 0 for no limit.
+**********************************************************************/
+{
+  cell_arena_struct *arena;
+
+  arena = (cell_arena_struct *)calloc(1, sizeof(cell_arena_struct));
+  if (arena == NULL)
+    nrerror("Memory allocation error in make_cell_arena().");
+  arena->limit = limit;
+  arena->block = new_block(ARENA_BLOCK_SIZE);
+
+  return arena;
+
+}
+
+void *arena_calloc(cell_arena_struct *arena,
+                   size_t             nmemb,
+                   size_t             size)
+/**********************************************************************
+  arena_calloc					October 2026
+
+  Returns nmemb*size bytes of zeroed memory from the arena, like
+  calloc().  The memory stays valid until the arena is reset, and must
+  not be passed to free().  Never returns NULL: if memory cannot be
+  allocated, or the cell's memory limit would be exceeded, the run is
+  stopped.
+**********************************************************************/
+{
+  arena_block_struct *block;
+  char                ErrStr[MAXSTRING];
+  size_t              bytes;
+  void               *ptr;
+
+  bytes = nmemb * size;
+  if (size != 0 && bytes / size != nmemb)
+    nrerror("Memory allocation error in arena_calloc().");
+  bytes = (bytes + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+  if (arena->limit > 0 && arena->used + bytes > arena->limit) {
+    sprintf(ErrStr, "Grid cell needs more than CELL_MEMORY_LIMIT = %lu MB of memory for its model state; increase CELL_MEMORY_LIMIT in the global parameter file.",
+            (unsigned long)(arena->limit >> 20));
+    nrerror(ErrStr);
+  }
+
+  block = arena->block;
+  if (block->size - block->used < bytes) {
+    /* start a new block, at least as big as all blocks so far */
+    block = new_block(bytes > arena->used ? bytes : arena->used);
+    block->next = arena->block;
+    arena->block = block;
+  }
+
+  ptr = block->data + block->used;
+  block->used += bytes;
+  arena->used += bytes;
+  if (arena->used > arena->peak) arena->peak = arena->used;
+  memset(ptr, 0, bytes);
+
+  return ptr;
+
+}
+
+size_t cell_arena_used(cell_arena_struct *arena)
+/**********************************************************************
+  cell_arena_used				October 2026
+
+  Returns the number of bytes taken from the arena since it was last
+  reset.
+**********************************************************************/
+{
+  return arena->used;
+}
+
+void reset_cell_arena(cell_arena_struct *arena)
+/**********************************************************************
+  reset_cell_arena				October 2026
+
+  Releases everything allocated from the arena.  If the last cell
+  filled more than one block, the blocks are replaced by a single
+  block that holds the largest cell seen so far.
+**********************************************************************/
+{
+  if (arena->block->next != NULL) {
+    free_blocks(arena->block);
+    arena->block = new_block(arena->peak);
+  }
+  arena->block->used = 0;
+  arena->used = 0;
+
+}
+
+void free_cell_arena(cell_arena_struct **arena)
+/**********************************************************************
+  free_cell_arena				October 2026
+
+  Frees the arena and everything allocated from it.
+**********************************************************************/
+{
+  free_blocks((*arena)->block);
+  free((char *)(*arena));
+  *arena = NULL;
+
+}
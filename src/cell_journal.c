@@ -0,0 +1,253 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <vicNl.h>
+
+static char vcid[] = "$Id$";
+
+/**********************************************************************
+  cell_journal					October 2026
+
+  Journal of the grid cells that a run has finished (CELL_JOURNAL), so
+  that a run that is killed part way through (e.g. a preempted batch
+  job) can be resumed without running the finished cells again.
+
+  The journal is a text file.  Once a cell's output files have been
+  closed and its state (if any) has been written to the state file, a
+  line
+
+    gridcel state_end
+
+  is appended to the journal and the journal is synced to disk, where
+  state_end is the length of the state file after the cell's state
+  (-1 if no state file is written).  Since a line is written only
+  after the cell has been completely written, an interrupted run loses
+  at most the cells that had not yet been journaled.
+
+  When a run starts and its journal exists, the cells listed in it are
+  skipped (read_soilparam() treats them like cells whose run flag is
+  not set), and the state file is truncated to the state_end of the
+  last journaled cell and appended to, which drops any partial records
+  of unfinished cells.  The output files of the unfinished cells are
+  re-created from scratch when these cells are run again.  A journal
+  line that was cut short by the interruption is discarded.  The
+  journal is removed when the run finishes.
+**********************************************************************/
+
+#define CELL_JOURNAL_HEADER "# gridcel state_end\n"
+
+struct cell_journal_struct {
+  int        fd;        /* journal file, opened for appending */
+  int        Ndone;     /* number of cells finished by earlier runs */
+  int       *done;      /* their cell numbers, sorted */
+  long long  state_end; /* length of the state file after the last of
+                           them; -1 if no state file was written */
+};
+
+static int compare_gridcel(const void *a,
+                           const void *b)
+{
+  int ga = *(const int *)a;
+  int gb = *(const int *)b;
+
+  return (ga > gb) - (ga < gb);
+}
+
+cell_journal_struct *open_cell_journal(char filename[])
+/**********************************************************************
+  open_cell_journal				October 2026
+
+  Opens the cell journal filename for appending, and reads the cells
+  that earlier runs have finished, if the journal already exists.
+**********************************************************************/
+{
+  cell_journal_struct *journal;
+  FILE                *old;
+  char                 line[MAXSTRING];
+  char                 ErrStr[MAXSTRING];
+  long long            state_end;
+  long long            length;
+  int                  gridcel;
+  int                  Nalloc;
+
+  journal = (cell_journal_struct *)calloc(1, sizeof(cell_journal_struct));
+  if (journal == NULL)
+    nrerror("Memory allocation error in open_cell_journal().");
+  journal->state_end = -1;
+
+  /* read the cells finished by earlier runs; length is the length of
+     the complete lines */
+  length = 0;
+  if ((old = fopen(filename, "r")) != NULL) {
+    Nalloc = 0;
+    while (fgets(line, MAXSTRING, old) != NULL
+           && line[strlen(line)-1] == '\n') {
+      length += strlen(line);
+      if (line[0] == '#') continue;
+      if (sscanf(line, "%d %lld", &gridcel, &state_end) != 2) {
+        snprintf(ErrStr, sizeof(ErrStr), "Unable to read line \"%.100s\" of the cell journal %.1000s.",
+                 line, filename);
+        nrerror(ErrStr);
+      }
+      if (journal->Ndone == Nalloc) {
+        Nalloc = Nalloc ? 2*Nalloc : 1024;
+        journal->done = (int *)realloc(journal->done, Nalloc*sizeof(int));
+        if (journal->done == NULL)
+          nrerror("Memory allocation error in open_cell_journal().");
+      }
+      journal->done[journal->Ndone++] = gridcel;
+      journal->state_end = state_end;
+    }
+    fclose(old);
+    qsort(journal->done, journal->Ndone, sizeof(int), compare_gridcel);
+  }
+
+  /* open the journal, dropping a line cut short by an interruption */
+  if ((journal->fd = open(filename, O_WRONLY | O_CREAT | O_APPEND, 0666)) < 0
+      || ftruncate(journal->fd, (off_t)length) != 0) {
+    snprintf(ErrStr, sizeof(ErrStr), "Unable to open the cell journal %.1000s: %s.", filename,
+             strerror(errno));
+    nrerror(ErrStr);
+  }
+  if (length == 0
+      && write(journal->fd, CELL_JOURNAL_HEADER, strlen(CELL_JOURNAL_HEADER)) < 0) {
+    snprintf(ErrStr, sizeof(ErrStr), "Unable to write to the cell journal %.1000s: %s.", filename,
+             strerror(errno));
+    nrerror(ErrStr);
+  }
+
+  if (journal->Ndone > 0)
+    fprintf(stderr, "Resuming the run: %d grid cells listed in the cell journal %s have already been run and will be skipped.\n",
+            journal->Ndone, filename);
+
+  return journal;
+
+}
+
+int cell_journal_done(cell_journal_struct *journal,
+                      int                  gridcel)
+/**********************************************************************
+  cell_journal_done				October 2026
+
+  Returns TRUE if an earlier run has finished cell gridcel.
+**********************************************************************/
+{
+  if (journal == NULL || journal->Ndone == 0)
+    return FALSE;
+
+  return bsearch(&gridcel, journal->done, journal->Ndone, sizeof(int),
+                 compare_gridcel) != NULL;
+
+}
+
+int cell_journal_resumed(cell_journal_struct *journal)
+/**********************************************************************
+  cell_journal_resumed				October 2026
+
+  Returns TRUE if the run resumes an interrupted run, i.e. if earlier
+  runs have finished some of the cells.
+**********************************************************************/
+{
+  return (journal != NULL && journal->Ndone > 0);
+
+}
+
+FILE *resume_state_file(cell_journal_struct *journal,
+                        global_param_struct *global,
+                        filenames_struct     filenames,
+                        int                  Nlayer,
+                        int                  Nnodes)
+/**********************************************************************
+  resume_state_file				October 2026
+
+  Opens the output state file.  If earlier runs have finished some of
+  the cells, the state file they wrote is re-opened instead of being
+  created, truncated to the end of the state of the last finished cell,
+  and positioned at its end, so that the states of the remaining cells
+  are appended to it.  Otherwise the state file is created with
+  open_state_file().
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+
+  FILE *statefile;
+  char  ErrStr[MAXSTRING];
+
+  if (journal == NULL || journal->Ndone == 0)
+    return open_state_file(global, filenames, Nlayer, Nnodes);
+
+  if (journal->state_end < 0) {
+    snprintf(ErrStr, sizeof(ErrStr), "The cell journal lists cells that were run without saving the model state, so the state file %.1000s cannot be resumed.  Remove the cell journal to start the run again from the beginning.",
+             filenames.statefile);
+    nrerror(ErrStr);
+  }
+  if ((statefile = fopen(filenames.statefile,
+                         options.BINARY_STATE_FILE ? "r+b" : "r+")) == NULL
+      || fseeko(statefile, 0, SEEK_END) != 0
+      || ftello(statefile) < journal->state_end
+      || ftruncate(fileno(statefile), (off_t)journal->state_end) != 0
+      || fseeko(statefile, (off_t)journal->state_end, SEEK_SET) != 0) {
+    snprintf(ErrStr, sizeof(ErrStr), "Unable to resume the state file %.1000s, which should hold the states of the %d cells listed in the cell journal.",
+             filenames.statefile, journal->Ndone);
+    nrerror(ErrStr);
+  }
+
+  return statefile;
+
+}
+
+void write_cell_journal(cell_journal_struct *journal,
+                        int                  gridcel,
+                        FILE                *statefile)
+/**********************************************************************
+  write_cell_journal				October 2026
+
+  Records that cell gridcel is finished: its output files must have
+  been closed, and its state (if any) written to statefile, which is
+  synced to disk first.  statefile is NULL if no state is saved.
+**********************************************************************/
+{
+  char      line[MAXSTRING];
+  char      ErrStr[MAXSTRING];
+  long long state_end;
+
+  state_end = -1;
+  if (statefile != NULL) {
+    fflush(statefile);
+    fsync(fileno(statefile));
+    state_end = ftello(statefile);
+  }
+
+  /* a single write, so that processes sharing the journal (NPROCS)
+     cannot interleave their lines */
+  sprintf(line, "%d %lld\n", gridcel, state_end);
+  if (write(journal->fd, line, strlen(line)) != (ssize_t)strlen(line)
+      || fsync(journal->fd) != 0) {
+    snprintf(ErrStr, sizeof(ErrStr), "Unable to write to the cell journal: %s.", strerror(errno));
+    nrerror(ErrStr);
+  }
+
+}
+
+void close_cell_journal(cell_journal_struct **journal,
+                        char                  filename[],
+                        int                   finished)
+/**********************************************************************
+  close_cell_journal				October 2026
+
+  Closes the cell journal, and removes it if the run has finished.
+**********************************************************************/
+{
+  if (*journal == NULL) return;
+  close((*journal)->fd);
+  if (finished)
+    remove(filename);
+  free((char *)(*journal)->done);
+  free((char *)(*journal));
+  *journal = NULL;
+
+}
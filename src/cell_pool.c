@@ -0,0 +1,574 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <vicNl.h>
+
+static char vcid[] = "$Id$";
+
+/**********************************************************************
+  cell_pool					October 2026
+
+  Thread-parallel grid cell driver, used when NTHREADS > 1.
+
+  The main thread reads the cell parameters (soil, veg, lake, and snow
+  band files) in file order, exactly as the serial driver does, and
+  submits each cell to a pool of worker threads via submit_cell().
+  Each worker owns its own atmos array, out_data list, out_data_files
+  array, forcing file handles, cell arena, and (if INIT_STATE is set)
+  its own handle on the initial state file, and runs the cell with
+  run_cell().
+
+  The model globals are thread-local; each worker binds the
+  simulation's context (see vic_context.c) before touching any of
+  them.  Since read_vegparam() may overwrite veg_lib entries with
+  cell-specific values, each cell gets a private copy of veg_lib,
+  taken right after its veg parameters have been read.
+
+  With CELL_SCHEDULE = FILE_ORDER, the workers take cells from the
+  queue in the order in which they were read.  With CELL_SCHEDULE =
+  LONGEST_FIRST, the workers wait until all cells have been read; the
+  queue is then sorted by decreasing cost, so that the most expensive
+  cells start first and the cheap ones fill in the gaps at the end of
+  the run.  Since the queue is shared, a worker that finishes early
+  simply takes the next cell, so no worker sits idle while cells are
+  waiting.  A cell's cost is its run time from the CELL_TIMING_LOG of
+  a previous run if available, and otherwise is estimated from its
+  number of veg tiles and snow bands, whether frozen soil is active,
+  and whether it has a lake (see estimate_cell_cost()).
+
+  Output files are per-cell, so they are identical to those of a serial
+  run.  The state file is shared: each cell writes its state to a
+  memory buffer, and the buffers are appended to the state file in the
+  order in which the cells were read, so that the state file is
+  identical to that of a serial run.  With CELL_JOURNAL, a cell is
+  journaled once its state has been appended, so the journal, too,
+  lists the cells in the order in which they were read.
+
+  If a cell's model state cannot be initialized (with CONTINUEONERROR
+  TRUE), the serial driver stops running cells; here, no further cells
+  are submitted, cells that follow the failed cell and have not yet
+  started are skipped, and no state is saved for any cell that follows
+  the failed cell.
+**********************************************************************/
+
+/* Relative costs used by estimate_cell_cost(), in units of one veg tile
+   in one snow band; based on timings of the benchmark configurations */
+#define COST_FULL_ENERGY  3.0   /* energy balance vs. water balance mode */
+#define COST_FROZEN_SOIL  4.0   /* cells with FS_ACTIVE */
+#define COST_LAKE         8.0   /* per lake, added to the tile count */
+
+typedef struct cell_job {
+  int                cellnum;     /* index of the cell among the active cells */
+  double             cost;        /* estimated or logged cost of the cell */
+  soil_con_struct    soil_con;
+  veg_con_struct    *veg_con;
+  lake_con_struct    lake_con;
+  veg_lib_struct    *veg_lib;     /* private copy of the veg library */
+  phase_profile_struct profile;   /* phase times of reading the cell's
+                                     parameters (PHASE_PROFILE) */
+  struct cell_job   *next;
+} cell_job_struct;
+
+typedef struct {
+  int                gridcel;
+  double             estimate;    /* cost from estimate_cell_cost() */
+  double             logged;      /* run time in the previous timing log;
+                                     < 0 = not in the log */
+  double             seconds;     /* wall time of the cell's run; < 0 = not run */
+  size_t             memory;      /* memory taken from the worker's arena */
+  char               FINISHED;    /* TRUE = cell has been run or skipped */
+  char              *state;       /* cell's model state, not yet appended
+                                     to the state file */
+  size_t             state_len;
+} cell_record_struct;
+
+struct cell_pool_struct {
+  int                   Nthreads;
+  pthread_t            *threads;
+  pthread_mutex_t       lock;
+  pthread_cond_t        job_ready;    /* signalled when a job is queued */
+  pthread_cond_t        job_taken;    /* signalled when a job is dequeued */
+  cell_job_struct      *head;         /* queue of cells waiting to run */
+  cell_job_struct      *tail;
+  int                   Nqueued;
+  char                  HOLD;         /* TRUE = don't start cells until all
+                                         have been submitted */
+  char                  DONE;         /* TRUE = no more cells will be submitted */
+  char                  FAILED;       /* TRUE = a cell failed initialization */
+  int                   fail_cellnum; /* first cell that failed initialization */
+  int                   first_cellnum;/* cellnum of the first cell submitted */
+  cell_record_struct   *cells;        /* records of the submitted cells,
+                                         indexed by cellnum - first_cellnum */
+  int                   Ncells;
+  int                   Nalloc;
+  int                   next_commit;  /* cellnum of next state to append */
+  int                   Ntiming;      /* cells in the previous timing log */
+  cell_timing_struct   *timing;
+  vic_context_struct   *ctx;          /* configuration of the simulation */
+  int                   startrec;
+  dmy_struct           *dmy;
+  filep_struct          filep;
+  filenames_struct      filenames;
+  out_data_file_struct *out_data_files;
+  out_data_struct      *out_data;
+};
+
+static void free_cell_job(cell_job_struct *job)
+{
+  extern THREAD_LOCAL option_struct options;
+
+  if (!options.OUTPUT_FORCE) {
+    free_vegcon(&job->veg_con);
+    free((char *)job->veg_lib);
+  }
+  free((char *)job->soil_con.AreaFract);
+  free((char *)job->soil_con.BandElev);
+  free((char *)job->soil_con.Tfactor);
+  free((char *)job->soil_con.Pfactor);
+  free((char *)job->soil_con.AboveTreeLine);
+
+}
+
+static double estimate_cell_cost(soil_con_struct *soil_con,
+                                 veg_con_struct  *veg_con,
+                                 lake_con_struct *lake_con)
+/* Estimate the relative cost of running a cell: the number of veg
+   tiles (plus bare soil) times the number of snow bands in use, scaled
+   up for the energy balance and frozen soil algorithms, plus the cost
+   of the lake model. */
+{
+  extern THREAD_LOCAL option_struct options;
+
+  double cost;
+  int    Nbands;
+  int    band;
+
+  if (options.OUTPUT_FORCE) return 1.0;
+
+  Nbands = 0;
+  for (band = 0; band < options.SNOW_BAND; band++)
+    if (soil_con->AreaFract[band] > 0) Nbands++;
+  if (Nbands < 1) Nbands = 1;
+
+  cost = (double)(veg_con[0].vegetat_type_num + 1);
+  if (options.LAKES && lake_con->lake_idx >= 0)
+    cost += COST_LAKE;
+  cost *= Nbands;
+  if (options.FULL_ENERGY)
+    cost *= COST_FULL_ENERGY;
+  if (options.FROZEN_SOIL && soil_con->FS_ACTIVE)
+    cost *= COST_FROZEN_SOIL;
+
+  return cost;
+
+}
+
+static int compare_jobs(const void *a, const void *b)
+/* decreasing cost; ties in file order */
+{
+  const cell_job_struct *ja = *(cell_job_struct * const *)a;
+  const cell_job_struct *jb = *(cell_job_struct * const *)b;
+
+  if (ja->cost > jb->cost) return -1;
+  if (ja->cost < jb->cost) return 1;
+  return (ja->cellnum > jb->cellnum) - (ja->cellnum < jb->cellnum);
+}
+
+static void sort_queue(cell_pool_struct *pool)
+/* Order the queue by decreasing cost.  Cells found in the timing log
+   use their logged run time; the estimates of the other cells are put
+   on the same scale as the logged times.  Must be called with
+   pool->lock held. */
+{
+  cell_job_struct   **jobs;
+  cell_job_struct    *job;
+  cell_record_struct *cell;
+  double              sum_logged;
+  double              sum_estimate;
+  double              scale;
+  int                 i;
+
+  if (pool->Nqueued == 0) return;
+
+  sum_logged = sum_estimate = 0;
+  for (i = 0; i < pool->Ncells; i++) {
+    if (pool->cells[i].logged >= 0) {
+      sum_logged += pool->cells[i].logged;
+      sum_estimate += pool->cells[i].estimate;
+    }
+  }
+  scale = (sum_logged > 0 && sum_estimate > 0) ? sum_logged / sum_estimate : 1.0;
+
+  jobs = (cell_job_struct **)calloc(pool->Nqueued, sizeof(cell_job_struct *));
+  if (jobs == NULL)
+    nrerror("Memory allocation error in sort_queue().");
+  for (i = 0, job = pool->head; job != NULL; job = job->next, i++) {
+    cell = &pool->cells[job->cellnum - pool->first_cellnum];
+    job->cost = (cell->logged >= 0) ? cell->logged : scale * cell->estimate;
+    jobs[i] = job;
+  }
+  qsort(jobs, pool->Nqueued, sizeof(cell_job_struct *), compare_jobs);
+  for (i = 0; i < pool->Nqueued - 1; i++)
+    jobs[i]->next = jobs[i+1];
+  jobs[pool->Nqueued-1]->next = NULL;
+  pool->head = jobs[0];
+  pool->tail = jobs[pool->Nqueued-1];
+  free((char *)jobs);
+
+}
+
+static void commit_states(cell_pool_struct *pool)
+/* Append the states of finished cells to the state file, in cell order,
+   and journal the cells.  Must be called with pool->lock held. */
+{
+  cell_record_struct *cell;
+
+  while (pool->next_commit - pool->first_cellnum < pool->Ncells
+         && !(pool->FAILED && pool->next_commit > pool->fail_cellnum)) {
+    cell = &pool->cells[pool->next_commit - pool->first_cellnum];
+    if (!cell->FINISHED) break;
+    if (cell->state != NULL) {
+      fwrite(cell->state, 1, cell->state_len, pool->filep.statefile);
+      free(cell->state);
+      cell->state = NULL;
+    }
+    if (pool->filep.cell_journal != NULL
+        && !(pool->FAILED && pool->next_commit == pool->fail_cellnum))
+      write_cell_journal(pool->filep.cell_journal, cell->gridcel,
+                         pool->filep.statefile);
+    pool->next_commit++;
+  }
+
+}
+
+static void *cell_worker(void *arg)
+{
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL global_param_struct global_param;
+
+  cell_pool_struct     *pool = (cell_pool_struct *)arg;
+  vic_context_struct    cell_ctx;
+  cell_job_struct      *job;
+  cell_record_struct   *cell;
+  atmos_data_struct    *atmos;
+  filep_struct          filep;
+  filenames_struct      filenames;
+  out_data_file_struct *out_data_files;
+  out_data_struct      *out_data;
+  cell_arena_struct    *arena;
+  int                   startrec;
+  int                   last_cellnum;
+  int                   ErrorFlag;
+  char                 *state;
+  size_t                state_len;
+  double                start;
+
+  /** Set up this thread's private copies of the per-cell structures **/
+  bind_vic_context(pool->ctx);
+  alloc_atmos(global_param.nrecs, &atmos);
+  out_data = copy_output_list(pool->out_data);
+  out_data_files = copy_out_data_files(pool->out_data_files);
+  arena = make_cell_arena((size_t)options.CELL_MEMORY_LIMIT << 20);
+  filep = pool->filep;
+  filenames = pool->filenames;
+  startrec = pool->startrec;
+
+  /** Each thread reads the initial state file with its own handle.  An
+      indexed state file is read in any order; otherwise the search only
+      moves forward, so the file is re-opened if a cell is taken out of
+      file order **/
+  filep.init_state_index = NULL;
+  if ( !options.OUTPUT_FORCE && options.INIT_STATE ) {
+    filep.init_state = check_state_file(filenames.init_state, pool->dmy,
+                                        &global_param, options.Nlayer,
+                                        options.Nnode, &startrec);
+    if ( options.BINARY_STATE_FILE )
+      filep.init_state_index = read_state_index(filep.init_state);
+  }
+  last_cellnum = -1;
+
+  while (TRUE) {
+
+    /** Take the next cell from the queue **/
+    pthread_mutex_lock(&pool->lock);
+    while ((pool->head == NULL || pool->HOLD) && !pool->DONE)
+      pthread_cond_wait(&pool->job_ready, &pool->lock);
+    if (pool->head == NULL) {
+      pthread_mutex_unlock(&pool->lock);
+      break;
+    }
+    job = pool->head;
+    pool->head = job->next;
+    if (pool->head == NULL) pool->tail = NULL;
+    pool->Nqueued--;
+    pthread_cond_signal(&pool->job_taken);
+    if (pool->FAILED && job->cellnum > pool->fail_cellnum) {
+      /* the serial driver would never have reached this cell */
+      pool->cells[job->cellnum - pool->first_cellnum].FINISHED = TRUE;
+      pthread_mutex_unlock(&pool->lock);
+      free_cell_job(job);
+      free((char *)job);
+      continue;
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    if ( !options.OUTPUT_FORCE && options.INIT_STATE && filep.init_state_index == NULL
+         && job->cellnum < last_cellnum ) {
+      fclose(filep.init_state);
+      filep.init_state = check_state_file(filenames.init_state, pool->dmy,
+                                          &global_param, options.Nlayer,
+                                          options.Nnode, &startrec);
+    }
+    last_cellnum = job->cellnum;
+
+    /** Run the cell **/
+    cell_ctx = *pool->ctx;
+    cell_ctx.veg_lib = job->veg_lib;
+    state = NULL;
+    state_len = 0;
+    filep.statefile = NULL;
+    if (pool->filep.statefile != NULL) {
+      if ((filep.statefile = open_memstream(&state, &state_len)) == NULL)
+        nrerror("Unable to open memory buffer for model state");
+    }
+
+    start = cell_clock();
+    import_phase_profile(&job->profile);
+    ErrorFlag = run_cell(&cell_ctx, job->cellnum, &job->soil_con, job->veg_con,
+                         &job->lake_con, atmos, pool->dmy, startrec, &filep,
+                         &filenames, out_data_files, out_data, arena);
+    start = cell_clock() - start;
+
+    if (filep.statefile != NULL) fclose(filep.statefile);
+    free_cell_job(job);
+
+    /** Hand the cell's state over to be appended to the state file **/
+    pthread_mutex_lock(&pool->lock);
+    cell = &pool->cells[job->cellnum - pool->first_cellnum];
+    cell->seconds = start;
+    cell->memory = cell_arena_used(arena);
+    cell->FINISHED = TRUE;
+    if (ErrorFlag == ERROR) {
+      if (!pool->FAILED || job->cellnum < pool->fail_cellnum)
+        pool->fail_cellnum = job->cellnum;
+      pool->FAILED = TRUE;
+      pthread_cond_broadcast(&pool->job_taken);
+      free(state);
+    }
+    else if (state != NULL) {
+      cell->state = state;
+      cell->state_len = state_len;
+    }
+    commit_states(pool);
+    pthread_mutex_unlock(&pool->lock);
+    free((char *)job);
+    reset_cell_arena(arena);
+
+  }
+
+  /** Clean up **/
+  if ( !options.OUTPUT_FORCE && options.INIT_STATE ) {
+    fclose(filep.init_state);
+    free_state_index(&filep.init_state_index);
+  }
+  free_out_data_files(&out_data_files);
+  free_out_data(&out_data);
+  free_atmos(global_param.nrecs, &atmos);
+  free_cell_arena(&arena);
+
+  return NULL;
+
+}
+
+cell_pool_struct *start_cell_pool(int                   Nthreads,
+                                  int                   first_cellnum,
+                                  vic_context_struct   *ctx,
+                                  dmy_struct           *dmy,
+                                  int                   startrec,
+                                  filep_struct         *filep,
+                                  filenames_struct     *filenames,
+                                  out_data_file_struct *out_data_files,
+                                  out_data_struct      *out_data)
+/**********************************************************************
+  start_cell_pool				October 2026
+
+  Starts Nthreads worker threads that run the cells passed to
+  submit_cell(), using the configuration in ctx.  first_cellnum is
+  the cellnum of the first cell that will be submitted; cells must be
+  submitted in order of consecutive cellnum.  The structures
+  passed in serve as templates for the
+  workers' private copies and must remain valid until
+  finish_cell_pool() returns.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+
+  cell_pool_struct *pool;
+  char              ErrStr[MAXSTRING];
+  int               i;
+
+  pool = (cell_pool_struct *)calloc(1, sizeof(cell_pool_struct));
+  if (pool == NULL)
+    nrerror("Memory allocation error in start_cell_pool().");
+  pool->threads = (pthread_t *)calloc(Nthreads, sizeof(pthread_t));
+  if (pool->threads == NULL)
+    nrerror("Memory allocation error in start_cell_pool().");
+
+  pool->Nthreads = Nthreads;
+  pool->first_cellnum = first_cellnum;
+  pool->next_commit = first_cellnum;
+  pool->HOLD = (options.CELL_SCHEDULE == SCHED_LONGEST_FIRST);
+  pool->ctx = ctx;
+  pool->dmy = dmy;
+  pool->startrec = startrec;
+  pool->filep = *filep;
+  pool->filenames = *filenames;
+  pool->out_data_files = out_data_files;
+  pool->out_data = out_data;
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->job_ready, NULL);
+  pthread_cond_init(&pool->job_taken, NULL);
+
+  if (pool->HOLD && strcmp(filenames->cell_timing, "MISSING") != 0)
+    pool->Ntiming = read_cell_timing(filenames->cell_timing, &pool->timing);
+
+  for (i = 0; i < Nthreads; i++) {
+    if (pthread_create(&pool->threads[i], NULL, cell_worker, pool) != 0) {
+      sprintf(ErrStr, "Unable to start worker thread %d of %d.", i+1, Nthreads);
+      nrerror(ErrStr);
+    }
+  }
+
+  return pool;
+
+}
+
+int submit_cell(cell_pool_struct *pool,
+                int               cellnum,
+                soil_con_struct  *soil_con,
+                veg_con_struct   *veg_con,
+                lake_con_struct  *lake_con)
+/**********************************************************************
+  submit_cell					October 2026
+
+  Queues a cell to be run by the worker threads.  The pool takes over
+  veg_con and the arrays in soil_con, and copies the current contents
+  of veg_lib.  With CELL_SCHEDULE = FILE_ORDER, blocks while 2*NTHREADS
+  cells are already waiting.
+
+  Returns ERROR if a cell has failed initialization, in which case the
+  cell is not run and the caller should stop reading cells.
+**********************************************************************/
+{
+  extern THREAD_LOCAL veg_lib_struct *veg_lib;
+  extern THREAD_LOCAL option_struct options;
+
+  cell_job_struct    *job;
+  cell_record_struct *cell;
+  size_t              libsize;
+
+  job = (cell_job_struct *)calloc(1, sizeof(cell_job_struct));
+  if (job == NULL)
+    nrerror("Memory allocation error in submit_cell().");
+  job->cellnum = cellnum;
+  job->soil_con = *soil_con;
+  job->veg_con = veg_con;
+  job->lake_con = *lake_con;
+  if (!options.OUTPUT_FORCE) {
+    libsize = (pool->ctx->Nveg_type + N_PET_TYPES_NON_NAT) * sizeof(veg_lib_struct);
+    if ((job->veg_lib = (veg_lib_struct *)malloc(libsize)) == NULL)
+      nrerror("Memory allocation error in submit_cell().");
+    memcpy(job->veg_lib, veg_lib, libsize);
+  }
+  export_phase_profile(&job->profile);
+
+  pthread_mutex_lock(&pool->lock);
+  while (!pool->HOLD && pool->Nqueued >= 2*pool->Nthreads && !pool->FAILED)
+    pthread_cond_wait(&pool->job_taken, &pool->lock);
+  if (pool->FAILED) {
+    pthread_mutex_unlock(&pool->lock);
+    free_cell_job(job);
+    free((char *)job);
+    return ERROR;
+  }
+
+  /* record the cell */
+  if (pool->Ncells == pool->Nalloc) {
+    pool->Nalloc = pool->Nalloc ? 2*pool->Nalloc : 1024;
+    pool->cells = (cell_record_struct *)realloc(pool->cells,
+                                                pool->Nalloc*sizeof(cell_record_struct));
+    if (pool->cells == NULL)
+      nrerror("Memory allocation error in submit_cell().");
+  }
+  cell = &pool->cells[pool->Ncells++];
+  memset(cell, 0, sizeof(cell_record_struct));
+  cell->gridcel = soil_con->gridcel;
+  cell->seconds = -1;
+  cell->logged = -1;
+  if (pool->HOLD) {
+    cell->estimate = estimate_cell_cost(soil_con, veg_con, lake_con);
+    cell->logged = lookup_cell_timing(soil_con->gridcel, pool->timing,
+                                      pool->Ntiming);
+  }
+
+  if (pool->tail == NULL) pool->head = job;
+  else pool->tail->next = job;
+  pool->tail = job;
+  pool->Nqueued++;
+  pthread_cond_signal(&pool->job_ready);
+  pthread_mutex_unlock(&pool->lock);
+
+  return 0;
+
+}
+
+void finish_cell_pool(cell_pool_struct **pool)
+/**********************************************************************
+  finish_cell_pool				October 2026
+
+  Waits for all submitted cells to finish, makes sure all of their
+  states have been appended to the state file, writes the timing log
+  (if CELL_TIMING_LOG is set), and frees the pool.
+**********************************************************************/
+{
+  FILE *log;
+  int   i;
+
+  pthread_mutex_lock(&(*pool)->lock);
+  if ((*pool)->HOLD) {
+    /* all cells have been read; start them, most expensive first */
+    sort_queue(*pool);
+    (*pool)->HOLD = FALSE;
+  }
+  (*pool)->DONE = TRUE;
+  pthread_cond_broadcast(&(*pool)->job_ready);
+  pthread_mutex_unlock(&(*pool)->lock);
+
+  for (i = 0; i < (*pool)->Nthreads; i++)
+    pthread_join((*pool)->threads[i], NULL);
+
+  if (strcmp((*pool)->filenames.cell_timing_out, "MISSING") != 0) {
+    /* cells that were not run are left out */
+    log = open_cell_timing((*pool)->filenames.cell_timing_out);
+    for (i = 0; i < (*pool)->Ncells; i++)
+      if ((*pool)->cells[i].seconds >= 0)
+        write_cell_timing(log, (*pool)->cells[i].gridcel, (*pool)->cells[i].seconds,
+                          (*pool)->cells[i].memory);
+    fclose(log);
+  }
+
+  /* states of cells that follow a failed cell are discarded */
+  for (i = 0; i < (*pool)->Ncells; i++)
+    free((*pool)->cells[i].state);
+
+  pthread_mutex_destroy(&(*pool)->lock);
+  pthread_cond_destroy(&(*pool)->job_ready);
+  pthread_cond_destroy(&(*pool)->job_taken);
+  free((char *)(*pool)->cells);
+  free((char *)(*pool)->timing);
+  free((char *)(*pool)->threads);
+  free((char *)(*pool));
+  *pool = NULL;
+
+}
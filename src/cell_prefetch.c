@@ -0,0 +1,285 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <vicNl.h>
+
+static char vcid[] = "$Id$";
+
+/**********************************************************************
+  cell_prefetch					October 2026
+
+  Two-stage grid cell pipeline, used when PREFETCH is TRUE and the
+  cells are run serially (NTHREADS = 1).
+
+  Running a cell has two phases: prepare_cell() opens the cell's files
+  and reads and disaggregates its forcings (which is dominated by I/O
+  and MTCLIM), and simulate_cell() runs the model.  Here, as soon as the
+  main thread has read the parameters of cell N+1, a helper thread
+  prepares cell N+1 while the main thread simulates cell N.  The two
+  cells use separate buffers (atmos array, out_data list, out_data_files
+  array, forcing file handles, and cell arena), which alternate between
+  the cells.
+
+  Cells are simulated in file order on the main thread, so the state
+  file, the initial state file, and all output files are identical to
+  those of a serial run without PREFETCH.  As in the thread pool, each
+  cell gets a private copy of veg_lib, since read_vegparam() for the
+  next cell may overwrite veg_lib entries.
+
+  If a cell's model state cannot be initialized (with CONTINUEONERROR
+  TRUE), the next cell, which has already been prepared, is discarded
+  and its output files are removed.
+**********************************************************************/
+
+typedef struct {
+  int                   cellnum;
+  soil_con_struct       soil_con;
+  veg_con_struct       *veg_con;
+  lake_con_struct       lake_con;
+  vic_context_struct    ctx;          /* simulation's context with the
+                                         cell's private veg_lib */
+  atmos_data_struct    *atmos;
+  filep_struct          filep;
+  filenames_struct      filenames;
+  out_data_file_struct *out_data_files;
+  out_data_struct      *out_data;
+  veg_hist_struct     **veg_hist;
+  cell_arena_struct    *arena;
+  dmy_struct           *dmy;
+  double                seconds;      /* wall time spent preparing the cell */
+  phase_profile_struct  profile;      /* phase times of reading and
+                                         preparing the cell (PHASE_PROFILE) */
+} prefetch_slot_struct;
+
+struct cell_prefetch_struct {
+  vic_context_struct   *ctx;          /* configuration of the simulation */
+  int                   startrec;
+  FILE                 *timing_log;   /* cell timing log, or NULL */
+  prefetch_slot_struct  slot[2];
+  int                   next;         /* slot to be filled next */
+  prefetch_slot_struct *ready;        /* prepared cell waiting to be
+                                         simulated, or NULL */
+};
+
+static void free_slot_cell(prefetch_slot_struct *slot)
+{
+  extern THREAD_LOCAL option_struct options;
+
+  if (!options.OUTPUT_FORCE) {
+    free_vegcon(&slot->veg_con);
+    free((char *)slot->ctx.veg_lib);
+  }
+  free((char *)slot->soil_con.AreaFract);
+  free((char *)slot->soil_con.BandElev);
+  free((char *)slot->soil_con.Tfactor);
+  free((char *)slot->soil_con.Pfactor);
+  free((char *)slot->soil_con.AboveTreeLine);
+
+}
+
+static void discard_slot_cell(prefetch_slot_struct *slot)
+/* Undo prepare_cell() for a cell that will not be simulated. */
+{
+  extern THREAD_LOCAL option_struct options;
+
+  int filenum;
+
+  if (slot->filep.forcing[0] != NULL)
+    fclose(slot->filep.forcing[0]);
+  if (slot->filep.forcing[1] != NULL)
+    fclose(slot->filep.forcing[1]);
+  for (filenum = 0; filenum < options.Noutfiles; filenum++) {
+    fclose(slot->out_data_files[filenum].fh);
+    remove(slot->out_data_files[filenum].filename);
+  }
+  reset_cell_arena(slot->arena);
+  free_slot_cell(slot);
+  memset(&slot->profile, 0, sizeof(phase_profile_struct));
+
+}
+
+static void *prepare_slot(void *arg)
+{
+  prefetch_slot_struct *slot = (prefetch_slot_struct *)arg;
+  double                start;
+
+  start = cell_clock();
+  bind_vic_context(&slot->ctx);
+  prepare_cell(&slot->soil_con, slot->veg_con, slot->atmos, slot->dmy,
+               &slot->filep, &slot->filenames, slot->out_data_files,
+               slot->out_data, &slot->veg_hist, slot->arena);
+  slot->seconds = cell_clock() - start;
+  export_phase_profile(&slot->profile);
+
+  return NULL;
+
+}
+
+static int simulate_ready_cell(cell_prefetch_struct *pf)
+/* Simulate the prepared cell on the calling thread, then restore the
+   simulation's own context. */
+{
+  prefetch_slot_struct *slot = pf->ready;
+  double                start;
+  int                   ErrorFlag;
+
+  start = cell_clock();
+  bind_vic_context(&slot->ctx);
+  import_phase_profile(&slot->profile);
+  ErrorFlag = simulate_cell(slot->cellnum, &slot->soil_con, slot->veg_con,
+                            &slot->lake_con, slot->atmos, slot->dmy,
+                            pf->startrec, &slot->filep, &slot->filenames,
+                            slot->out_data_files, slot->out_data,
+                            slot->veg_hist, slot->arena);
+  bind_vic_context(pf->ctx);
+
+  if (ErrorFlag != ERROR && slot->filep.cell_journal != NULL)
+    write_cell_journal(slot->filep.cell_journal, slot->soil_con.gridcel,
+                       slot->filep.statefile);
+  if (ErrorFlag != ERROR && pf->timing_log != NULL)
+    write_cell_timing(pf->timing_log, slot->soil_con.gridcel,
+                      slot->seconds + cell_clock() - start,
+                      cell_arena_used(slot->arena));
+
+  reset_cell_arena(slot->arena);
+  free_slot_cell(slot);
+  pf->ready = NULL;
+
+  return ErrorFlag;
+
+}
+
+cell_prefetch_struct *start_cell_prefetch(vic_context_struct   *ctx,
+                                          dmy_struct           *dmy,
+                                          int                   startrec,
+                                          filep_struct         *filep,
+                                          filenames_struct     *filenames,
+                                          out_data_file_struct *out_data_files,
+                                          out_data_struct      *out_data,
+                                          FILE                 *timing_log)
+/**********************************************************************
+  start_cell_prefetch				October 2026
+
+  Sets up the two buffers of the PREFETCH pipeline, using the
+  structures passed in as templates.  The state file and initial state
+  file handles in filep are used by both buffers.  If timing_log is
+  not NULL, the time spent preparing and simulating each cell is
+  written to it.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL global_param_struct global_param;
+
+  cell_prefetch_struct *pf;
+  int                   i;
+
+  pf = (cell_prefetch_struct *)calloc(1, sizeof(cell_prefetch_struct));
+  if (pf == NULL)
+    nrerror("Memory allocation error in start_cell_prefetch().");
+  pf->ctx = ctx;
+  pf->startrec = startrec;
+  pf->timing_log = timing_log;
+  for (i = 0; i < 2; i++) {
+    alloc_atmos(global_param.nrecs, &pf->slot[i].atmos);
+    pf->slot[i].out_data = copy_output_list(out_data);
+    pf->slot[i].out_data_files = copy_out_data_files(out_data_files);
+    pf->slot[i].arena = make_cell_arena((size_t)options.CELL_MEMORY_LIMIT << 20);
+    pf->slot[i].filep = *filep;
+    pf->slot[i].filenames = *filenames;
+    pf->slot[i].dmy = dmy;
+  }
+
+  return pf;
+
+}
+
+int prefetch_cell(cell_prefetch_struct *pf,
+                  int                   cellnum,
+                  soil_con_struct      *soil_con,
+                  veg_con_struct       *veg_con,
+                  lake_con_struct      *lake_con)
+/**********************************************************************
+  prefetch_cell					October 2026
+
+  Starts preparing a cell on a helper thread and, meanwhile, simulates
+  the previously prepared cell (if any) on the calling thread.  The
+  pipeline takes over veg_con and the arrays in soil_con, and copies
+  the current contents of veg_lib.
+
+  Returns ERROR if the previous cell's model state could not be
+  initialized, in which case this cell is discarded and the caller
+  should stop reading cells.
+**********************************************************************/
+{
+  extern THREAD_LOCAL veg_lib_struct *veg_lib;
+  extern THREAD_LOCAL option_struct options;
+
+  prefetch_slot_struct *slot;
+  pthread_t             helper;
+  size_t                libsize;
+  int                   ErrorFlag;
+
+  /** Fill the free buffer with the new cell **/
+  slot = &pf->slot[pf->next];
+  slot->cellnum = cellnum;
+  slot->soil_con = *soil_con;
+  slot->veg_con = veg_con;
+  slot->lake_con = *lake_con;
+  slot->ctx = *pf->ctx;
+  slot->ctx.veg_lib = NULL;
+  if (!options.OUTPUT_FORCE) {
+    libsize = (pf->ctx->Nveg_type + N_PET_TYPES_NON_NAT) * sizeof(veg_lib_struct);
+    if ((slot->ctx.veg_lib = (veg_lib_struct *)malloc(libsize)) == NULL)
+      nrerror("Memory allocation error in prefetch_cell().");
+    memcpy(slot->ctx.veg_lib, veg_lib, libsize);
+  }
+  export_phase_profile(&slot->profile);
+
+  /** Prepare it in the background while the previous cell runs **/
+  if (pthread_create(&helper, NULL, prepare_slot, slot) != 0)
+    nrerror("Unable to start forcing prefetch thread.");
+
+  ErrorFlag = 0;
+  if (pf->ready != NULL)
+    ErrorFlag = simulate_ready_cell(pf);
+
+  pthread_join(helper, NULL);
+
+  if (ErrorFlag == ERROR) {
+    /* the serial driver would never have reached this cell */
+    discard_slot_cell(slot);
+    return ERROR;
+  }
+
+  pf->ready = slot;
+  pf->next = 1 - pf->next;
+
+  return 0;
+
+}
+
+void finish_cell_prefetch(cell_prefetch_struct **pf)
+/**********************************************************************
+  finish_cell_prefetch				October 2026
+
+  Simulates the last prepared cell, if any, and frees the pipeline.
+**********************************************************************/
+{
+  extern THREAD_LOCAL global_param_struct global_param;
+
+  int i;
+
+  if ((*pf)->ready != NULL)
+    simulate_ready_cell(*pf);
+
+  for (i = 0; i < 2; i++) {
+    free_out_data_files(&(*pf)->slot[i].out_data_files);
+    free_out_data(&(*pf)->slot[i].out_data);
+    free_atmos(global_param.nrecs, &(*pf)->slot[i].atmos);
+    free_cell_arena(&(*pf)->slot[i].arena);
+  }
+  free((char *)(*pf));
+  *pf = NULL;
+
+}
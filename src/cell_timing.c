@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vicNl.h>
+
+static char vcid[] = "$Id$";
+
+/**********************************************************************
+  cell_timing					October 2026
+
+  Routines for the per-cell run time log (CELL_TIMING_LOG).  The log
+  is a text file with one "gridcel seconds memory_MB" line per cell
+  that was run, in the order of the soil parameter file, where
+  memory_MB is the memory the cell took from its cell arena (see
+  cell_arena.c); lines beginning with '#' are comments.  A log written
+  by one run is used by the next run to order (CELL_SCHEDULE =
+  LONGEST_FIRST) and split (NPROCS > 1) the grid cells by cost; only
+  the first two columns are read.
+**********************************************************************/
+
+static int compare_gridcel(const void *a, const void *b)
+{
+  const cell_timing_struct *ta = (const cell_timing_struct *)a;
+  const cell_timing_struct *tb = (const cell_timing_struct *)b;
+
+  return (ta->gridcel > tb->gridcel) - (ta->gridcel < tb->gridcel);
+}
+
+double cell_clock()
+/**********************************************************************
+  cell_clock					October 2026
+
+  Returns the time in seconds on a monotonic clock, for timing cells.
+**********************************************************************/
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + 1.e-9 * (double)now.tv_nsec;
+}
+
+int read_cell_timing(char                *filename,
+                     cell_timing_struct **timing)
+/**********************************************************************
+  read_cell_timing				October 2026
+
+  Reads a cell timing log into *timing, sorted by gridcel for
+  lookup_cell_timing(), and returns the number of cells read.  A
+  missing log is not an error: a warning is printed and 0 is returned.
+**********************************************************************/
+{
+  FILE   *log;
+  char    line[MAXSTRING];
+  int     Ntiming;
+  int     Nalloc;
+  int     gridcel;
+  double  seconds;
+
+  *timing = NULL;
+  if ((log = fopen(filename, "r")) == NULL) {
+    fprintf(stderr, "WARNING: cell timing log %s not found; cell costs will be estimated from the cell parameters.\n", filename);
+    return 0;
+  }
+
+  Ntiming = Nalloc = 0;
+  while (fgets(line, MAXSTRING, log) != NULL) {
+    if (line[0] == '#' || sscanf(line, "%d %lf", &gridcel, &seconds) != 2)
+      continue;
+    if (Ntiming == Nalloc) {
+      Nalloc = Nalloc ? 2*Nalloc : 1024;
+      *timing = (cell_timing_struct *)realloc(*timing, Nalloc*sizeof(cell_timing_struct));
+      if (*timing == NULL)
+        nrerror("Memory allocation error in read_cell_timing().");
+    }
+    (*timing)[Ntiming].gridcel = gridcel;
+    (*timing)[Ntiming].seconds = seconds;
+    Ntiming++;
+  }
+  fclose(log);
+
+  if (Ntiming > 0)
+    qsort(*timing, Ntiming, sizeof(cell_timing_struct), compare_gridcel);
+
+  return Ntiming;
+
+}
+
+double lookup_cell_timing(int                 gridcel,
+                          cell_timing_struct *timing,
+                          int                 Ntiming)
+/**********************************************************************
+  lookup_cell_timing				October 2026
+
+  Returns the logged run time of gridcel, or -1 if it is not in the log.
+**********************************************************************/
+{
+  cell_timing_struct  key;
+  cell_timing_struct *found;
+
+  if (Ntiming == 0) return -1;
+  key.gridcel = gridcel;
+  found = (cell_timing_struct *)bsearch(&key, timing, Ntiming,
+                                        sizeof(cell_timing_struct),
+                                        compare_gridcel);
+  return (found != NULL) ? found->seconds : -1;
+
+}
+
+FILE *open_cell_timing(char *filename)
+/**********************************************************************
+  open_cell_timing				October 2026
+
+  Opens a cell timing log for writing and writes its header.
+**********************************************************************/
+{
+  FILE *log;
+
+  log = open_file(filename, "w");
+  fprintf(log, "# gridcel seconds memory_MB\n");
+
+  return log;
+
+}
+
+void write_cell_timing(FILE   *log,
+                       int     gridcel,
+                       double  seconds,
+                       size_t  memory)
+/**********************************************************************
+  write_cell_timing				October 2026
+
+  Writes the run time of one cell, and the memory (bytes) it took from
+  its cell arena, to a cell timing log.
+**********************************************************************/
+{
+  fprintf(log, "%d %.6f %.3f\n", gridcel, seconds, memory / 1048576.);
+}
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <vicNl.h>
 
 static char vcid[] = "$Id$";
@@ -9,7 +10,8 @@ void check_files(filep_struct     *filep,
 /**********************************************************************
 	check_files		Dag Lohmann		January 1996
 
-  This routine opens files for soil, vegetation, and global parameters.
+  This routine opens files for soil, vegetation, and global parameters,
+  and packed forcing files.
 
   Modifcations:
   02-27-01 Added controls for lake model parameter file    KAC
@@ -17,11 +19,16 @@ void check_files(filep_struct     *filep,
   2006-Oct-16 Merged infiles and outfiles structs into filep_struct.	TJB
   2006-Nov-07 Removed LAKE_MODEL option.				TJB
   2013-Dec-27 Moved OUTPUT_FORCE to options_struct.			TJB
+  2026-Oct-18 Opens packed forcing files (FORCE_FORMAT PACKED), whose
+	      index is read once here and shared by all cells.
 **********************************************************************/
 {
-  extern option_struct  options;
+  extern THREAD_LOCAL option_struct  options;
+  extern THREAD_LOCAL param_set_struct param_set;
   extern FILE          *open_file(char string[], char type[]);
 
+  int file_num;
+
   filep->soilparam   = open_file(fnames->soil, "r");
   if (!options.OUTPUT_FORCE) {
     filep->veglib      = open_file(fnames->veglib, "r");
@@ -32,6 +39,14 @@ void check_files(filep_struct     *filep,
       filep->lakeparam = open_file(fnames->lakeparam,"r");
   }
 
+  for (file_num = 0; file_num < 2; file_num++) {
+    filep->forcing_pack[file_num] = NULL;
+    if (param_set.FORCE_FORMAT[file_num] == PACKED
+        && strcasecmp(fnames->f_path_pfx[file_num], "MISSING") != 0)
+      filep->forcing_pack[file_num] = open_forcing_pack(fnames->f_path_pfx[file_num],
+                                                        file_num);
+  }
+
 }
 
 
@@ -31,10 +31,13 @@ FILE *check_state_file(char                *init_state_name,
   2006-08-23 Changed order of fread/fwrite statements from ...1, sizeof...
              to ...sizeof, 1,... GCT
   2006-Oct-16 Merged infiles and outfiles structs into filep_struct. TJB
+  2026-Oct-18 Finds the snapshot of a multi-snapshot state file that
+	      is given by the date on the INIT_STATE line, and stores
+	      its number in global->init_state_snapshot.
 
 *********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   FILE   *init_state;
   char    filename[MAXSTRING];
@@ -43,6 +46,9 @@ FILE *check_state_file(char                *init_state_name,
   int     tmp_Nlayer;
   int     tmp_Nnodes;
   int     startday, startmonth, startyear;
+  int     Nsnapshots;
+  int     date;
+  int     i;
 
   /* open state file */
   if ( options.BINARY_STATE_FILE )
@@ -80,6 +86,36 @@ FILE *check_state_file(char                *init_state_name,
     nrerror(ErrStr);
   }
 
+  /* Find the requested snapshot */
+  global->init_state_snapshot = -1;
+  if ( options.BINARY_STATE_FILE && startyear == MULTI_SNAPSHOT_STATE ) {
+    if ( global->init_state_date == MISSING ) {
+      sprintf(ErrStr,"The model state file %s holds several snapshots.  Give the date (YYYY-MM-DD) of the snapshot to start from after the file name on the INIT_STATE line of the global control file.", init_state_name);
+      nrerror(ErrStr);
+    }
+    Nsnapshots = startmonth;
+    for ( i = 0; i < Nsnapshots; i++ ) {
+      if ( fread( &startyear, sizeof(int), 1, init_state ) != 1
+           || fread( &startmonth, sizeof(int), 1, init_state ) != 1
+           || fread( &startday, sizeof(int), 1, init_state ) != 1 ) {
+        sprintf(ErrStr,"Unable to read the snapshot dates of the model state file %s.", init_state_name);
+        nrerror(ErrStr);
+      }
+      date = startyear*10000 + startmonth*100 + startday;
+      if ( date == global->init_state_date )
+        global->init_state_snapshot = i;
+    }
+    if ( global->init_state_snapshot < 0 ) {
+      sprintf(ErrStr,"The model state file %s holds no snapshot for %04d-%02d-%02d.", init_state_name, global->init_state_date/10000, (global->init_state_date/100)%100, global->init_state_date%100);
+      nrerror(ErrStr);
+    }
+  }
+  else if ( global->init_state_date != MISSING
+            && global->init_state_date != startyear*10000 + startmonth*100 + startday ) {
+    sprintf(ErrStr,"The model state file %s holds the state of %04d-%02d-%02d, not of the requested %04d-%02d-%02d.", init_state_name, startyear, startmonth, startday, global->init_state_date/10000, (global->init_state_date/100)%100, global->init_state_date%100);
+    nrerror(ErrStr);
+  }
+
   return(init_state);
 
 }
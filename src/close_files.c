@@ -27,28 +27,31 @@ void close_files(filep_struct         *filep,
 	      out_data_files structure.					TJB
   2006-Oct-16 Merged infiles and outfiles structs into filep_struct.	TJB
   2012-Jan-16 Removed LINK_DEBUG code					BN
+  2026-Oct-18 Packed forcing files (forcing[] is NULL) are left open,
+	      since they hold the forcings of all cells.
+  2026-Oct-18 Output files are no longer gzipped here; those that are
+	      to be compressed were written through a gzip stream.
+  2026-Oct-18 Forcing files are no longer gzipped here (COMPRESS), which
+	      rewrote the user's input files in place.
 **********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   int filenum;
 
   /**********************
     Close All Input Files
     **********************/
 
-  fclose(filep->forcing[0]);
-  if(options.COMPRESS) compress_files(fnames->forcing[0]);
-  if(filep->forcing[1]!=NULL) {
+  if(filep->forcing[0]!=NULL)
+    fclose(filep->forcing[0]);
+  if(filep->forcing[1]!=NULL)
     fclose(filep->forcing[1]);
-    if(options.COMPRESS) compress_files(fnames->forcing[1]);
-  }
 
   /*******************
     Close Output Files
     *******************/
   for (filenum=0; filenum<options.Noutfiles; filenum++) {
     fclose(out_data_files[filenum].fh);
-    if(options.COMPRESS) compress_files(out_data_files[filenum].filename);
   }
 
 }
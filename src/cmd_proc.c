@@ -20,9 +20,11 @@ filenames_struct cmd_proc(int argc, char *argv[])
             using the "-g" flag.                                KAC
   2003-Oct-03 Added -v option to display version information.		TJB
   2012-Jan-16 Removed LINK_DEBUG code					BN
+  2026-Oct-18 Added -j option to set the number of threads.
+  2026-Oct-18 Added -p option to set the number of processes.
 **********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   extern int getopt();
   extern char *optarg;
   extern char *optstring;
@@ -55,6 +57,24 @@ filenames_struct cmd_proc(int argc, char *argv[])
       strcpy(names.global, optarg);
       GLOBAL_SET = TRUE;
       break;
+    case 'j':
+      /** Number of Threads (overrides NTHREADS in global file) **/
+      options.NTHREADS = atoi(optarg);
+      if (options.NTHREADS < 1) {
+        fprintf(stderr,"ERROR: Number of threads given with '-j' must be >= 1\n");
+        usage(argv[0]);
+        exit(1);
+      }
+      break;
+    case 'p':
+      /** Number of Processes (overrides NPROCS in global file) **/
+      options.NPROCS = atoi(optarg);
+      if (options.NPROCS < 1) {
+        fprintf(stderr,"ERROR: Number of processes given with '-p' must be >= 1\n");
+        usage(argv[0]);
+        exit(1);
+      }
+      break;
     default:
       /** Print Usage if Invalid Command Line Arguments **/
       usage(argv[0]);
@@ -81,13 +101,19 @@ void usage(char *temp)
 
   Modifications:
   2013-Dec-28 Removed user_def.h.				TJB
+  2026-Oct-18 Added -j option.
+  2026-Oct-18 Added -p option.
 **********************************************************************/
 {
-  fprintf(stderr,"Usage: %s [-v | -o | -g<global_parameter_file>]\n",temp);
+  fprintf(stderr,"Usage: %s [-v | -o | -g<global_parameter_file> [-j<num_threads>] [-p<num_processes>]]\n",temp);
   fprintf(stderr,"  v: display version information\n");
   fprintf(stderr,"  o: display compile-time options settings (set in vicNl_def.h)\n");
   fprintf(stderr,"  g: read model parameters from <global_parameter_file>.\n");
   fprintf(stderr,"       <global_parameter_file> is a file that contains all needed model\n");
   fprintf(stderr,"       parameters as well as model option flags, and the names and\n");
   fprintf(stderr,"       locations of all other files.\n");
+  fprintf(stderr,"  j: run grid cells in parallel on <num_threads> threads.\n");
+  fprintf(stderr,"       Overrides NTHREADS in <global_parameter_file>.\n");
+  fprintf(stderr,"  p: split the grid cells among <num_processes> processes.\n");
+  fprintf(stderr,"       Overrides NPROCS in <global_parameter_file>.\n");
 }
@@ -19,7 +19,7 @@ double compute_coszen(double lat,
 
 **********************************************************************/
 {  
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   double coslat;
   double sinlat;
   double decl;
@@ -35,7 +35,8 @@
 
   programmer: Ted Bohn
   date      : July 25, 2013
-  changes   :
+  changes   : 2026-Oct-18 Temporary arrays are now stored on the stack
+              instead of being allocated on every call.
   references: 
 ********************************************************************************/
 
@@ -59,27 +60,18 @@ void compute_soil_resp(int Nnodes,
                        double *RhInterTot,
                        double *RhSlowTot)
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   int i;
   double Tref;
-  double *TK;
+  double TK[MAX_NODES];
   double fTLitter;
-  double *fTSoil;
+  double fTSoil[MAX_NODES];
   double fMLitter;
-  double *fMSoil;
-  double *CInterNode;
-  double *CSlowNode;
-  double *RhInter;
-  double *RhSlow;
-
-  /* Allocate temp arrays */
-  TK = (double*)calloc(Nnodes,sizeof(double));
-  fTSoil = (double*)calloc(Nnodes,sizeof(double));
-  fMSoil = (double*)calloc(Nnodes,sizeof(double));
-  CInterNode = (double*)calloc(Nnodes,sizeof(double));
-  CSlowNode = (double*)calloc(Nnodes,sizeof(double));
-  RhInter = (double*)calloc(Nnodes,sizeof(double));
-  RhSlow = (double*)calloc(Nnodes,sizeof(double));
+  double fMSoil[MAX_NODES];
+  double CInterNode[MAX_NODES];
+  double CSlowNode[MAX_NODES];
+  double RhInter[MAX_NODES];
+  double RhSlow[MAX_NODES];
 
   /* Compute Lloyd-Taylor temperature dependence */
   Tref = 10+KELVIN; /* reference temperature of 10 C */
@@ -129,13 +121,5 @@ void compute_soil_resp(int Nnodes,
     *RhSlowTot += RhSlow[i];
   }
 
-  free((char *)TK);
-  free((char *)fTSoil);
-  free((char *)fMSoil);
-  free((char *)CInterNode);
-  free((char *)CSlowNode);
-  free((char *)RhInter);
-  free((char *)RhSlow);
-
 }
 
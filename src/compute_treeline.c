@@ -31,9 +31,9 @@ void compute_treeline(atmos_data_struct        *atmos,
 ************************************************************************/
 {
 
-  extern option_struct       options;
-  extern global_param_struct global_param;
-  extern int                 NR, NF;
+  extern THREAD_LOCAL option_struct       options;
+  extern THREAD_LOCAL global_param_struct global_param;
+  extern THREAD_LOCAL int                 NR, NF;
 
   double MonthSum;
   double AnnualSum;
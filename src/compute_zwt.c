@@ -21,7 +21,7 @@ double compute_zwt(soil_con_struct  *soil_con,
 ****************************************************************************/
 
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   int    i;
   double zwt;
@@ -65,7 +65,7 @@ void wrap_compute_zwt(soil_con_struct  *soil_con,
 ****************************************************************************/
 
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   int    i;
   int    lindex;
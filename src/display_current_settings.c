@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <vicNl.h>
 
 static char vcid[] = "$Id$";
@@ -67,15 +68,32 @@ void display_current_settings(int                 mode,
   2014-Mar-28 Removed DIST_PRCP option.					TJB
   2014-Apr-25 Added LAI_SRC, VEGPARAM_ALB, and ALB_SRC options.		TJB
   2014-Apr-25 Added VEGPARAM_VEGCOVER and VEGCOVER_SRC options.		TJB
+  2026-Oct-18 Added NTHREADS option.
+  2026-Oct-18 Added NPROCS option.
+  2026-Oct-18 Added CELL_SCHEDULE and CELL_TIMING_LOG options.
+  2026-Oct-18 Added PREFETCH option.
+  2026-Oct-18 Added ASYNC_OUTPUT option.
+  2026-Oct-18 Added CELL_MEMORY_LIMIT option.
+  2026-Oct-18 Added PACKED forcing file format.
+  2026-Oct-18 Added STATE_SCHEDULE option, and the snapshot date of
+	      INIT_STATE.
+  2026-Oct-18 Added CELL_JOURNAL option.
+  2026-Oct-18 Added EXPLICIT_SOLVER option.
+  2026-Oct-18 Added SOLVER_TELEMETRY option.
+  2026-Oct-18 Added PHASE_PROFILE option.
+  2026-Oct-18 Added SOLAR_GEOM_PRECISION option.
+  2026-Oct-18 Added IMPLICIT_JACOBIAN option.
+  2026-Oct-18 Added ENERGY_WARM_START option.
 
 **********************************************************************/
 {
 
   extern char *version;
-  extern option_struct options;
-  extern param_set_struct param_set;
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL param_set_struct param_set;
 
   int file_num;
+  int i;
 
   if (mode == DISP_VERSION) {
     fprintf(stderr,"***** VIC Version %s *****\n",version);
@@ -168,6 +186,10 @@ void display_current_settings(int                 mode,
     fprintf(stderr,"CLOSE_ENERGY\t\t\tTRUE\n");
   else
     fprintf(stderr,"CLOSE_ENERGY\t\t\tFALSE\n");
+  if (options.ENERGY_WARM_START)
+    fprintf(stderr,"ENERGY_WARM_START\t\tTRUE\n");
+  else
+    fprintf(stderr,"ENERGY_WARM_START\t\tFALSE\n");
   if (options.COMPUTE_TREELINE)
     fprintf(stderr,"COMPUTE_TREELINE\t\tTRUE\n");
   else
@@ -216,6 +238,16 @@ void display_current_settings(int                 mode,
     fprintf(stderr,"IMPLICIT\t\tTRUE\n");
   else
     fprintf(stderr,"IMPLICIT\t\tFALSE\n");
+  if (options.EXPLICIT_SOLVER == ES_NEWTON)
+    fprintf(stderr,"EXPLICIT_SOLVER\t\tNEWTON\n");
+  else
+    fprintf(stderr,"EXPLICIT_SOLVER\t\tGAUSS_SEIDEL\n");
+  if (options.IMPLICIT_JACOBIAN == IJ_ANALYTIC)
+    fprintf(stderr,"IMPLICIT_JACOBIAN\tANALYTIC\n");
+  else if (options.IMPLICIT_JACOBIAN == IJ_CHECK)
+    fprintf(stderr,"IMPLICIT_JACOBIAN\tCHECK\n");
+  else
+    fprintf(stderr,"IMPLICIT_JACOBIAN\tFD\n");
   if (options.NOFLUX)
     fprintf(stderr,"NOFLUX\t\t\tTRUE\n");
   else
@@ -251,6 +283,7 @@ void display_current_settings(int                 mode,
   else if (options.SNOW_DENSITY == DENS_SNTHRM)
     fprintf(stderr,"SNOW_DENSITY\t\tDENS_SNTHRM\n");
   fprintf(stderr,"SW_PREC_THRESH\t\t%f\n",options.SW_PREC_THRESH);
+  fprintf(stderr,"SOLAR_GEOM_PRECISION\t%f\n",options.SOLAR_GEOM_PRECISION);
   if (options.TFALLBACK == TRUE)
     fprintf(stderr,"TFALLBACK\t\tTRUE\n");
   else
@@ -300,6 +333,8 @@ void display_current_settings(int                 mode,
         fprintf(stderr,"FORCE_ENDIAN\t\tBIG\n");
       if (param_set.FORCE_FORMAT[file_num] == BINARY)
         fprintf(stderr,"FORCE_FORMAT\t\tBINARY\n");
+      else if (param_set.FORCE_FORMAT[file_num] == PACKED)
+        fprintf(stderr,"FORCE_FORMAT\t\tPACKED\n");
       else
         fprintf(stderr,"FORCE_FORMAT\t\tASCII\n");
     }
@@ -388,6 +423,10 @@ void display_current_settings(int                 mode,
   fprintf(stderr,"Input State File:\n");
   if (options.INIT_STATE) {
     fprintf(stderr,"INIT_STATE\t\tTRUE\t%s\n",names->init_state);
+    if (global->init_state_date != MISSING)
+      fprintf(stderr,"INIT_STATE snapshot\t%04d-%02d-%02d\n",
+              global->init_state_date/10000, (global->init_state_date/100)%100,
+              global->init_state_date%100);
     if (options.BINARY_STATE_FILE)
       fprintf(stderr,"BINARY_STATE_FILE\tTRUE\n");
     else
@@ -401,9 +440,20 @@ void display_current_settings(int                 mode,
   if (options.SAVE_STATE) {
     fprintf(stderr,"SAVE_STATE\t\tTRUE\n");
     fprintf(stderr,"STATENAME\t\t%s\n",names->statefile);
-    fprintf(stderr,"STATEYEAR\t\t%d\n",global->stateyear);
-    fprintf(stderr,"STATEMONTH\t\t%d\n",global->statemonth);
-    fprintf(stderr,"STATEDAY\t\t%d\n",global->stateday);
+    if (options.STATE_SCHEDULE) {
+      fprintf(stderr,"STATE_SCHEDULE\t\t");
+      if (global->state_monthly_day > 0)
+        fprintf(stderr,"MONTHLY %d ",global->state_monthly_day);
+      for (i = 0; i < global->Nstate_dates; i++)
+        fprintf(stderr,"%04d-%02d-%02d ",global->state_date[i]/10000,
+                (global->state_date[i]/100)%100,global->state_date[i]%100);
+      fprintf(stderr,"\n");
+    }
+    else {
+      fprintf(stderr,"STATEYEAR\t\t%d\n",global->stateyear);
+      fprintf(stderr,"STATEMONTH\t\t%d\n",global->statemonth);
+      fprintf(stderr,"STATEDAY\t\t%d\n",global->stateday);
+    }
     if (options.BINARY_STATE_FILE)
       fprintf(stderr,"BINARY_STATE_FILE\tTRUE\n");
     else
@@ -421,6 +471,10 @@ void display_current_settings(int                 mode,
     fprintf(stderr,"ALMA_OUTPUT\t\tTRUE\n");
   else
     fprintf(stderr,"ALMA_OUTPUT\t\tFALSE\n");
+  if (options.ASYNC_OUTPUT)
+    fprintf(stderr,"ASYNC_OUTPUT\t\tTRUE\n");
+  else
+    fprintf(stderr,"ASYNC_OUTPUT\t\tFALSE\n");
   if (options.BINARY_OUTPUT)
     fprintf(stderr,"BINARY_OUTPUT\t\tTRUE\n");
   else
@@ -446,6 +500,30 @@ void display_current_settings(int                 mode,
   else
     fprintf(stderr,"PRT_SNOW_BAND\t\tFALSE\n");
   fprintf(stderr,"SKIPYEAR\t\t%d\n",global->skipyear);
+
+  fprintf(stderr,"\n");
+  fprintf(stderr,"Run Control:\n");
+  fprintf(stderr,"NTHREADS\t\t%d\n",options.NTHREADS);
+  fprintf(stderr,"NPROCS\t\t\t%d\n",options.NPROCS);
+  if (options.CELL_SCHEDULE == SCHED_LONGEST_FIRST)
+    fprintf(stderr,"CELL_SCHEDULE\t\tLONGEST_FIRST\n");
+  else
+    fprintf(stderr,"CELL_SCHEDULE\t\tFILE_ORDER\n");
+  if (options.PREFETCH)
+    fprintf(stderr,"PREFETCH\t\tTRUE\n");
+  else
+    fprintf(stderr,"PREFETCH\t\tFALSE\n");
+  if (strcmp(names->cell_timing, "MISSING") != 0)
+    fprintf(stderr,"CELL_TIMING_LOG\t\t%s\n",names->cell_timing);
+  fprintf(stderr,"CELL_MEMORY_LIMIT\t%d\n",options.CELL_MEMORY_LIMIT);
+  if (strcmp(names->cell_journal, "MISSING") != 0)
+    fprintf(stderr,"CELL_JOURNAL\t\t%s\n",names->cell_journal);
+  if (options.SOLVER_TELEMETRY)
+    fprintf(stderr,"SOLVER_TELEMETRY\t%s\n",names->solver_telemetry);
+  if (options.PHASE_PROFILE)
+    fprintf(stderr,"PHASE_PROFILE\t\tTRUE\n");
+  else
+    fprintf(stderr,"PHASE_PROFILE\t\tFALSE\n");
   fprintf(stderr,"\n");
 
 }
@@ -38,7 +38,7 @@ void faparl(double  *CanopLayerBnd,
             double  *LAIlayer,
             double  *aPAR)
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   double         FC;
   int            cidx;
   double         ZH;
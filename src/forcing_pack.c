@@ -0,0 +1,390 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <vicNl.h>
+
+static char vcid[] = "$Id$";
+
+/**********************************************************************
+  forcing_pack					October 2026
+
+  Packed forcing files (FORCE_FORMAT PACKED) hold the forcing records
+  of many grid cells in a single file, so that a large domain does not
+  need one forcing file per cell (and one file open per cell).  They
+  are made from the per-cell forcing files by vicPack (see vicPack.c).
+
+  File layout (header and index integers are little-endian):
+
+    bytes 0-7     "VICFPACK"
+    bytes 8-11    format version (FORCING_PACK_VERSION)
+    bytes 12-15   number of cells, Ncells
+    bytes 16-19   number of values per record
+    bytes 20-23   byte order of the records (LITTLE or BIG)
+    bytes 24-31   reserved (0)
+    Ncells index entries of FORCING_PACK_ENTRY bytes:
+      bytes 0-3   gridcel (signed)
+      bytes 4-7   reserved (0)
+      bytes 8-15  lat (IEEE double)
+      bytes 16-23 lng (IEEE double)
+      bytes 24-31 byte offset of the cell's records in the file
+      bytes 32-39 length of the cell's records in bytes
+    records of the cells
+
+  Each cell's records are laid out exactly as in a binary forcing file
+  (one scaled short per field, or per veg tile for the veg_hist fields;
+  see read_atmos_data()), without the file header, and are decoded
+  with the N_TYPES, FORCE_TYPE, and FORCE_ENDIAN of the global
+  parameter file.
+
+  When the simulation starts, the index is read once (see
+  check_files()); each cell's records are then read with a single
+  pread(), which needs no seek on the shared file descriptor, so the
+  worker threads and the PREFETCH thread can read cells concurrently.
+**********************************************************************/
+
+#define FORCING_PACK_MAGIC   "VICFPACK"
+#define FORCING_PACK_VERSION 1
+#define FORCING_PACK_HEADER  32      /* bytes in the file header */
+#define FORCING_PACK_ENTRY   40      /* bytes per index entry */
+
+struct forcing_pack_struct {
+  char                      filename[MAXSTRING];
+  int                       fd;
+  int                       Ncells;
+  forcing_pack_cell_struct *cell;    /* index, sorted by gridcel */
+};
+
+static unsigned long long get_le(const unsigned char *p,
+                                 int                  nbytes)
+{
+  unsigned long long value;
+  int                i;
+
+  value = 0;
+  for (i = nbytes - 1; i >= 0; i--)
+    value = (value << 8) | p[i];
+
+  return value;
+
+}
+
+static void put_le(unsigned char      *p,
+                   unsigned long long  value,
+                   int                 nbytes)
+{
+  int i;
+
+  for (i = 0; i < nbytes; i++, value >>= 8)
+    p[i] = (unsigned char)(value & 0xFF);
+
+}
+
+static double get_le_double(const unsigned char *p)
+{
+  unsigned long long bits;
+  double             value;
+
+  bits = get_le(p, 8);
+  memcpy(&value, &bits, sizeof(value));
+
+  return value;
+
+}
+
+static void put_le_double(unsigned char *p,
+                          double         value)
+{
+  unsigned long long bits;
+
+  memcpy(&bits, &value, sizeof(bits));
+  put_le(p, bits, 8);
+
+}
+
+static void pread_all(forcing_pack_struct *pack,
+                      unsigned char       *buf,
+                      size_t               nbytes,
+                      size_t               offset)
+/* Read nbytes at offset, or stop the run. */
+{
+  char    ErrStr[MAXSTRING];
+  ssize_t n;
+
+  while (nbytes > 0) {
+    n = pread(pack->fd, buf, nbytes, (off_t)offset);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0) {
+      snprintf(ErrStr, sizeof(ErrStr), "Unable to read %lu bytes at offset %lu of packed forcing file %.1000s.",
+               (unsigned long)nbytes, (unsigned long)offset, pack->filename);
+      nrerror(ErrStr);
+    }
+    buf += n;
+    nbytes -= n;
+    offset += n;
+  }
+
+}
+
+static int compare_gridcel(const void *a,
+                           const void *b)
+{
+  const forcing_pack_cell_struct *cell_a = (const forcing_pack_cell_struct *)a;
+  const forcing_pack_cell_struct *cell_b = (const forcing_pack_cell_struct *)b;
+
+  return (cell_a->gridcel > cell_b->gridcel) - (cell_a->gridcel < cell_b->gridcel);
+
+}
+
+size_t forcing_pack_data_start(int Ncells)
+/**********************************************************************
+  forcing_pack_data_start			October 2026
+
+  Returns the byte offset of the first record in a packed forcing file
+  with Ncells cells, i.e. the size of its header and index.
+**********************************************************************/
+{
+  return FORCING_PACK_HEADER + (size_t)Ncells * FORCING_PACK_ENTRY;
+}
+
+void write_forcing_pack_index(FILE                     *packfile,
+                              int                       file_num,
+                              int                       Ncells,
+                              forcing_pack_cell_struct *cell)
+/**********************************************************************
+  write_forcing_pack_index			October 2026
+
+  Writes the header and index of a packed forcing file for the records
+  of forcing file file_num, at the current position of packfile (which
+  should be the start of the file).  cell holds the Ncells index
+  entries, in file order.
+**********************************************************************/
+{
+  extern THREAD_LOCAL param_set_struct param_set;
+
+  unsigned char *buf;
+  unsigned char *entry;
+  size_t         nbytes;
+  int            i;
+
+  nbytes = forcing_pack_data_start(Ncells);
+  if ((buf = (unsigned char *)calloc(nbytes, 1)) == NULL)
+    nrerror("Memory allocation error in write_forcing_pack_index().");
+
+  memcpy(buf, FORCING_PACK_MAGIC, 8);
+  put_le(buf + 8, FORCING_PACK_VERSION, 4);
+  put_le(buf + 12, (unsigned long long)Ncells, 4);
+  put_le(buf + 16, binary_forcing_rec_size(file_num) / sizeof(short), 4);
+  put_le(buf + 20, (unsigned long long)param_set.FORCE_ENDIAN[file_num], 4);
+  for (i = 0; i < Ncells; i++) {
+    entry = buf + FORCING_PACK_HEADER + (size_t)i * FORCING_PACK_ENTRY;
+    put_le(entry, (unsigned long long)(unsigned int)cell[i].gridcel, 4);
+    put_le_double(entry + 8, cell[i].lat);
+    put_le_double(entry + 16, cell[i].lng);
+    put_le(entry + 24, cell[i].offset, 8);
+    put_le(entry + 32, cell[i].length, 8);
+  }
+
+  if (fwrite(buf, 1, nbytes, packfile) != nbytes)
+    nrerror("Unable to write the index of the packed forcing file.");
+  free((char *)buf);
+
+}
+
+forcing_pack_struct *open_forcing_pack(char *filename,
+                                       int   file_num)
+/**********************************************************************
+  open_forcing_pack				October 2026
+
+  Opens the packed forcing file filename, which holds the records of
+  forcing file file_num, and reads its index.  Stops the run if the
+  file is not a packed forcing file, or if its records do not match
+  the fields (N_TYPES and FORCE_TYPE) or FORCE_ENDIAN given for
+  forcing file file_num in the global parameter file.
+**********************************************************************/
+{
+  extern THREAD_LOCAL param_set_struct param_set;
+
+  forcing_pack_struct *pack;
+  unsigned char        header[FORCING_PACK_HEADER];
+  unsigned char       *index;
+  unsigned char       *entry;
+  char                 ErrStr[MAXSTRING];
+  struct stat          st;
+  size_t               Nvalues;
+  size_t               nbytes;
+  int                  i;
+
+  pack = (forcing_pack_struct *)calloc(1, sizeof(forcing_pack_struct));
+  if (pack == NULL)
+    nrerror("Memory allocation error in open_forcing_pack().");
+  strcpy(pack->filename, filename);
+
+  if ((pack->fd = open(filename, O_RDONLY)) < 0 || fstat(pack->fd, &st) != 0) {
+    snprintf(ErrStr, sizeof(ErrStr), "Unable to open packed forcing file %s.", filename);
+    nrerror(ErrStr);
+  }
+
+  /** Header **/
+  if ((size_t)st.st_size < FORCING_PACK_HEADER) {
+    snprintf(ErrStr, sizeof(ErrStr), "%s is not a packed forcing file.", filename);
+    nrerror(ErrStr);
+  }
+  pread_all(pack, header, FORCING_PACK_HEADER, 0);
+  if (memcmp(header, FORCING_PACK_MAGIC, 8) != 0) {
+    snprintf(ErrStr, sizeof(ErrStr), "%s is not a packed forcing file.", filename);
+    nrerror(ErrStr);
+  }
+  if (get_le(header + 8, 4) != FORCING_PACK_VERSION) {
+    snprintf(ErrStr, sizeof(ErrStr), "Packed forcing file %s has format version %d; this version of VIC reads version %d.",
+             filename, (int)get_le(header + 8, 4), FORCING_PACK_VERSION);
+    nrerror(ErrStr);
+  }
+  pack->Ncells = (int)get_le(header + 12, 4);
+  Nvalues = binary_forcing_rec_size(file_num) / sizeof(short);
+  if (get_le(header + 16, 4) != Nvalues) {
+    snprintf(ErrStr, sizeof(ErrStr), "Packed forcing file %s has %d values per record, but the global parameter file defines %d for forcing file %d.",
+             filename, (int)get_le(header + 16, 4), (int)Nvalues, file_num+1);
+    nrerror(ErrStr);
+  }
+  if (get_le(header + 20, 4) != (unsigned long long)param_set.FORCE_ENDIAN[file_num]) {
+    snprintf(ErrStr, sizeof(ErrStr), "The byte order of packed forcing file %s does not match FORCE_ENDIAN for forcing file %d.",
+             filename, file_num+1);
+    nrerror(ErrStr);
+  }
+
+  /** Index **/
+  nbytes = forcing_pack_data_start(pack->Ncells);
+  if (nbytes > (size_t)st.st_size) {
+    snprintf(ErrStr, sizeof(ErrStr), "Packed forcing file %s is truncated.", filename);
+    nrerror(ErrStr);
+  }
+  pack->cell = (forcing_pack_cell_struct *)calloc(pack->Ncells + 1,
+                                                  sizeof(forcing_pack_cell_struct));
+  index = (unsigned char *)malloc(nbytes - FORCING_PACK_HEADER + 1);
+  if (pack->cell == NULL || index == NULL)
+    nrerror("Memory allocation error in open_forcing_pack().");
+  pread_all(pack, index, nbytes - FORCING_PACK_HEADER, FORCING_PACK_HEADER);
+  for (i = 0; i < pack->Ncells; i++) {
+    entry = index + (size_t)i * FORCING_PACK_ENTRY;
+    pack->cell[i].gridcel = (int)(unsigned int)get_le(entry, 4);
+    pack->cell[i].lat = get_le_double(entry + 8);
+    pack->cell[i].lng = get_le_double(entry + 16);
+    pack->cell[i].offset = (size_t)get_le(entry + 24, 8);
+    pack->cell[i].length = (size_t)get_le(entry + 32, 8);
+    if (pack->cell[i].offset > (size_t)st.st_size
+        || pack->cell[i].length > (size_t)st.st_size - pack->cell[i].offset) {
+      snprintf(ErrStr, sizeof(ErrStr), "Packed forcing file %s is truncated: the records of grid cell %d extend past its end.",
+               filename, pack->cell[i].gridcel);
+      nrerror(ErrStr);
+    }
+  }
+  free((char *)index);
+
+  qsort(pack->cell, pack->Ncells, sizeof(forcing_pack_cell_struct),
+        compare_gridcel);
+  for (i = 1; i < pack->Ncells; i++) {
+    if (pack->cell[i].gridcel == pack->cell[i-1].gridcel) {
+      snprintf(ErrStr, sizeof(ErrStr), "Grid cell %d appears more than once in packed forcing file %s.",
+               pack->cell[i].gridcel, filename);
+      nrerror(ErrStr);
+    }
+  }
+
+  return pack;
+
+}
+
+int find_forcing_pack_cell(forcing_pack_struct *pack,
+                           int                  gridcel,
+                           double               lat,
+                           double               lng)
+/**********************************************************************
+  find_forcing_pack_cell			October 2026
+
+  Returns the index of grid cell gridcel in the packed forcing file.
+  The cell's latitude and longitude must match lat and lng to
+  GRID_DECIMAL decimal places, i.e. the cell must be the one whose
+  per-cell forcing file would have had the same name; otherwise (or if
+  the cell is not in the file) the run is stopped.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+
+  forcing_pack_cell_struct  key;
+  forcing_pack_cell_struct *cell;
+  char                      ErrStr[MAXSTRING];
+  char                      want[2][MAXSTRING];
+  char                      have[2][MAXSTRING];
+
+  key.gridcel = gridcel;
+  cell = (forcing_pack_cell_struct *)bsearch(&key, pack->cell, pack->Ncells,
+                                             sizeof(forcing_pack_cell_struct),
+                                             compare_gridcel);
+  if (cell == NULL) {
+    snprintf(ErrStr, sizeof(ErrStr), "Grid cell %d is not in packed forcing file %.1000s.",
+             gridcel, pack->filename);
+    nrerror(ErrStr);
+  }
+
+  sprintf(want[0], "%.*f", options.GRID_DECIMAL, lat);
+  sprintf(want[1], "%.*f", options.GRID_DECIMAL, lng);
+  sprintf(have[0], "%.*f", options.GRID_DECIMAL, cell->lat);
+  sprintf(have[1], "%.*f", options.GRID_DECIMAL, cell->lng);
+  if (strcmp(want[0], have[0]) != 0 || strcmp(want[1], have[1]) != 0) {
+    snprintf(ErrStr, sizeof(ErrStr), "Grid cell %d is at %.100s_%.100s in the soil parameter file, but at %.100s_%.100s in packed forcing file %.1000s.",
+             gridcel, want[0], want[1], have[0], have[1], pack->filename);
+    nrerror(ErrStr);
+  }
+
+  return (int)(cell - pack->cell);
+
+}
+
+size_t forcing_pack_cell_length(forcing_pack_struct *pack,
+                                int                  cell)
+/**********************************************************************
+  forcing_pack_cell_length			October 2026
+
+  Returns the number of bytes of records of a cell (as returned by
+  find_forcing_pack_cell()) in the packed forcing file.
+**********************************************************************/
+{
+  return pack->cell[cell].length;
+}
+
+void read_forcing_pack(forcing_pack_struct *pack,
+                       int                  cell,
+                       size_t               offset,
+                       size_t               nbytes,
+                       unsigned char       *buf)
+/**********************************************************************
+  read_forcing_pack				October 2026
+
+  Reads nbytes of the records of a cell (as returned by
+  find_forcing_pack_cell()) into buf, starting offset bytes into the
+  cell's records, with one pread().  May be called by several threads
+  at once.
+**********************************************************************/
+{
+  pread_all(pack, buf, nbytes, pack->cell[cell].offset + offset);
+}
+
+void close_forcing_pack(forcing_pack_struct **pack)
+/**********************************************************************
+  close_forcing_pack				October 2026
+
+  Closes the packed forcing file and frees its index.
+**********************************************************************/
+{
+  close((*pack)->fd);
+  free((char *)(*pack)->cell);
+  free((char *)(*pack));
+  *pack = NULL;
+
+}
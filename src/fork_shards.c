@@ -0,0 +1,372 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <vicNl.h>
+
+static char vcid[] = "$Id$";
+
+static int read_active_cells(char                 *soilname,
+                             cell_journal_struct  *cell_journal,
+                             int                 **gridcel)
+/* Find the cells in the soil parameter file whose run flag is set and
+   that are not listed in cell_journal, the same way read_soilparam()
+   decides whether to run a cell, and return their number; their cell
+   numbers are stored in *gridcel. */
+{
+  FILE *soilparam;
+  char  line[MAXSTRING];
+  int   flag;
+  int   Ncells;
+  int   Nalloc;
+
+  soilparam = open_file(soilname, "r");
+  *gridcel = NULL;
+  Ncells = Nalloc = 0;
+  while ( fscanf(soilparam, "%d", &flag) != EOF ) {
+    if ( fgets(line, MAXSTRING, soilparam) == NULL ) break;
+    if ( !flag ) continue;
+    if ( Ncells == Nalloc ) {
+      Nalloc = Nalloc ? 2*Nalloc : 1024;
+      *gridcel = (int *)realloc(*gridcel, Nalloc*sizeof(int));
+      if ( *gridcel == NULL )
+        nrerror("Memory allocation error in fork_shards().");
+    }
+    if ( sscanf(line, "%d", &(*gridcel)[Ncells]) != 1 )
+      (*gridcel)[Ncells] = MISSING;
+    else if ( cell_journal_done(cell_journal, (*gridcel)[Ncells]) )
+      continue;
+    Ncells++;
+  }
+  fclose(soilparam);
+
+  return Ncells;
+
+}
+
+static void close_parameter_files(filep_struct *filep)
+/* Close the parameter and packed forcing files opened by check_files(),
+   as at the end of the main program; used by the children to drop the
+   handles they inherited before opening their own. */
+{
+  extern THREAD_LOCAL option_struct options;
+
+  fclose(filep->soilparam);
+  if ( filep->forcing_pack[0] != NULL )
+    close_forcing_pack(&filep->forcing_pack[0]);
+  if ( filep->forcing_pack[1] != NULL )
+    close_forcing_pack(&filep->forcing_pack[1]);
+  if ( !options.OUTPUT_FORCE ) {
+    fclose(filep->veglib);
+    fclose(filep->vegparam);
+    if ( options.SNOW_BAND > 1 )
+      fclose(filep->snowband);
+    if ( options.LAKES )
+      fclose(filep->lakeparam);
+  }
+
+}
+
+static void split_cells(int               Nprocs,
+                        int               Ncells,
+                        int              *gridcel,
+                        filenames_struct *filenames,
+                        int              *bounds)
+/* Set bounds[0..Nprocs] so that shard k runs cells bounds[k] to
+   bounds[k+1]-1.  With CELL_SCHEDULE = LONGEST_FIRST and a cell timing
+   log from a previous run, the shards are balanced by logged run time
+   (cells missing from the log count as the mean logged time);
+   otherwise each shard gets the same number of cells. */
+{
+  extern THREAD_LOCAL option_struct options;
+
+  cell_timing_struct *timing;
+  double             *cost;
+  double              total;
+  double              mean;
+  double              sum;
+  int                 Ntiming;
+  int                 Nlogged;
+  int                 i;
+  int                 k;
+
+  for ( k = 0; k <= Nprocs; k++ )
+    bounds[k] = (int)((long)k * Ncells / Nprocs);
+
+  if ( options.CELL_SCHEDULE != SCHED_LONGEST_FIRST
+       || strcmp(filenames->cell_timing, "MISSING") == 0 )
+    return;
+  if ( (Ntiming = read_cell_timing(filenames->cell_timing, &timing)) == 0 )
+    return;
+
+  cost = (double *)calloc(Ncells, sizeof(double));
+  if ( cost == NULL )
+    nrerror("Memory allocation error in fork_shards().");
+  total = 0;
+  Nlogged = 0;
+  for ( i = 0; i < Ncells; i++ ) {
+    cost[i] = lookup_cell_timing(gridcel[i], timing, Ntiming);
+    if ( cost[i] >= 0 ) {
+      total += cost[i];
+      Nlogged++;
+    }
+  }
+  mean = (Nlogged > 0) ? total / Nlogged : 1;
+  total = 0;
+  for ( i = 0; i < Ncells; i++ ) {
+    if ( cost[i] < 0 ) cost[i] = mean;
+    total += cost[i];
+  }
+
+  /* each shard ends where the cumulative cost first reaches its share,
+     keeping at least one cell per shard */
+  sum = 0;
+  i = 0;
+  for ( k = 1; k < Nprocs; k++ ) {
+    while ( i < Ncells - (Nprocs - k) && (i < bounds[k-1] + 1 || sum + 0.5*cost[i] < k * total / Nprocs) )
+      sum += cost[i++];
+    bounds[k] = i;
+  }
+
+  free((char *)cost);
+  free((char *)timing);
+
+}
+
+static void shard_file_name(char *shardname,
+                            char *filename,
+                            int   shard)
+{
+  sprintf(shardname, "%s.shard%d", filename, shard);
+}
+
+static void merge_shard_timings(int               Nprocs,
+                                filenames_struct *filenames)
+/* Concatenate the shard cell timing logs, in shard order, and remove
+   them. */
+{
+  FILE *log;
+  FILE *shardfile;
+  char  shardname[MAXSTRING];
+  char  line[MAXSTRING];
+  int   shard;
+
+  log = open_cell_timing(filenames->cell_timing_out);
+  for ( shard = 0; shard < Nprocs; shard++ ) {
+    shard_file_name(shardname, filenames->cell_timing_out, shard);
+    if ( (shardfile = fopen(shardname, "r")) == NULL ) continue;
+    while ( fgets(line, MAXSTRING, shardfile) != NULL )
+      if ( line[0] != '#' ) fputs(line, log);
+    fclose(shardfile);
+    remove(shardname);
+  }
+  fclose(log);
+
+}
+
+static int skip_line(FILE   *file,
+                     char   *buf,
+                     size_t  size)
+/* Read past the next line of file, in pieces of up to size-1
+   characters; return FALSE if the file ends before the line does. */
+{
+  do {
+    if ( fgets(buf, (int)size, file) == NULL )
+      return FALSE;
+  } while ( buf[strlen(buf)-1] != '\n' );
+
+  return TRUE;
+
+}
+
+static void merge_shard_states(int               Nprocs,
+                               filenames_struct *filenames)
+/* Concatenate the cell records of the shard state files, in shard order,
+   behind a single state file header, and remove the shard files.  The
+   indexes of binary shard files are not copied; the merged file gets
+   an index of its own. */
+{
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL global_param_struct global_param;
+
+  FILE            *statefile;
+  FILE            *shardfile;
+  filenames_struct shardnames;
+  state_index_struct *index;
+  char             ErrStr[MAXSTRING];
+  char             buf[BUFSIZ];
+  size_t           n;
+  long long        header;
+  long long        remaining;
+  int              shard;
+
+  statefile = open_state_file(&global_param, *filenames, options.Nlayer,
+                              options.Nnode);
+  /* the shard files have the same header as the merged file */
+  header = ftello(statefile);
+
+  shardnames = *filenames;
+  for ( shard = 0; shard < Nprocs; shard++ ) {
+    shard_file_name(shardnames.statefile, filenames->statefile, shard);
+    remaining = -1;
+    if ( options.BINARY_STATE_FILE ) {
+      shardfile = open_file(shardnames.statefile, "rb");
+      /* skip the header: state date (or snapshot dates), Nlayer, and
+         Nnode */
+      fseeko(shardfile, (off_t)header, SEEK_SET);
+      /* copy the cell records only, not the index behind them */
+      if ( (index = read_state_index(shardfile)) != NULL ) {
+        remaining = state_index_start(index) - header;
+        free_state_index(&index);
+      }
+    }
+    else {
+      shardfile = open_file(shardnames.statefile, "r");
+      /* skip the header: state date line and Nlayer/Nnode line */
+      if ( !skip_line(shardfile, buf, sizeof(buf))
+           || !skip_line(shardfile, buf, sizeof(buf)) ) {
+        snprintf(ErrStr, sizeof(ErrStr),
+                 "Unable to read the header of state file shard %.1000s.",
+                 shardnames.statefile);
+        nrerror(ErrStr);
+      }
+    }
+    while ( remaining != 0
+            && (n = fread(buf, 1, (remaining < 0 || remaining > sizeof(buf))
+                                  ? sizeof(buf) : (size_t)remaining,
+                          shardfile)) > 0 ) {
+      fwrite(buf, 1, n, statefile);
+      if ( remaining > 0 ) remaining -= n;
+    }
+    fclose(shardfile);
+    remove(shardnames.statefile);
+  }
+
+  if ( options.BINARY_STATE_FILE )
+    write_state_index(statefile, filenames->statefile);
+  fclose(statefile);
+
+}
+
+int fork_shards(int               Nprocs,
+                filep_struct     *filep,
+                filenames_struct *filenames,
+                int              *first_cell,
+                int              *last_cell)
+/**********************************************************************
+  fork_shards					October 2026
+
+  Splits the active cells of the soil parameter file into Nprocs
+  contiguous shards and forks one child process per shard.  With
+  CELL_SCHEDULE = LONGEST_FIRST and a CELL_TIMING_LOG from a previous
+  run, the shards are balanced by logged run time; otherwise they hold
+  equal numbers of cells.  Must be
+  called after the global parameter file and veg library have been
+  read, and before the initial state file or state file are opened.
+
+  In each child, the parameter files inherited from the parent are
+  closed and re-opened (so that no file offsets are shared with the
+  other processes), the name of the state
+  file (and of the cell timing log, if any) is changed to
+  <name>.shard<k>, and [first_cell, last_cell)
+  is set to the range of active cell indices (as counted by cellnum in
+  the main program) that the child should run.  The child returns
+  FALSE and carries on with the normal grid cell loop, skipping cells
+  outside its range.
+
+  The parent waits for all children to finish, then (if SAVE_STATE is
+  set) merges the shard state files into the state file, and likewise
+  the shard timing logs.  Since the
+  shards are contiguous and each shard file holds its cells in file
+  order, concatenating them reproduces the state file of a single
+  process run.  The parent returns TRUE and should exit without
+  running any cells.
+
+  If a cell's model state cannot be initialized (with CONTINUEONERROR
+  TRUE), only the remaining cells of that cell's shard are skipped.
+
+  With CELL_JOURNAL, the cells that an interrupted run has finished are
+  left out of the shards, and the children append the cells they
+  finish to the same journal.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+
+  char   ErrStr[MAXSTRING];
+  char   filename[MAXSTRING];
+  int   *gridcel;
+  int   *bounds;
+  int    Ncells;
+  int    shard;
+  int    status;
+  int    Nfailed;
+  pid_t *pids;
+
+  Ncells = read_active_cells(filenames->soil, filep->cell_journal, &gridcel);
+  if ( Nprocs > Ncells ) Nprocs = Ncells;
+  if ( Nprocs < 1 ) Nprocs = 1;
+
+  pids = (pid_t *)calloc(Nprocs, sizeof(pid_t));
+  bounds = (int *)calloc(Nprocs + 1, sizeof(int));
+  if ( pids == NULL || bounds == NULL )
+    nrerror("Memory allocation error in fork_shards().");
+  split_cells(Nprocs, Ncells, gridcel, filenames, bounds);
+  free((char *)gridcel);
+
+  /* don't let the children inherit unwritten output */
+  fflush(NULL);
+
+  for ( shard = 0; shard < Nprocs; shard++ ) {
+    pids[shard] = fork();
+    if ( pids[shard] < 0 ) {
+      sprintf(ErrStr, "Unable to start process %d of %d.", shard+1, Nprocs);
+      nrerror(ErrStr);
+    }
+    if ( pids[shard] == 0 ) {
+      /** Child: run one shard of the cells **/
+      close_parameter_files(filep);
+      check_files(filep, filenames);
+      if ( strcmp(filenames->statefile, "NONE") != 0 ) {
+        strcpy(filename, filenames->statefile);
+        shard_file_name(filenames->statefile, filename, shard);
+      }
+      if ( strcmp(filenames->cell_timing_out, "MISSING") != 0 ) {
+        strcpy(filename, filenames->cell_timing_out);
+        shard_file_name(filenames->cell_timing_out, filename, shard);
+      }
+      *first_cell = bounds[shard];
+      *last_cell  = bounds[shard+1];
+      free((char *)pids);
+      free((char *)bounds);
+      return FALSE;
+    }
+  }
+
+  /** Parent: wait for all shards **/
+  Nfailed = 0;
+  for ( shard = 0; shard < Nprocs; shard++ ) {
+    if ( waitpid(pids[shard], &status, 0) < 0
+         || !WIFEXITED(status) || WEXITSTATUS(status) != 0 ) {
+      fprintf(stderr, "ERROR: process %d of %d (cells %d to %d) did not finish.\n",
+              shard+1, Nprocs, bounds[shard], bounds[shard+1] - 1);
+      Nfailed++;
+    }
+  }
+  free((char *)pids);
+  free((char *)bounds);
+  if ( Nfailed > 0 ) {
+    sprintf(ErrStr, "%d of %d processes failed; the state file (if any) has not been assembled from its shards.", Nfailed, Nprocs);
+    nrerror(ErrStr);
+  }
+
+  if ( !options.OUTPUT_FORCE && options.SAVE_STATE
+       && strcmp(filenames->statefile, "NONE") != 0 )
+    merge_shard_states(Nprocs, filenames);
+  if ( strcmp(filenames->cell_timing_out, "MISSING") != 0 )
+    merge_shard_timings(Nprocs, filenames);
+
+  return TRUE;
+
+}
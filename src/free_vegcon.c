@@ -16,7 +16,7 @@ void free_vegcon(veg_con_struct **veg_con)
 **********************************************************************/
 {
  
-  extern option_struct   options;
+  extern THREAD_LOCAL option_struct   options;
   int i;
   
   for(i=0;i<veg_con[0][0].vegetat_type_num;i++) { 
@@ -1,13 +1,32 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <strings.h>
+#include <pthread.h>
 #include <vicNl.h>
 #include <stdarg.h>
 
 #define MAXIT 1000
+#define MAXIT_NEWTON 50	/* maximum Newton iterations in solve_T_profile_newton() */
+#define MAX_HALVINGS 10	/* maximum halvings of a Newton step */
+#define JAC_STEP 1e-4	/* relative step of the forward differences of fdjac3() */
+#define JAC_CHECK_TOL 1e-3	/* largest difference (C) between the profiles
+				   solved with the two Jacobians that
+				   IMPLICIT_JACOBIAN CHECK accepts */
 
 static char vcid[] = "$Id$";
 
+/* comparison of the implicit solutions with the finite-difference and
+   analytic Jacobians (IMPLICIT_JACOBIAN CHECK), for all threads of this
+   process */
+static long            jac_check_solves;   /* profiles solved both ways */
+static long            jac_check_both;     /* ... converged both ways */
+static long            jac_check_fd_only;  /* ... only with forward differences */
+static long            jac_check_an_only;  /* ... only with the analytic Jacobian */
+static long            jac_check_over;     /* converged both ways, but differ
+					      by more than JAC_CHECK_TOL */
+static double          jac_check_max;      /* largest difference, C */
+static pthread_mutex_t jac_check_lock = PTHREAD_MUTEX_INITIALIZER;
+
 int calc_layer_average_thermal_props(energy_bal_struct *energy,
 				     layer_data_struct *layer,
 				     soil_con_struct   *soil_con,
@@ -57,7 +76,7 @@ int calc_layer_average_thermal_props(energy_bal_struct *energy,
   2014-Mar-28 Removed DIST_PRCP option.					TJB
 ******************************************************************/
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   int     i, ErrorFlag;
 
   if (options.FROZEN_SOIL && soil_con->FS_ACTIVE)
@@ -150,12 +169,12 @@ int  solve_T_profile(double *T,
   2013-Dec-27 Removed QUICK_FS option.					TJB
 **********************************************************************/
 
-  extern option_struct options;
-  static double A[MAX_NODES];
-  static double B[MAX_NODES];
-  static double C[MAX_NODES];
-  static double D[MAX_NODES];
-  static double E[MAX_NODES];
+  extern THREAD_LOCAL option_struct options;
+  static THREAD_LOCAL double A[MAX_NODES];
+  static THREAD_LOCAL double B[MAX_NODES];
+  static THREAD_LOCAL double C[MAX_NODES];
+  static THREAD_LOCAL double D[MAX_NODES];
+  static THREAD_LOCAL double E[MAX_NODES];
 
   double *aa, *bb, *cc, *dd, *ee, Bexp;
 
@@ -289,11 +308,20 @@ int solve_T_profile_implicit(double *T,                           // update
   2012-Jan-16 Removed LINK_DEBUG code					BN
   2013-Dec-26 Removed EXCESS_ICE option.				TJB
   2014-Jan-14 Modified cold nose hack to also cover warm nose case.
+  2026-Oct-18 newt_raph() now uses the analytic Jacobian supplied by
+	      fda_heat_eqn().
+  2026-Oct-18 The Jacobian is selected by IMPLICIT_JACOBIAN; the
+	      default (FD) is the forward-difference Jacobian of
+	      fdjac3(), as before.  With CHECK, the profile is also
+	      solved with the analytic Jacobian, from the same start, and
+	      the two solutions are compared (see print_jacobian_check()).
   **********************************************************************/
   
-  extern option_struct options;
-  int  n, Error;
+  extern THREAD_LOCAL option_struct options;
+  int  n, Error, Error_check;
   double res[MAX_NODES];
+  double T_check[MAX_NODES];
+  double diff, maxdiff;
   void (*vecfunc)(double *, double *, int, int, ...);
   int j;
 
@@ -313,7 +341,36 @@ int solve_T_profile_implicit(double *T,                           // update
   
   // modified Newton-Raphson to solve for new T
   vecfunc = &(fda_heat_eqn);
-  Error = newt_raph(vecfunc, &T[1], n);
+  if (options.IMPLICIT_JACOBIAN == IJ_CHECK) {
+    // solve with the analytic Jacobian from the same start, for
+    // comparison only; the forward-difference solution below is used
+    for (j=0; j<n; j++)
+      T_check[j] = T[j+1];
+    Error_check = newt_raph(vecfunc, T_check, n, TRUE);
+  }
+  Error = newt_raph(vecfunc, &T[1], n,
+		    options.IMPLICIT_JACOBIAN == IJ_ANALYTIC);
+
+  if (options.IMPLICIT_JACOBIAN == IJ_CHECK) {
+    maxdiff = 0;
+    if (Error == 0 && Error_check == 0)
+      for (j=0; j<n; j++) {
+	diff = fabs(T_check[j] - T[j+1]);
+	if (diff > maxdiff) maxdiff = diff;
+      }
+    pthread_mutex_lock(&jac_check_lock);
+    jac_check_solves++;
+    if (Error == 0 && Error_check == 0) {
+      jac_check_both++;
+      if (maxdiff > JAC_CHECK_TOL) jac_check_over++;
+      if (maxdiff > jac_check_max) jac_check_max = maxdiff;
+    }
+    else if (Error == 0)
+      jac_check_fd_only++;
+    else if (Error_check == 0)
+      jac_check_an_only++;
+    pthread_mutex_unlock(&jac_check_lock);
+  }
  
   // update temperature boundaries
   if(Error == 0 ){
@@ -344,6 +401,31 @@ int solve_T_profile_implicit(double *T,                           // update
 
 }
 
+void print_jacobian_check()
+/**********************************************************************
+  print_jacobian_check				October 2026
+
+  Prints the comparison, by solve_T_profile_implicit() with
+  IMPLICIT_JACOBIAN CHECK, of the soil temperature profiles solved with
+  the forward-difference and the analytic Jacobian.  Each process of an
+  NPROCS run prints its own.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+
+  if (options.IMPLICIT_JACOBIAN != IJ_CHECK) return;
+
+  pthread_mutex_lock(&jac_check_lock);
+  fprintf(stderr, "\nImplicit Jacobian check: %ld soil temperature profiles solved with both Jacobians\n",
+	  jac_check_solves);
+  fprintf(stderr, "  converged with both: %ld; only with forward differences: %ld; only analytic: %ld\n",
+	  jac_check_both, jac_check_fd_only, jac_check_an_only);
+  fprintf(stderr, "  largest difference: %.6f C; profiles differing by more than %g C: %ld\n",
+	  jac_check_max, JAC_CHECK_TOL, jac_check_over);
+  pthread_mutex_unlock(&jac_check_lock);
+
+}
+
  
 
 int calc_soil_thermal_fluxes(int     Nnodes,
@@ -394,16 +476,26 @@ int calc_soil_thermal_fluxes(int     Nnodes,
   2013-Dec-27 Moved SPATIAL_FROST to options_struct.			TJB
   2013-Dec-27 Removed QUICK_FS option.					TJB
   2014-Mar-28 Modified cold nose hack to also cover warm nose case.	TJB
+  2026-Oct-18 Added EXPLICIT_SOLVER option: with EXPLICIT_SOLVER NEWTON,
+	      the profile is first solved by solve_T_profile_newton(), and
+	      only solved by sweeps if that fails.  The iterations are
+	      counted in soil_T_iter.
+  2026-Oct-18 Each solution is recorded in the solver telemetry
+	      (SOLVER_TELEMETRY), with its iterations and fallbacks.
   **********************************************************************/
 
   /** Eventually the nodal ice contents will also have to be updated **/
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL soil_T_iter_struct soil_T_iter;
 
   int    Error;
   char   Done;
   int    j;
   int    ItCount;
+  int    Niter;
+  int    Nfallback;
+  double start;
   double threshold = 1.e-2;	/* temperature profile iteration threshold */
   double maxdiff;
   double diff;
@@ -425,6 +517,27 @@ int calc_soil_thermal_fluxes(int     Nnodes,
     Tfbcount[j] = 0;
   }
 
+  start = solver_call_start();
+  Niter = 0;
+  Nfallback = 0;
+  soil_T_iter.Nsolutions++;
+  if (options.EXPLICIT_SOLVER == ES_NEWTON) {
+    /* solve the whole profile by Newton iteration; if it does not
+       converge, start again from Tlast with node-by-node sweeps */
+    Done = solve_T_profile_newton(Nnodes, T, T0, moist, max_moist, ice,
+				  bubble, expt, A, B, C, D, E, FS_ACTIVE,
+				  NOFLUX, EXP_TRANS, threshold, &ItCount);
+    soil_T_iter.Niter += ItCount;
+    Niter = ItCount;
+    if (!Done) {
+      for(j=0;j<Nnodes;j++)
+	T[j] = Tlast[j];
+      soil_T_iter.Nfallback++;
+      Nfallback++;
+    }
+    ItCount = 0;
+  }
+
   while(!Done && Error==0 && ItCount<MAXIT) {
     ItCount++;
     maxdiff=threshold;
@@ -512,6 +625,12 @@ int calc_soil_thermal_fluxes(int     Nnodes,
     if(maxdiff <= threshold) Done=TRUE;
     
   }
+  if (options.EXPLICIT_SOLVER == ES_NEWTON)
+    soil_T_iter.Nsweeps += ItCount;
+  else
+    soil_T_iter.Niter += ItCount;
+  if (!Done) Nfallback++; /* sweeps stopped at MAXIT */
+  solver_call_end(ST_SOIL_T, start, Niter + ItCount, 0, Nfallback);
   
   if (options.TFALLBACK) {
     // HACK to prevent runaway cold nose
@@ -553,6 +672,285 @@ int calc_soil_thermal_fluxes(int     Nnodes,
 
 }
 
+static double soil_thermal_residual(int     Nnodes,
+				    double *T,
+				    double *T0,
+				    double *moist,
+				    double *max_moist,
+				    double *ice,
+				    double *bubble,
+				    double *expt,
+				    double *A,
+				    double *B,
+				    double *C,
+				    double *D,
+				    double *E,
+				    int     FS_ACTIVE,
+				    int     NOFLUX,
+				    int     EXP_TRANS,
+				    double *scale,
+				    double *res,
+				    double *a,
+				    double *b,
+				    double *c,
+				    int    *Nfrozen)
+/**********************************************************************
+  Computes the residuals res of the explicit soil heat equation at the
+  nodes 1 to Nnodes-2 (Nnodes-1 if NOFLUX) for the temperatures T, in
+  the form used by soil_thermal_eqn(), and the sub-diagonal (a),
+  diagonal (b) and super-diagonal (c) of their Jacobian; entry k is the
+  equation of node k+1.  Each equation is multiplied by scale[k], the
+  inverse of the magnitude of its diagonal without the phase term (set
+  by soil_thermal_scale()), so that its residual is in C.  Nfrozen
+  returns the number of nodes whose equation includes the ice content
+  (the others are linear in T).  Returns the sum of the squared
+  residuals.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+
+  int    j;
+  int    k;
+  int    n;
+  double TL;
+  double TU;
+  double ice_new;
+  double dice;
+  double unfrozen;
+  double exponent;
+  double dTL;
+  double dTU;
+  double flux_term1;
+  double flux_term2;
+  double norm;
+
+  n = NOFLUX ? Nnodes-1 : Nnodes-2;
+  norm = 0;
+  *Nfrozen = 0;
+  for (k = 0; k < n; k++) {
+    j = k+1;
+    TU = T[j-1];
+    TL = (j < Nnodes-1) ? T[j+1] : T[j];
+
+    /* ice content, as in soil_thermal_eqn(), and its derivative (see
+       maximum_unfrozen_water() and maximum_unfrozen_water_deriv()) */
+    ice_new = 0;
+    dice = 0;
+    if (T[j] < 0 && FS_ACTIVE && options.FROZEN_SOIL) {
+      (*Nfrozen)++;
+      exponent = -(2.0 / (expt[j] - 3.0));
+      unfrozen = max_moist[j] * pow((-Lf * T[j]) / 273.16 / (9.81 * bubble[j] / 100.), exponent);
+      if (unfrozen > max_moist[j]) unfrozen = max_moist[j];
+      else if (unfrozen < 0.) unfrozen = 0.;
+      else dice = -exponent * unfrozen / T[j];
+      ice_new = moist[j] - unfrozen;
+      if (ice_new < 0) { ice_new = 0; dice = 0; }
+      else if (ice_new > max_moist[j]) { ice_new = max_moist[j]; dice = 0; }
+    }
+
+    flux_term1 = B[j]*(TL-TU);
+    if (!EXP_TRANS) {
+      flux_term2 = C[j]*(TL-T[j]) - D[j]*(T[j]-TU);
+      b[k] = -A[j] - C[j] - D[j] + E[j]*dice;
+      dTL = B[j] + C[j];
+      dTU = -B[j] + D[j];
+    }
+    else {
+      flux_term2 = C[j]*(TL-2.*T[j]+TU) - D[j]*(TL-TU);
+      b[k] = -A[j] - 2.*C[j] + E[j]*dice;
+      dTL = B[j] + C[j] - D[j];
+      dTU = -B[j] + C[j] + D[j];
+    }
+
+    /* "cold nose" fix of soil_thermal_eqn(), where T[j] is frozen */
+    if (j == 1 && T[j] < 0 && FS_ACTIVE && options.FROZEN_SOIL
+        && fabs(TL-TU) > 5. && T[j] < TL && T[j] < TU
+        && flux_term1 < 0 && flux_term2 > 0 && fabs(flux_term1) > fabs(flux_term2)) {
+      flux_term1 = 0;
+      dTL -= B[j];
+      dTU += B[j];
+    }
+
+    res[k] = -A[j]*(T[j]-T0[j]) + flux_term1 + flux_term2 + E[j]*(ice_new-ice[j]);
+    a[k] = dTU;
+    if (j < Nnodes-1) c[k] = dTL;
+    else {
+      /* no flux bottom boundary: TL is T[j] itself */
+      b[k] += dTL;
+      c[k] = 0;
+    }
+
+    res[k] *= scale[k];
+    a[k] *= scale[k];
+    b[k] *= scale[k];
+    c[k] *= scale[k];
+    norm += res[k]*res[k];
+  }
+
+  return (norm);
+
+}
+
+static void soil_thermal_scale(int     Nnodes,
+			       double *A,
+			       double *B,
+			       double *C,
+			       double *D,
+			       int     NOFLUX,
+			       int     EXP_TRANS,
+			       double *scale)
+/**********************************************************************
+  Computes the scale factors of the equations of
+  soil_thermal_residual(): the inverse of the magnitude of the diagonal
+  of each equation, without the phase term.
+**********************************************************************/
+{
+  int    j;
+  int    k;
+  int    n;
+  double diag;
+
+  n = NOFLUX ? Nnodes-1 : Nnodes-2;
+  for (k = 0; k < n; k++) {
+    j = k+1;
+    if (!EXP_TRANS) {
+      diag = -A[j] - C[j] - D[j];
+      if (j == Nnodes-1) diag += B[j] + C[j];
+    }
+    else {
+      diag = -A[j] - 2.*C[j];
+      if (j == Nnodes-1) diag += B[j] + C[j] - D[j];
+    }
+    scale[k] = (diag != 0) ? 1. / fabs(diag) : 1.;
+  }
+
+}
+
+int solve_T_profile_newton(int     Nnodes,
+			   double *T,
+			   double *T0,
+			   double *moist,
+			   double *max_moist,
+			   double *ice,
+			   double *bubble,
+			   double *expt,
+			   double *A,
+			   double *B,
+			   double *C,
+			   double *D,
+			   double *E,
+			   int     FS_ACTIVE,
+			   int     NOFLUX,
+			   int     EXP_TRANS,
+			   double  threshold,
+			   int    *ItCount)
+/**********************************************************************
+  solve_T_profile_newton			October 2026
+
+  Solves the explicit soil heat equation (the equations that
+  calc_soil_thermal_fluxes() solves node by node) for the whole
+  temperature profile at once, by Newton iteration on the tridiagonal
+  system of the nodal equations.  Each step is damped by halving it
+  until it reduces the sum of the squared residuals.
+
+  The iteration has converged when no residual, expressed in C (see
+  soil_thermal_residual()), exceeds threshold/10.  The size of the
+  steps is no measure of convergence here: just below 0 C the phase
+  term makes the equations so steep that the steps are tiny while the
+  residuals are not.  Where no node is frozen, before or after a step,
+  the equations are linear, and the step is exact.
+
+  On entry T holds the initial guess (T[0], and T[Nnodes-1] unless
+  NOFLUX, are the boundary temperatures); on return it holds the
+  solution.  Returns TRUE if the iteration converged, otherwise FALSE,
+  in which case T holds the last iterate.  ItCount returns the number
+  of Newton iterations.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+
+  int    j;
+  int    k;
+  int    n;
+  int    halvings;
+  int    Nfrozen;
+  char   linear;
+  double lambda;
+  double norm;
+  double norm_new;
+  double maxres;
+  double step[MAX_NODES];
+  double T_new[MAX_NODES];
+  double scale[MAX_NODES];
+  double work[2][4][MAX_NODES];
+  double *res, *a, *b, *c;
+  double *res_new, *a_new, *b_new, *c_new;
+  double *swap;
+
+  /* residuals and Jacobian of the current and of the trial iterate */
+  res = work[0][0]; a = work[0][1]; b = work[0][2]; c = work[0][3];
+  res_new = work[1][0]; a_new = work[1][1]; b_new = work[1][2]; c_new = work[1][3];
+
+  n = NOFLUX ? Nnodes-1 : Nnodes-2;
+  *ItCount = 0;
+  if (n < 1) return (TRUE);
+
+  for (j = 0; j < Nnodes; j++)
+    T_new[j] = T[j];
+  soil_thermal_scale(Nnodes, A, B, C, D, NOFLUX, EXP_TRANS, scale);
+  norm = soil_thermal_residual(Nnodes, T, T0, moist, max_moist, ice, bubble,
+			       expt, A, B, C, D, E, FS_ACTIVE, NOFLUX, EXP_TRANS,
+			       scale, res, a, b, c, &Nfrozen);
+
+  while (TRUE) {
+    maxres = 0;
+    for (k = 0; k < n; k++)
+      if (fabs(res[k]) > maxres) maxres = fabs(res[k]);
+    if (maxres <= 0.1*threshold) return (TRUE);
+    if (*ItCount >= MAXIT_NEWTON) return (FALSE);
+    (*ItCount)++;
+
+    /* Newton step: solve J*step = -res */
+    for (k = 0; k < n; k++)
+      step[k] = -res[k];
+    tridiag(a, b, c, step, n);
+    linear = (Nfrozen == 0);
+    for (k = 0; k < n; k++) {
+      if (!isfinite(step[k])) return (FALSE);
+      if (T[k+1] + step[k] < 0 && FS_ACTIVE && options.FROZEN_SOIL) linear = FALSE;
+    }
+    if (linear) {
+      for (k = 0; k < n; k++)
+	T[k+1] += step[k];
+      return (TRUE);
+    }
+
+    /* halve the step until it reduces the residuals */
+    lambda = 1;
+    for (halvings = 0; halvings <= MAX_HALVINGS; halvings++) {
+      for (k = 0; k < n; k++)
+	T_new[k+1] = T[k+1] + lambda*step[k];
+      norm_new = soil_thermal_residual(Nnodes, T_new, T0, moist, max_moist,
+				       ice, bubble, expt, A, B, C, D, E,
+				       FS_ACTIVE, NOFLUX, EXP_TRANS,
+				       scale, res_new, a_new, b_new, c_new,
+				       &Nfrozen);
+      if (norm_new < (1. - 1.e-4*lambda) * norm) break;
+      lambda *= 0.5;
+    }
+    if (halvings > MAX_HALVINGS) return (FALSE);
+
+    for (k = 0; k < n; k++)
+      T[k+1] = T_new[k+1];
+    swap = res; res = res_new; res_new = swap;
+    swap = a; a = a_new; a_new = swap;
+    swap = b; b = b_new; b_new = swap;
+    swap = c; c = c_new; c_new = swap;
+    norm = norm_new;
+  }
+
+}
+
 double error_solve_T_profile (double Tj, ...) {
 
   va_list ap;
@@ -657,47 +1055,67 @@ void fda_heat_eqn(double T_2[], double res[], int n, int init, ...)
 	      now all nodes are checked and corrected if necessary.		TJB
   2013-Jan-08 Excluded bottom node from check in cold nose fix.			TJB
   2013-Dec-26 Removed EXCESS_ICE option.				TJB
+  2026-Oct-18 Added init==2, which returns the analytic tridiagonal
+	      Jacobian of the residuals, so that newt_raph() no longer
+	      needs n residual evaluations per trial to approximate it.
+	      The derivatives of the ice content, kappa, and Cs of each
+	      node are computed with the residuals when focus==-1.
+  2026-Oct-18 The derivatives are only computed if IMPLICIT_JACOBIAN is
+	      ANALYTIC or CHECK.  init==2 declines to return the Jacobian
+	      (so that newt_raph() uses forward differences) if the
+	      residual of a frozen node is not differentiable within the
+	      forward-difference step: where its ice would vanish, or
+	      where its kappa and Cs would switch from the stored values
+	      to recomputed ones.
   **********************************************************************/
     
-  static double  deltat;
-  static int     FS_ACTIVE;
-  static int     NOFLUX;
-  static int     EXP_TRANS;
-  static double *T0;
-  static double *moist;
-  static double *ice;
-  static double *kappa;
-  static double *Cs;
-  static double *max_moist;
-  static double *bubble;
-  static double *expt;
-  static double *alpha;
-  static double *beta;
-  static double *gamma;
-  static double *Zsum;
-  static double Dp;
-  static double *bulk_dens_min;
-  static double *soil_dens_min;
-  static double *quartz;
-  static double *bulk_density;
-  static double *soil_density;
-  static double *organic;
-  static double *depth;
-  static int Nlayers;
+  extern THREAD_LOCAL option_struct options;
+
+  static THREAD_LOCAL double  deltat;
+  static THREAD_LOCAL int     FS_ACTIVE;
+  static THREAD_LOCAL int     NOFLUX;
+  static THREAD_LOCAL int     EXP_TRANS;
+  static THREAD_LOCAL double *T0;
+  static THREAD_LOCAL double *moist;
+  static THREAD_LOCAL double *ice;
+  static THREAD_LOCAL double *kappa;
+  static THREAD_LOCAL double *Cs;
+  static THREAD_LOCAL double *max_moist;
+  static THREAD_LOCAL double *bubble;
+  static THREAD_LOCAL double *expt;
+  static THREAD_LOCAL double *alpha;
+  static THREAD_LOCAL double *beta;
+  static THREAD_LOCAL double *gamma;
+  static THREAD_LOCAL double *Zsum;
+  static THREAD_LOCAL double Dp;
+  static THREAD_LOCAL double *bulk_dens_min;
+  static THREAD_LOCAL double *soil_dens_min;
+  static THREAD_LOCAL double *quartz;
+  static THREAD_LOCAL double *bulk_density;
+  static THREAD_LOCAL double *soil_density;
+  static THREAD_LOCAL double *organic;
+  static THREAD_LOCAL double *depth;
+  static THREAD_LOCAL int Nlayers;
   
   // variables used to calculate residual of the heat equation
   // defined here
-  static double Ts;
-  static double Tb;
+  static THREAD_LOCAL double Ts;
+  static THREAD_LOCAL double Tb;
   
   // locally used variables
-  static double ice_new[MAX_NODES], Cs_new[MAX_NODES], kappa_new[MAX_NODES];
-  static double DT[MAX_NODES],DT_down[MAX_NODES],DT_up[MAX_NODES],T_up[MAX_NODES];
-  static double Dkappa[MAX_NODES];
-  static double Bexp;
+  static THREAD_LOCAL double ice_new[MAX_NODES], Cs_new[MAX_NODES], kappa_new[MAX_NODES];
+  static THREAD_LOCAL double DT[MAX_NODES],DT_down[MAX_NODES],DT_up[MAX_NODES],T_up[MAX_NODES];
+  static THREAD_LOCAL double Dkappa[MAX_NODES];
+  static THREAD_LOCAL double Bexp;
+  static THREAD_LOCAL double dice_new[MAX_NODES], dCs_new[MAX_NODES], dkappa_new[MAX_NODES];
+  static THREAD_LOCAL char   kink;
   char PAST_BOTTOM;
   double storage_term, flux_term, phase_term, flux_term1, flux_term2;
   double Lsum;
+  double *a, *b, *c;
+  double F1, Gflux, gu, gd, grid2, grid3;
+  double T_step;
+  int *valid;
   int i, lidx;
   int focus, left, right;
   
@@ -748,6 +1166,67 @@ void fda_heat_eqn(double T_2[], double res[], int n, int init, ...)
     for (i=0; i<n; i++) 
       T_2[i] = T0[i+1];    
   }
+
+  // calculate the Jacobian if init==2; the residuals at T_2 must have
+  // been calculated last (init==0 and focus==-1).  The Jacobian is
+  // returned in the arrays a (sub-diagonal), b (diagonal), and c
+  // (super-diagonal) passed as variable arguments, as in fdjac3();
+  // the int pointed to by the fourth variable argument is set to FALSE
+  // if the Jacobian could not be calculated, and the caller must then
+  // approximate it by finite differences.
+  else if (init==2) {
+    va_start(arg_addr, init);
+    a     = va_arg(arg_addr, double *);
+    b     = va_arg(arg_addr, double *);
+    c     = va_arg(arg_addr, double *);
+    valid = va_arg(arg_addr, int *);
+    *valid = !kink;
+    if (kink) {
+      va_end(arg_addr);
+      return;
+    }
+
+    for (i=0; i<n; i++) {
+      // flux_term1 = F1*Dkappa*DT and flux_term2 = kappa*Gflux, with
+      // Gflux = gd*DT_down - gu*DT_up
+      if(!EXP_TRANS) {
+	F1 = 1./alpha[i]/alpha[i];
+	gu = 1./beta[i]/(0.5*alpha[i]);
+	gd = 1./gamma[i]/(0.5*alpha[i]);
+      }
+      else { //grid transformation
+	grid2 = (Bexp*(Zsum[i+1]+1.))*(Bexp*(Zsum[i+1]+1.));
+	grid3 = Bexp*(Zsum[i+1]+1.)*(Zsum[i+1]+1.);
+	F1 = 1./4./grid2;
+	gu = 1./grid2 + 0.5/grid3;
+	gd = 1./grid2 - 0.5/grid3;
+      }
+      Gflux = gd*DT_down[i] - gu*DT_up[i];
+
+      // derivative with respect to T_2[i]: kappa, ice, and Cs of node i+1
+      b[i] = dkappa_new[i+1]*Gflux - kappa_new[i+1]*(gu+gd)
+	+ ice_density*Lf*dice_new[i+1]/deltat
+	- (dCs_new[i+1]*(2.*T_2[i] - T0[i+1]) + 2.*Cs_new[i+1] - Cs[i+1])/deltat;
+      if(NOFLUX && i==n-1)
+	b[i] += F1*dkappa_new[i+1]*DT[i];
+
+      // derivative with respect to T_2[i-1]: DT, DT_up, and kappa of node i
+      if (i>0)
+	a[i] = -F1*dkappa_new[i]*DT[i] - F1*Dkappa[i] + kappa_new[i+1]*gu;
+      else
+	a[i] = 0.;
+
+      // derivative with respect to T_2[i+1]: DT, DT_down, and kappa of node i+2
+      if (i<n-1)
+	c[i] = F1*dkappa_new[i+2]*DT[i] + F1*Dkappa[i] + kappa_new[i+1]*gd;
+      else
+	c[i] = 0.;
+
+      if (!isfinite(a[i]) || !isfinite(b[i]) || !isfinite(c[i]) || b[i]==0.)
+	*valid = FALSE;
+    }
+    va_end(arg_addr);
+  }
   
   // calculate residuals if init==0
   else {
@@ -761,6 +1240,7 @@ void fda_heat_eqn(double T_2[], double res[], int n, int init, ...)
       lidx = 0;
       Lsum = 0.;
       PAST_BOTTOM = FALSE;
+      kink = FALSE;
 
       for (i=0; i<n+1; i++) {
 	kappa_new[i]=kappa[i];
@@ -774,6 +1254,29 @@ void fda_heat_eqn(double T_2[], double res[], int n, int init, ...)
 	  else ice_new[i] = 0;
 	  Cs_new[i]=Cs[i];
 
+	  // derivatives of ice, kappa, and Cs with respect to T_2[i-1],
+	  // for the Jacobian (Cs is linear in the ice content)
+	  dice_new[i] = dkappa_new[i] = dCs_new[i] = 0;
+	  if (ice_new[i]>0 && options.IMPLICIT_JACOBIAN != IJ_FD) {
+	    // the residual is not differentiable here if the ice vanishes
+	    // within the forward-difference step (ice only decreases with
+	    // T), or if the stored kappa and Cs are still in use
+	    T_step = T_2[i-1] + JAC_STEP*(T_2[i-1]!=0 ? fabs(T_2[i-1]) : 1.);
+	    if (ice_new[i]==ice[i] || T_step>=0
+		|| moist[i] - maximum_unfrozen_water(T_step, max_moist[i], 
+						     bubble[i], expt[i]) <= 0)
+	      kink = TRUE;
+	    dice_new[i] = -maximum_unfrozen_water_deriv(T_2[i-1], 
+							max_moist[i], bubble[i], expt[i]);
+	    if (dice_new[i]!=0) {
+	      dkappa_new[i] = -dice_new[i]*soil_conductivity_deriv(moist[i], moist[i] - ice_new[i],
+					     soil_dens_min[lidx], bulk_dens_min[lidx], quartz[lidx],
+					     soil_density[lidx], bulk_density[lidx], organic[lidx]);
+	      dCs_new[i] = dice_new[i]*(volumetric_heat_capacity(bulk_density[lidx]/soil_density[lidx], moist[i]-ice_new[i]-1., ice_new[i]+1., organic[lidx])
+					- volumetric_heat_capacity(bulk_density[lidx]/soil_density[lidx], moist[i]-ice_new[i], ice_new[i], organic[lidx]));
+	    }
+	  }
+
 	  // update other states due to ice content change
 	  /***********************************************/
 	  if (ice_new[i]!=ice[i]) {
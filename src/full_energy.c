@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <vicNl.h>
 #include <math.h>
 
@@ -113,11 +114,17 @@ int  full_energy(int                  gridcell,
   2014-Mar-28 Removed DIST_PRCP option.						TJB
   2014-Apr-25 Added non-climatological veg params.				TJB
   2014-Apr-25 Added partial vegcover fraction.					TJB
+  2026-Oct-18 aero_resist is now stored on the stack instead of being
+	      allocated on every time step.
+  2026-Oct-18 The calls of solve_lake() are recorded in the solver
+	      telemetry (SOLVER_TELEMETRY).
+  2026-Oct-18 surface_fluxes() and solve_lake() are timed by the phase
+	      profiler (PHASE_PROFILE).
 
 **********************************************************************/
 {
-  extern veg_lib_struct *veg_lib;
-  extern option_struct   options;
+  extern THREAD_LOCAL veg_lib_struct *veg_lib;
+  extern THREAD_LOCAL option_struct   options;
   char                   overstory;
   int                    i, j, p;
   int                    lidx;
@@ -137,12 +144,15 @@ int  full_energy(int                  gridcell,
   double                 surf_atten;
   double                 Tend_surf;
   double                 Tend_grnd;
+  double                 solve_start;
+  double                 phase;
   double                 wind_h;
   double                 height;
   double                 displacement[3];
   double                 roughness[3];
   double                 ref_height[3];
-  double               **aero_resist;
+  double                 aero_resist_data[N_PET_TYPES+1][3];
+  double                *aero_resist[N_PET_TYPES+1];
   double                 Cv;
   double                 Le;
   double                 Melt[2*MAX_BANDS];
@@ -171,10 +181,10 @@ int  full_energy(int                  gridcell,
   energy_bal_struct    **energy;
   snow_data_struct     **snow;
 
-  /* Allocate aero_resist array */
-  aero_resist = (double**)calloc(N_PET_TYPES+1,sizeof(double*));
+  /* Initialize aero_resist array */
+  memset(aero_resist_data, 0, sizeof(aero_resist_data));
   for (p=0; p<N_PET_TYPES+1; p++) {
-    aero_resist[p] = (double*)calloc(3,sizeof(double));
+    aero_resist[p] = aero_resist_data[p];
   }
 
   /* set local pointers */
@@ -417,6 +427,7 @@ int  full_energy(int                  gridcell,
 	  for (p=0; p<N_PET_TYPES; p++)
 	    cell[iveg][band].pot_evap[p] = 0;
 
+	  phase = phase_start();
 	  ErrorFlag = surface_fluxes(overstory, bare_albedo, height, ice0[band], moist0[band], 
 				     surf_atten, &(Melt[band*2]), &Le, 
 				     aero_resist,
@@ -432,6 +443,7 @@ int  full_energy(int                  gridcell,
 				     &(snow[iveg][band]), 
 				     soil_con, &(veg_var[iveg][band]), 
 				     lag_one, sigma_slope, fetch, veg_con[iveg].CanopLayerBnd);
+	  phase_end(PH_SURFACE_FLUXES, phase);
 	  
 	  if ( ErrorFlag == ERROR ) return ( ERROR );
 	  
@@ -468,11 +480,6 @@ int  full_energy(int                  gridcell,
     }
   }
 
-  for (p=0; p<N_PET_TYPES+1; p++) {
-    free((char *)aero_resist[p]);
-  }
-  free((char *)aero_resist);
-
   /****************************
      Run Lake Model           
   ****************************/
@@ -547,6 +554,8 @@ int  full_energy(int                  gridcell,
     atmos->out_rain += rainprec * lake_con->Cl[0] * lakefrac;
     atmos->out_snow += snowprec * lake_con->Cl[0] * lakefrac;
 
+    phase = phase_start();
+    solve_start = solver_call_start();
     ErrorFlag = solve_lake(snowprec, rainprec, atmos->air_temp[NR],
                            atmos->wind[NR], atmos->vp[NR] / 1000.,
                            atmos->shortwave[NR], atmos->longwave[NR],
@@ -554,6 +563,8 @@ int  full_energy(int                  gridcell,
                            atmos->pressure[NR] / 1000.,
                            atmos->density[NR], lake_var, *lake_con,
                            *soil_con, gp->dt, rec, gp->wind_h, dmy[rec], fraci);
+    solver_call_end(ST_SOLVE_LAKE, solve_start, 0, 0, ErrorFlag == ERROR);
+    phase_end(PH_SOLVE_LAKE, phase);
     if ( ErrorFlag == ERROR ) return (ERROR);
 
     /**********************************************************************
@@ -5,14 +5,19 @@
 
 static char vcid[] = "$Id$";
 
-double func_atmos_energy_bal(double Tcanopy, va_list ap) {
+double func_atmos_energy_bal(double Tcanopy, void *args) {
 /**********************************************************************
   func_atmos_energy_bal.c      Keith Cherkauer        February 6, 2001
 
   This routine solves the atmospheric exchange energy balance.
 
+  Modifications:
+  2026-Oct-18 Inputs are now passed in an atmos_energy_bal_args_struct
+	      instead of a va_list.
 **********************************************************************/
 
+  atmos_energy_bal_args_struct *in = (atmos_energy_bal_args_struct *)args;
+
   double  LatentHeat;
   double  NetRadiation;
   double  Ra;
@@ -25,15 +30,15 @@ double func_atmos_energy_bal(double Tcanopy, va_list ap) {
   // internal routine variables
   double  Error;
 
-  // extract variables from va_arg
-  LatentHeat    = (double)  va_arg(ap, double);
-  NetRadiation  = (double)  va_arg(ap, double);
-  Ra            = (double)  va_arg(ap, double);
-  Tair          = (double)  va_arg(ap, double);
-  atmos_density = (double)  va_arg(ap, double);
-  InSensible    = (double)  va_arg(ap, double);
+  // extract variables from the argument structure
+  LatentHeat    = in->LatentHeat;
+  NetRadiation  = in->NetRadiation;
+  Ra            = in->Ra;
+  Tair          = in->Tair;
+  atmos_density = in->atmos_density;
+  InSensible    = in->InSensible;
 
-  SensibleHeat  = (double *)va_arg(ap, double *);
+  SensibleHeat  = in->SensibleHeat;
 
   // compute sensible heat flux between canopy and atmosphere
   (*SensibleHeat) = atmos_density * Cp * (Tair - Tcanopy) / Ra;
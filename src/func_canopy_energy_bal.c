@@ -1,11 +1,10 @@
-#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <vicNl.h>
 
 static char vcid[] = "$Id$";
 
-double func_canopy_energy_bal(double Tfoliage, va_list ap)
+double func_canopy_energy_bal(double Tfoliage, void *args)
 /*********************************************************************
   func_canopy_energy_bal    Keith Cherkauer         January 27, 2001
 
@@ -25,10 +24,14 @@ double func_canopy_energy_bal(double Tfoliage, va_list ap)
   2013-Jul-25 Added photosynthesis terms.				TJB
   2013-Dec-27 Moved SPATIAL_FROST to options_struct.			TJB
   2014-Mar-28 Removed DIST_PRCP option.					TJB
+  2026-Oct-18 Inputs are now passed in a canopy_energy_bal_args_struct
+	      instead of a va_list.
  ********************************************************************/
 {
 
-  extern option_struct   options;
+  extern THREAD_LOCAL option_struct   options;
+
+  canopy_energy_bal_args_struct *in = (canopy_energy_bal_args_struct *)args;
 
   /* General Model Parameters */
   int     band;
@@ -105,74 +108,74 @@ double func_canopy_energy_bal(double Tfoliage, va_list ap)
   double  Tmp;
   double  prec;
 
-  /** Read variables from variable length argument list **/
+  /** Read variables from the argument structure **/
 
   /* General Model Parameters */
-  band    = (int) va_arg(ap, int);
-  month   = (int) va_arg(ap, int);
-  rec     = (int) va_arg(ap, int);
+  band    = in->band;
+  month   = in->month;
+  rec     = in->rec;
 
-  delta_t   = (double) va_arg(ap, double);
-  elevation = (double) va_arg(ap, double);
+  delta_t   = in->delta_t;
+  elevation = in->elevation;
 
-  Wmax        = (double *) va_arg(ap, double *);
-  Wcr         = (double *) va_arg(ap, double *);
-  Wpwp        = (double *) va_arg(ap, double *);
-  depth       = (double *) va_arg(ap, double *);
-  frost_fract = (double *) va_arg(ap, double *);
+  Wmax        = in->Wmax;
+  Wcr         = in->Wcr;
+  Wpwp        = in->Wpwp;
+  depth       = in->depth;
+  frost_fract = in->frost_fract;
 
   /* Atmopheric Condition and Forcings */
-  AirDens  = (double) va_arg(ap, double);
-  EactAir  = (double) va_arg(ap, double);
-  Press    = (double) va_arg(ap, double);
-  Le       = (double) va_arg(ap, double);
-  Tcanopy     = (double) va_arg(ap, double);
-  Vpd      = (double) va_arg(ap, double);
-  shortwave= (double) va_arg(ap, double);
-  Catm     = (double) va_arg(ap, double);
-  dryFrac = (double *) va_arg(ap, double *);
-
-  Evap     = (double *) va_arg(ap, double *);
-  Ra       = (double *) va_arg(ap, double *);
-  Ra_used  = (double *) va_arg(ap, double *);
-  Rainfall = (double) va_arg(ap, double);
-  Wind     = (double *) va_arg(ap, double *);
+  AirDens  = in->AirDens;
+  EactAir  = in->EactAir;
+  Press    = in->Press;
+  Le       = in->Le;
+  Tcanopy     = in->Tcanopy;
+  Vpd      = in->Vpd;
+  shortwave= in->shortwave;
+  Catm     = in->Catm;
+  dryFrac = in->dryFrac;
+
+  Evap     = in->Evap;
+  Ra       = in->Ra;
+  Ra_used  = in->Ra_used;
+  Rainfall = in->Rainfall;
+  Wind     = in->Wind;
 
   /* Vegetation Terms */
-  UnderStory = (int) va_arg(ap, int);
-  iveg       = (int) va_arg(ap, int);
-  veg_class  = (int) va_arg(ap, int);
+  UnderStory = in->UnderStory;
+  iveg       = in->iveg;
+  veg_class  = in->veg_class;
 
-  displacement = (double *) va_arg(ap, double *);
-  ref_height   = (double *) va_arg(ap, double *);
-  roughness    = (double *) va_arg(ap, double *);
+  displacement = in->displacement;
+  ref_height   = in->ref_height;
+  roughness    = in->roughness;
 
-  root = (float *) va_arg(ap, float *);
-  CanopLayerBnd= (double *) va_arg(ap, double *);
+  root = in->root;
+  CanopLayerBnd= in->CanopLayerBnd;
 
   /* Water Flux Terms */
-  IntRain = (double) va_arg(ap, double);
-  IntSnow = (double) va_arg(ap, double);
+  IntRain = in->IntRain;
+  IntSnow = in->IntSnow;
 
-  Wdew    = (double *) va_arg(ap, double *);
+  Wdew    = in->Wdew;
 
-  layer   = (layer_data_struct *) va_arg(ap, layer_data_struct *);
-  veg_var = (veg_var_struct *) va_arg(ap, veg_var_struct *);
+  layer   = in->layer;
+  veg_var = in->veg_var;
 
   /* Energy Flux Terms */
-  LongOverIn         = (double) va_arg(ap, double);
-  LongUnderOut       = (double) va_arg(ap, double);
-  NetShortOver       = (double) va_arg(ap, double);
-
-  AdvectedEnergy     = (double *) va_arg(ap, double *);
-  LatentHeat         = (double *) va_arg(ap, double *);
-  LatentHeatSub      = (double *) va_arg(ap, double *);
-  LongOverOut        = (double *) va_arg(ap, double *);
-  NetLongOver        = (double *) va_arg(ap, double *);
-  NetRadiation       = (double *) va_arg(ap, double *);
-  RefreezeEnergy     = (double *) va_arg(ap, double *);
-  SensibleHeat       = (double *) va_arg(ap, double *);
-  VaporMassFlux      = (double *) va_arg(ap, double *);
+  LongOverIn         = in->LongOverIn;
+  LongUnderOut       = in->LongUnderOut;
+  NetShortOver       = in->NetShortOver;
+
+  AdvectedEnergy     = in->AdvectedEnergy;
+  LatentHeat         = in->LatentHeat;
+  LatentHeatSub      = in->LatentHeatSub;
+  LongOverOut        = in->LongOverOut;
+  NetLongOver        = in->NetLongOver;
+  NetRadiation       = in->NetRadiation;
+  RefreezeEnergy     = in->RefreezeEnergy;
+  SensibleHeat       = in->SensibleHeat;
+  VaporMassFlux      = in->VaporMassFlux;
 
   /* Calculate the net radiation at the canopy surface, using the canopy 
      temperature.  The outgoing longwave is subtracted twice, because the 
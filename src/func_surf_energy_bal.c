@@ -5,7 +5,7 @@
 
 static char vcid[] = "$Id$";
 
-double func_surf_energy_bal(double Ts, va_list ap)
+double func_surf_energy_bal(double Ts, void *args)
 /**********************************************************************
 	func_surf_energy_bal	Keith Cherkauer		January 3, 1996
 
@@ -115,10 +115,16 @@ double func_surf_energy_bal(double Ts, va_list ap)
   2014-Apr-25 Added partial veg cover fraction, bare soil evap between
 	      the plants, and re-scaling of LAI & plant fluxes from
 	      global to local and back.					TJB
+  2026-Oct-18 transp is now stored on the stack instead of being
+	      allocated on every call.
+  2026-Oct-18 Inputs are now passed in a surf_energy_bal_args_struct
+	      instead of a va_list.
 **********************************************************************/
 {
-  extern option_struct options;
-  extern veg_lib_struct *veg_lib;
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL veg_lib_struct *veg_lib;
+
+  surf_energy_bal_args_struct *in = (surf_energy_bal_args_struct *)args;
 
   /* define routine input variables */
 
@@ -133,7 +139,7 @@ double func_surf_energy_bal(double Ts, va_list ap)
   int Error;
   
   //error counting variables for IMPLICIT option
-  static int error_cnt0, error_cnt1;  
+  static THREAD_LOCAL int error_cnt0, error_cnt1;  
 
   double delta_t;
 
@@ -293,7 +299,7 @@ double func_surf_energy_bal(double Ts, va_list ap)
   double T1_plus;
   double D1_minus;
   double D1_plus;
-  double *transp;
+  double transp[MAX_LAYERS];
   double Ra_bare[3];
   double tmp_wind[3];
   double tmp_height;
@@ -302,133 +308,133 @@ double func_surf_energy_bal(double Ts, va_list ap)
   double tmp_ref_height[3];
 
   /************************************
-    Read variables from variable list 
+    Read variables from argument structure
   ************************************/
 
   /* general model terms */
-  rec                     = (int) va_arg(ap, int);
-  nrecs                    = (int) va_arg(ap, int);
-  month                   = (int) va_arg(ap, int);
-  VEG                     = (int) va_arg(ap, int);
-  veg_class               = (int) va_arg(ap, int);
-  iveg                    = (int) va_arg(ap, int);
-  delta_t                 = (double) va_arg(ap, double);
+  rec                     = in->rec;
+  nrecs                    = in->nrecs;
+  month                   = in->month;
+  VEG                     = in->VEG;
+  veg_class               = in->veg_class;
+  iveg                    = in->iveg;
+  delta_t                 = in->delta_t;
 
   /* soil layer terms */
-  Cs1                     = (double) va_arg(ap, double);
-  Cs2                     = (double) va_arg(ap, double);
-  D1                      = (double) va_arg(ap, double);
-  D2                      = (double) va_arg(ap, double);
-  T1_old                  = (double) va_arg(ap, double);
-  T2                      = (double) va_arg(ap, double);
-  Ts_old                  = (double) va_arg(ap, double);
-  Told_node               = (double *) va_arg(ap, double *);
-  bubble                  = (double) va_arg(ap, double);
-  dp                      = (double) va_arg(ap, double);
-  expt                    = (double) va_arg(ap, double);
-  ice0                    = (double) va_arg(ap, double);
-  kappa1                  = (double) va_arg(ap, double);
-  kappa2                  = (double) va_arg(ap, double);
-  max_moist               = (double) va_arg(ap, double);
-  moist                   = (double) va_arg(ap, double);
-
-  root                    = (float  *) va_arg(ap, float  *);
-  CanopLayerBnd           = (double *) va_arg(ap, double *);
+  Cs1                     = in->Cs1;
+  Cs2                     = in->Cs2;
+  D1                      = in->D1;
+  D2                      = in->D2;
+  T1_old                  = in->T1_old;
+  T2                      = in->T2;
+  Ts_old                  = in->Ts_old;
+  Told_node               = in->Told_node;
+  bubble                  = in->bubble;
+  dp                      = in->dp;
+  expt                    = in->expt;
+  ice0                    = in->ice0;
+  kappa1                  = in->kappa1;
+  kappa2                  = in->kappa2;
+  max_moist               = in->max_moist;
+  moist                   = in->moist;
+
+  root                    = in->root;
+  CanopLayerBnd           = in->CanopLayerBnd;
 
   /* meteorological forcing terms */
-  UnderStory              = (int) va_arg(ap, int);
-  overstory               = (int) va_arg(ap, int);
-
-  NetShortBare            = (double) va_arg(ap, double);
-  NetShortGrnd            = (double) va_arg(ap, double);
-  NetShortSnow            = (double) va_arg(ap, double);
-  Tair                    = (double) va_arg(ap, double);
-  atmos_density           = (double) va_arg(ap, double);
-  atmos_pressure          = (double) va_arg(ap, double);
-  emissivity              = (double) va_arg(ap, double);
-  LongBareIn              = (double) va_arg(ap, double);
-  LongSnowIn              = (double) va_arg(ap, double);
-  surf_atten              = (double) va_arg(ap, double);
-  vp                      = (double) va_arg(ap, double);
-  vpd                     = (double) va_arg(ap, double);
-  shortwave               = (double) va_arg(ap, double);
-  Catm                    = (double) va_arg(ap, double);
-  dryFrac                 = (double *) va_arg(ap, double *);
-
-  Wdew                    = (double *) va_arg(ap, double *);
-  displacement            = (double *) va_arg(ap, double *);
-  ra                      = (double *) va_arg(ap, double *);
-  Ra_used                 = (double *) va_arg(ap, double *);
-  rainfall                = (double) va_arg(ap, double);
-  ref_height              = (double *) va_arg(ap, double *);
-  roughness               = (double *) va_arg(ap, double *);
-  wind                    = (double *) va_arg(ap, double *);
+  UnderStory              = in->UnderStory;
+  overstory               = in->overstory;
+
+  NetShortBare            = in->NetShortBare;
+  NetShortGrnd            = in->NetShortGrnd;
+  NetShortSnow            = in->NetShortSnow;
+  Tair                    = in->Tair;
+  atmos_density           = in->atmos_density;
+  atmos_pressure          = in->atmos_pressure;
+  emissivity              = in->emissivity;
+  LongBareIn              = in->LongBareIn;
+  LongSnowIn              = in->LongSnowIn;
+  surf_atten              = in->surf_atten;
+  vp                      = in->vp;
+  vpd                     = in->vpd;
+  shortwave               = in->shortwave;
+  Catm                    = in->Catm;
+  dryFrac                 = in->dryFrac;
+
+  Wdew                    = in->Wdew;
+  displacement            = in->displacement;
+  ra                      = in->ra;
+  Ra_used                 = in->Ra_used;
+  rainfall                = in->rainfall;
+  ref_height              = in->ref_height;
+  roughness               = in->roughness;
+  wind                    = in->wind;
 
   /* latent heat terms */
-  Le                      = (double) va_arg(ap, double);
+  Le                      = in->Le;
 
   /* snowpack terms */
-  Advection               = (double) va_arg(ap, double);
-  OldTSurf                = (double) va_arg(ap, double);
-  TPack                   = (double) va_arg(ap, double);
-  Tsnow_surf              = (double) va_arg(ap, double);
-  kappa_snow              = (double) va_arg(ap, double);
-  melt_energy             = (double) va_arg(ap, double);
-  snow_coverage           = (double) va_arg(ap, double);
-  snow_density            = (double) va_arg(ap, double);
-  snow_swq                = (double) va_arg(ap, double);
-  snow_water              = (double) va_arg(ap, double);
+  Advection               = in->Advection;
+  OldTSurf                = in->OldTSurf;
+  TPack                   = in->TPack;
+  Tsnow_surf              = in->Tsnow_surf;
+  kappa_snow              = in->kappa_snow;
+  melt_energy             = in->melt_energy;
+  snow_coverage           = in->snow_coverage;
+  snow_density            = in->snow_density;
+  snow_swq                = in->snow_swq;
+  snow_water              = in->snow_water;
     
-  deltaCC                 = (double *) va_arg(ap, double *);
-  refreeze_energy         = (double *) va_arg(ap, double *);
-  vapor_flux              = (double *) va_arg(ap, double *);
-  blowing_flux            = (double *) va_arg(ap, double *);
-  surface_flux            = (double *) va_arg(ap, double *);
+  deltaCC                 = in->deltaCC;
+  refreeze_energy         = in->refreeze_energy;
+  vapor_flux              = in->vapor_flux;
+  blowing_flux            = in->blowing_flux;
+  surface_flux            = in->surface_flux;
 
   /* soil node terms */
-  Nnodes                  = (int) va_arg(ap, int);
-
-  Cs_node                 = (double *) va_arg(ap, double *);
-  T_node                  = (double *) va_arg(ap, double *);
-  Tnew_node               = (double *) va_arg(ap, double *);
-  Tnew_fbflag             = (char *) va_arg(ap, char *);
-  Tnew_fbcount            = (int *) va_arg(ap, int *);
-  alpha                   = (double *) va_arg(ap, double *);
-  beta                    = (double *) va_arg(ap, double *);
-  bubble_node             = (double *) va_arg(ap, double *);
-  Zsum_node               = (double *) va_arg(ap, double *);
-  expt_node               = (double *) va_arg(ap, double *);
-  gamma                   = (double *) va_arg(ap, double *);
-  ice_node                = (double *) va_arg(ap, double *);
-  kappa_node              = (double *) va_arg(ap, double *);
-  max_moist_node          = (double *) va_arg(ap, double *);
-  moist_node              = (double *) va_arg(ap, double *);
+  Nnodes                  = in->Nnodes;
+
+  Cs_node                 = in->Cs_node;
+  T_node                  = in->T_node;
+  Tnew_node               = in->Tnew_node;
+  Tnew_fbflag             = in->Tnew_fbflag;
+  Tnew_fbcount            = in->Tnew_fbcount;
+  alpha                   = in->alpha;
+  beta                    = in->beta;
+  bubble_node             = in->bubble_node;
+  Zsum_node               = in->Zsum_node;
+  expt_node               = in->expt_node;
+  gamma                   = in->gamma;
+  ice_node                = in->ice_node;
+  kappa_node              = in->kappa_node;
+  max_moist_node          = in->max_moist_node;
+  moist_node              = in->moist_node;
 
   /* model structures */
-  soil_con                = (soil_con_struct *) va_arg(ap, soil_con_struct *);
-  layer               = (layer_data_struct *) va_arg(ap, layer_data_struct *);
-  veg_var             = (veg_var_struct *) va_arg(ap, veg_var_struct *);
+  soil_con                = in->soil_con;
+  layer               = in->layer;
+  veg_var             = in->veg_var;
 
   /* control flags */
-  INCLUDE_SNOW            = (int) va_arg(ap, int);
-  NOFLUX                  = (int) va_arg(ap, int);
-  EXP_TRANS               = (int) va_arg(ap, int);
-  SNOWING                 = (int) va_arg(ap, int);
+  INCLUDE_SNOW            = in->INCLUDE_SNOW;
+  NOFLUX                  = in->NOFLUX;
+  EXP_TRANS               = in->EXP_TRANS;
+  SNOWING                 = in->SNOWING;
 
-  FIRST_SOLN              = (int *) va_arg(ap, int *);
+  FIRST_SOLN              = in->FIRST_SOLN;
 
   /* returned energy balance terms */
-  NetLongBare             = (double *) va_arg(ap, double *);
-  NetLongSnow             = (double *) va_arg(ap, double *);
-  T1                      = (double *) va_arg(ap, double *);
-  deltaH                  = (double *) va_arg(ap, double *);
-  fusion                  = (double *) va_arg(ap, double *);
-  grnd_flux               = (double *) va_arg(ap, double *);
-  latent_heat             = (double *) va_arg(ap, double *);
-  latent_heat_sub         = (double *) va_arg(ap, double *);
-  sensible_heat           = (double *) va_arg(ap, double *);
-  snow_flux               = (double *) va_arg(ap, double *);
-  store_error             = (double *) va_arg(ap, double *);
+  NetLongBare             = in->NetLongBare;
+  NetLongSnow             = in->NetLongSnow;
+  T1                      = in->T1;
+  deltaH                  = in->deltaH;
+  fusion                  = in->fusion;
+  grnd_flux               = in->grnd_flux;
+  latent_heat             = in->latent_heat;
+  latent_heat_sub         = in->latent_heat_sub;
+  sensible_heat           = in->sensible_heat;
+  snow_flux               = in->snow_flux;
+  store_error             = in->store_error;
 
   /* take additional variables from soil_con structure */
   b_infilt = soil_con->b_infilt;
@@ -463,7 +469,6 @@ double func_surf_energy_bal(double Ts, va_list ap)
   TMean = Ts;
   Tmp = TMean + KELVIN;
 
-  transp = (double *) calloc(options.Nlayer,sizeof(double));
   for (i=0; i<options.Nlayer; i++) {
     transp[i] = 0;
   }
@@ -752,7 +757,6 @@ double func_surf_energy_bal(double Ts, va_list ap)
   }
   else Evap = 0.;
 
-  free(transp);
   
   /**********************************************************************
     Compute the Latent Heat Flux from the Surface and Covering Vegetation
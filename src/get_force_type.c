@@ -42,7 +42,7 @@ void get_force_type(char   *cmdstr,
 
 *************************************************************/
 
-  extern param_set_struct param_set;
+  extern THREAD_LOCAL param_set_struct param_set;
 
   char optstr[50];
   char flgstr[10];
@@ -8,9 +8,9 @@ static char vcid[] = "$Id$";
 /********************************************************************/
 /*			GLOBAL VARIABLES                            */
 /********************************************************************/
-int NR;		      /* array index for atmos struct that indicates
+THREAD_LOCAL int NR;		      /* array index for atmos struct that indicates
 			 the model step avarage or sum */
-int NF;		      /* array index loop counter limit for atmos
+THREAD_LOCAL int NF;		      /* array index loop counter limit for atmos
 			 struct that indicates the SNOW_STEP values */
  
 global_param_struct get_global_param(filenames_struct *names,
@@ -117,11 +117,31 @@ global_param_struct get_global_param(filenames_struct *names,
   2014-Mar-28 Removed DIST_PRCP option.				                TJB
   2014-Apr-25 Changed LAI_FROM_* to FROM_*; added ALB_SRC.			TJB
   2014-Apr-25 Added VEGCOVER_SRC.						TJB
+  2026-Oct-18 Added NTHREADS option.  A value given on the command line
+	      (-j) takes precedence over the global parameter file.
+  2026-Oct-18 Added NPROCS option, which can also be given on the
+	      command line (-p).
+  2026-Oct-18 Added CELL_SCHEDULE and CELL_TIMING_LOG options.
+  2026-Oct-18 Added PREFETCH option.
+  2026-Oct-18 Added ASYNC_OUTPUT option.
+  2026-Oct-18 Added check of CANOPY_LAYERS against MAX_CANOPY.
+  2026-Oct-18 Added CELL_MEMORY_LIMIT option.
+  2026-Oct-18 Added PACKED forcing file format (FORCE_FORMAT PACKED).
+  2026-Oct-18 Added STATE_SCHEDULE option, and the snapshot date of
+	      INIT_STATE.  The state file name of a STATE_SCHEDULE is used
+	      as given, without a date.
+  2026-Oct-18 Added CELL_JOURNAL option.
+  2026-Oct-18 Added EXPLICIT_SOLVER option.
+  2026-Oct-18 Added SOLVER_TELEMETRY option.
+  2026-Oct-18 Added PHASE_PROFILE option.
+  2026-Oct-18 Added SOLAR_GEOM_PRECISION option.
+  2026-Oct-18 Added IMPLICIT_JACOBIAN option.
+  2026-Oct-18 Added ENERGY_WARM_START option.
 **********************************************************************/
 {
-  extern option_struct    options;
-  extern param_set_struct param_set;
-  extern int              NF, NR;
+  extern THREAD_LOCAL option_struct    options;
+  extern THREAD_LOCAL param_set_struct param_set;
+  extern THREAD_LOCAL int              NF, NR;
 
   char cmdstr[MAXSTRING];
   char optstr[MAXSTRING];
@@ -134,6 +154,8 @@ global_param_struct get_global_param(filenames_struct *names,
   int  tmpstartdate;
   int  tmpenddate;
   int  lastvalidday;
+  int  tmp_nthreads;
+  int  tmp_nprocs;
   int  lastday[] = {
             31, /* JANUARY */
             28, /* FEBRUARY */
@@ -152,6 +174,8 @@ global_param_struct get_global_param(filenames_struct *names,
 
   /** Initialize global parameters (that aren't part of the options struct) **/
   global.dt            = MISSING;
+  tmp_nthreads         = 1;
+  tmp_nprocs           = 1;
   global.nrecs         = MISSING;
   global.startyear     = MISSING;
   global.startmonth    = MISSING;
@@ -179,7 +203,15 @@ global_param_struct get_global_param(filenames_struct *names,
   global.stateyear     = MISSING;
   global.statemonth    = MISSING;
   global.stateday      = MISSING;
+  global.Nstate_dates  = 0;
+  global.state_monthly_day = 0;
+  global.init_state_date = MISSING;
+  global.init_state_snapshot = -1;
   strcpy(names->statefile,    "MISSING");
+  strcpy(names->cell_journal, "MISSING");
+  strcpy(names->solver_telemetry, "MISSING");
+  strcpy(names->cell_timing,  "MISSING");
+  strcpy(names->cell_timing_out, "MISSING");
   strcpy(names->soil,         "MISSING");
   strcpy(names->veg,          "MISSING");
   strcpy(names->veglib,       "MISSING");
@@ -282,6 +314,25 @@ global_param_struct get_global_param(filenames_struct *names,
         if(strcasecmp("TRUE",flgstr)==0) options.IMPLICIT=TRUE;
         else options.IMPLICIT = FALSE;
       }
+      else if(strcasecmp("EXPLICIT_SOLVER",optstr)==0) {
+        sscanf(cmdstr,"%*s %s",flgstr);
+        if(strcasecmp("GAUSS_SEIDEL",flgstr)==0) options.EXPLICIT_SOLVER=ES_GAUSS_SEIDEL;
+        else if(strcasecmp("NEWTON",flgstr)==0) options.EXPLICIT_SOLVER=ES_NEWTON;
+        else {
+          snprintf(ErrStr,sizeof(ErrStr),"EXPLICIT_SOLVER must be either GAUSS_SEIDEL or NEWTON (found %.100s).",flgstr);
+          nrerror(ErrStr);
+        }
+      }
+      else if(strcasecmp("IMPLICIT_JACOBIAN",optstr)==0) {
+        sscanf(cmdstr,"%*s %s",flgstr);
+        if(strcasecmp("FD",flgstr)==0) options.IMPLICIT_JACOBIAN=IJ_FD;
+        else if(strcasecmp("ANALYTIC",flgstr)==0) options.IMPLICIT_JACOBIAN=IJ_ANALYTIC;
+        else if(strcasecmp("CHECK",flgstr)==0) options.IMPLICIT_JACOBIAN=IJ_CHECK;
+        else {
+          snprintf(ErrStr,sizeof(ErrStr),"IMPLICIT_JACOBIAN must be FD, ANALYTIC, or CHECK (found %.100s).",flgstr);
+          nrerror(ErrStr);
+        }
+      }
       else if(strcasecmp("EXP_TRANS",optstr)==0) {
         sscanf(cmdstr,"%*s %s",flgstr);
         if(strcasecmp("TRUE",flgstr)==0) options.EXP_TRANS=TRUE;
@@ -316,6 +367,11 @@ global_param_struct get_global_param(filenames_struct *names,
         if(strcasecmp("TRUE",flgstr)==0) options.CLOSE_ENERGY=TRUE;
         else options.CLOSE_ENERGY = FALSE;
       }
+      else if(strcasecmp("ENERGY_WARM_START",optstr)==0) {
+        sscanf(cmdstr,"%*s %s",flgstr);
+        if(strcasecmp("TRUE",flgstr)==0) options.ENERGY_WARM_START=TRUE;
+        else options.ENERGY_WARM_START = FALSE;
+      }
       else if(strcasecmp("CONTINUEONERROR",optstr)==0) {
         sscanf(cmdstr,"%*s %s",flgstr);
         if(strcasecmp("TRUE",flgstr)==0) options.CONTINUEONERROR=TRUE;
@@ -392,6 +448,12 @@ global_param_struct get_global_param(filenames_struct *names,
         sscanf(cmdstr,"%*s %s",flgstr);
         options.SW_PREC_THRESH = atof(flgstr);
       }
+      else if(strcasecmp("SOLAR_GEOM_PRECISION",optstr)==0) {
+        sscanf(cmdstr,"%*s %s",flgstr);
+        options.SOLAR_GEOM_PRECISION = atof(flgstr);
+        if (options.SOLAR_GEOM_PRECISION < 0)
+          nrerror("SOLAR_GEOM_PRECISION must be >= 0.");
+      }
       else if(strcasecmp("TFALLBACK",optstr)==0) {
         sscanf(cmdstr,"%*s %s",flgstr);
         if(strcasecmp("TRUE",flgstr)==0) options.TFALLBACK=TRUE;
@@ -429,15 +491,65 @@ global_param_struct get_global_param(filenames_struct *names,
         else options.RC_MODE = RC_JARVIS;
       }
 
+      /*************************************
+       Define run control options
+      *************************************/
+      else if(strcasecmp("NTHREADS",optstr)==0) {
+        sscanf(cmdstr,"%*s %d",&tmp_nthreads);
+      }
+      else if(strcasecmp("NPROCS",optstr)==0) {
+        sscanf(cmdstr,"%*s %d",&tmp_nprocs);
+      }
+      else if(strcasecmp("CELL_SCHEDULE",optstr)==0) {
+        sscanf(cmdstr,"%*s %s",flgstr);
+        if(strcasecmp("FILE_ORDER",flgstr)==0) options.CELL_SCHEDULE=SCHED_FILE_ORDER;
+        else if(strcasecmp("LONGEST_FIRST",flgstr)==0) options.CELL_SCHEDULE=SCHED_LONGEST_FIRST;
+        else {
+          snprintf(ErrStr,sizeof(ErrStr),"CELL_SCHEDULE must be either FILE_ORDER or LONGEST_FIRST (found %.100s).",flgstr);
+          nrerror(ErrStr);
+        }
+      }
+      else if(strcasecmp("CELL_TIMING_LOG",optstr)==0) {
+        sscanf(cmdstr,"%*s %s",names->cell_timing);
+        strcpy(names->cell_timing_out,names->cell_timing);
+      }
+      else if(strcasecmp("CELL_JOURNAL",optstr)==0) {
+        sscanf(cmdstr,"%*s %s",names->cell_journal);
+      }
+      else if(strcasecmp("SOLVER_TELEMETRY",optstr)==0) {
+        sscanf(cmdstr,"%*s %s",names->solver_telemetry);
+        options.SOLVER_TELEMETRY = TRUE;
+      }
+      else if(strcasecmp("PHASE_PROFILE",optstr)==0) {
+        sscanf(cmdstr,"%*s %s",flgstr);
+        if(strcasecmp("TRUE",flgstr)==0) options.PHASE_PROFILE=TRUE;
+        else options.PHASE_PROFILE = FALSE;
+      }
+      else if(strcasecmp("PREFETCH",optstr)==0) {
+        sscanf(cmdstr,"%*s %s",flgstr);
+        if(strcasecmp("TRUE",flgstr)==0) options.PREFETCH=TRUE;
+        else options.PREFETCH = FALSE;
+      }
+      else if(strcasecmp("CELL_MEMORY_LIMIT",optstr)==0) {
+        sscanf(cmdstr,"%*s %d",&options.CELL_MEMORY_LIMIT);
+      }
+
       /*************************************
        Define state files
       *************************************/
       else if(strcasecmp("INIT_STATE",optstr)==0) {
-        sscanf(cmdstr,"%*s %s",flgstr);
+        strcpy(flgstr2,"");
+        sscanf(cmdstr,"%*s %s %s",flgstr,flgstr2);
         if(strcasecmp("FALSE",flgstr)==0) options.INIT_STATE=FALSE;
         else {
 	  options.INIT_STATE = TRUE;
 	  strcpy(names->init_state,flgstr);
+	  if(strlen(flgstr2) > 0 && flgstr2[0] != '#') {
+	    if((global.init_state_date = parse_state_date(flgstr2)) == MISSING) {
+	      snprintf(ErrStr,sizeof(ErrStr),"Invalid INIT_STATE snapshot date \"%.100s\"; the date must be given as YYYY-MM-DD.",flgstr2);
+	      nrerror(ErrStr);
+	    }
+	  }
 	}
       }
       else if(strcasecmp("STATENAME",optstr)==0) {
@@ -453,6 +565,10 @@ global_param_struct get_global_param(filenames_struct *names,
       else if(strcasecmp("STATEDAY",optstr)==0) {
         sscanf(cmdstr,"%*s %d",&global.stateday);
       }
+      else if(strcasecmp("STATE_SCHEDULE",optstr)==0) {
+        parse_state_schedule(cmdstr,&global);
+        options.STATE_SCHEDULE = TRUE;
+      }
       else if(strcasecmp("BINARY_STATE_FILE",optstr)==0) {
         sscanf(cmdstr,"%*s %s",flgstr);
         if(strcasecmp("FALSE",flgstr)==0) options.BINARY_STATE_FILE=FALSE;
@@ -482,8 +598,10 @@ global_param_struct get_global_param(filenames_struct *names,
 	  param_set.FORCE_FORMAT[file_num] = BINARY;
 	else if (strcasecmp(flgstr, "ASCII") == 0)
 	  param_set.FORCE_FORMAT[file_num] = ASCII;
+	else if (strcasecmp(flgstr, "PACKED") == 0)
+	  param_set.FORCE_FORMAT[file_num] = PACKED;
 	else
-	  nrerror("FORCE_FORMAT must be either ASCII or BINARY.");
+	  nrerror("FORCE_FORMAT must be ASCII, BINARY, or PACKED.");
       }
       else if (strcasecmp("FORCE_ENDIAN",optstr)==0) {
 	sscanf(cmdstr, "%*s %s", flgstr);
@@ -684,6 +802,11 @@ global_param_struct get_global_param(filenames_struct *names,
         if(strcasecmp("TRUE",flgstr)==0) options.COMPRESS=TRUE;
         else options.COMPRESS = FALSE;
       }
+      else if(strcasecmp("ASYNC_OUTPUT",optstr)==0) {
+        sscanf(cmdstr,"%*s %s",flgstr);
+        if(strcasecmp("TRUE",flgstr)==0) options.ASYNC_OUTPUT=TRUE;
+        else options.ASYNC_OUTPUT = FALSE;
+      }
       else if(strcasecmp("BINARY_OUTPUT",optstr)==0) {
         sscanf(cmdstr,"%*s %s",flgstr);
         if(strcasecmp("TRUE",flgstr)==0) options.BINARY_OUTPUT=TRUE;
@@ -843,7 +966,7 @@ global_param_struct get_global_param(filenames_struct *names,
         nrerror(ErrStr);
       }
       if (param_set.FORCE_FORMAT[i] == MISSING) {
-        sprintf(ErrStr,"Need to specify the INPUT_FORMAT (ASCII or BINARY) for forcing file %d.",i);
+        sprintf(ErrStr,"Need to specify the FORCE_FORMAT (ASCII, BINARY, or PACKED) for forcing file %d.",i);
         nrerror(ErrStr);
       }
       if (param_set.FORCE_INDEX[i][param_set.N_TYPES[i]-1] == MISSING) {
@@ -872,6 +995,32 @@ global_param_struct get_global_param(filenames_struct *names,
   if ( strcmp ( names->soil, "MISSING" ) == 0 )
     nrerror("No soil parameter file has been defined.  Make sure that the global file defines the soil parameter file on the line that begins with \"SOIL\".");
 
+  // Validate the number of threads
+  if ( options.NTHREADS == 0 ) {
+    // not set on the command line
+    options.NTHREADS = tmp_nthreads;
+  }
+  if ( options.NTHREADS < 1 ) {
+    sprintf(ErrStr,"Invalid number of threads specified (%d).  NTHREADS must be >= 1.",options.NTHREADS);
+    nrerror(ErrStr);
+  }
+
+  // Validate the number of processes
+  if ( options.NPROCS == 0 ) {
+    // not set on the command line
+    options.NPROCS = tmp_nprocs;
+  }
+  if ( options.NPROCS < 1 ) {
+    sprintf(ErrStr,"Invalid number of processes specified (%d).  NPROCS must be >= 1.",options.NPROCS);
+    nrerror(ErrStr);
+  }
+
+  // Validate the cell memory limit
+  if ( options.CELL_MEMORY_LIMIT < 0 ) {
+    sprintf(ErrStr,"Invalid cell memory limit specified (%d MB).  CELL_MEMORY_LIMIT must be >= 0 (0 = no limit).",options.CELL_MEMORY_LIMIT);
+    nrerror(ErrStr);
+  }
+
   /*******************************************************************************
     Validate parameters required for normal simulations but NOT for OUTPUT_FORCE
   *******************************************************************************/
@@ -939,7 +1088,17 @@ global_param_struct get_global_param(filenames_struct *names,
   }
 
   // Validate the output state file information
-  if( options.SAVE_STATE ) {
+  if( options.STATE_SCHEDULE ) {
+    if ( !options.SAVE_STATE || strcmp ( names->statefile, "MISSING" ) == 0)
+      nrerror("\"STATE_SCHEDULE\" was specified, but no output state file has been defined.  Make sure that the global file defines the output state file on the line that begins with \"STATENAME\".");
+    if ( !options.BINARY_STATE_FILE )
+      nrerror("A STATE_SCHEDULE saves its states in a multi-snapshot state file, which must be binary.  Set BINARY_STATE_FILE to TRUE in your global parameter file.");
+    if ( global.stateyear != MISSING || global.statemonth != MISSING || global.stateday != MISSING )
+      nrerror("Both STATE_SCHEDULE and STATEYEAR, STATEMONTH, or STATEDAY were given.  Give the dates on which to save state with one or the other.");
+    if ( global.Nstate_dates == 0 && global.state_monthly_day == 0 )
+      nrerror("\"STATE_SCHEDULE\" was specified without any dates.");
+  }
+  else if( options.SAVE_STATE ) {
     if ( strcmp ( names->statefile, "MISSING" ) == 0)
       nrerror("\"SAVE_STATE\" was specified, but no output state file has been defined.  Make sure that the global file defines the output state file on the line that begins with \"SAVE_STATE\".");
     if ( global.stateyear == MISSING || global.statemonth == MISSING || global.stateday == MISSING )  {
@@ -957,9 +1116,12 @@ global_param_struct get_global_param(filenames_struct *names,
       sprintf(ErrStr,"Unusual specification of the date to save state for state file (%s).\nSpecified date (yyyy-mm-dd): %04d-%02d-%02d\nMake sure STATEYEAR, STATEMONTH, and STATEDAY are set correctly in your global parameter file.\n", names->statefile, global.stateyear, global.statemonth, global.stateday);
       nrerror(ErrStr);
     }
+    global.Nstate_dates = 1;
+    global.state_date[0] = global.stateyear*10000 + global.statemonth*100
+                           + global.stateday;
   }
   // Set the statename here to be able to compare with INIT_STATE name
-  if( options.SAVE_STATE ) {
+  if( options.SAVE_STATE && !options.STATE_SCHEDULE ) {
     sprintf(names->statefile,"%s_%04i%02i%02i", names->statefile,
           global.stateyear, global.statemonth, global.stateday);
   }
@@ -968,6 +1130,12 @@ global_param_struct get_global_param(filenames_struct *names,
       nrerror(ErrStr);
   }
 
+  // Validate the cell journal information
+  if( strcmp( names->cell_journal, "MISSING" ) != 0 && options.NPROCS > 1
+      && options.SAVE_STATE && !options.OUTPUT_FORCE )  {
+    nrerror("CELL_JOURNAL cannot be combined with NPROCS > 1 when the model state is saved, since the state files of the processes are only assembled at the end of the run.  Use NTHREADS instead of NPROCS, or run without CELL_JOURNAL.");
+  }
+
   // Validate soil parameter/simulation mode combinations
   if(options.QUICK_FLUX) {
     if(options.Nnode != 3) {
@@ -1012,6 +1180,10 @@ global_param_struct get_global_param(filenames_struct *names,
     sprintf(ErrStr,"Global file wants more soil thermal nodes (%d) than are defined by MAX_NODES (%d).  Edit vicNl_def.h and recompile.",options.Nnode,MAX_NODES);
     nrerror(ErrStr);
   }
+  if(options.Ncanopy > MAX_CANOPY) {
+    sprintf(ErrStr,"Global file wants more canopy layers (%d) than are defined by MAX_CANOPY (%d).  Edit vicNl_def.h and recompile.",options.Ncanopy,MAX_CANOPY);
+    nrerror(ErrStr);
+  }
   if(!options.FULL_ENERGY && options.CLOSE_ENERGY) {
     sprintf(ErrStr,"CLOSE_ENERGY is TRUE but FULL_ENERGY is FALSE. Set FULL_ENERGY to TRUE to run CLOSE_ENERGY, or set CLOSE_ENERGY to FALSE.");
     nrerror(ErrStr);
@@ -1082,7 +1254,19 @@ global_param_struct get_global_param(filenames_struct *names,
   fprintf(stderr,"\n");
   fprintf(stderr,"Using %d Snow Bands\n",options.SNOW_BAND);
   fprintf(stderr,"Using %d Root Zones\n",options.ROOT_ZONES);
-  if ( options.SAVE_STATE )
+  if ( options.NTHREADS > 1 )
+    fprintf(stderr,"Running grid cells on %d threads\n",options.NTHREADS);
+  if ( options.NPROCS > 1 )
+    fprintf(stderr,"Splitting grid cells among %d processes\n",options.NPROCS);
+  if ( options.NTHREADS > 1 && options.CELL_SCHEDULE == SCHED_LONGEST_FIRST )
+    fprintf(stderr,"Running the most expensive grid cells first\n");
+  if ( options.NTHREADS == 1 && options.PREFETCH )
+    fprintf(stderr,"Prefetching the forcings of the next grid cell\n");
+  if ( options.CELL_MEMORY_LIMIT > 0 )
+    fprintf(stderr,"Limiting the memory of each grid cell to %d MB\n",options.CELL_MEMORY_LIMIT);
+  if ( options.SAVE_STATE && options.STATE_SCHEDULE )
+    fprintf(stderr,"Model state will be saved on a schedule\n\n");
+  else if ( options.SAVE_STATE )
     fprintf(stderr,"Model state will be saved on = %02i/%02i/%04i\n\n",
 	    global.stateday, global.statemonth, global.stateyear);
   if ( options.BINARY_OUTPUT ) 
@@ -21,16 +21,26 @@
   2012-Jan-16 Removed LINK_DEBUG code					BN
   2013-Dec-27 Removed QUICK_FS option.					TJB
   2014-May-20 Added ref_veg_vegcover.					TJB
+  2026-Oct-18 Made veg_lib, Error, and param_set thread-local, since
+	      they hold per-cell state, for the NTHREADS option.  Added
+	      -j option to optstring.
+  2026-Oct-18 Added -p option to optstring.
+  2026-Oct-18 Added soil_T_iter.
+  2026-Oct-18 Added solver_telemetry.
+  2026-Oct-18 Added phase_profile.
 **********************************************************************/
 char *version = "4.2.b 2015-January-22";
-char *optstring = "g:vo";
+char *optstring = "g:j:p:vo";
 int flag;
 
-global_param_struct global_param;
-veg_lib_struct *veg_lib;
-option_struct options;
-Error_struct Error;
-param_set_struct param_set;
+THREAD_LOCAL global_param_struct global_param;
+THREAD_LOCAL veg_lib_struct *veg_lib;
+THREAD_LOCAL option_struct options;
+THREAD_LOCAL Error_struct Error;
+THREAD_LOCAL param_set_struct param_set;
+THREAD_LOCAL soil_T_iter_struct soil_T_iter;
+THREAD_LOCAL solver_telemetry_struct solver_telemetry;
+THREAD_LOCAL phase_profile_struct phase_profile;
 
   /**************************************************************************
     Define some reference landcover types that always exist regardless
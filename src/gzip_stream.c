@@ -0,0 +1,152 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <zlib.h>
+#include <vicNl.h>
+
+static char vcid[] = "$Id$";
+
+/**********************************************************************
+  gzip_stream					October 2026
+
+  Streams that read or write gzip-compressed files through zlib.  The
+  compressed file is presented to the rest of the model as an ordinary
+  FILE stream (made with fopencookie()), so that the file readers and
+  write_data() work unchanged with fgets(), fread(), fprintf(), and
+  fwrite(); the data are compressed or decompressed in memory as they
+  pass through, and an uncompressed copy of the file never exists on
+  disk.
+
+  Read streams can be rewound (open_file() rewinds a file after
+  skipping its header), but not positioned relative to the end of the
+  file, since the uncompressed size is not known in advance.  Write
+  streams cannot be positioned.
+**********************************************************************/
+
+/* Size of zlib's input and output buffers for gzipped files */
+#define GZ_BUFFER_SIZE (256*1024)
+
+static ssize_t gz_cookie_read(void   *cookie,
+                              char   *buf,
+                              size_t  size)
+{
+  gzFile      gz = (gzFile)cookie;
+  char        ErrStr[MAXSTRING];
+  const char *msg;
+  int         errnum;
+  int         n;
+
+  if (size > INT_MAX) size = INT_MAX;
+  n = gzread(gz, buf, (unsigned)size);
+  if (n <= 0) {
+    msg = gzerror(gz, &errnum);
+    if (n < 0 || (errnum != Z_OK && errnum != Z_STREAM_END)) {
+      /* zlib's message starts with the file name */
+      snprintf(ErrStr, sizeof(ErrStr), "Unable to decompress %.1000s", msg);
+      nrerror(ErrStr);
+    }
+  }
+
+  return n;
+
+}
+
+static ssize_t gz_cookie_write(void       *cookie,
+                               const char *buf,
+                               size_t      size)
+{
+  gzFile      gz = (gzFile)cookie;
+  char        ErrStr[MAXSTRING];
+  const char *msg;
+  int         errnum;
+  int         n;
+
+  if (size > INT_MAX) size = INT_MAX;
+  if (size == 0) return 0;
+  n = gzwrite(gz, buf, (unsigned)size);
+  if (n <= 0) {
+    msg = gzerror(gz, &errnum);
+    snprintf(ErrStr, sizeof(ErrStr), "Unable to compress %.1000s", msg);
+    nrerror(ErrStr);
+  }
+
+  return n;
+
+}
+
+static int gz_cookie_seek(void    *cookie,
+                          off64_t *offset,
+                          int      whence)
+{
+  z_off_t pos;
+
+  /* the uncompressed size is not known in advance */
+  if (whence == SEEK_END)
+    return -1;
+  if ((pos = gzseek((gzFile)cookie, (z_off_t)*offset, whence)) < 0)
+    return -1;
+  *offset = pos;
+
+  return 0;
+
+}
+
+static int gz_cookie_close(void *cookie)
+{
+  int status;
+
+  /* for write streams, this writes the rest of the compressed data */
+  if ((status = gzclose((gzFile)cookie)) != Z_OK) {
+    fprintf(stderr, "Error closing a gzipped file (zlib error %d).\n",
+            status);
+    return EOF;
+  }
+
+  return 0;
+
+}
+
+FILE *open_gzip_file(char filename[],
+                     char type[],
+                     int  level)
+/**********************************************************************
+  open_gzip_file				October 2026
+
+  Opens the gzipped file filename as a stream.  For type "r" or "rb",
+  reading the stream yields the file's uncompressed contents.  For
+  type "w" or "wb", the file is created or truncated, and data written
+  to the stream are compressed with zlib compression level level
+  (1 = fastest, 9 = smallest); the file is complete when the stream is
+  closed with fclose().  Returns NULL if the file cannot be opened.
+**********************************************************************/
+{
+  cookie_io_functions_t  io;
+  gzFile                 gz;
+  FILE                  *stream;
+  char                   mode[4];
+  int                    write;
+
+  write = (type[0] == 'w');
+  if (write) {
+    if (level < 1 || level > 9)
+      nrerror("Invalid compression level in open_gzip_file().");
+    sprintf(mode, "wb%d", level);
+  }
+  else
+    strcpy(mode, "rb");
+  if ((gz = gzopen(filename, mode)) == NULL)
+    return NULL;
+  gzbuffer(gz, GZ_BUFFER_SIZE);
+
+  io.read = write ? NULL : gz_cookie_read;
+  io.write = write ? gz_cookie_write : NULL;
+  io.seek = write ? NULL : gz_cookie_seek;
+  io.close = gz_cookie_close;
+  if ((stream = fopencookie(gz, write ? "w" : "r", io)) == NULL)
+    gzclose(gz);
+
+  return stream;
+
+}
@@ -149,7 +149,7 @@ int ice_melt(double            z2,
 	      double           *save_LWnet,
 	      double            fracprv)
 {
-  extern option_struct   options;
+  extern THREAD_LOCAL option_struct   options;
 
   int    Twidth;
 
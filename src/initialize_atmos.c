@@ -6,7 +6,7 @@ static char vcid[] = "$Id$";
 
 void initialize_atmos(atmos_data_struct        *atmos,
                       dmy_struct               *dmy,
-		      FILE                    **infile,
+		      filep_struct             *filep,
 		      veg_lib_struct           *veg_lib,
 		      veg_con_struct           *veg_con,
                       veg_hist_struct         **veg_hist,
@@ -134,12 +134,16 @@ void initialize_atmos(atmos_data_struct        *atmos,
   2013-Dec-27 Moved OUTPUT_FORCE to options_struct.				TJB
   2014-Apr-25 Added LAI and albedo.						TJB
   2014-Apr-25 Added partial vegcover fraction.					TJB
+  2026-Oct-18 Replaced infile with filep in the argument list, for
+	      packed forcing files.
+  2026-Oct-18 The forcing read and MTCLIM are timed by the phase
+	      profiler (PHASE_PROFILE).
 **********************************************************************/
 {
-  extern option_struct       options;
-  extern param_set_struct    param_set;
-  extern global_param_struct global_param;
-  extern int                 NR, NF;
+  extern THREAD_LOCAL option_struct       options;
+  extern THREAD_LOCAL param_set_struct    param_set;
+  extern THREAD_LOCAL global_param_struct global_param;
+  extern THREAD_LOCAL int                 NR, NF;
 
   int     i;
   int     j;
@@ -171,6 +175,7 @@ void initialize_atmos(atmos_data_struct        *atmos,
   double *Tfactor;
   char   *AboveTreeLine;
   double  min_Tfactor;
+  double  phase;
   double  shortwave;
   double  svp_tair;
   double *hourlyrad;
@@ -362,7 +367,9 @@ void initialize_atmos(atmos_data_struct        *atmos,
     read in meteorological data 
   *******************************/
 
-  forcing_data = read_forcing_data(infile, global_param, &veg_hist_data);
+  phase = phase_start();
+  forcing_data = read_forcing_data(filep, global_param, &veg_hist_data);
+  phase_end(PH_FORCING_READ, phase);
   
   fprintf(stderr,"\nRead meteorological forcing file\n");
 
@@ -951,9 +958,11 @@ void initialize_atmos(atmos_data_struct        *atmos,
     vp, MTCLIM will use them to compute the other variables
     more accurately.
   **************************************************/
+  phase = phase_start();
   mtclim_wrapper(have_dewpt, have_shortwave, hour_offset, elevation, slope,
                    aspect, ehoriz, whoriz, annual_prec, phi, Ndays_local,
                    dmy_local, prec, tmax, tmin, tskc, daily_vp, hourlyrad, fdir);
+  phase_end(PH_MTCLIM, phase);
 
   /***********************************************************
     Shortwave, part 2.
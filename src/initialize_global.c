@@ -133,10 +133,23 @@ void initialize_global() {
   2014-Mar-28 Removed DIST_PRCP option.						TJB
   2014-Apr-25 Added LAI_SRC, VEGPARAM_ALB, and ALB_SRC options.			TJB
   2014-Apr-25 Added VEGPARAM_VEGCOVER and VEGCOVER_SRC options.			TJB
+  2026-Oct-18 Added NTHREADS option.
+  2026-Oct-18 Added NPROCS option.
+  2026-Oct-18 Added CELL_SCHEDULE option.
+  2026-Oct-18 Added PREFETCH option.
+  2026-Oct-18 Added ASYNC_OUTPUT option.
+  2026-Oct-18 Added CELL_MEMORY_LIMIT option.
+  2026-Oct-18 Added STATE_SCHEDULE option.
+  2026-Oct-18 Added EXPLICIT_SOLVER option.
+  2026-Oct-18 Added SOLVER_TELEMETRY option.
+  2026-Oct-18 Added PHASE_PROFILE option.
+  2026-Oct-18 Added SOLAR_GEOM_PRECISION option.
+  2026-Oct-18 Added IMPLICIT_JACOBIAN option.
+  2026-Oct-18 Added ENERGY_WARM_START option.
 *********************************************************************/
 
-  extern option_struct options;
-  extern param_set_struct param_set;
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL param_set_struct param_set;
 
   int i, j;
 
@@ -151,12 +164,15 @@ void initialize_global() {
   options.COMPUTE_TREELINE      = FALSE;
   options.CONTINUEONERROR       = TRUE;
   options.CORRPREC              = FALSE;
+  options.ENERGY_WARM_START     = FALSE;
   options.EQUAL_AREA            = FALSE;
   options.EXP_TRANS             = TRUE;
   options.FROZEN_SOIL           = FALSE;
   options.FULL_ENERGY           = FALSE;
   options.GRND_FLUX_TYPE        = GF_410;
   options.IMPLICIT              = TRUE;
+  options.EXPLICIT_SOLVER       = ES_GAUSS_SEIDEL;
+  options.IMPLICIT_JACOBIAN     = IJ_FD;
   options.LAKES                 = FALSE;
   options.LAKE_PROFILE          = FALSE;
   options.LW_CLOUD              = LW_CLOUD_DEARDORFF;
@@ -177,6 +193,7 @@ void initialize_global() {
   options.SNOW_BAND             = 1;
   options.SNOW_DENSITY          = DENS_BRAS;
   options.SNOW_STEP             = 1;
+  options.SOLAR_GEOM_PRECISION  = 0;
   options.SPATIAL_FROST         = FALSE;
   options.SPATIAL_SNOW          = FALSE;
   options.SW_PREC_THRESH        = 0;
@@ -200,8 +217,20 @@ void initialize_global() {
   options.BINARY_STATE_FILE     = FALSE;
   options.INIT_STATE            = FALSE;
   options.SAVE_STATE            = FALSE;
+  options.STATE_SCHEDULE        = FALSE;
+  // run control options
+  options.NTHREADS              = 0;	/* 0 = not set on command line;
+					   becomes 1 if not set in the global
+					   parameter file either */
+  options.NPROCS                = 0;	/* same convention as NTHREADS */
+  options.CELL_SCHEDULE         = SCHED_FILE_ORDER;
+  options.PREFETCH              = FALSE;
+  options.CELL_MEMORY_LIMIT     = 0;
+  options.SOLVER_TELEMETRY      = FALSE;
+  options.PHASE_PROFILE         = FALSE;
   // output options
   options.ALMA_OUTPUT           = FALSE;
+  options.ASYNC_OUTPUT          = FALSE;
   options.BINARY_OUTPUT         = FALSE;
   options.COMPRESS              = FALSE;
   options.MOISTFRACT            = FALSE;
@@ -78,7 +78,7 @@ int initialize_lake (lake_var_struct   *lake,
   2013-Dec-27 Moved SPATIAL_FROST to options_struct.			TJB
 **********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   int i, k;
   int status;
   double depth;
@@ -126,8 +126,8 @@ int initialize_model_state(all_vars_struct     *all_vars,
   2014-Mar-28 Removed DIST_PRCP option.							TJB
 **********************************************************************/
 {
-  extern option_struct options;
-  extern veg_lib_struct *veg_lib;
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL veg_lib_struct *veg_lib;
 
   char     ErrStr[MAXSTRING];
   char     FIRST_VEG;
@@ -232,7 +232,8 @@ int initialize_model_state(all_vars_struct     *all_vars,
 
   if(options.INIT_STATE) {
 
-    read_initial_model_state(filep.init_state, all_vars, global_param,  
+    read_initial_model_state(filep.init_state, filep.init_state_index,
+                             all_vars, global_param,
 			     Nveg, options.SNOW_BAND, cellnum, soil_con,
 			     lake_con);
 
@@ -678,8 +679,8 @@ int update_thermal_nodes(all_vars_struct     *all_vars,
   2013-Dec-26 Removed EXCESS_ICE option.				TJB
 **********************************************************************/
 {
-  extern option_struct options;
-  extern veg_lib_struct *veg_lib;
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL veg_lib_struct *veg_lib;
   char     ErrStr[MAXSTRING];
   char     FIRST_VEG;
   int      veg, index;
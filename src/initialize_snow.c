@@ -61,7 +61,7 @@ void initialize_snow (snow_data_struct **snow,
 	      option.							TJB
 **********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   int i, j;
   int startlayer;
 
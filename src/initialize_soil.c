@@ -31,7 +31,7 @@ void initialize_soil (cell_data_struct **cell,
   2013-Dec-27 Moved SPATIAL_FROST to options_struct.			TJB
 **********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   int veg, band, lindex, frost_area;
   double tmp_moist[MAX_LAYERS];
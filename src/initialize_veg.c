@@ -27,7 +27,7 @@ void initialize_veg(veg_var_struct      **veg_var,
 
 **********************************************************************/
 {
-  extern option_struct   options;
+  extern THREAD_LOCAL option_struct   options;
 
   int i, j, k;
 
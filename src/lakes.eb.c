@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <vicNl.h>
 
@@ -1933,9 +1934,11 @@ int water_balance (lake_var_struct *lake, lake_con_struct lake_con, int dt, all_
   2013-Dec-26 Removed EXCESS_ICE option.				TJB
   2013-Dec-27 Moved SPATIAL_FROST to options_struct.			TJB
   2013-Dec-27 Removed QUICK_FS option.					TJB
+  2026-Oct-18 delta_moist and moist are now stored on the stack instead
+	      of being allocated on every call.
 **********************************************************************/
 {
-  extern option_struct   options;
+  extern THREAD_LOCAL option_struct   options;
   int isave_n;
   double d_area, d_level, d_volume;
   double inflow_volume;
@@ -1965,8 +1968,8 @@ int water_balance (lake_var_struct *lake, lake_con_struct lake_con, int dt, all_
   double Dsmax, resid_moist, liq, rel_moist;
   double *frost_fract;
   double volume_save;
-  double *delta_moist;
-  double *moist;
+  double delta_moist[MAX_LAYERS];
+  double moist[MAX_LAYERS];
   double max_newfraction;
   double depth_in_save;
 
@@ -1977,8 +1980,8 @@ int water_balance (lake_var_struct *lake, lake_con_struct lake_con, int dt, all_
 
   frost_fract = soil_con.frost_fract;
 
-  delta_moist = (double*)calloc(options.Nlayer,sizeof(double));
-  moist = (double*)calloc(options.Nlayer,sizeof(double));
+  memset(delta_moist, 0, options.Nlayer*sizeof(double));
+  memset(moist, 0, options.Nlayer*sizeof(double));
 
   /**********************************************************************
    * 1. Preliminary stuff
@@ -2373,9 +2376,6 @@ int water_balance (lake_var_struct *lake, lake_con_struct lake_con, int dt, all_
     advect_carbon_storage(lakefrac, newfraction, lake, &(cell[iveg][band]));
   }
 
-  free((char*)delta_moist);
-  free((char*)moist);
-
   return(0);
 
 }
@@ -2406,7 +2406,7 @@ void advect_soil_veg_storage(double lakefrac,
 **********************************************************************/
 {
 
-  extern option_struct   options;
+  extern THREAD_LOCAL option_struct   options;
   int lidx;
   double new_moist[MAX_LAYERS];
   double tmp_moist[MAX_LAYERS];
@@ -2525,7 +2525,7 @@ void rescale_soil_veg_fluxes(double oldfrac,
 **********************************************************************/
 {
 
-  extern option_struct   options;
+  extern THREAD_LOCAL option_struct   options;
   int lidx;
 
   if (newfrac < SMALL) {
@@ -2760,7 +2760,7 @@ void advect_carbon_storage(double lakefrac,
 **********************************************************************/
 {
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   int i,k;
 
   if (newfraction > lakefrac) { // lake grew, wetland shrank
@@ -4,7 +4,8 @@
  
 static char vcid[] = "$Id$";
 
-all_vars_struct make_all_vars(int  nveg)
+all_vars_struct make_all_vars(int                nveg,
+                              cell_arena_struct *arena)
 /**********************************************************************
 	read_all_vars	Keith Cherkauer		May 21, 1996
 
@@ -19,19 +20,22 @@ all_vars_struct make_all_vars(int  nveg)
   2006-Nov-07 Removed LAKE_MODEL option.  TJB
   2009-Jul-31 Removed extra lake/wetland tile.			TJB
   2014-Mar-28 Removed DIST_PRCP option.					TJB
+  2026-Oct-18 The structures are now allocated from the cell's arena,
+	      which is reset at the end of the cell; removed
+	      free_all_vars().
 **********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   all_vars_struct temp;
   int              Nitems;
 
   Nitems = nveg + 1;
 
-  temp.snow   = make_snow_data(Nitems);
-  temp.energy = make_energy_bal(Nitems);
-  temp.veg_var  = make_veg_var(Nitems);
-  temp.cell     = make_cell_data(Nitems,options.Nlayer);
+  temp.snow   = make_snow_data(Nitems, arena);
+  temp.energy = make_energy_bal(Nitems, arena);
+  temp.veg_var  = make_veg_var(Nitems, arena);
+  temp.cell     = make_cell_data(Nitems,options.Nlayer, arena);
 
   return (temp);
 
@@ -4,24 +4,27 @@
  
 static char vcid[] = "$Id$";
 
-cell_data_struct **make_cell_data(int veg_type_num, int Nlayer)
+cell_data_struct **make_cell_data(int veg_type_num, int Nlayer,
+                                  cell_arena_struct *arena)
 /**********************************************************************
 	make_cell_data	Keith Cherkauer		July 9, 1997
 
   This subroutine makes an array of type cell, which contains soil
   column variables for a single grid cell.
 
+  Modifications:
+  2026-Oct-18 Allocated from the cell's arena.
 **********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   int i;
   cell_data_struct **temp;
 
-  temp = (cell_data_struct**) calloc(veg_type_num, 
+  temp = (cell_data_struct**) arena_calloc(arena, veg_type_num, 
                                   sizeof(cell_data_struct*));
   for(i=0;i<veg_type_num;i++) {
-    temp[i] = (cell_data_struct*) calloc(options.SNOW_BAND, 
+    temp[i] = (cell_data_struct*) arena_calloc(arena, options.SNOW_BAND, 
 					 sizeof(cell_data_struct));
 /*     for(j=0;j<options.SNOW_BAND;j++) { */
 /*       temp[i][j].layer  */
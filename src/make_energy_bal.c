@@ -4,7 +4,7 @@
  
 static char vcid[] = "$Id$";
 
-energy_bal_struct **make_energy_bal(int nveg)
+energy_bal_struct **make_energy_bal(int nveg, cell_arena_struct *arena)
 /**********************************************************************
 	make_energy_bal	Keith Cherkauer		May 26, 1996
 
@@ -15,20 +15,20 @@ energy_bal_struct **make_energy_bal(int nveg)
   01-Nov-04 Removed modification of Nnodes, as this was preventing
 	    correct reading/writing of state files for QUICK_FLUX
 	    =TRUE.						TJB
-
+  2026-Oct-18 Allocated from the cell's arena.
 **********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   int i, j;
   energy_bal_struct **temp;
 
-  temp = (energy_bal_struct**) calloc(nveg, 
+  temp = (energy_bal_struct**) arena_calloc(arena, nveg, 
 				      sizeof(energy_bal_struct*));
 
   /** Initialize all records to unfrozen conditions */
   for(i = 0; i < nveg; i++) {
-    temp[i] = (energy_bal_struct*) calloc(options.SNOW_BAND, 
+    temp[i] = (energy_bal_struct*) arena_calloc(arena, options.SNOW_BAND, 
 					  sizeof(energy_bal_struct));
     for(j = 0; j < options.SNOW_BAND; j++) {
       temp[i][j].frozen = FALSE;
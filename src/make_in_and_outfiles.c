@@ -33,15 +33,26 @@ void make_in_and_outfiles(filep_struct         *filep,
 	      in global parameter file.					TJB
   2011-May-25 Expanded latchar, lngchar, and junk allocations to handle
 	      GRID_DECIMAL > 4.						TJB
+  2026-Oct-18 For packed forcing files (FORCE_FORMAT PACKED), the cell
+	      is looked up in the packed file's index instead of opening
+	      a forcing file; filep->forcing[] is then NULL.  The second
+	      forcing file is now opened according to its own
+	      FORCE_FORMAT rather than that of the first.
+  2026-Oct-18 Output files are written through a gzip stream, with
+	      ".gz" appended to their names, if their compression (or
+	      else the COMPRESS option) asks for it.
 
 **********************************************************************/
 {
-  extern option_struct    options;
-  extern param_set_struct param_set;
+  extern THREAD_LOCAL option_struct    options;
+  extern THREAD_LOCAL param_set_struct param_set;
   extern FILE *open_file(char string[], char type[]);
 
   char   latchar[20], lngchar[20], junk[6];
+  char   ErrStr[MAXSTRING];
   int filenum;
+  int file_num;
+  int compress;
 
   sprintf(junk, "%%.%if", options.GRID_DECIMAL);
   sprintf(latchar, junk, soil->lat);
@@ -51,25 +62,27 @@ void make_in_and_outfiles(filep_struct         *filep,
   Input Forcing Files
   ********************************/
 
-  strcpy(filenames->forcing[0], filenames->f_path_pfx[0]);
-  strcat(filenames->forcing[0], latchar);
-  strcat(filenames->forcing[0], "_");
-  strcat(filenames->forcing[0], lngchar);
-  if(param_set.FORCE_FORMAT[0] == BINARY)
-    filep->forcing[0] = open_file(filenames->forcing[0], "rb");
-  else
-    filep->forcing[0] = open_file(filenames->forcing[0], "r");
-
   filep->forcing[1] = NULL;
-  if(strcasecmp(filenames->f_path_pfx[1],"MISSING")!=0) {
-    strcpy(filenames->forcing[1], filenames->f_path_pfx[1]);
-    strcat(filenames->forcing[1], latchar);
-    strcat(filenames->forcing[1], "_");
-    strcat(filenames->forcing[1], lngchar);
-    if(param_set.FORCE_FORMAT[0] == BINARY) 
-      filep->forcing[1] = open_file(filenames->forcing[1], "rb");
-    else 
-      filep->forcing[1] = open_file(filenames->forcing[1], "r");
+  for (file_num = 0; file_num < 2; file_num++) {
+    if (file_num == 1 && strcasecmp(filenames->f_path_pfx[1],"MISSING") == 0)
+      break;
+    if(param_set.FORCE_FORMAT[file_num] == PACKED) {
+      /* all cells are in one file, opened by check_files() */
+      strcpy(filenames->forcing[file_num], filenames->f_path_pfx[file_num]);
+      filep->forcing[file_num] = NULL;
+      filep->forcing_cell[file_num]
+        = find_forcing_pack_cell(filep->forcing_pack[file_num],
+                                 soil->gridcel, soil->lat, soil->lng);
+      continue;
+    }
+    strcpy(filenames->forcing[file_num], filenames->f_path_pfx[file_num]);
+    strcat(filenames->forcing[file_num], latchar);
+    strcat(filenames->forcing[file_num], "_");
+    strcat(filenames->forcing[file_num], lngchar);
+    if(param_set.FORCE_FORMAT[file_num] == BINARY)
+      filep->forcing[file_num] = open_file(filenames->forcing[file_num], "rb");
+    else
+      filep->forcing[file_num] = open_file(filenames->forcing[file_num], "r");
   }
 
   /********************************
@@ -84,7 +97,23 @@ void make_in_and_outfiles(filep_struct         *filep,
     strcat(out_data_files[filenum].filename, latchar);
     strcat(out_data_files[filenum].filename, "_");
     strcat(out_data_files[filenum].filename, lngchar);
-    if(options.BINARY_OUTPUT)
+    compress = out_data_files[filenum].compress;
+    if (compress == OUT_COMPRESS_DEFAULT)
+      compress = options.COMPRESS ? OUT_COMPRESS_GZIP : OUT_COMPRESS_NONE;
+    if (compress != OUT_COMPRESS_NONE) {
+      /* compressed as it is written; no uncompressed copy is made */
+      strcat(out_data_files[filenum].filename, ".gz");
+      out_data_files[filenum].fh
+        = open_gzip_file(out_data_files[filenum].filename,
+                         options.BINARY_OUTPUT ? "wb" : "w",
+                         compress == OUT_COMPRESS_GZIP_FAST ? 1 : 6);
+      if (out_data_files[filenum].fh == NULL) {
+        snprintf(ErrStr, sizeof(ErrStr), "Unable to open output file \"%.1000s\".",
+                 out_data_files[filenum].filename);
+        nrerror(ErrStr);
+      }
+    }
+    else if(options.BINARY_OUTPUT)
       out_data_files[filenum].fh = open_file(out_data_files[filenum].filename, "wb");
     else out_data_files[filenum].fh = open_file(out_data_files[filenum].filename, "w");
   }
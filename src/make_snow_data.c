@@ -4,7 +4,7 @@
  
 static char vcid[] = "$Id$";
 
-snow_data_struct **make_snow_data(int nveg)
+snow_data_struct **make_snow_data(int nveg, cell_arena_struct *arena)
 /**********************************************************************
 	make_snow_data	Keith Cherkauer		January 22, 1997
 
@@ -15,19 +15,19 @@ snow_data_struct **make_snow_data(int nveg)
   07-09-98 modified to make te make a two dimensional array which 
            also accounts for a variable number of snow elevation
            bands                                               KAC
-
+  2026-Oct-18 Allocated from the cell's arena.
 **********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   int                i;
   snow_data_struct **temp;
 
-  temp = (snow_data_struct **) calloc(nveg, 
+  temp = (snow_data_struct **) arena_calloc(arena, nveg, 
 				      sizeof(snow_data_struct *));
 
   for(i=0;i<nveg;i++) {
-    temp[i] = (snow_data_struct *) calloc(options.SNOW_BAND, 
+    temp[i] = (snow_data_struct *) arena_calloc(arena, options.SNOW_BAND, 
 					  sizeof(snow_data_struct));
   }
     
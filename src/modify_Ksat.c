@@ -51,7 +51,7 @@ double modify_Ksat(double Temp) {
 
 **********************************************************************/
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   double Factor;
 
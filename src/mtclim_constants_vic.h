@@ -25,6 +25,8 @@ Sat Aug 21 16:58:43 1999
   2011-Nov-04 Updated to MTCLIM 4.3				TJB
   2012-Feb-16 Removed calc_srad_humidity().			TJB
   2013-Jul-25 Added data->s_fdir.				TJB
+  2026-Oct-18 Added solar_geom_struct, get_solar_geometry() and
+	      release_solar_geometry().
 
 */
 
@@ -111,6 +113,44 @@ typedef struct
   /* end vic_change */
 } data_struct;
 
+/* start vic_change */
+/* solar geometry of a site, shared by the cells with the same latitude,
+   slope, aspect and horizons (see solar_geometry.c); yearday 366 is the
+   same as yearday 365 */
+typedef struct solar_geom_struct
+{
+  double lat;                  /* site latitude, dec. degrees */
+  double slp;                  /* site slope, degrees */
+  double asp;                  /* site aspect, degrees */
+  double ehoriz;               /* site east horizon, degrees */
+  double whoriz;               /* site west horizon, degrees */
+  double daylength[366];       /* daylength, seconds */
+  double flat_potrad[366];     /* daylight average potential radiation on a
+				  flat surface, W/m2 */
+  double slope_potrad[366];    /* daylight average potential radiation on
+				  the slope, W/m2 */
+  double sum_flat_potrad[366]; /* daily total potential radiation on a flat
+				  surface, J/m2 */
+  int radfract_first[366];     /* first SRADDT step of the day with potential
+				  radiation */
+  int radfract_start[366];     /* index in radfract of that step */
+  int radfract_n[366];         /* number of steps from the first to the last
+				  step with potential radiation */
+  double *radfract;            /* fraction of the day's potential radiation in
+				  each of those steps */
+  int trans_start[366];        /* index in am and dir_flat_topa of the day's
+				  first sunlit step */
+  int trans_n[366];            /* number of sunlit steps of the day */
+  double *am;                  /* optical air mass of each sunlit step */
+  double *dir_flat_topa;       /* potential radiation on a flat surface at
+				  the top of the atmosphere in each sunlit
+				  step, J/m2 */
+  int Nusers;                  /* number of cells using the site */
+  long last_used;              /* when a cell last asked for the site */
+  struct solar_geom_struct *next;
+} solar_geom_struct;
+/* end vic_change */
+
 /********************************
  **                             **
  **    FUNCTION PROTOTYPES      **
@@ -123,9 +163,12 @@ int calc_prcp(const control_struct *ctrl, const parameter_struct *p,
 /* start vic_change */
 int calc_srad_humidity_iterative(const control_struct *ctrl,
 				 const parameter_struct *p, data_struct *data,
-				 double **tiny_radfract);
+				 const solar_geom_struct *geom);
 int snowpack(const control_struct *ctrl, const parameter_struct *p, 
 	      data_struct *data);
+solar_geom_struct *get_solar_geometry(double lat, double slope, double aspect,
+				      double ehoriz, double whoriz);
+void release_solar_geometry(solar_geom_struct *geom);
 void compute_srad_humidity_onetime(int ndays, const control_struct *ctrl, data_struct *data, double *tdew, double *pva, double *ttmax0, double *flat_potrad, double *slope_potrad, double sky_prop, double *daylength, double *pet, double *parray, double pa, double *dtr);
 /* end vic_change */
 int data_alloc(const control_struct *ctrl, data_struct *data);
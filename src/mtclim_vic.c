@@ -49,6 +49,11 @@
   2013-Jul-19 Fixed bug in shortwave computation for case when daily shortwave
 	      is supplied by the user.						HFC via TJB
   2013-Jul-25 Added data->s_fdir.						TJB
+  2026-Oct-18 calc_srad_humidity_iterative() takes the solar geometry of the
+	      site (daylength, potential radiation and the optical air mass of
+	      each sunlit time step) from get_solar_geometry(), which caches it
+	      for all cells with the same site, instead of computing it and
+	      tiny_radfract for each cell.
 */
 
 /*
@@ -534,12 +539,12 @@ int snowpack(const control_struct *ctrl, const parameter_struct *p,
 /* Note: too many changes to maintain the start/end vic change comments */
 int calc_srad_humidity_iterative(const control_struct *ctrl,
 				 const parameter_struct *p, data_struct *data,
-				 double **tiny_radfract)
+				 const solar_geom_struct *geom)
 {
   int ok=1;
   int i,j,ndays;
   int start_yday,end_yday,isloop;
-  int ami,yday;
+  int yday;
   double ttmax0[366];
   double flat_potrad[366];
   double slope_potrad[366];
@@ -552,15 +557,7 @@ int calc_srad_humidity_iterative(const control_struct *ctrl,
   double tmax,tmin;
   double t1,t2;
   double pratio;
-  double lat,coslat,sinlat,dt,h,dh;
-  double cosslp,sinslp,cosasp,sinasp;
-  double bsg1,bsg2,bsg3;
-  double decl,cosdecl,sindecl,cosegeom,sinegeom,coshss,hss;
-  double sc,dir_beam_topa;
-  double sum_flat_potrad,sum_slope_potrad,sum_trans;
-  double cosh,sinh;
-  double cza,cbsa,coszeh,coszwh;
-  double dir_flat_topa,am;
+  double sum_trans;
   double t_tmax,b;
   double tmink,ratio,ratio2,ratio3,tdewk;
   double pvs,vpd;
@@ -572,14 +569,8 @@ int calc_srad_humidity_iterative(const control_struct *ctrl,
   double horizon_scalar, slope_scalar;
   int update_pva;
 
-  /* optical airmass by degrees */
-  double optam[21] = {2.90,3.05,3.21,3.39,3.69,3.82,4.07,4.37,4.72,5.12,5.60,
-		      6.18,6.88,7.77,8.90,10.39,12.44,15.36,19.79,26.96,30.00};
-  
   /* start vic_change */
-  int tinystep;
-  int tinystepspday;
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   double tfmax_tmp;
   /* end vic_change */
   
@@ -759,176 +750,35 @@ int calc_srad_humidity_iterative(const control_struct *ctrl,
   trans1 = pow(TBASE,pratio);
   
   /* STEP (3) build 366-day array of ttmax0, potential rad, and daylength */
-  
-  /* precalculate the transcendentals */
-  lat = p->site_lat;
-  /* check for (+/-) 90 degrees latitude, throws off daylength calc */
-  lat *= RADPERDEG;
-  if (lat > 1.5707) 
-    lat = 1.5707;
-  if (lat < -1.5707) 
-    lat = -1.5707;
-  coslat = cos(lat);
-  sinlat = sin(lat);
-  cosslp = cos(p->site_slp * RADPERDEG);
-  sinslp = sin(p->site_slp * RADPERDEG);
-  cosasp = cos(p->site_asp * RADPERDEG);
-  sinasp = sin(p->site_asp * RADPERDEG);
-  /* cosine of zenith angle for east and west horizons */
-  coszeh = cos(1.570796 - (p->site_ehoriz * RADPERDEG));
-  coszwh = cos(1.570796 - (p->site_whoriz * RADPERDEG));
-  
-  /* sub-daily time and angular increment information */
-  dt = SRADDT;                /* set timestep */ 
-  dh = dt / SECPERRAD;        /* calculate hour-angle step */
-  /* start vic_change */
-  tinystepspday = 86400/SRADDT;
-  /* end vic_change */
 
-  /* begin loop through yeardays */
-  for (i=0 ; i<365 ; i++) {
-    /* calculate cos and sin of declination */
-    decl = MINDECL * cos(((double)i + DAYSOFF) * RADPERDAY);
-    cosdecl = cos(decl);
-    sindecl = sin(decl);
-    
-    /* do some precalculations for beam-slope geometry (bsg) */
-    bsg1 = -sinslp * sinasp * cosdecl;
-    bsg2 = (-cosasp * sinslp * sinlat + cosslp * coslat) * cosdecl;
-    bsg3 = (cosasp * sinslp * coslat + cosslp * sinlat) * sindecl;
-    
-    /* calculate daylength as a function of lat and decl */
-    cosegeom = coslat * cosdecl;
-    sinegeom = sinlat * sindecl;
-    coshss = -(sinegeom) / cosegeom;
-    if (coshss < -1.0) 
-      coshss = -1.0;  /* 24-hr daylight */
-    if (coshss > 1.0) 
-      coshss = 1.0;    /* 0-hr daylight */
-    hss = acos(coshss);                /* hour angle at sunset (radians) */
-    /* daylength (seconds) */
-    daylength[i] = 2.0 * hss * SECPERRAD;
-    
-    /* start vic_change */
-    if (daylength[i] > 86400)
-      daylength[i] = 86400;
-    /* end vic_change */
-    
-    /* solar constant as a function of yearday (W/m^2) */
-    sc = 1368.0 + 45.5*sin((2.0*PI*(double)i/365.25) + 1.7);
-    /* extraterrestrial radiation perpendicular to beam, total over
-       the timestep (J) */
-    dir_beam_topa = sc * dt;
-    
+  /* start vic_change */
+  /* the solar geometry of the site, which does not depend on the cell's
+     elevation, comes from get_solar_geometry(); only the transmittance
+     is summed here, over the sunlit time steps of each day */
+  for (i=0 ; i<366 ; i++) {
     sum_trans = 0.0;
-    sum_flat_potrad = 0.0;
-    sum_slope_potrad = 0.0;
-    
-    /* begin sub-daily hour-angle loop, from -hss to hss */
-    for (h=-hss ; h<hss ; h+=dh) {
-      /* precalculate cos and sin of hour angle */
-      cosh = cos(h);
-      sinh = sin(h);
-      
-      /* calculate cosine of solar zenith angle */
-      cza = cosegeom * cosh + sinegeom;
-      
-      /* calculate cosine of beam-slope angle */
-      cbsa = sinh * bsg1 + cosh * bsg2 + bsg3;
-      
-      /* check if sun is above a flat horizon */
-      if (cza > 0.0) {
-	/* when sun is above the ideal (flat) horizon, do all the
-	   flat-surface calculations to determine daily total
-	   transmittance, and save flat-surface potential radiation
-	   for later calculations of diffuse radiation */
-	
-	/* potential radiation for this time period, flat surface,
-	   top of atmosphere */
-	dir_flat_topa = dir_beam_topa * cza;
-	
-	/* determine optical air mass */
-	am = 1.0/(cza + 0.0000001);
-	if (am > 2.9) {
-	  ami = (int)(acos(cza)/RADPERDEG) - 69;
-	  if (ami < 0) 
-	    ami = 0;
-	  if (ami > 20) 
-	    ami = 20;
-	  am = optam[ami];
-	}
-	
-	/* correct instantaneous transmittance for this optical
-	   air mass */
-	trans2 = pow(trans1,am);
-	
-	/* instantaneous transmittance is weighted by potential
-	   radiation for flat surface at top of atmosphere to get
-	   daily total transmittance */
-	sum_trans += trans2 * dir_flat_topa;
-	
-	/* keep track of total potential radiation on a flat
-	   surface for ideal horizons */
-	sum_flat_potrad += dir_flat_topa;
-	
-	/* keep track of whether this time step contributes to
-	   component 1 (direct on slope) */
-	if ((h<0.0 && cza>coszeh && cbsa>0.0) ||
-	    (h>=0.0 && cza>coszwh && cbsa>0.0)) {
-	  
-	  /* sun between east and west horizons, and direct on
-	     slope. this period contributes to component 1 */
-	  sum_slope_potrad += dir_beam_topa * cbsa;
-	}
-	
-      } /* end if sun above ideal horizon */
-      else dir_flat_topa = -1;
-
-      /* start vic_change */
-      tinystep = (12L * 3600L + h * SECPERRAD)/SRADDT;
-      if (tinystep < 0)
-	tinystep = 0;
-      if (tinystep > tinystepspday-1)
-	tinystep = tinystepspday-1;
-      if (dir_flat_topa > 0)
-	tiny_radfract[i][tinystep] = dir_flat_topa;
-      else
-	tiny_radfract[i][tinystep] = 0;
-      /* end vic_change */
-      
-    } /* end of sub-daily hour-angle loop */
-    
-    /* start vic_change */
-    if (daylength[i] && sum_flat_potrad > 0) {
-      for (j = 0; j < tinystepspday; j++)
-	tiny_radfract[i][j] /= sum_flat_potrad;
+    for (j = geom->trans_start[i];
+         j < geom->trans_start[i] + geom->trans_n[i]; j++) {
+      /* correct instantaneous transmittance for this optical
+	 air mass */
+      trans2 = pow(trans1,geom->am[j]);
+
+      /* instantaneous transmittance is weighted by potential
+	 radiation for flat surface at top of atmosphere to get
+	 daily total transmittance */
+      sum_trans += trans2 * geom->dir_flat_topa[j];
     }
-    /* end vic_change */
 
     /* calculate maximum daily total transmittance and daylight average
        flux density for a flat surface and the slope */
-    if (daylength[i]) {
-      ttmax0[i] = sum_trans / sum_flat_potrad;
-      flat_potrad[i] = sum_flat_potrad / daylength[i];
-      slope_potrad[i] = sum_slope_potrad / daylength[i];
-    }
-    else {
+    if (geom->daylength[i])
+      ttmax0[i] = sum_trans / geom->sum_flat_potrad[i];
+    else
       ttmax0[i] = 0.0;
-      flat_potrad[i] = 0.0;
-      slope_potrad[i] = 0.0;
-    }
-
-  } /* end of i=365 days loop */
-  
-  /* force yearday 366 = yearday 365 */
-  ttmax0[365] = ttmax0[364];
-  flat_potrad[365] = flat_potrad[364];
-  slope_potrad[365] = slope_potrad[364];
-  daylength[365] = daylength[364];
-  
-  /* start vic_change */
-  for (j = 0 ; j < tinystepspday; j++)
-    tiny_radfract[365][j] = tiny_radfract[364][j];
+    flat_potrad[i] = geom->flat_potrad[i];
+    slope_potrad[i] = geom->slope_potrad[i];
+    daylength[i] = geom->daylength[i];
+  }
   /* end vic_change */
 
   /* STEP (4)  calculate the sky proportion for diffuse radiation */
@@ -1097,7 +947,7 @@ int calc_srad_humidity_iterative(const control_struct *ctrl,
 /* New function, not originally part of MTCLIM code */
 void compute_srad_humidity_onetime(int ndays, const control_struct *ctrl, data_struct *data, double *tdew, double *pva, double *ttmax0, double *flat_potrad, double *slope_potrad, double sky_prop, double *daylength, double *pet, double *parray, double pa, double *dtr) {
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   int i;
   int yday;
   double t_tmax;
@@ -31,6 +31,9 @@
   2013-Jul-19 Fixed bug in shortwave computation for case when daily shortwave
 	      is supplied by the user.					HFC via TJB
   2013-Jul-25 Added data->s_fdir.					TJB
+  2026-Oct-18 Replaced the tiny_radfract array, allocated and computed for
+	      each cell, with the solar geometry of the site, which
+	      get_solar_geometry() caches for all cells with the same site.
 
 *******************************************************************************/
 /******************************************************************************/
@@ -57,12 +60,12 @@ void mtclim_init(int have_dewpt, int have_shortwave, double elevation, double sl
                    double ehoriz, double whoriz, double annual_prcp, 
 		   double lat, int Ndays, dmy_struct *dmy, 
 		   double *prec, double *tmax, double *tmin, double *vp, double *hourlyrad, 
-		   double **tiny_radfract, control_struct *ctrl, 
+		   control_struct *ctrl, 
 		   parameter_struct *p, data_struct *mtclim_data); 
 
 void mtclim_to_vic(double hour_offset, 
 		     int Ndays, dmy_struct *dmy, 
-		     double **tiny_radfract, control_struct *ctrl, 
+		     const solar_geom_struct *geom, control_struct *ctrl, 
 		     data_struct *mtclim_data, double *tskc, double *vp, 
 		     double *hourlyrad, double *fdir);
 
@@ -78,32 +81,24 @@ void mtclim_wrapper(int have_dewpt, int have_shortwave, double hour_offset,
 
   Modifications:
   2012-Feb-16 Cleaned up commented code.					TJB
+  2026-Oct-18 Takes the solar geometry of the site from
+	      get_solar_geometry().
 ******************************************************************************/
 {
   control_struct ctrl;
   parameter_struct p;
   data_struct mtclim_data;
-  double **tiny_radfract;
-  int i;
-
-  /* allocate space for the tiny_radfract array */
-  tiny_radfract = (double **) calloc(366, sizeof(double*));
-  if (tiny_radfract == NULL) {
-    nrerror("Memory allocation error in mtclim_init() ...\n");
-  }
-  for (i=0; i<366; i++) {
-    tiny_radfract[i] = (double *) calloc(86400, sizeof(double));
-    if (tiny_radfract[i] == NULL) {
-      nrerror("Memory allocation error in mtclim_init() ...\n");
-    }
-  }
+  solar_geom_struct *geom;
 
   /* initialize the mtclim data structures */ 
   mtclim_init(have_dewpt, have_shortwave, elevation, slope, aspect, ehoriz, whoriz,
                 annual_prcp, lat, Ndays, dmy, prec,
-		tmax, tmin, vp, hourlyrad, tiny_radfract, &ctrl, &p,
+		tmax, tmin, vp, hourlyrad, &ctrl, &p,
 		&mtclim_data);  
 
+  /* get the solar geometry of the site */
+  geom = get_solar_geometry(lat, slope, aspect, ehoriz, whoriz);
+
   /* calculate daily air temperatures */
   if (calc_tair(&ctrl, &p, &mtclim_data)) {
     nrerror("Error in calc_tair()... exiting\n");
@@ -120,34 +115,30 @@ void mtclim_wrapper(int have_dewpt, int have_shortwave, double hour_offset,
   }
   
   /* calculate srad and humidity with iterative algorithm */
-  if (calc_srad_humidity_iterative(&ctrl, &p, &mtclim_data, tiny_radfract)) { 
+  if (calc_srad_humidity_iterative(&ctrl, &p, &mtclim_data, geom)) { 
     nrerror("Error in calc_srad_humidity_iterative()... exiting\n");
   }
 
   /* translate the mtclim structures back to the VIC data structures */
   mtclim_to_vic(hour_offset, Ndays,
-		  dmy, tiny_radfract, &ctrl,&mtclim_data, tskc, vp,
+		  dmy, geom, &ctrl,&mtclim_data, tskc, vp,
 		  hourlyrad, fdir);
 
   /* clean up */
   if (data_free(&ctrl, &mtclim_data)) {
     nrerror("Error in data_free()... exiting\n");
   }
-  for (i=0; i<366; i++) {
-    free(tiny_radfract[i]);
-  }
-  free(tiny_radfract);
+  release_solar_geometry(geom);
 }
   
 void mtclim_init(int have_dewpt, int have_shortwave, double elevation, double slope, double aspect,
                    double ehoriz, double whoriz, double annual_prcp, 
 		   double lat, int Ndays, dmy_struct *dmy, 
 		   double *prec, double *tmax, double *tmin, double *vp, double *hourlyrad, 
-		   double **tiny_radfract, control_struct *ctrl, 
+		   control_struct *ctrl, 
 		   parameter_struct *p, data_struct *mtclim_data)
 {
   int i,j;
-  int tinystepspday;
 
   /* initialize the control structure */
 
@@ -208,17 +199,25 @@ void mtclim_init(int have_dewpt, int have_shortwave, double elevation, double sl
     if (have_dewpt==1)
       nrerror("have_dewpt not yet implemented ...\n");
   }
-  tinystepspday = 86400/SRADDT;
-  for (i = 0; i < 366; i++) {
-    for (j = 0; j < tinystepspday; j++) {
-      tiny_radfract[i][j] = 0;
-    }
-  }
+}
+
+static double radfract(const solar_geom_struct *geom,
+		       int                      yday,
+		       int                      tinystep)
+/******************************************************************************
+  radfract: fraction of the potential radiation of yearday yday (0-365) that
+  falls in SRADDT step tinystep of the day.
+******************************************************************************/
+{
+  tinystep -= geom->radfract_first[yday];
+  if (tinystep < 0 || tinystep >= geom->radfract_n[yday])
+    return 0;
+  return geom->radfract[geom->radfract_start[yday] + tinystep];
 }
 
 void mtclim_to_vic(double hour_offset, 
 		     int Ndays, dmy_struct *dmy, 
-		     double **tiny_radfract, control_struct *ctrl, 
+		     const solar_geom_struct *geom, control_struct *ctrl, 
 		     data_struct *mtclim_data, double *tskc, double *vp, 
 		     double *hourlyrad, double *fdir)
 /******************************************************************************
@@ -227,6 +226,7 @@ void mtclim_to_vic(double hour_offset,
   Modifications:
   2012-Feb-16 Removed check on mtclim_data->insw for storing tinyradfract data
 	      in hourlyrad array.						TJB
+  2026-Oct-18 Takes tiny_radfract from the solar geometry of the site.
 ******************************************************************************/
 {
   int i,j,k;
@@ -264,7 +264,8 @@ void mtclim_to_vic(double hour_offset,
         if (tinystep > 24*tinystepsphour-1) {
           tinystep -= 24*tinystepsphour; 
         }
-        hourlyrad[i*24+j] += tiny_radfract[dmy[i*24+j].day_in_year-1][tinystep];
+        hourlyrad[i*24+j] += radfract(geom, dmy[i*24+j].day_in_year-1,
+				      tinystep);
       }
       hourlyrad[i*24+j] *= tmp_rad;
     }
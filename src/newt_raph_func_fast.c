@@ -13,7 +13,7 @@
 #define RELAX3   0.2
 
 int newt_raph(void (*vecfunc)(double x[], double fvec[], int n, int init, ...), 
-               double x[], int n)
+               double x[], int n, int analytic_jac)
 {
 
 /******************************************************************
@@ -30,13 +30,24 @@ int newt_raph(void (*vecfunc)(double x[], double fvec[], int n, int init, ...),
   2012-Jan-28 Replaced local precompile variable MAXSIZE with VIC's
 	      MAX_NODES so that array lengths here are always in sync
 	      with array lengths in the rest of VIC.			TJB 
+  2026-Oct-18 Added analytic_jac.  If it is TRUE, vecfunc supplies the
+	      tridiagonal Jacobian itself (when called with init = 2)
+	      instead of it being approximated by fdjac3(), which costs
+	      n evaluations of vecfunc per trial.  fdjac3() is still
+	      used in trials in which vecfunc cannot supply the
+	      Jacobian.
+  2026-Oct-18 Each call is recorded in the solver telemetry
+	      (SOLVER_TELEMETRY), with its number of trials.
 ******************************************************************/
 
   int k, i, index[MAX_NODES], Error;
+  int valid;
   double errx, errf, d, fvec[MAX_NODES], fjac[MAX_NODES*MAX_NODES], p[MAX_NODES];
   double a[MAX_NODES], b[MAX_NODES], c[MAX_NODES];
+  double start;
 
   Error = 0;
+  start = solver_call_start();
 
   for (k=0; k<MAXTRIAL; k++) {
 
@@ -48,11 +59,16 @@ int newt_raph(void (*vecfunc)(double x[], double fvec[], int n, int init, ...),
     for (i=0; i<n; i++) errf+=fabs(fvec[i]);
     if (errf<=TOLF) {
       //fprintf(stderr, "Number of Newton-Raphson trials (F criterium with F error = %g): %d\n", errf, k);
+      solver_call_end(ST_NEWT_RAPH, start, k+1, 0, Error);
       return (Error);
     }
     
-    // calculate the Jacobian
-    fdjac3(x, fvec, a, b, c, vecfunc, n);
+    // calculate the Jacobian, analytically if vecfunc can
+    valid = FALSE;
+    if (analytic_jac)
+      (*vecfunc)(x, fvec, n, 2, a, b, c, &valid);
+    if (!valid)
+      fdjac3(x, fvec, a, b, c, vecfunc, n);
 
     for (i=0; i<n; i++) p[i]=-fvec[i];
 
@@ -74,6 +90,7 @@ int newt_raph(void (*vecfunc)(double x[], double fvec[], int n, int init, ...),
     // stop if TOLX is satisfied
     if (errx<=TOLX) {
       //fprintf(stderr, "Number of Newton-Raphson trials (x criterium with F error = %g): %d\n", errf, k);
+      solver_call_end(ST_NEWT_RAPH, start, k+1, 0, Error);
       return (Error);
     }
   }
@@ -86,6 +103,7 @@ int newt_raph(void (*vecfunc)(double x[], double fvec[], int n, int init, ...),
 #endif
   //vicerror("");
 
+  solver_call_end(ST_NEWT_RAPH, start, MAXTRIAL, 0, Error);
   return (Error);
 }
 
@@ -29,13 +29,17 @@ FILE *open_file(char string[],char type[])
 /******************************************************************/
 /* 30-Oct-03 Added message announcing the opening of files when type
 	     is "rb".						TJB
+   2026-Oct-18 If only <string>.gz exists, it is now decompressed as it
+	     is read, in memory, instead of being unzipped on disk with
+	     "gzip -d"; this only applies to "r" and "rb".  Compressed
+	     inputs are thus read from read-only directories, and left
+	     as they are.
  ******************************************************************/
 
 {
 
   FILE *stream;
   char zipname[MAXSTRING],
-       command[MAXSTRING],
        jnkstr[MAXSTRING];
   int  temp, headcnt, i;
 
@@ -50,27 +54,17 @@ FILE *open_file(char string[],char type[])
     /** Check if file is compressed **/
     strcpy(zipname,string);
     strcat(zipname,".gz");
-    stream = fopen(zipname,type);
+    if (strcmp(type,"r") == 0 || strcmp(type,"rb") == 0)
+      stream = open_gzip_file(zipname, type, 0);
     if (stream == NULL) {
       fprintf(stderr,"\n Error opening \"%s\".",string);
       fprintf(stderr,"\n");
       nrerror("Unable to open File");
     }
-    fclose(stream);
 
-    /** uncompress and open zipped file **/
 #if VERBOSE
-    fprintf(stderr,"unzipping \"%s\".",string);
+    fprintf(stderr,"\n decompressing \"%s\" while reading it.",zipname);
 #endif
-
-    sprintf(command,"gzip -d %s",zipname);
-    system(command);
-    stream = fopen(string,type);
-    if (stream == NULL) {
-      fprintf(stderr,"\n Error opening \"%s\".",string);
-      fprintf(stderr,"\n");
-      nrerror("Unable to Open File");
-    }
   }
 
 #if VERBOSE
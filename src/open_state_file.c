@@ -24,14 +24,20 @@ FILE *open_state_file(global_param_struct *global,
              to ...sizeof, 1,... GCT
   2006-Oct-16 Merged infiles and outfiles structs into filep_struct;
 	      This included moving global->statename to filenames->statefile. TJB
+  2026-Oct-18 With STATE_SCHEDULE, writes the header of a multi-snapshot
+	      state file, which lists the dates of all snapshots.
 
 *********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   FILE   *statefile;
   char    filename[MAXSTRING];
   double  Nsum;
+  int     flag;
+  int     zero;
+  int     date;
+  int     i;
 
   /* open state file */
   sprintf(filename,"%s", filenames.statefile);
@@ -41,7 +47,16 @@ FILE *open_state_file(global_param_struct *global,
     statefile = open_file(filename,"w");
 
   /* Write save state date information */
-  if ( options.BINARY_STATE_FILE ) {
+  if ( options.STATE_SCHEDULE ) {
+    /* multi-snapshot file: flag, number of snapshots, and 0 in place of
+       the state date; the snapshot dates follow Nlayer and Nnode */
+    flag = MULTI_SNAPSHOT_STATE;
+    zero = 0;
+    fwrite( &flag, sizeof(int), 1, statefile );
+    fwrite( &global->Nstate_dates, sizeof(int), 1, statefile );
+    fwrite( &zero, sizeof(int), 1, statefile );
+  }
+  else if ( options.BINARY_STATE_FILE ) {
     fwrite( &global->stateyear, sizeof(int), 1, statefile );
     fwrite( &global->statemonth, sizeof(int), 1, statefile );
     fwrite( &global->stateday, sizeof(int), 1, statefile );
@@ -60,6 +75,18 @@ FILE *open_state_file(global_param_struct *global,
     fprintf(statefile,"%i %i\n", Nlayer, Nnodes);
   }
 
+  /* Write the dates of the snapshots (year, month, day) */
+  if ( options.STATE_SCHEDULE ) {
+    for ( i = 0; i < global->Nstate_dates; i++ ) {
+      date = global->state_date[i] / 10000;
+      fwrite( &date, sizeof(int), 1, statefile );
+      date = (global->state_date[i] / 100) % 100;
+      fwrite( &date, sizeof(int), 1, statefile );
+      date = global->state_date[i] % 100;
+      fwrite( &date, sizeof(int), 1, statefile );
+    }
+  }
+
   return(statefile);
 
 }
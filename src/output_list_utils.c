@@ -66,7 +66,7 @@ out_data_struct *create_output_list() {
   2014-Apr-25 Added OUT_VEGCOVER.					TJB
 *************************************************************/
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   int v;
   out_data_struct *out_data;
 
@@ -484,12 +484,16 @@ void free_out_data_files(out_data_file_struct **out_data_files) {
 
   This routine frees the memory in the out_data_files array.
 
+  Modifications:
+  2026-Oct-18 Free the record buffers used by write_data().
+
 *************************************************************/
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   int filenum;
 
   for (filenum=0; filenum<options.Noutfiles; filenum++) {
     free((char*)(*out_data_files)[filenum].varid);
+    free((char*)(*out_data_files)[filenum].buf);
   }
   free((char*)(*out_data_files));
 
@@ -513,3 +517,62 @@ void free_out_data(out_data_struct **out_data) {
 
 }
 
+
+out_data_struct *copy_output_list(out_data_struct *out_data) {
+/*************************************************************
+  copy_output_list()				October 2026
+
+  This routine creates a copy of the list of output variables,
+  with the same configuration (write flags, formats, types,
+  multipliers, and aggregation methods) but its own data arrays.
+  Used to give each thread of the parallel driver its own list.
+
+*************************************************************/
+  int v;
+  out_data_struct *new_data;
+
+  new_data = (out_data_struct *)calloc(N_OUTVAR_TYPES,sizeof(out_data_struct));
+  if (new_data == NULL)
+    nrerror("Memory allocation error in copy_output_list().");
+
+  for (v=0; v<N_OUTVAR_TYPES; v++) {
+    new_data[v] = out_data[v];
+    new_data[v].data = (double *)calloc(out_data[v].nelem, sizeof(double));
+    new_data[v].aggdata = (double *)calloc(out_data[v].nelem, sizeof(double));
+  }
+
+  return new_data;
+
+}
+
+out_data_file_struct *copy_out_data_files(out_data_file_struct *out_data_files) {
+/*************************************************************
+  copy_out_data_files()				October 2026
+
+  This routine creates a copy of the out_data_files array, with
+  its own varid arrays.  The file names and handles are not set;
+  they are filled in for each cell by make_in_and_outfiles().  The
+  copy gets its own record buffers on its first write_data().
+
+*************************************************************/
+  extern THREAD_LOCAL option_struct options;
+  int filenum;
+  out_data_file_struct *new_files;
+
+  new_files = (out_data_file_struct *)calloc(options.Noutfiles,sizeof(out_data_file_struct));
+  if (new_files == NULL)
+    nrerror("Memory allocation error in copy_out_data_files().");
+
+  for (filenum=0; filenum<options.Noutfiles; filenum++) {
+    strcpy(new_files[filenum].prefix, out_data_files[filenum].prefix);
+    new_files[filenum].nvars = out_data_files[filenum].nvars;
+    new_files[filenum].compress = out_data_files[filenum].compress;
+    new_files[filenum].varid = (int *)calloc(out_data_files[filenum].nvars, sizeof(int));
+    memcpy(new_files[filenum].varid, out_data_files[filenum].varid,
+           out_data_files[filenum].nvars*sizeof(int));
+    new_files[filenum].fh = NULL;
+  }
+
+  return new_files;
+
+}
@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <vicNl.h>
+
+static char vcid[] = "$Id$";
+
+/**********************************************************************
+  output_writer					October 2026
+
+  Asynchronous output writer, used when ASYNC_OUTPUT is TRUE.
+
+  Instead of calling write_data() itself, put_data() hands each output
+  record (the aggregated values of the variables that appear in the
+  output files, plus the record's date) to queue_output(), which copies
+  it into a ring buffer and returns.  A writer thread takes records
+  from the ring buffer in order and writes them to the cell's output
+  files with write_data(), so that the time step loop does not wait for
+  the formatting of ASCII output or for the disk.
+
+  The ring buffer has one producer (the thread simulating the cell)
+  and one consumer (the writer thread), so the two indices into it are
+  each owned by one thread.  It is not lock-free: two counting
+  semaphores track the filled and empty slots, and each record costs
+  a sem_wait() and a sem_post() on each side.  The producer only
+  blocks when OUTPUT_RING_RECS records are waiting to be written.
+
+  If a fatal error occurs on the writer thread itself (e.g. a failed
+  write in write_data()), vicerror() must not drain the writer, which
+  would wait for itself; see on_output_writer().
+
+  Since the records are written in order by the same write_data(), the
+  output files are identical to those written synchronously.
+**********************************************************************/
+
+typedef struct {
+  dmy_struct         dmy;
+  char               END;          /* TRUE = no more records will follow */
+} output_slot_struct;
+
+struct output_writer_struct {
+  pthread_t             thread;
+  vic_context_struct    ctx;          /* configuration of the simulation */
+  out_data_file_struct *out_data_files;
+  out_data_struct       out_data[N_OUTVAR_TYPES]; /* writer's view of the
+                                         output variables; aggdata points
+                                         into the slot being written */
+  int                   dt;           /* output time step (hours) */
+  int                   Nvars;        /* number of variables in the files */
+  int                  *varid;        /* ids of the variables in the files */
+  int                  *offset;       /* offset of each variable's values
+                                         in a slot's values */
+  int                   Nvalues;      /* values per slot */
+  output_slot_struct    slot[OUTPUT_RING_RECS];
+  double               *values;       /* OUTPUT_RING_RECS*Nvalues values */
+  int                   head;         /* next slot to fill (producer) */
+  int                   tail;         /* next slot to write (consumer) */
+  sem_t                 filled;       /* number of filled slots */
+  sem_t                 empty;        /* number of empty slots */
+  phase_profile_struct  profile;      /* writer's phase times (PHASE_PROFILE) */
+};
+
+static void *writer_main(void *arg)
+{
+  extern THREAD_LOCAL Error_struct Error;
+
+  output_writer_struct *w = (output_writer_struct *)arg;
+  output_slot_struct   *slot;
+  double               *values;
+  int                   i;
+
+  bind_vic_context(&w->ctx);
+
+  /* so that vicerror() on this thread closes the cell's output files
+     without draining the writer */
+  Error.out_data_files = w->out_data_files;
+  Error.output_writer = w;
+
+  for (;;) {
+    while (sem_wait(&w->filled) != 0)
+      ;
+    slot = &w->slot[w->tail];
+    if (slot->END)
+      break;
+    values = w->values + (size_t)w->tail * w->Nvalues;
+    for (i = 0; i < w->Nvars; i++)
+      w->out_data[w->varid[i]].aggdata = values + w->offset[i];
+    write_data(w->out_data_files, w->out_data, &slot->dmy, w->dt);
+    w->tail = (w->tail + 1) % OUTPUT_RING_RECS;
+    sem_post(&w->empty);
+  }
+
+  /* hand the time spent writing over to the cell's thread */
+  export_phase_profile(&w->profile);
+
+  return NULL;
+
+}
+
+output_writer_struct *start_output_writer(out_data_file_struct *out_data_files,
+                                          out_data_struct      *out_data,
+                                          int                   dt)
+/**********************************************************************
+  start_output_writer				October 2026
+
+  Starts a writer thread for the output files of the cell that the
+  calling thread is about to simulate.  dt is the output time step
+  (hours), as passed to write_data().
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+
+  output_writer_struct *w;
+  char                 *used;
+  int                   file_idx;
+  int                   var_idx;
+  int                   v;
+
+  w = (output_writer_struct *)calloc(1, sizeof(output_writer_struct));
+  used = (char *)calloc(N_OUTVAR_TYPES, sizeof(char));
+  if (w == NULL || used == NULL)
+    nrerror("Memory allocation error in start_output_writer().");
+
+  save_vic_context(&w->ctx, 0);
+  w->ctx.veg_lib = NULL;
+  w->out_data_files = out_data_files;
+  w->dt = dt;
+
+  /* Find the variables that appear in the output files */
+  for (file_idx = 0; file_idx < options.Noutfiles; file_idx++)
+    for (var_idx = 0; var_idx < out_data_files[file_idx].nvars; var_idx++)
+      used[out_data_files[file_idx].varid[var_idx]] = TRUE;
+  w->varid = (int *)calloc(N_OUTVAR_TYPES, sizeof(int));
+  w->offset = (int *)calloc(N_OUTVAR_TYPES, sizeof(int));
+  if (w->varid == NULL || w->offset == NULL)
+    nrerror("Memory allocation error in start_output_writer().");
+  for (v = 0; v < N_OUTVAR_TYPES; v++) {
+    w->out_data[v] = out_data[v];
+    w->out_data[v].data = NULL;
+    w->out_data[v].aggdata = NULL;
+    if (used[v]) {
+      w->varid[w->Nvars] = v;
+      w->offset[w->Nvars] = w->Nvalues;
+      w->Nvalues += out_data[v].nelem;
+      w->Nvars++;
+    }
+  }
+  free((char *)used);
+
+  w->values = (double *)calloc((size_t)OUTPUT_RING_RECS * w->Nvalues + 1,
+                               sizeof(double));
+  if (w->values == NULL)
+    nrerror("Memory allocation error in start_output_writer().");
+
+  sem_init(&w->filled, 0, 0);
+  sem_init(&w->empty, 0, OUTPUT_RING_RECS);
+  if (pthread_create(&w->thread, NULL, writer_main, w) != 0)
+    nrerror("Unable to start output writer thread.");
+
+  return w;
+
+}
+
+void queue_output(output_writer_struct *w,
+                  out_data_struct      *out_data,
+                  dmy_struct           *dmy)
+/**********************************************************************
+  queue_output					October 2026
+
+  Copies one output record (the aggdata of the variables in the output
+  files, and the record's date) into the writer's ring buffer.  Waits
+  only if the ring buffer is full.
+**********************************************************************/
+{
+  double *values;
+  int     i;
+
+  while (sem_wait(&w->empty) != 0)
+    ;
+  values = w->values + (size_t)w->head * w->Nvalues;
+  for (i = 0; i < w->Nvars; i++)
+    memcpy(values + w->offset[i], out_data[w->varid[i]].aggdata,
+           out_data[w->varid[i]].nelem * sizeof(double));
+  w->slot[w->head].dmy = *dmy;
+  w->slot[w->head].END = FALSE;
+  w->head = (w->head + 1) % OUTPUT_RING_RECS;
+  sem_post(&w->filled);
+
+}
+
+int on_output_writer(output_writer_struct *w)
+/**********************************************************************
+  on_output_writer				October 2026
+
+  Returns TRUE if the calling thread is the writer thread of w.
+**********************************************************************/
+{
+  return pthread_equal(pthread_self(), w->thread);
+}
+
+void finish_output_writer(output_writer_struct **w)
+/**********************************************************************
+  finish_output_writer				October 2026
+
+  Waits until all queued records have been written, then stops the
+  writer thread and frees it.  The output files are left open.  The
+  writer's phase times (PHASE_PROFILE) are added to those of the
+  calling thread.
+**********************************************************************/
+{
+  while (sem_wait(&(*w)->empty) != 0)
+    ;
+  (*w)->slot[(*w)->head].END = TRUE;
+  sem_post(&(*w)->filled);
+  pthread_join((*w)->thread, NULL);
+  import_phase_profile(&(*w)->profile);
+
+  sem_destroy(&(*w)->filled);
+  sem_destroy(&(*w)->empty);
+  free((char *)(*w)->values);
+  free((char *)(*w)->varid);
+  free((char *)(*w)->offset);
+  free((char *)(*w));
+  *w = NULL;
+
+}
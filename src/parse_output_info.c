@@ -28,9 +28,11 @@ void parse_output_info(filenames_struct      *names,
   2009-Mar-15 Added default values for format, typestr, and
 	      multstr, so that they can be omitted from global
 	      param file.					TJB
+  2026-Oct-18 OUTFILE takes an optional third field, the compression
+	      of the file (NONE, GZIP, or GZIP_FAST).
 **********************************************************************/
 {
-  extern option_struct    options;
+  extern THREAD_LOCAL option_struct    options;
 
   char cmdstr[MAXSTRING];
   char optstr[MAXSTRING];
@@ -44,6 +46,7 @@ void parse_output_info(filenames_struct      *names,
   int  type;
   char multstr[20];
   float mult;
+  char compstr[MAXSTRING];
   int  tmp_noutfiles;
   char ErrStr[MAXSTRING];
 
@@ -79,7 +82,20 @@ void parse_output_info(filenames_struct      *names,
           sprintf(ErrStr, "Error in global param file: number of output files specified in N_OUTFILES (%d) is less than actual number of output files defined in the global param file.",options.Noutfiles);
           nrerror(ErrStr);
         }
-        sscanf(cmdstr,"%*s %s %d",(*out_data_files)[outfilenum].prefix,&((*out_data_files)[outfilenum].nvars));
+        strcpy(compstr,"");
+        sscanf(cmdstr,"%*s %s %d %s",(*out_data_files)[outfilenum].prefix,&((*out_data_files)[outfilenum].nvars),compstr);
+        if (strcasecmp("",compstr) == 0 || compstr[0] == '#')
+          (*out_data_files)[outfilenum].compress = OUT_COMPRESS_DEFAULT;
+        else if (strcasecmp("NONE",compstr) == 0)
+          (*out_data_files)[outfilenum].compress = OUT_COMPRESS_NONE;
+        else if (strcasecmp("GZIP",compstr) == 0)
+          (*out_data_files)[outfilenum].compress = OUT_COMPRESS_GZIP;
+        else if (strcasecmp("GZIP_FAST",compstr) == 0)
+          (*out_data_files)[outfilenum].compress = OUT_COMPRESS_GZIP_FAST;
+        else {
+          snprintf(ErrStr, sizeof(ErrStr), "Error in global param file: compression \"%.100s\" of output file \"%.1000s\" must be NONE, GZIP, or GZIP_FAST.",compstr,(*out_data_files)[outfilenum].prefix);
+          nrerror(ErrStr);
+        }
         (*out_data_files)[outfilenum].varid = (int *)calloc((*out_data_files)[outfilenum].nvars, sizeof(int));
         outvarnum = 0;
       }
@@ -134,7 +134,7 @@ void calc_rc_ps(char    Ctype,
   references: 
 ********************************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   double GPP0;                  /* aggregate canopy assimilation (photosynthesis)
                                    in absence of soil moisture stress */
   double Rdark0;                /* aggregate canopy dark respiration in absence of
@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <vicNl.h>
+
+static char vcid[] = "$Id$";
+
+/**********************************************************************
+  phase_profile					October 2026
+
+  Phase profiler (PHASE_PROFILE), which shows where the run time of the
+  model goes.  The phases of running a cell (see the PH_ constants in
+  vicNl_def.h) are timed with the monotonic clock of cell_clock(): each
+  call of a phase adds its wall time to the thread's phase_profile.
+  Some phases are part of others (e.g. solve_snow() is timed within
+  surface_fluxes(), which is timed within full_energy()); the time of
+  a phase includes that of its parts.
+
+  When a cell has been simulated, its phase times are printed to
+  stderr and added to the run's totals, which are printed as a table
+  at the end of the run.  A cell's phases do not all run on the thread
+  that simulates it: with NTHREADS > 1 the main thread reads the cell's
+  parameters, with PREFETCH a helper thread prepares its forcings, and
+  with ASYNC_OUTPUT a writer thread writes its output.  Their times are
+  handed over with export_phase_profile() and import_phase_profile(),
+  so that each cell is charged with all of its phases.  With NTHREADS
+  > 1, or with PREFETCH and ASYNC_OUTPUT, phases run concurrently, so
+  the run's totals may add up to more than its wall time.  Each process
+  of an NPROCS run prints its own totals.
+
+  Timing a phase costs two clock readings while PHASE_PROFILE is TRUE,
+  and nothing otherwise.
+**********************************************************************/
+
+static const char *phase_name[N_PHASES] = {
+  "read_soilparam", "read_vegparam", "initialize_atmos", "forcing_read",
+  "MTCLIM", "initialize_model_state", "full_energy", "surface_fluxes",
+  "solve_snow", "runoff", "solve_lake", "put_data", "write_data"
+};
+
+/* nesting depth of each phase (see the PH_ constants) */
+static const int phase_depth[N_PHASES] = {
+  0, 0, 0, 1, 1, 0, 0, 1, 2, 2, 1, 0, 1
+};
+
+/* totals of the cells run by all threads of this process */
+static phase_profile_struct run_profile;
+static pthread_mutex_t      run_profile_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void add_profile(phase_profile_struct *to,
+                        phase_profile_struct *from)
+{
+  int i;
+
+  for (i = 0; i < N_PHASES; i++) {
+    to->calls[i] += from->calls[i];
+    to->seconds[i] += from->seconds[i];
+  }
+
+}
+
+double phase_start()
+/**********************************************************************
+  phase_start					October 2026
+
+  Returns the start time of a phase, to be passed to phase_end(); 0 if
+  PHASE_PROFILE is FALSE.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+
+  if (!options.PHASE_PROFILE) return 0;
+  return cell_clock();
+
+}
+
+void phase_end(int    phase,
+               double start)
+/**********************************************************************
+  phase_end					October 2026
+
+  Adds a call of phase (PH_READ_SOILPARAM, ...) that started at time
+  start to the thread's phase profile.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL phase_profile_struct phase_profile;
+
+  if (!options.PHASE_PROFILE) return;
+
+  phase_profile.calls[phase]++;
+  phase_profile.seconds[phase] += cell_clock() - start;
+
+}
+
+void export_phase_profile(phase_profile_struct *profile)
+/**********************************************************************
+  export_phase_profile				October 2026
+
+  Moves the phase times of the calling thread into *profile, to be
+  taken over with import_phase_profile() by the thread that simulates
+  the cell to which they belong.
+**********************************************************************/
+{
+  extern THREAD_LOCAL phase_profile_struct phase_profile;
+
+  add_profile(profile, &phase_profile);
+  memset(&phase_profile, 0, sizeof(phase_profile_struct));
+
+}
+
+void import_phase_profile(phase_profile_struct *profile)
+/**********************************************************************
+  import_phase_profile				October 2026
+
+  Moves the phase times in *profile (see export_phase_profile()) into
+  the calling thread's phase profile.
+**********************************************************************/
+{
+  extern THREAD_LOCAL phase_profile_struct phase_profile;
+
+  add_profile(&phase_profile, profile);
+  memset(profile, 0, sizeof(phase_profile_struct));
+
+}
+
+void write_phase_profile(int gridcel)
+/**********************************************************************
+  write_phase_profile				October 2026
+
+  Prints the phase times of cell gridcel, which has just been
+  simulated by the calling thread, and adds them to the run's totals.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL phase_profile_struct phase_profile;
+
+  char   line[2*MAXSTRING];
+  size_t length;
+  int    i;
+
+  if (!options.PHASE_PROFILE) return;
+
+  /* one line per cell, printed at once so that the lines of cells run
+     by different threads are not mixed up */
+  length = sprintf(line, "Phase times of cell %d (s):", gridcel);
+  for (i = 0; i < N_PHASES; i++)
+    if (phase_profile.calls[i] > 0)
+      length += sprintf(line + length, " %s %.3f", phase_name[i],
+                        phase_profile.seconds[i]);
+  sprintf(line + length, "\n");
+  fputs(line, stderr);
+
+  pthread_mutex_lock(&run_profile_lock);
+  add_profile(&run_profile, &phase_profile);
+  pthread_mutex_unlock(&run_profile_lock);
+  memset(&phase_profile, 0, sizeof(phase_profile_struct));
+
+}
+
+void print_phase_profile(double seconds)
+/**********************************************************************
+  print_phase_profile				October 2026
+
+  Prints the run's phase totals, for a run that took seconds of wall
+  time.  Phase times left in the calling thread (e.g. parameters read
+  for cells that were skipped) are added to the totals first.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL phase_profile_struct phase_profile;
+
+  int i;
+
+  if (!options.PHASE_PROFILE) return;
+
+  pthread_mutex_lock(&run_profile_lock);
+  add_profile(&run_profile, &phase_profile);
+  memset(&phase_profile, 0, sizeof(phase_profile_struct));
+
+  fprintf(stderr, "\nPhase profile of the run (wall time %.3f s):\n", seconds);
+  fprintf(stderr, "%-28s %12s %8s %12s %12s\n", "phase", "seconds",
+          "% run", "calls", "us/call");
+  for (i = 0; i < N_PHASES; i++) {
+    if (run_profile.calls[i] == 0) continue;
+    fprintf(stderr, "%*s%-*s %12.3f %7.1f%% %12ld %12.2f\n",
+            2*phase_depth[i], "", 28 - 2*phase_depth[i], phase_name[i],
+            run_profile.seconds[i],
+            seconds > 0 ? 100. * run_profile.seconds[i] / seconds : 0.,
+            run_profile.calls[i],
+            1.e6 * run_profile.seconds[i] / run_profile.calls[i]);
+  }
+  pthread_mutex_unlock(&run_profile_lock);
+
+}
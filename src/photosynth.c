@@ -55,7 +55,7 @@ void photosynth(char    Ctype,
                 double *Rphoto, 
                 double *Agross) 
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   double T;
   double T1;
   double T0;
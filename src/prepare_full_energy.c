@@ -41,16 +41,15 @@ void prepare_full_energy(int               iveg,
   2013-Dec-26 Removed EXCESS_ICE option.				TJB
   2013-Dec-27 Moved SPATIAL_FROST to options_struct.			TJB
   2014-Mar-28 Removed DIST_PRCP option.					TJB
+  2026-Oct-18 layer is now stored on the stack instead of being
+	      allocated on every call.
 *******************************************************************/
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   int                i, band;
   double            *null_ptr;
-  layer_data_struct *layer;
-
-  layer = (layer_data_struct *)calloc(options.Nlayer,
-				      sizeof(layer_data_struct));
+  layer_data_struct  layer[MAX_LAYERS];
 
   for(band=0;band<options.SNOW_BAND;band++) {
 
@@ -109,6 +108,4 @@ void prepare_full_energy(int               iveg,
 
   }
 
-  free((char *)layer);
-
 }
@@ -338,6 +338,8 @@ print_force_type(force_type_struct *force_type)
 void
 print_global_param(global_param_struct *gp)
 {
+    int i;
+
     printf("global_param:\n");
     printf("\tMAX_SNOW_TEMP: %.4lf\n", gp->MAX_SNOW_TEMP);
     printf("\tMIN_RAIN_TEMP: %.4lf\n", gp->MIN_RAIN_TEMP);
@@ -368,6 +370,15 @@ print_global_param(global_param_struct *gp)
     printf("\tstateday     : %d\n", gp->stateday);
     printf("\tstatemonth   : %d\n", gp->statemonth);
     printf("\tstateyear    : %d\n", gp->stateyear);
+    printf("\tNstate_dates : %d\n", gp->Nstate_dates);
+    printf("\tstate_date   :");
+    for (i = 0; i < gp->Nstate_dates; i++) {
+        printf("\t%d", gp->state_date[i]);
+    }
+    printf("\n");
+    printf("\tstate_monthly_day : %d\n", gp->state_monthly_day);
+    printf("\tinit_state_date : %d\n", gp->init_state_date);
+    printf("\tinit_state_snapshot : %d\n", gp->init_state_snapshot);
 }
 
 void
@@ -551,6 +562,7 @@ print_option(option_struct *option)
     printf("\tBINARY_STATE_FILE  : %d\n", option->BINARY_STATE_FILE);
     printf("\tINIT_STATE         : %d\n", option->INIT_STATE);
     printf("\tSAVE_STATE         : %d\n", option->SAVE_STATE);
+    printf("\tSTATE_SCHEDULE     : %d\n", option->STATE_SCHEDULE);
     printf("\tALMA_OUTPUT        : %d\n", option->ALMA_OUTPUT);
     printf("\tBINARY_OUTPUT      : %d\n", option->BINARY_OUTPUT);
     printf("\tCOMPRESS           : %d\n", option->COMPRESS);
@@ -595,6 +607,7 @@ print_out_data_file(out_data_file_struct *outf)
     printf("\tfilename: %s\n", outf->filename);
     printf("\tfh: %p\n", outf->fh);
     printf("\tnvars: %d\n", outf->nvars);
+    printf("\tcompress: %d\n", outf->compress);
     printf("\tvarid: %p\n", outf->varid);
 }
 
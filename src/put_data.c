@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <vicNl.h>
 
 static char vcid[] = "$Id$";
@@ -11,6 +12,7 @@ int  put_data(all_vars_struct   *all_vars,
               lake_con_struct   *lake_con,
               out_data_file_struct   *out_data_files,
               out_data_struct   *out_data,
+              output_writer_struct *output_writer,
               save_data_struct  *save_data,
 	      dmy_struct        *dmy,
               int                rec)
@@ -156,11 +158,20 @@ int  put_data(all_vars_struct   *all_vars,
   2014-Mar-28 Removed DIST_PRCP option.					TJB
   2014-Apr-25 Added OUT_LAI.						TJB
   2014-Apr-25 Added OUT_VEGCOVER.					TJB
+  2026-Oct-18 Added output_writer; if it is not NULL (ASYNC_OUTPUT),
+	      output records are queued to it instead of being written
+	      here.
+  2026-Oct-18 Added report of the iterations of the explicit soil T
+	      profile solutions (soil_T_iter).
+  2026-Oct-18 The iterations of the explicit soil T profile solutions
+	      are only reported with EXPLICIT_SOLVER NEWTON; the sweeps
+	      of the default solver are recorded by SOLVER_TELEMETRY.
 **********************************************************************/
 {
-  extern global_param_struct global_param;
-  extern veg_lib_struct  *veg_lib;
-  extern option_struct    options;
+  extern THREAD_LOCAL global_param_struct global_param;
+  extern THREAD_LOCAL veg_lib_struct  *veg_lib;
+  extern THREAD_LOCAL option_struct    options;
+  extern THREAD_LOCAL soil_T_iter_struct soil_T_iter;
   int                     veg;
   int                     index;
   int                     band;
@@ -195,13 +206,13 @@ int  put_data(all_vars_struct   *all_vars,
   int                     dt_sec;
   int                     out_dt_sec;
   int                     out_step_ratio;
-  static int              step_count;
+  static THREAD_LOCAL int              step_count;
   int                     ErrorFlag;
-  static int              Tfoliage_fbcount_total;
-  static int              Tcanopy_fbcount_total;
-  static int              Tsnowsurf_fbcount_total;
-  static int              Tsurf_fbcount_total;
-  static int              Tsoil_fbcount_total;
+  static THREAD_LOCAL int              Tfoliage_fbcount_total;
+  static THREAD_LOCAL int              Tcanopy_fbcount_total;
+  static THREAD_LOCAL int              Tsnowsurf_fbcount_total;
+  static THREAD_LOCAL int              Tsurf_fbcount_total;
+  static THREAD_LOCAL int              Tsoil_fbcount_total;
 
   cell_data_struct      **cell;
   energy_bal_struct     **energy;
@@ -648,7 +659,10 @@ int  put_data(all_vars_struct   *all_vars,
   /******************************************************************************************
     Return to parent function if this was just an initialization of wb and eb storage terms
   ******************************************************************************************/
-  if (rec < 0) return(0);
+  if (rec < 0) {
+    memset(&soil_T_iter, 0, sizeof(soil_T_iter_struct));
+    return(0);
+  }
 
 
 
@@ -661,6 +675,11 @@ int  put_data(all_vars_struct   *all_vars,
     fprintf(stderr,"Total number of fallbacks in Tsnowsurf: %d\n", Tsnowsurf_fbcount_total);
     fprintf(stderr,"Total number of fallbacks in Tsurf: %d\n", Tsurf_fbcount_total);
     fprintf(stderr,"Total number of fallbacks in soil T profile: %d\n", Tsoil_fbcount_total);
+    if (soil_T_iter.Nsolutions > 0 && options.EXPLICIT_SOLVER == ES_NEWTON)
+      fprintf(stderr,"Explicit soil T profile solutions: %ld, Newton iterations: %ld (%.2f per solution), solved by sweeps instead: %ld (%ld sweeps)\n",
+              soil_T_iter.Nsolutions, soil_T_iter.Niter,
+              (double)soil_T_iter.Niter/soil_T_iter.Nsolutions,
+              soil_T_iter.Nfallback, soil_T_iter.Nsweeps);
   }
 
   /********************
@@ -770,7 +789,10 @@ int  put_data(all_vars_struct   *all_vars,
           }
         }
       }
-      write_data(out_data_files, out_data, dmy, global_param.out_dt);
+      if (output_writer != NULL)
+        queue_output(output_writer, out_data, dmy);
+      else
+        write_data(out_data_files, out_data, dmy, global_param.out_dt);
     }
 
     // Reset the step count
@@ -805,7 +827,7 @@ void collect_wb_terms(cell_data_struct  cell,
                       out_data_struct  *out_data)
 {
 
-  extern option_struct    options;
+  extern THREAD_LOCAL option_struct    options;
   double AreaFactor;
   double tmp_evap;
   double tmp_cond1;
@@ -991,7 +1013,7 @@ void collect_eb_terms(energy_bal_struct energy,
                       out_data_struct  *out_data)
 {
 
-  extern option_struct    options;
+  extern THREAD_LOCAL option_struct    options;
   double AreaFactor;
   double tmp_fract;
   double rad_temp;
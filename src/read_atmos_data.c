@@ -1,11 +1,424 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <locale.h>
 #include <vicNl.h>
 
 static char vcid[] = "$Id$";
 
-void read_atmos_data(FILE                 *infile,
+/* Number of records of a binary forcing file decoded at a time, so that
+   the block being decoded stays in cache while its columns are read */
+#define DECODE_BLOCK_RECS 1024
+
+static const unsigned char *map_forcing_file(FILE   *infile,
+                                             size_t *nbytes,
+                                             char   *MAPPED)
+/* Map the whole forcing file into memory; if it cannot be mapped (e.g.
+   it is not a regular file), read it into a buffer instead. */
+{
+  struct stat    st;
+  unsigned char *buf;
+  size_t         size;
+  size_t         n;
+  void          *map;
+
+  fflush(infile);
+  if (fstat(fileno(infile), &st) == 0 && S_ISREG(st.st_mode)) {
+    *nbytes = (size_t)st.st_size;
+    if (*nbytes == 0) {
+      *MAPPED = FALSE;
+      return NULL;
+    }
+    map = mmap(NULL, *nbytes, PROT_READ, MAP_PRIVATE, fileno(infile), 0);
+    if (map != MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+      madvise(map, *nbytes, MADV_SEQUENTIAL);
+#endif
+      *MAPPED = TRUE;
+      return (const unsigned char *)map;
+    }
+  }
+
+  *MAPPED = FALSE;
+  rewind(infile);
+  size = 1 << 20;
+  *nbytes = 0;
+  if ((buf = (unsigned char *)malloc(size)) == NULL)
+    nrerror("Memory allocation error in read_atmos_data().");
+  while ((n = fread(buf + *nbytes, 1, size - *nbytes, infile)) > 0) {
+    *nbytes += n;
+    if (*nbytes == size) {
+      size *= 2;
+      if ((buf = (unsigned char *)realloc(buf, size)) == NULL)
+        nrerror("Memory allocation error in read_atmos_data().");
+    }
+  }
+
+  return buf;
+
+}
+
+static void unmap_forcing_file(const unsigned char *data,
+                               size_t               nbytes,
+                               char                 MAPPED)
+{
+  if (MAPPED)
+    munmap((void *)data, nbytes);
+  else
+    free((void *)data);
+}
+
+static void decode_column(const unsigned char *src,
+                          size_t               stride,
+                          int                  n,
+                          char                 SIGNED,
+                          char                 BIG_ENDIAN_FILE,
+                          double               multiplier,
+                          double              *dst)
+/* Convert n scaled shorts, stride bytes apart, to doubles.  Each case
+   is a separate loop, so that the loop bodies stay branch-free. */
+{
+  int r;
+
+  if (SIGNED && BIG_ENDIAN_FILE)
+    for (r = 0; r < n; r++, src += stride)
+      dst[r] = (double)(signed short)((src[0] << 8) | src[1]) / multiplier;
+  else if (SIGNED)
+    for (r = 0; r < n; r++, src += stride)
+      dst[r] = (double)(signed short)(src[0] | (src[1] << 8)) / multiplier;
+  else if (BIG_ENDIAN_FILE)
+    for (r = 0; r < n; r++, src += stride)
+      dst[r] = (double)(unsigned short)((src[0] << 8) | src[1]) / multiplier;
+  else
+    for (r = 0; r < n; r++, src += stride)
+      dst[r] = (double)(unsigned short)(src[0] | (src[1] << 8)) / multiplier;
+
+}
+
+static int count_lines(const char *p,
+                       const char *end)
+/* Count the newlines in [p, end). */
+{
+  int count;
+
+  for (count = 0; p < end && (p = memchr(p, '\n', end - p)) != NULL; p++)
+    count++;
+
+  return count;
+
+}
+
+#define IS_BLANK(c) ((c) == ' ' || (c) == '\t' || (c) == '\r' || (c) == '\v' || (c) == '\f')
+
+static const char *parse_ascii_value(const char *p,
+                                     const char *end,
+                                     double     *value)
+/* Parse the number that starts at p and ends at the next blank or end of
+   line; return a pointer past it, or NULL if it is not a number.
+
+   Numbers of up to 19 significant digits whose mantissa is at most 2^53
+   and whose decimal exponent is within +/-22 (i.e. all numbers normally
+   found in forcing files) are converted with a single multiplication
+   or division by an exact power of ten, which gives the correctly
+   rounded result, as strtod() does.  Anything else (long mantissas,
+   large exponents, "nan", "inf", hexadecimal) is passed to strtod(),
+   with the decimal point changed to that of the current locale, so
+   that the result does not depend on the locale either way. */
+{
+  static const double pow10[23] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  const char         *q;
+  const char         *token_end;
+  char                token[64];
+  char               *stop;
+  char                NEGATIVE;
+  int                 Ndigits;
+  int                 Nsig;
+  int                 exp10;
+  int                 exponent;
+  int                 exp_sign;
+  unsigned long long  mantissa;
+  size_t              len;
+  size_t              k;
+
+  q = p;
+  NEGATIVE = FALSE;
+  if (q < end && (*q == '-' || *q == '+')) {
+    NEGATIVE = (*q == '-');
+    q++;
+  }
+
+  mantissa = 0;
+  Ndigits = Nsig = exp10 = 0;
+  while (q < end && *q >= '0' && *q <= '9') {
+    if (Nsig > 0 || *q != '0') Nsig++;
+    mantissa = mantissa * 10 + (*q - '0');
+    Ndigits++;
+    q++;
+  }
+  if (q < end && *q == '.') {
+    q++;
+    while (q < end && *q >= '0' && *q <= '9') {
+      if (Nsig > 0 || *q != '0') Nsig++;
+      mantissa = mantissa * 10 + (*q - '0');
+      exp10--;
+      Ndigits++;
+      q++;
+    }
+  }
+  if (Ndigits > 0 && q < end && (*q == 'e' || *q == 'E')) {
+    token_end = q++;
+    exp_sign = 1;
+    if (q < end && (*q == '-' || *q == '+')) {
+      if (*q == '-') exp_sign = -1;
+      q++;
+    }
+    if (q < end && *q >= '0' && *q <= '9') {
+      exponent = 0;
+      while (q < end && *q >= '0' && *q <= '9') {
+        if (exponent < 10000) exponent = exponent * 10 + (*q - '0');
+        q++;
+      }
+      exp10 += exp_sign * exponent;
+    }
+    else
+      q = token_end;
+  }
+
+  if (Ndigits > 0 && (q == end || IS_BLANK(*q) || *q == '\n')) {
+    if (mantissa == 0) {
+      *value = NEGATIVE ? -0.0 : 0.0;
+      return q;
+    }
+    if (Nsig <= 19 && mantissa <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22) {
+      *value = (exp10 < 0) ? (double)mantissa / pow10[-exp10]
+                           : (double)mantissa * pow10[exp10];
+      if (NEGATIVE) *value = -*value;
+      return q;
+    }
+  }
+
+  /* general case */
+  for (token_end = p; token_end < end && !IS_BLANK(*token_end) && *token_end != '\n'; token_end++)
+    ;
+  len = token_end - p;
+  if (len == 0 || len >= sizeof(token))
+    return NULL;
+  memcpy(token, p, len);
+  token[len] = '\0';
+  for (k = 0; k < len; k++)
+    if (token[k] == '.') token[k] = localeconv()->decimal_point[0];
+  *value = strtod(token, &stop);
+  if (stop != token + len)
+    return NULL;
+
+  return token_end;
+
+}
+
+int parse_ascii_forcing(const char  *p,
+                        const char  *end,
+                        int          line,
+                        int          file_num,
+                        int          Nrecs,
+                        double     **forcing_data,
+                        double    ***veg_hist_data)
+/**********************************************************************
+  parse_ascii_forcing				October 2026
+
+  Parses up to Nrecs records of ASCII forcing file file_num from the
+  text in [p, end), one record per line; line is the line number of
+  p in the file, for error messages.  Each line must hold at least
+  one value per field (one per veg tile for ALBEDO, LAI_IN, and
+  VEGCOVER), separated by blanks; anything after them is ignored, as
+  are blank lines.  A line with too few values, or a value that is not
+  a number, stops the run with an error giving its line and column.
+  Returns the number of records parsed.
+**********************************************************************/
+{
+  extern THREAD_LOCAL param_set_struct param_set;
+
+  const char *line_start;
+  const char *q;
+  char        ErrStr[MAXSTRING];
+  int         rec;
+  int         i, j;
+  int         type;
+  int         Nelem;
+  int         Nvalues;
+  int         Nfound;
+  double     *dst;
+
+  Nvalues = (int)(binary_forcing_rec_size(file_num) / sizeof(short));
+
+  for (rec = 0; rec < Nrecs; rec++) {
+
+    /* skip blank lines */
+    for (;;) {
+      line_start = p;
+      while (p < end && IS_BLANK(*p)) p++;
+      if (p == end || *p != '\n') break;
+      p++;
+      line++;
+    }
+    if (p == end) break;
+
+    Nfound = 0;
+    for (i = 0; i < param_set.N_TYPES[file_num]; i++) {
+      type = param_set.FORCE_INDEX[file_num][i];
+      Nelem = param_set.TYPE[type].N_ELEM;
+      for (j = 0; j < Nelem; j++) {
+        while (p < end && IS_BLANK(*p)) p++;
+        if (p == end || *p == '\n') {
+          sprintf(ErrStr, "Forcing file %d, line %d, column %d: expected %d values per record, but found only %d.",
+                  file_num+1, line, (int)(p - line_start) + 1, Nvalues, Nfound);
+          nrerror(ErrStr);
+        }
+        if (type != ALBEDO && type != LAI_IN && type != VEGCOVER)
+          dst = &forcing_data[type][rec];
+        else
+          dst = &veg_hist_data[type][j][rec];
+        if ((q = parse_ascii_value(p, end, dst)) == NULL) {
+          for (q = p; q < end && !IS_BLANK(*q) && *q != '\n' && q - p < 32; q++)
+            ;
+          sprintf(ErrStr, "Forcing file %d, line %d, column %d: \"%.*s\" is not a number.",
+                  file_num+1, line, (int)(p - line_start) + 1, (int)(q - p), p);
+          nrerror(ErrStr);
+        }
+        p = q;
+        Nfound++;
+      }
+    }
+
+    /* skip the rest of the line */
+    if ((p = memchr(p, '\n', end - p)) == NULL)
+      p = end;
+    else
+      p++;
+    line++;
+
+  }
+
+  return rec;
+
+}
+
+size_t binary_forcing_header_size(const unsigned char *data,
+                                  size_t               nbytes,
+                                  int                  file_num)
+/**********************************************************************
+  binary_forcing_header_size			October 2026
+
+  Returns the size in bytes of the header of binary forcing file
+  file_num, whose contents (nbytes long) start at data, or 0 if the
+  file has no header.  A VIC header starts with 4 instances of the
+  identifier 0xFFFF, followed by the number of bytes in the header
+  (in the file's byte order), which is the offset at which the data
+  records start.
+**********************************************************************/
+{
+  extern THREAD_LOCAL param_set_struct param_set;
+
+  unsigned short Identifier[4];
+  int            i;
+
+  if (nbytes < 5*sizeof(unsigned short))
+    return 0;
+  for (i=0; i<4; i++)
+    Identifier[i] = (unsigned short)(data[2*i] | (data[2*i+1] << 8));
+  if (Identifier[0] != 0xFFFF || Identifier[1] != 0xFFFF || Identifier[2] != 0xFFFF || Identifier[3] != 0xFFFF)
+    return 0;
+  if (param_set.FORCE_ENDIAN[file_num] == BIG)
+    return (size_t)((data[8] << 8) | data[9]);
+  else
+    return (size_t)(data[8] | (data[9] << 8));
+
+}
+
+size_t binary_forcing_rec_size(int file_num)
+/**********************************************************************
+  binary_forcing_rec_size			October 2026
+
+  Returns the size in bytes of one record of binary forcing file
+  file_num: one short per field, or per veg tile for the veg_hist
+  fields (ALBEDO, LAI_IN, VEGCOVER).
+**********************************************************************/
+{
+  extern THREAD_LOCAL param_set_struct param_set;
+
+  int    i;
+  size_t Nvalues;
+
+  Nvalues = 0;
+  for (i = 0; i < param_set.N_TYPES[file_num]; i++)
+    Nvalues += param_set.TYPE[param_set.FORCE_INDEX[file_num][i]].N_ELEM;
+
+  return Nvalues * sizeof(short);
+
+}
+
+int decode_binary_forcing(const unsigned char  *data,
+                          size_t                nbytes,
+                          int                   file_num,
+                          int                   Nrecs,
+                          double              **forcing_data,
+                          double             ***veg_hist_data)
+/**********************************************************************
+  decode_binary_forcing				October 2026
+
+  Decodes up to Nrecs records of binary forcing file file_num, which
+  start at data (nbytes long; any header has already been skipped), into
+  forcing_data and veg_hist_data.  Each value is a short in the file's
+  byte order (FORCE_ENDIAN), divided by its field's multiplier.  The
+  records are decoded in blocks of DECODE_BLOCK_RECS, one column (field
+  or veg tile) at a time.  Returns the number of whole records decoded.
+**********************************************************************/
+{
+  extern THREAD_LOCAL param_set_struct param_set;
+
+  int               rec0;
+  int               n;
+  int               i, j;
+  int               type;
+  size_t            recsize;
+  size_t            col;
+  force_type_struct *force_type;
+  double           *dst;
+
+  recsize = binary_forcing_rec_size(file_num);
+  if ((size_t)Nrecs > nbytes / recsize)
+    Nrecs = (int)(nbytes / recsize);
+
+  for (rec0 = 0; rec0 < Nrecs; rec0 += DECODE_BLOCK_RECS) {
+    n = (Nrecs - rec0 < DECODE_BLOCK_RECS) ? Nrecs - rec0 : DECODE_BLOCK_RECS;
+    col = 0;
+    for (i = 0; i < param_set.N_TYPES[file_num]; i++) {
+      type = param_set.FORCE_INDEX[file_num][i];
+      force_type = &param_set.TYPE[type];
+      for (j = 0; j < force_type->N_ELEM; j++, col++) {
+        if (type != ALBEDO && type != LAI_IN && type != VEGCOVER)
+          dst = forcing_data[type];
+        else
+          dst = veg_hist_data[type][j];
+        decode_column(data + (size_t)rec0 * recsize + col * sizeof(short),
+                      recsize, n, force_type->SIGNED,
+                      param_set.FORCE_ENDIAN[file_num] == BIG,
+                      force_type->multiplier, dst + rec0);
+      }
+    }
+  }
+
+  return Nrecs;
+
+}
+
+void read_atmos_data(filep_struct         *filep,
 		     global_param_struct   global_param,
 		     int                   file_num,
 		     int                   forceskip,
@@ -18,7 +431,8 @@ void read_atmos_data(FILE                 *infile,
 
   BINARY
   Binary data are always specified as unsigned or signed ints, and a
-  multiplier is used to convert to float.
+  multiplier is used to convert to float.  The file is mapped into
+  memory and decoded in bulk by decode_binary_forcing().
 
   atmos variable: type:            model units:
   
@@ -29,9 +443,17 @@ void read_atmos_data(FILE                 *infile,
   swap bytes code from Kernighan, Brian W. and Rob Pike, "The practice of
   programming", Addison-Wesley, Reading, Massachusetts, 1999, 267 pp,
   page 206.   		
-  
+
+  PACKED
+  The records of all cells are stored, as in a binary file, in one
+  packed forcing file (see forcing_pack.c); only the cell's records
+  for the simulation period are read, with a single read.
+
   ASCII
   ASCII data should have the same units as given in the table above.
+  The file is mapped into memory and parsed by parse_ascii_forcing(),
+  which gives the same values as fscanf("%lf") and reports the line
+  and column of any value that cannot be parsed.
 
   
   Supported Input Field Combinations, options in parenthesis optional:
@@ -60,27 +482,46 @@ void read_atmos_data(FILE                 *infile,
   2014-Apr-25 Added non-climatological veg parameters (as forcing
 	      variables).						TJB
   2014-Apr-25 Added partial vegcover fraction.				TJB
+  2026-Oct-18 Binary forcing files are now mapped into memory and
+	      decoded a column at a time by decode_binary_forcing(),
+	      instead of with one fread() per value.  The records skipped
+	      at the start of the file now account for the veg tiles of
+	      the veg_hist fields.  A file that ends before the simulation
+	      does is now always reported; previously, the record after
+	      the last complete one was filled with stale values.
+  2026-Oct-18 ASCII forcing files are now mapped into memory and parsed
+	      by parse_ascii_forcing() instead of with fscanf().  Lines
+	      with too few values, and values that are not numbers, are
+	      now reported with their line and column.
+  2026-Oct-18 Added the PACKED forcing file format.  Replaced infile
+	      with filep in the argument list.  Moved the detection of
+	      binary file headers to binary_forcing_header_size().
 
   **********************************************************************/
 {
   
-  extern option_struct options;
-  extern param_set_struct param_set;
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL param_set_struct param_set;
   
   int             rec;
   int             skip_recs;
-  int             i,j;
-  int             endian;
-  int             fields;
+  int             i;
   int             Nfields;
-  int             day=0;
+  int             Nrecs;
+  int             line;
   int            *field_index;
-  unsigned short  ustmp;
-  signed short    stmp;
-  char            str[MAXSTRING+1];
   char            ErrStr[MAXSTRING+1];
-  unsigned short  Identifier[4];
-  int             Nbytes;
+  FILE           *infile;
+  size_t          Nbytes;
+  const unsigned char *data;
+  unsigned char  *buf;
+  size_t          Nbytes_file;
+  size_t          offset;
+  long            start;
+  const char     *text;
+  const char     *p;
+  const char     *end;
+  char            MAPPED;
 
   Nfields     = param_set.N_TYPES[file_num];
   field_index = param_set.FORCE_INDEX[file_num];
@@ -106,104 +547,66 @@ void read_atmos_data(FILE                 *infile,
     nrerror(ErrStr);
   }
 
-  if(infile==NULL)fprintf(stderr,"NULL file\n");
+  infile = filep->forcing[file_num];
+  if(infile==NULL && param_set.FORCE_FORMAT[file_num] != PACKED)
+    fprintf(stderr,"NULL file\n");
+
+  /** number of records needed to cover the simulation **/
+  Nrecs = (global_param.nrecs * global_param.dt + param_set.FORCE_DT[file_num] - 1)
+    / param_set.FORCE_DT[file_num];
   
   /***************************
     Read BINARY Forcing Data
   ***************************/
 
   if(param_set.FORCE_FORMAT[file_num] == BINARY){
-	  
-    /** test whether the machine is little-endian or big-endian **/
-    i = 1;
-    if(*(char *)&i == 1)
-      endian = LITTLE;
-    else    
-      endian = BIG;
-	  
-    // Check for presence of a header, & skip over it if appropriate.
-    // A VIC header will start with 4 instances of the identifier,
-    // followed by number of bytes in the header (Nbytes).
-    // Nbytes is assumed to be the byte offset at which the data records start.
-    fseek(infile,0,SEEK_SET);
-    if (feof(infile))
+
+    /** map (or read) the whole file into memory **/
+    data = map_forcing_file(infile, &Nbytes_file, &MAPPED);
+    if (Nbytes_file == 0)
       nrerror("No data in the forcing file.  Model stopping...");
-    for (i=0; i<4; i++) {
-      fread(&ustmp,sizeof(unsigned short),1,infile);
-      if (endian != param_set.FORCE_ENDIAN[file_num]) {
-        ustmp = ((ustmp & 0xFF) << 8) | ((ustmp >> 8) & 0xFF);
-      }
-      Identifier[i] = ustmp;
-    }
-    if (Identifier[0] != 0xFFFF || Identifier[1] != 0xFFFF || Identifier[2] != 0xFFFF || Identifier[3] != 0xFFFF) {
-      Nbytes = 0;
-    }
-    else {
-      fread(&ustmp,sizeof(unsigned short),1,infile);
-      if (endian != param_set.FORCE_ENDIAN[file_num]) {
-        ustmp = ((ustmp & 0xFF) << 8) | ((ustmp >> 8) & 0xFF);
-      }
-      Nbytes = (int)ustmp;
-    }
-    fseek(infile,Nbytes,SEEK_SET);
 
+    // Check for presence of a header, & skip over it if appropriate.
+    Nbytes = binary_forcing_header_size(data, Nbytes_file, file_num);
 
     /** if forcing file starts before the model simulation, 
 	skip over its starting records **/
-    fseek(infile,skip_recs*Nfields*sizeof(short),SEEK_CUR);
-    if (feof(infile))
+    offset = Nbytes + (size_t)skip_recs * binary_forcing_rec_size(file_num);
+    if (offset >= Nbytes_file)
       nrerror("No data for the specified time period in the forcing file.  Model stopping...");
-	  
-    /** Read BINARY forcing data **/
-    rec = 0;
-	  
-    while ( !feof(infile) && (rec * param_set.FORCE_DT[file_num] 
-			      < global_param.nrecs * global_param.dt) ) {
-
-      for(i=0;i<Nfields;i++) {
-        if (field_index[i] != ALBEDO && field_index[i] != LAI_IN && field_index[i] != VEGCOVER) {
-	  if(param_set.TYPE[field_index[i]].SIGNED) {
-	    fread(&stmp,sizeof(short int),1,infile);
-	    if (endian != param_set.FORCE_ENDIAN[file_num]) {
-	      stmp = ((stmp & 0xFF) << 8) | ((stmp >> 8) & 0xFF);
-	    }
-	    forcing_data[field_index[i]][rec] 
-	      = (double)stmp / param_set.TYPE[field_index[i]].multiplier;
-	  }
-	  else {
-	    fread(&ustmp,sizeof(unsigned short int),1,infile);
-	    if (endian != param_set.FORCE_ENDIAN[file_num]) {
-	      ustmp = ((ustmp & 0xFF) << 8) | ((ustmp >> 8) & 0xFF);
-	    }
-	    forcing_data[field_index[i]][rec] 
-	      = (double)ustmp / param_set.TYPE[field_index[i]].multiplier;
-	  }
-	}
-	else {
-          for(j=0;j<param_set.TYPE[field_index[i]].N_ELEM;j++) {
-	    if(param_set.TYPE[field_index[i]].SIGNED) {
-	      fread(&stmp,sizeof(short int),1,infile);
-	      if (endian != param_set.FORCE_ENDIAN[file_num]) {
-	        stmp = ((stmp & 0xFF) << 8) | ((stmp >> 8) & 0xFF);
-	      }
-	      veg_hist_data[field_index[i]][j][rec] 
-	        = (double)stmp / param_set.TYPE[field_index[i]].multiplier;
-	    }
-	    else {
-	      fread(&ustmp,sizeof(unsigned short int),1,infile);
-	      if (endian != param_set.FORCE_ENDIAN[file_num]) {
-	        ustmp = ((ustmp & 0xFF) << 8) | ((ustmp >> 8) & 0xFF);
-	      }
-	      veg_hist_data[field_index[i]][j][rec] 
-	        = (double)ustmp / param_set.TYPE[field_index[i]].multiplier;
-	    }
-          }
-	}
-      }
-			
-      rec++;
-			
-    }
+
+    /** Decode BINARY forcing data **/
+    rec = decode_binary_forcing(data + offset, Nbytes_file - offset, file_num,
+                                Nrecs, forcing_data, veg_hist_data);
+
+    unmap_forcing_file(data, Nbytes_file, MAPPED);
+
+  }
+
+  /***************************
+    Read PACKED Forcing Data
+  ***************************/
+
+  else if(param_set.FORCE_FORMAT[file_num] == PACKED){
+
+    /** read only the records of the simulation period **/
+    Nbytes_file = forcing_pack_cell_length(filep->forcing_pack[file_num],
+                                           filep->forcing_cell[file_num]);
+    offset = (size_t)skip_recs * binary_forcing_rec_size(file_num);
+    if (offset >= Nbytes_file)
+      nrerror("No data for the specified time period in the forcing file.  Model stopping...");
+    Nbytes_file -= offset;
+    if (Nbytes_file > (size_t)Nrecs * binary_forcing_rec_size(file_num))
+      Nbytes_file = (size_t)Nrecs * binary_forcing_rec_size(file_num);
+
+    if ((buf = (unsigned char *)malloc(Nbytes_file)) == NULL)
+      nrerror("Memory allocation error in read_atmos_data().");
+    read_forcing_pack(filep->forcing_pack[file_num],
+                      filep->forcing_cell[file_num], offset, Nbytes_file, buf);
+    rec = decode_binary_forcing(buf, Nbytes_file, file_num, Nrecs,
+                                forcing_data, veg_hist_data);
+    free((char *)buf);
+
   }
 
   /**************************
@@ -219,30 +622,31 @@ void read_atmos_data(FILE                 *infile,
     // and to any other functions that read the files, so that those functions could
     // also read the headers if necessary).
 
+    /** map (or read) the whole file into memory; the data start where
+	open_file() left off, after the header **/
+    start = ftell(infile);
+    data = map_forcing_file(infile, &Nbytes_file, &MAPPED);
+    if (start < 0 || (size_t)start > Nbytes_file)
+      start = 0;
+    text = (const char *)data;
+    end = text + Nbytes_file;
+    line = count_lines(text, text + start) + 1;
+    p = text + start;
+
     /* skip to the beginning of the required met data */
     for(i=0;i<skip_recs;i++){
-      if( fgets(str, MAXSTRING, infile) == NULL )
+      if( p == end || (p = memchr(p, '\n', end - p)) == NULL )
 	nrerror("No data for the specified time period in the forcing file.  Model stopping...");
+      p++;
+      line++;
     }
-	  
+
     /* read forcing data */
-    rec=0;
+    rec = parse_ascii_forcing(p, end, line, file_num, Nrecs, forcing_data,
+                              veg_hist_data);
+
+    unmap_forcing_file(data, Nbytes_file, MAPPED);
 
-    while( !feof(infile) && (rec * param_set.FORCE_DT[file_num] 
-			      < global_param.nrecs * global_param.dt ) ) {
-      for(i=0;i<Nfields;i++) {
-        if (field_index[i] != ALBEDO && field_index[i] != LAI_IN && field_index[i] != VEGCOVER) {
-	  fscanf(infile,"%lf", &forcing_data[field_index[i]][rec]);
-        }
-        else {
-          for(j=0;j<param_set.TYPE[field_index[i]].N_ELEM;j++) {
-	    fscanf(infile,"%lf", &veg_hist_data[field_index[i]][j][rec]);
-          }
-        }
-      }
-      fgets(str, MAXSTRING, infile);
-      rec++;
-    }
   }
   
   if(rec * param_set.FORCE_DT[file_num] 
@@ -5,7 +5,7 @@
  
 static char vcid[] = "$Id$";
 
-double **read_forcing_data(FILE                **infile,
+double **read_forcing_data(filep_struct         *filep,
 			   global_param_struct   global_param,
 			   double            ****veg_hist_data)
 /**********************************************************************
@@ -20,11 +20,13 @@ double **read_forcing_data(FILE                **infile,
   2014-Apr-25 Added non-climatological veg parameters (as forcing
 	      variables).						TJB
   2014-Apr-25 Added partial vegcover fraction.				TJB
+  2026-Oct-18 Replaced infile with filep in the argument list, for
+	      packed forcing files.
 **********************************************************************/
 {
-  extern option_struct    options;
-  extern param_set_struct param_set;
-  extern int              NR, NF;
+  extern THREAD_LOCAL option_struct    options;
+  extern THREAD_LOCAL param_set_struct param_set;
+  extern THREAD_LOCAL int              NR, NF;
 
   char                 errorstr[MAXSTRING];
   int                  i,j;
@@ -49,7 +51,7 @@ double **read_forcing_data(FILE                **infile,
 
   /** Read First Forcing Data File **/
   if(param_set.FORCE_DT[0] > 0) {
-    read_atmos_data(infile[0], global_param, 0, global_param.forceskip[0],
+    read_atmos_data(filep, global_param, 0, global_param.forceskip[0],
 		    forcing_data, (*veg_hist_data));
   }
   else {
@@ -59,7 +61,7 @@ double **read_forcing_data(FILE                **infile,
 
   /** Read Second Forcing Data File **/
   if(param_set.FORCE_DT[1] > 0) {
-    read_atmos_data(infile[1], global_param, 1, global_param.forceskip[1], 
+    read_atmos_data(filep, global_param, 1, global_param.forceskip[1], 
 		    forcing_data, (*veg_hist_data));
   }
 
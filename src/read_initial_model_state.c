@@ -6,6 +6,7 @@
 static char vcid[] = "$Id$";
 
 void read_initial_model_state(FILE                *init_state,
+			      state_index_struct  *init_state_index,
 			      all_vars_struct     *all_vars,
 			      global_param_struct *gp,
 			      int                  Nveg,
@@ -88,13 +89,18 @@ void read_initial_model_state(FILE                *init_state,
   2013-Dec-27 Moved SPATIAL_FROST to options_struct.			TJB
   2013-Dec-28 Removed NO_REWIND option.					TJB
   2014-Mar-28 Removed DIST_PRCP option.					TJB
+  2026-Oct-18 If the binary state file has an index (init_state_index
+	      is not NULL), the cell's record is found with one seek.
+	      Otherwise, the records of other cells are skipped with
+	      fseek() instead of being read one byte at a time.
+  2026-Oct-18 Reads the record of the cell from snapshot
+	      gp->init_state_snapshot of a multi-snapshot state file.
 *********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   char   tmpstr[MAXSTRING];
   char   ErrStr[MAXSTRING];
-  char   tmpchar;
   double tmpval;
   double depth_node[MAX_NODES];
   int    veg, iveg;
@@ -105,7 +111,7 @@ void read_initial_model_state(FILE                *init_state,
   int    tmp_Nveg;
   int    tmp_Nband;
   int    tmp_char;
-  int    byte, Nbytes;
+  int    Nbytes;
   int    tmp_int, node;
   int    frost_area;
 
@@ -121,6 +127,19 @@ void read_initial_model_state(FILE                *init_state,
   energy  = all_vars->energy;
   lake_var = &all_vars->lake_var;
 
+  /* go straight to the cell's record, if the file is indexed */
+  if ( options.BINARY_STATE_FILE && init_state_index != NULL ) {
+    if ( !seek_state_cell(init_state_index, init_state,
+			  gp->init_state_snapshot < 0 ? 0 : gp->init_state_snapshot,
+			  cellnum) ) {
+      sprintf(ErrStr, "Requested grid cell (%d) is not in the model state file.", 
+	      cellnum);
+      nrerror(ErrStr);
+    }
+  }
+  else if ( gp->init_state_snapshot >= 0 )
+    nrerror("The multi-snapshot model state file has no index, so the records of the requested snapshot cannot be found.  The state file may be incomplete.");
+
   /* read cell information */
   if ( options.BINARY_STATE_FILE ) {
     fread( &tmp_cellnum, sizeof(int), 1, init_state );
@@ -134,8 +153,7 @@ void read_initial_model_state(FILE                *init_state,
   while ( tmp_cellnum != cellnum && !feof(init_state) ) {
     if ( options.BINARY_STATE_FILE ) {
       // skip rest of current cells info
-      for ( byte = 0; byte < Nbytes; byte++ ) 
-	fread ( &tmpchar, 1, 1, init_state);
+      fseek( init_state, Nbytes, SEEK_CUR );
       // read info for next cell
       fread( &tmp_cellnum, sizeof(int), 1, init_state );
       fread( &tmp_Nveg, sizeof(int), 1, init_state );
@@ -69,7 +69,7 @@ lake_con_struct read_lakeparam(FILE            *lakeparam,
 **********************************************************************/
 
 {
-  extern option_struct   options;
+  extern THREAD_LOCAL option_struct   options;
   int    i;
   int    lakecel;
   int    junk, flag;
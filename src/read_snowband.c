@@ -27,7 +27,7 @@ void read_snowband(FILE    *snowband,
   2013-Dec-28 Removed NO_REWIND option.					TJB
 **********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   char    ErrStr[MAXSTRING];
   int     band;
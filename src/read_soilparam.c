@@ -6,6 +6,7 @@
 static char vcid[] = "$Id$";
 
 soil_con_struct read_soilparam(FILE *soilparam,
+			       cell_journal_struct *cell_journal,
 			       char *RUN_MODEL,
 			       char *MODEL_DONE)
 /**********************************************************************
@@ -125,12 +126,14 @@ soil_con_struct read_soilparam(FILE *soilparam,
   2013-Dec-27 Moved OUTPUT_FORCE to options_struct.			TJB
   2014-Mar-24 Removed ARC_SOIL option                               BN
   2014-Mar-28 Removed DIST_PRCP option.								TJB
+  2026-Oct-18 Added cell_journal; cells that an earlier, interrupted run
+	      has finished are not run (RUN_MODEL is FALSE).
 **********************************************************************/
 {
   void ttrim( char *string );
-  extern option_struct options;
-  extern global_param_struct global_param;
-  extern veg_lib_struct *veg_lib;
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL global_param_struct global_param;
+  extern THREAD_LOCAL veg_lib_struct *veg_lib;
   char            ErrStr[MAXSTRING];
   char            line[MAXSTRING];
   char            tmpline[MAXSTRING];
@@ -178,6 +181,12 @@ soil_con_struct read_soilparam(FILE *soilparam,
       sprintf(ErrStr,"ERROR: Unexpected EOF while reading soil file\n");
       nrerror(ErrStr);
     }
+
+    /* skip cells that an earlier, interrupted run has finished */
+    if (*RUN_MODEL && cell_journal != NULL
+        && sscanf(line, "%d", &tempint) == 1
+        && cell_journal_done(cell_journal, tempint))
+      *RUN_MODEL = FALSE;
   }
   else {
     *MODEL_DONE = TRUE;
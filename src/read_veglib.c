@@ -28,7 +28,7 @@ veg_lib_struct *read_veglib(FILE *veglib, int *Ntype)
   2014-Apr-25 Added partial vegcover fraction.				TJB
 **********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   veg_lib_struct *temp;
   int    i, j;
   int    tmpflag;
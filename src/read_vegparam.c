@@ -55,8 +55,8 @@ veg_con_struct *read_vegparam(FILE *vegparam,
 {
 
   void ttrim( char *string );
-  extern veg_lib_struct *veg_lib;
-  extern option_struct   options;
+  extern THREAD_LOCAL veg_lib_struct *veg_lib;
+  extern THREAD_LOCAL option_struct   options;
   veg_con_struct *temp;
   int             vegcel, i, j, k, vegetat_type_num, skip, veg_class;
   int             MaxVeg;
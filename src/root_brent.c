@@ -101,7 +101,17 @@ static char vcid[] = "$Id$";
   2007-Sep-01 Removed the integer "eval" since it is never used for anything.	JCA
   2009-May-22 Modified root-bracketing scheme to handle case when one bound
 	      yields garbage output from the target function.			TJB
+  2026-Oct-18 Each call is recorded in the solver telemetry
+	      (SOLVER_TELEMETRY), with its iterations and bracket
+	      expansions.
 *****************************************************************************/
+static double brent_return(double root, double start, int Niter, int Nexpand)
+/* Records the call in the solver telemetry, and returns root */
+{
+  solver_call_end(ST_ROOT_BRENT, start, Niter, Nexpand, root == ERROR);
+  return root;
+}
+
 double root_brent(double LowerBound, double UpperBound, char *ErrorString,
                 double (*Function)(double Estimate, va_list ap), ...)
 {
@@ -123,10 +133,13 @@ double root_brent(double LowerBound, double UpperBound, char *ErrorString,
   double tol;
   double last_bad;
   double last_good;
+  double start;
   int which_err;
   int i;
   int j;
 
+  start = solver_call_start();
+
   /* initialize variable argument list */
   a = LowerBound;
   b = UpperBound;
@@ -141,7 +154,7 @@ double root_brent(double LowerBound, double UpperBound, char *ErrorString,
   if (fa == ERROR && fb == ERROR) {
     sprintf(ErrorString,"ERROR: %s: lower and upper bounds %f and %f failed to bracket the root because the given function was not defined at either point.\n",Routine,a,b);
     va_end(ap);
-    return(ERROR);
+    return(brent_return(ERROR, start, 0, 0));
   }      
 
   // If Function returns value of ERROR for one bound but not both bounds,
@@ -177,7 +190,7 @@ double root_brent(double LowerBound, double UpperBound, char *ErrorString,
       /* if we get here, we could not find a bound for which the function returns a valid value */
       sprintf(ErrorString,"ERROR: %s: the given function produced undefined values while attempting to bracket the root between %f and %f.\n",Routine,LowerBound,UpperBound);
       va_end(ap);
-      return(ERROR);
+      return(brent_return(ERROR, start, 0, 0));
     }
     else {
       if (which_err == -1) {
@@ -215,7 +228,7 @@ double root_brent(double LowerBound, double UpperBound, char *ErrorString,
           /* Undefined function values in both directions - give up */
           sprintf(ErrorString,"ERROR: %s: the given function produced undefined values while attempting to bracket the root between %f and %f.\n",Routine,LowerBound,UpperBound);
           va_end(ap);
-          return(ERROR);
+          return(brent_return(ERROR, start, 0, j));
         }
         last_good = a;
       }
@@ -227,7 +240,7 @@ double root_brent(double LowerBound, double UpperBound, char *ErrorString,
           /* Undefined function values in both directions - give up */
           sprintf(ErrorString,"ERROR: %s: the given function produced undefined values while attempting to bracket the root between %f and %f.\n",Routine,LowerBound,UpperBound);
           va_end(ap);
-          return(ERROR);
+          return(brent_return(ERROR, start, 0, j));
         }
         last_good = b;
       }
@@ -249,7 +262,7 @@ double root_brent(double LowerBound, double UpperBound, char *ErrorString,
         /* if we get here, we could not find a bound for which the function returns a valid value */
         sprintf(ErrorString,"ERROR: %s: the given function produced undefined values while attempting to bracket the root between %f and %f.\n",Routine,LowerBound,UpperBound);
         va_end(ap);
-        return(ERROR);
+        return(brent_return(ERROR, start, 0, j));
       }
       else {
         if (which_err == -1) {
@@ -270,7 +283,7 @@ double root_brent(double LowerBound, double UpperBound, char *ErrorString,
     /* if we get here, the lower and upper bounds did not bracket the root */
     sprintf(ErrorString,"WARNING: %s: lower and upper bounds %f and %f failed to bracket the root.\n",Routine,a,b);
     va_end(ap);
-    return(ERROR);
+    return(brent_return(ERROR, start, 0, j));
   }
 
   // At this point, we have bracketed the root
@@ -302,7 +315,7 @@ double root_brent(double LowerBound, double UpperBound, char *ErrorString,
     
     if (fabs(m) <= tol || fb == 0) {
       va_end(ap);
-      return b;
+      return(brent_return(b, start, i+1, j));
     }
     
     else {
@@ -354,7 +367,7 @@ double root_brent(double LowerBound, double UpperBound, char *ErrorString,
       if(fb == ERROR){
 	sprintf(ErrorString,"ERROR returned to root_brent on iteration %d: temperature = %.4f\n",i+1,b);
 	va_end(ap);
-	return( ERROR );
+	return(brent_return(ERROR, start, i+1, j));
       }      
 
     }
@@ -362,7 +375,7 @@ double root_brent(double LowerBound, double UpperBound, char *ErrorString,
   /* If we get here, there were too many iterations */
   sprintf(ErrorString,"WARNING: %s: too many iterations.\n",Routine);
   va_end(ap);
-  return(ERROR);
+  return(brent_return(ERROR, start, MAXITER, j));
 
 }
 
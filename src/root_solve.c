@@ -0,0 +1,284 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <math.h>
+#include <vicNl.h>
+
+static char vcid[] = "$Id$";
+
+#define MAXITER  1000
+#define MACHEPS  3e-8
+#define T        1e-7
+#define MAXWARM  6     /* secant steps taken from the starting guess */
+#define WARM_DT  2.0   /* first step away from the starting guess (C) */
+#define MAXRANGE 50.   /* how far root_brent() may expand the bounds (C) */
+
+/**********************************************************************
+  root_solve					October 2026
+
+  Finds the temperature at which Function(Estimate, args) is zero, for
+  the energy balance functions (func_surf_energy_bal(),
+  func_canopy_energy_bal() and func_atmos_energy_bal()), whose inputs
+  are passed in a structure args filled once by the caller instead of
+  in a variable argument list.
+
+  The search starts from Guess, normally the temperature that solved
+  the balance in the previous time step.  From Guess and a point
+  WARM_DT away from it, secant steps are taken until a step is within
+  the tolerance of root_brent(), or two consecutive points bracket the
+  root.  Each step is extended by the tolerance
+  with which the root is found, so that once the secant estimate is
+  accurate the step crosses the root.  The bracket found this way is
+  then narrowed with the safeguarded secant and inverse quadratic
+  steps of Brent's method, as in root_brent().  Since the bracket is
+  usually narrow, this takes fewer evaluations of Function than
+  bracketing the root between LowerBound and UpperBound.
+
+  This search is only made with ENERGY_WARM_START = TRUE.  Otherwise
+  (the default) the root is found by root_brent() between LowerBound
+  and UpperBound, as before root_solve() was added, so that output is
+  unchanged.
+
+  Guess is moved into [LowerBound, UpperBound] if it lies outside.
+  The secant steps may leave these bounds by up to MAXRANGE, which is
+  as far as root_brent() expands them when they do not bracket the
+  root.  If no bracket is found within MAXWARM steps and this range,
+  or Function returns ERROR, the root is found by root_brent() between
+  LowerBound and UpperBound, exactly as before.  The root is found to
+  the tolerance of root_brent().
+
+  Returns the root, or ERROR with a description in ErrorString.
+  *Nevals is set to the number of evaluations of Function.
+
+  Modifications:
+  2026-Oct-18 Each call is recorded in the solver telemetry
+	      (SOLVER_TELEMETRY), with its function evaluations and
+	      whether it fell back to root_brent().
+  2026-Oct-18 The search from Guess is only made with
+	      ENERGY_WARM_START = TRUE.
+**********************************************************************/
+
+typedef double (*root_solve_func)(double, void *);
+
+static double brent_bracketed(double a, double b, double fa, double fb,
+                              char *ErrorString, root_solve_func Function,
+                              void *args, int *Nevals)
+/**********************************************************************
+  Brent's method of root_brent(), starting from a bracket [a, b] whose
+  function values fa and fb have opposite signs.
+**********************************************************************/
+{
+  double c;
+  double d;
+  double e;
+  double fc;
+  double m;
+  double p;
+  double q;
+  double r;
+  double s;
+  double tol;
+  int    i;
+
+  c = b;
+  fc = fb;
+  d = e = b - a;
+
+  for (i = 0; i < MAXITER; i++) {
+
+    if (fb*fc > 0) {
+      c = a;
+      fc = fa;
+      d = b - a;
+      e = d;
+    }
+
+    if (fabs(fc) < fabs(fb)) {
+      a = b;
+      b = c;
+      c = a;
+      fa = fb;
+      fb = fc;
+      fc = fa;
+    }
+
+    tol = 2 * MACHEPS * fabs(b) + T;
+    m = 0.5 * (c - b);
+
+    if (fabs(m) <= tol || fb == 0)
+      return b;
+
+    if (fabs(e) < tol || fabs(fa) <= fabs(fb)) {
+      d = m;
+      e = d;
+    }
+    else {
+      s = fb/fa;
+      if (a == c) {
+        /* linear interpolation */
+        p = 2 * m * s;
+        q = 1 - s;
+      }
+      else {
+        /* inverse quadratic interpolation */
+        q = fa/fc;
+        r = fb/fc;
+        p = s * (2 * m * q * (q - r) - (b - a) * (r - 1));
+        q = (q - 1) * (r - 1) * (s - 1);
+      }
+      if (p > 0)
+        q = -q;
+      else
+        p = -p;
+      s = e;
+      e = d;
+      if ((2 * p) < ( 3 * m * q - fabs(tol * q)) && p < fabs(0.5 * s * q))
+        d = p/q;
+      else {
+        d = m;
+        e = d;
+      }
+    }
+    a = b;
+    fa = fb;
+    b += (fabs(d) > tol) ? d : ((m > 0) ? tol : -tol);
+    fb = Function(b, args);
+    (*Nevals)++;
+
+    if (fb == ERROR) {
+      sprintf(ErrorString,"ERROR returned to root_solve on iteration %d: temperature = %.4f\n",i+1,b);
+      return(ERROR);
+    }
+
+  }
+
+  sprintf(ErrorString,"WARNING: root_solve: too many iterations.\n");
+  return(ERROR);
+
+}
+
+static double root_brent_func(double Estimate, va_list ap)
+/**********************************************************************
+  Evaluates the function passed to root_brent() by root_solve().
+**********************************************************************/
+{
+  root_solve_func  Function;
+  void            *args;
+  int             *Nevals;
+
+  Function = va_arg(ap, root_solve_func);
+  args     = va_arg(ap, void *);
+  Nevals   = va_arg(ap, int *);
+
+  (*Nevals)++;
+  return Function(Estimate, args);
+
+}
+
+static double warm_solve(double           Guess,
+                         double           LowerBound,
+                         double           UpperBound,
+                         char            *ErrorString,
+                         root_solve_func  Function,
+                         void            *args,
+                         int             *Nevals,
+                         int             *fallback)
+/**********************************************************************
+  The search of root_solve(); *fallback is set to TRUE if the root had
+  to be bracketed by root_brent().
+**********************************************************************/
+{
+  double x0;
+  double x1;
+  double f0;
+  double f1;
+  double dx;
+  double tol;
+  int    j;
+
+  *Nevals = 0;
+  *fallback = FALSE;
+
+  /* start from the guess, and step towards the middle of the bounds */
+  x0 = Guess;
+  if (x0 < LowerBound) x0 = LowerBound;
+  if (x0 > UpperBound) x0 = UpperBound;
+  f0 = Function(x0, args);
+  (*Nevals)++;
+  if (f0 == 0)
+    return x0;
+  x1 = (x0 < 0.5*(LowerBound+UpperBound)) ? x0 + WARM_DT : x0 - WARM_DT;
+
+  for (j = 0; j < MAXWARM && f0 != ERROR; j++) {
+
+    f1 = Function(x1, args);
+    (*Nevals)++;
+    if (f1 == ERROR)
+      break;
+    if (f1 == 0)
+      return x1;
+    if (f0*f1 < 0)
+      return brent_bracketed(x0, x1, f0, f1, ErrorString, Function, args,
+                             Nevals);
+    if (f1 == f0)
+      break;
+
+    /* secant step; once it is within the tolerance the root is found,
+       otherwise it is extended by the tolerance so that it crosses the
+       root once the estimate is accurate */
+    tol = 2 * MACHEPS * fabs(x1) + T;
+    dx = -f1 * (x1 - x0) / (f1 - f0);
+    if (fabs(dx) <= tol)
+      return x1 + dx;
+    dx += (dx > 0) ? tol : -tol;
+    x0 = x1;
+    f0 = f1;
+    x1 = x0 + dx;
+    if (x1 < LowerBound - MAXRANGE || x1 > UpperBound + MAXRANGE)
+      break;
+
+  }
+
+  /* no bracket near the guess: bracket the root between the bounds */
+  *fallback = TRUE;
+  return root_brent(LowerBound, UpperBound, ErrorString, root_brent_func,
+                    Function, args, Nevals);
+
+}
+
+double root_solve(double  Guess,
+                  double  LowerBound,
+                  double  UpperBound,
+                  char   *ErrorString,
+                  double (*Function)(double Estimate, void *args),
+                  void   *args,
+                  int    *Nevals)
+{
+  extern THREAD_LOCAL option_struct options;
+
+  double start;
+  double root;
+  int    fallback;
+
+  start = solver_call_start();
+  if (options.ENERGY_WARM_START)
+    root = warm_solve(Guess, LowerBound, UpperBound, ErrorString, Function,
+                      args, Nevals, &fallback);
+  else {
+    *Nevals = 0;
+    fallback = FALSE;
+    root = root_brent(LowerBound, UpperBound, ErrorString, root_brent_func,
+                      Function, args, Nevals);
+  }
+  solver_call_end(ST_ROOT_SOLVE, start, *Nevals, 0, fallback);
+
+  return root;
+
+}
+
+#undef MAXITER
+#undef MACHEPS
+#undef T
+#undef MAXWARM
+#undef WARM_DT
+#undef MAXRANGE
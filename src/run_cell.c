@@ -0,0 +1,302 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vicNl.h>
+
+static char vcid[] = "$Id$";
+
+void prepare_cell(soil_con_struct       *soil_con,
+                  veg_con_struct        *veg_con,
+                  atmos_data_struct     *atmos,
+                  dmy_struct            *dmy,
+                  filep_struct          *filep,
+                  filenames_struct      *filenames,
+                  out_data_file_struct  *out_data_files,
+                  out_data_struct       *out_data,
+                  veg_hist_struct     ***veg_hist,
+                  cell_arena_struct     *arena)
+/**********************************************************************
+  prepare_cell					October 2026
+
+  First phase of running a grid cell: opens the cell's forcing and
+  output files, writes the output file headers, and reads and
+  disaggregates the cell's forcings into atmos (and, if veg parameters
+  are read from the forcing files, into *veg_hist, which is allocated
+  here from arena).  With OUTPUT_FORCE, this writes the forcing output
+  files.
+
+  This phase does not touch the model state, so it can be run for one
+  cell while the previous cell is being simulated (see PREFETCH).  The
+  calling thread must have bound the cell's context.
+**********************************************************************/
+{
+  extern THREAD_LOCAL veg_lib_struct *veg_lib;
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL global_param_struct global_param;
+
+  double phase;
+
+  /** Build Gridded Filenames, and Open **/
+  make_in_and_outfiles(filep, filenames, soil_con, out_data_files);
+
+  if (options.PRT_HEADER) {
+    /** Write output file headers **/
+    write_header(out_data_files, out_data, dmy, global_param);
+  }
+
+  *veg_hist = NULL;
+  if (!options.OUTPUT_FORCE) {
+
+    /** allocate memory for the veg_hist_struct **/
+    alloc_veg_hist(global_param.nrecs, veg_con[0].vegetat_type_num, veg_hist,
+                   arena);
+
+  } /* !OUTPUT_FORCE */
+
+  /**************************************************
+     Initialize Meteological Forcing Values That
+     Have not Been Specifically Set
+   **************************************************/
+
+#if VERBOSE
+  fprintf(stderr,"Initializing Forcing Data\n");
+#endif /* VERBOSE */
+
+  phase = phase_start();
+  initialize_atmos(atmos, dmy, filep, veg_lib, veg_con, *veg_hist,
+		   soil_con, out_data_files, out_data);
+  phase_end(PH_INIT_ATMOS, phase);
+
+}
+
+int simulate_cell(int                   cellnum,
+                  soil_con_struct      *soil_con,
+                  veg_con_struct       *veg_con,
+                  lake_con_struct      *lake_con,
+                  atmos_data_struct    *atmos,
+                  dmy_struct           *dmy,
+                  int                   startrec,
+                  filep_struct         *filep,
+                  filenames_struct     *filenames,
+                  out_data_file_struct *out_data_files,
+                  out_data_struct      *out_data,
+                  veg_hist_struct     **veg_hist,
+                  cell_arena_struct    *arena)
+/**********************************************************************
+  simulate_cell					October 2026
+
+  Second phase of running a grid cell, after prepare_cell(): initializes
+  the model state (allocated from arena), runs all time steps, writes
+  the model state to filep->statefile on each state date (if
+  filep->statefile is not NULL), and closes the cell's files.  The
+  calling thread must have bound the cell's context.  With
+  ASYNC_OUTPUT, the output records are written by an output writer
+  thread (see output_writer.c), which is stopped before the files are
+  closed.  The caller resets arena once it is done with the cell, which
+  frees the model state and veg_hist.
+  With SOLVER_TELEMETRY, the calls of the solvers made while running
+  the cell are written to the telemetry file filep->solver_telemetry.
+  With PHASE_PROFILE, the cell's phase times are printed.
+  The heap allocations of full_energy() and put_data() are counted as
+  those of the time steps in vicNl_alloc (see alloc_count.c).
+
+  Returns ERROR if the model state could not be initialized (and
+  CONTINUEONERROR is TRUE), in which case the cell's files are left
+  open and no further cells should be run; otherwise returns 0.
+  Errors during the time step loop are handled here according to
+  CONTINUEONERROR.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL Error_struct Error;
+  extern THREAD_LOCAL global_param_struct global_param;
+
+  char                     ErrStr[MAXSTRING];
+  int                      rec;
+  int                      snapshot;
+  int                      ErrorFlag;
+  double                   phase;
+  all_vars_struct          all_vars;
+  save_data_struct         save_data;
+  output_writer_struct    *output_writer;
+
+  if (!options.OUTPUT_FORCE) {
+
+    /** Make Top-level Control Structure **/
+    all_vars     = make_all_vars(veg_con[0].vegetat_type_num, arena);
+
+    /**************************************************
+      Initialize Energy Balance and Snow Variables
+    **************************************************/
+
+#if VERBOSE
+    fprintf(stderr,"Model State Initialization\n");
+#endif /* VERBOSE */
+    rec = startrec;
+    start_solver_telemetry(soil_con->gridcel, &dmy[startrec]);
+    phase = phase_start();
+    ErrorFlag = initialize_model_state(&all_vars, dmy[0], &global_param, *filep,
+			   soil_con->gridcel, veg_con[0].vegetat_type_num,
+			   options.Nnode,
+			   atmos[0].air_temp[NR],
+			   soil_con, veg_con, *lake_con);
+    phase_end(PH_INIT_STATE, phase);
+    if ( ErrorFlag == ERROR ) {
+      if ( options.CONTINUEONERROR == TRUE ) {
+	// Handle grid cell solution error
+	fprintf(stderr, "ERROR: Grid cell %i failed in record %i so the simulation has not finished.  An incomplete output file has been generated, check your inputs before rerunning the simulation.\n", soil_con->gridcel, rec);
+	write_solver_telemetry(filep->solver_telemetry);
+	write_phase_profile(soil_con->gridcel);
+	return ( ERROR );
+      } else {
+	// Else exit program on cell solution error as in previous versions
+	sprintf(ErrStr, "ERROR: Grid cell %i failed in record %i so the simulation has ended. Check your inputs before rerunning the simulation.\n", soil_con->gridcel, rec);
+	vicerror(ErrStr);
+      }
+    }
+
+#if VERBOSE
+    fprintf(stderr,"Running Model\n");
+#endif /* VERBOSE */
+
+    /** Start the output writer thread **/
+    output_writer = NULL;
+    if (options.ASYNC_OUTPUT)
+      output_writer = start_output_writer(out_data_files, out_data,
+                                          global_param.out_dt);
+
+    /** Update Error Handling Structure **/
+    Error.filep = *filep;
+    Error.out_data_files = out_data_files;
+    Error.output_writer = output_writer;
+
+    /** Initialize the storage terms in the water and energy balances **/
+    /** Sending a negative record number (-global_param.nrecs) to put_data() will accomplish this **/
+    phase = phase_start();
+    ErrorFlag = put_data(&all_vars, &atmos[0], soil_con, veg_con, lake_con, out_data_files, out_data, output_writer, &save_data, &dmy[0], -global_param.nrecs);
+    phase_end(PH_PUT_DATA, phase);
+
+    /******************************************
+      Run Model in Grid Cell for all Time Steps
+    ******************************************/
+
+    for ( rec = startrec ; rec < global_param.nrecs; rec++ ) {
+
+      /**************************************************
+	Compute cell physics for 1 timestep
+      **************************************************/
+      solver_telemetry_month(&dmy[rec]);
+      alloc_count_phase(ALLOC_TIME_STEP);
+      phase = phase_start();
+      ErrorFlag = full_energy(cellnum, rec, &atmos[rec], &all_vars, dmy, &global_param, lake_con, soil_con, veg_con, veg_hist);
+      phase_end(PH_FULL_ENERGY, phase);
+
+      /**************************************************
+	Write cell average values for current time step
+      **************************************************/
+      phase = phase_start();
+      ErrorFlag = put_data(&all_vars, &atmos[rec], soil_con, veg_con, lake_con, out_data_files, out_data, output_writer, &save_data, &dmy[rec], rec);
+      phase_end(PH_PUT_DATA, phase);
+      alloc_count_phase(ALLOC_SETUP);
+
+      /************************************
+	Save model state at assigned date
+	(after the final time step of the assigned date)
+      ************************************/
+      if ( filep->statefile != NULL
+	   && ( snapshot = state_snapshot(&global_param, dmy, rec) ) >= 0 )
+	write_model_state(&all_vars, &global_param, veg_con->vegetat_type_num, soil_con->gridcel, snapshot, filep, soil_con, *lake_con);
+
+      if ( ErrorFlag == ERROR ) {
+	if ( options.CONTINUEONERROR == TRUE ) {
+	  // Handle grid cell solution error
+	  fprintf(stderr, "ERROR: Grid cell %i failed in record %i so the simulation has not finished.  An incomplete output file has been generated, check your inputs before rerunning the simulation.\n", soil_con->gridcel, rec);
+	  break;
+	} else {
+	  // Else exit program on cell solution error as in previous versions
+	  sprintf(ErrStr, "ERROR: Grid cell %i failed in record %i so the simulation has ended. Check your inputs before rerunning the simulation.\n", soil_con->gridcel, rec);
+	  vicerror(ErrStr);
+	}
+      }
+
+    } /* End Rec Loop */
+
+    /** Wait for the remaining output records to be written **/
+    if (output_writer != NULL)
+      finish_output_writer(&output_writer);
+    Error.output_writer = NULL;
+
+    /** Write the cell's solver telemetry and phase times **/
+    write_solver_telemetry(filep->solver_telemetry);
+    write_phase_profile(soil_con->gridcel);
+
+  } /* !OUTPUT_FORCE */
+
+  close_files(filep, out_data_files, filenames);
+
+  return ( 0 );
+
+}
+
+int run_cell(vic_context_struct   *ctx,
+             int                   cellnum,
+             soil_con_struct      *soil_con,
+             veg_con_struct       *veg_con,
+             lake_con_struct      *lake_con,
+             atmos_data_struct    *atmos,
+             dmy_struct           *dmy,
+             int                   startrec,
+             filep_struct         *filep,
+             filenames_struct     *filenames,
+             out_data_file_struct *out_data_files,
+             out_data_struct      *out_data,
+             cell_arena_struct    *arena)
+/**********************************************************************
+  run_cell					October 2026
+
+  This routine runs the model for a single grid cell whose parameters
+  (soil_con, veg_con, lake_con, and the snow band data stored in
+  soil_con) have already been read.  It opens the cell's forcing and
+  output files, initializes the forcings and the model state, runs
+  all time steps, writes the model state to filep->statefile on each
+  state date (if filep->statefile is not NULL), and closes the cell's
+  files.
+
+  The model configuration is taken from ctx, which is bound to the
+  calling thread first; ctx->veg_lib must be the veg library as
+  modified by read_vegparam() for this cell.
+
+  The cell's model state and veg_hist are allocated from arena.  The
+  caller remains responsible for resetting arena, and for freeing
+  veg_con and the arrays in soil_con.
+
+  Returns ERROR if the model state could not be initialized (and
+  CONTINUEONERROR is TRUE), in which case no further cells should be
+  run; otherwise returns 0.  Errors during the time step loop are
+  handled here according to CONTINUEONERROR.
+
+  Modifications:
+  2026-Oct-18 Moved the per-cell portion of the main program from
+	      vicNl.c to this routine so that it can be shared by the
+	      serial and thread-parallel (NTHREADS > 1) drivers.
+  2026-Oct-18 Added ctx to the argument list.
+  2026-Oct-18 Split into prepare_cell() and simulate_cell(), so that
+	      the forcings of one cell can be prepared while the previous
+	      cell is simulated (PREFETCH option).
+  2026-Oct-18 Added arena to the argument list; the cell's model state
+	      and veg_hist are now allocated from it.
+**********************************************************************/
+{
+  veg_hist_struct        **veg_hist;
+
+  /** Install the simulation's configuration in this thread **/
+  bind_vic_context(ctx);
+
+  prepare_cell(soil_con, veg_con, atmos, dmy, filep, filenames,
+               out_data_files, out_data, &veg_hist, arena);
+
+  return ( simulate_cell(cellnum, soil_con, veg_con, lake_con, atmos, dmy,
+                         startrec, filep, filenames, out_data_files,
+                         out_data, veg_hist, arena) );
+
+}
@@ -168,7 +168,7 @@ int  runoff(cell_data_struct  *cell,
   2014-May-09 Added check on liquid soil moisture to ensure always >= 0.	TJB
 **********************************************************************/
 {  
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   int                firstlayer, lindex;
   int                i;
   int                last_layer[MAX_LAYERS*3];
@@ -533,7 +533,7 @@ int  runoff(cell_data_struct  *cell,
 void compute_runoff_and_asat(soil_con_struct *soil_con, double *moist, double inflow, double *A, double *runoff)
 {
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   double top_moist;  // total moisture (liquid and frozen) in topmost soil layers (mm)
   double top_max_moist;  // maximum storable moisture (liquid and frozen) in topmost soil layers (mm)
   int lindex;
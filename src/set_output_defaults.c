@@ -32,7 +32,7 @@ out_data_file_struct *set_output_defaults(out_data_struct *out_data) {
   2013-Dec-27 Moved OUTPUT_FORCE to options_struct.			TJB
 *************************************************************/
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   out_data_file_struct *out_data_files;
   int v, i;
   int filenum;
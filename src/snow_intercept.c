@@ -81,6 +81,9 @@ static char vcid[] = "$Id$";
   2013-Dec-27 Moved SPATIAL_FROST to options_struct.			TJB
   2014-Mar-28 Removed DIST_PRCP option.					TJB
   2014-May-05 Added logic to handle LAI = 0.				TJB
+  2026-Oct-18 The inputs of func_canopy_energy_bal() are now filled in
+	      once, in a canopy_energy_bal_args_struct, and Tfoliage is
+	      found by root_solve(), starting from the previous Tfoliage.
 *****************************************************************************/
 int snow_intercept(double  Dt,
 		   double  F,  
@@ -134,7 +137,7 @@ int snow_intercept(double  Dt,
 		   veg_var_struct    *veg_var)
 {
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   /* double AdvectedEnergy; */         /* Energy advected by the rain (W/m2) */
   double BlownSnow;              /* Depth of snow blown of the canopy (m) */
@@ -189,6 +192,8 @@ int snow_intercept(double  Dt,
   double  Catm; //
 
   char ErrorString[MAXSTRING];
+  canopy_energy_bal_args_struct canopy_args;
+  int     Nevals;
 
   AirDens   = atmos->density[hidx];
   EactAir   = atmos->vp[hidx];
@@ -340,6 +345,56 @@ int snow_intercept(double  Dt,
     *Tfoliage = Tcanopy;
   }
 
+  /* inputs of the canopy energy balance */
+  canopy_args.band           = band;
+  canopy_args.month          = month;
+  canopy_args.rec            = rec;
+  canopy_args.delta_t        = Dt;
+  canopy_args.elevation      = soil_con->elevation;
+  canopy_args.Wmax           = soil_con->max_moist;
+  canopy_args.Wcr            = soil_con->Wcr;
+  canopy_args.Wpwp           = soil_con->Wpwp;
+  canopy_args.depth          = soil_con->depth;
+  canopy_args.frost_fract    = soil_con->frost_fract;
+  canopy_args.AirDens        = AirDens;
+  canopy_args.EactAir        = EactAir;
+  canopy_args.Press          = Press;
+  canopy_args.Le             = Le;
+  canopy_args.Tcanopy        = Tcanopy;
+  canopy_args.Vpd            = Vpd;
+  canopy_args.shortwave      = shortwave;
+  canopy_args.Catm           = Catm;
+  canopy_args.dryFrac        = dryFrac;
+  canopy_args.Evap           = &Evap;
+  canopy_args.Ra             = Ra;
+  canopy_args.Ra_used        = Ra_used;
+  canopy_args.Rainfall       = *RainFall;
+  canopy_args.Wind           = Wind;
+  canopy_args.UnderStory     = UnderStory;
+  canopy_args.iveg           = iveg;
+  canopy_args.veg_class      = veg_class;
+  canopy_args.displacement   = displacement;
+  canopy_args.ref_height     = ref_height;
+  canopy_args.roughness      = roughness;
+  canopy_args.root           = root;
+  canopy_args.CanopLayerBnd  = CanopLayerBnd;
+  canopy_args.IntRain        = IntRainOrg;
+  canopy_args.IntSnow        = *IntSnow;
+  canopy_args.Wdew           = IntRain;
+  canopy_args.layer          = layer;
+  canopy_args.veg_var        = veg_var;
+  canopy_args.LongOverIn     = LongOverIn;
+  canopy_args.LongUnderOut   = LongUnderOut;
+  canopy_args.AdvectedEnergy = AdvectedEnergy;
+  canopy_args.LatentHeat     = LatentHeat;
+  canopy_args.LatentHeatSub  = LatentHeatSub;
+  canopy_args.LongOverOut    = LongOverOut;
+  canopy_args.NetLongOver    = NetLongOver;
+  canopy_args.NetRadiation   = &NetRadiation;
+  canopy_args.RefreezeEnergy = &RefreezeEnergy;
+  canopy_args.SensibleHeat   = SensibleHeat;
+  canopy_args.VaporMassFlux  = VaporMassFlux;
+
   /* Calculate the net radiation at the canopy surface, using the canopy 
      temperature.  The outgoing longwave is subtracted twice, because the 
      canopy radiates in two directions */
@@ -351,28 +406,9 @@ int snow_intercept(double  Dt,
 
     *AlbedoOver = NEW_SNOW_ALB; // albedo of intercepted snow in canopy
     *NetShortOver = (1. - *AlbedoOver) * ShortOverIn; // net SW in canopy
+    canopy_args.NetShortOver = *NetShortOver;
 
-    Qnet = solve_canopy_energy_bal(0., band, month, rec, Dt, 
-				   soil_con->elevation, soil_con->max_moist,
-				   soil_con->Wcr, soil_con->Wpwp, 
-				   soil_con->depth, 
-				   soil_con->frost_fract, 
-				   AirDens, EactAir, Press, Le, 
-				   Tcanopy, Vpd,
-				   shortwave, Catm, dryFrac,
-				   &Evap, Ra, Ra_used,
-				   *RainFall, Wind, UnderStory, iveg, 
-				   veg_class, displacement, ref_height, 
-				   roughness, root, CanopLayerBnd, 
-				   IntRainOrg, *IntSnow, 
-				   IntRain, layer, veg_var, 
-				   LongOverIn, LongUnderOut, 
-				   *NetShortOver, 
-				   AdvectedEnergy, 
-				   LatentHeat, LatentHeatSub, 
-				   LongOverOut, NetLongOver, &NetRadiation, 
-				   &RefreezeEnergy, SensibleHeat, 
-				   VaporMassFlux);
+    Qnet = func_canopy_energy_bal(0., &canopy_args);
 
     if ( Qnet != 0 ) {
       /* Intercepted snow not melting - need to find temperature */
@@ -388,6 +424,7 @@ int snow_intercept(double  Dt,
     /* No snow in canopy */
     *AlbedoOver = bare_albedo;
     *NetShortOver = (1. - *AlbedoOver) * ShortOverIn; // net SW in canopy
+    canopy_args.NetShortOver = *NetShortOver;
     Qnet = -9999;
     Tupper = (*Tfoliage) + SNOW_DT;
     Tlower = (*Tfoliage) - SNOW_DT;
@@ -396,24 +433,8 @@ int snow_intercept(double  Dt,
 
   if ( Tupper != MISSING && Tlower != MISSING ) {
 
-    *Tfoliage = root_brent(Tlower, Tupper, ErrorString, func_canopy_energy_bal,  band, 
-			   month, rec, Dt, soil_con->elevation, soil_con->max_moist, 
-			   soil_con->Wcr, soil_con->Wpwp, soil_con->depth, 
-			   soil_con->frost_fract, 
-			   AirDens, EactAir, Press, Le, 
-			   Tcanopy, Vpd, shortwave, Catm, dryFrac,
-			   &Evap, Ra, Ra_used,
-			   *RainFall, Wind, UnderStory, iveg, 
-			   veg_class, displacement, ref_height, 
-			   roughness, root, CanopLayerBnd, IntRainOrg, *IntSnow, 
-			   IntRain, layer, veg_var, 
-			   LongOverIn, LongUnderOut, 
-			   *NetShortOver, 
-			   AdvectedEnergy, 
-			   LatentHeat, LatentHeatSub, 
-			   LongOverOut, NetLongOver, &NetRadiation, 
-			   &RefreezeEnergy, SensibleHeat, 
-			   VaporMassFlux);
+    *Tfoliage = root_solve(*Tfoliage, Tlower, Tupper, ErrorString,
+			   func_canopy_energy_bal, &canopy_args, &Nevals);
     
     if ( *Tfoliage <= -998 ) {
       if (options.TFALLBACK) {
@@ -444,25 +465,7 @@ int snow_intercept(double  Dt,
       }
     }
     
-    Qnet = solve_canopy_energy_bal(*Tfoliage, band, month, rec, Dt, 
-				   soil_con->elevation, soil_con->max_moist, soil_con->Wcr, 
-				   soil_con->Wpwp, soil_con->depth, 
-				   soil_con->frost_fract, 
-				   AirDens, EactAir, Press, Le, 
-				   Tcanopy, Vpd, shortwave, Catm, dryFrac,
-				   &Evap, Ra, Ra_used,
-				   *RainFall, Wind, UnderStory, iveg, 
-				   veg_class, displacement, ref_height, 
-				   roughness, root, CanopLayerBnd,
-				   IntRainOrg, *IntSnow, 
-				   IntRain, layer, veg_var, 
-				   LongOverIn, LongUnderOut, 
-				   *NetShortOver, 
-				   AdvectedEnergy, 
-				   LatentHeat, LatentHeatSub, 
-				   LongOverOut, NetLongOver, &NetRadiation, 
-				   &RefreezeEnergy, SensibleHeat, 
-				   VaporMassFlux);
+    Qnet = func_canopy_energy_bal(*Tfoliage, &canopy_args);
 
   }
 
@@ -629,18 +632,6 @@ int snow_intercept(double  Dt,
 
 }
 
-double solve_canopy_energy_bal(double Tfoliage, ...)
-{
-  va_list  ap;
-  double   Qnet;
-
-  va_start(ap, Tfoliage);
-  Qnet = func_canopy_energy_bal(Tfoliage, ap);
-  va_end(ap);
-
-  return Qnet;
-}
-
 double error_calc_canopy_energy_bal(double Tfoliage, ...)
 {
   va_list  ap;
@@ -656,7 +647,7 @@ double error_calc_canopy_energy_bal(double Tfoliage, ...)
 double error_print_canopy_energy_bal(double Tfoliage, va_list ap)
 {  
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   /* General Model Parameters */
   int     band;
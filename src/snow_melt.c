@@ -156,7 +156,7 @@ int  snow_melt(double            Le,
                snow_data_struct *snow,
 	       soil_con_struct  *soil_con)
 {
-  extern option_struct   options;
+  extern THREAD_LOCAL option_struct   options;
   int    Twidth;
   double error;
   double DeltaPackCC;            /* Change in cold content of the pack */
@@ -63,7 +63,7 @@ double snow_density(snow_data_struct *snow, double new_snow, double sswq, double
 
 **********************************************************************/
 
-  extern option_struct   options;
+  extern THREAD_LOCAL option_struct   options;
   double density_new;
   double density;
   double depth;
@@ -213,7 +213,7 @@ double new_snow_density(double air_temp) {
 	      compatibility.  DENS_BRAS = original algorithm; DENS_SNTHRM
 	      = Lundberg and Pomeroy (1998).				TJB
 **********************************************************************/
-  extern option_struct   options;
+  extern THREAD_LOCAL option_struct   options;
   double density_new;
 
   density_new = 0.0;
@@ -261,7 +261,7 @@ double snow_albedo(double new_snow,
 	      104 (D16), 19,587-19,597, 1999.				KAC via TJB
 **********************************************************************/
 
-  extern option_struct   options;
+  extern THREAD_LOCAL option_struct   options;
 
   /** New Snow **/
   if(new_snow > TraceSnow  && cold_content < 0.0 ) albedo = NEW_SNOW_ALB;
@@ -37,7 +37,8 @@
 
   programmer: Ted Bohn
   date      : July 25, 2013
-  changes   :
+  changes   : 2026-Oct-18 Temporary arrays are now stored on the stack
+              instead of being allocated on every call.
   references: 
 ********************************************************************************/
 
@@ -53,16 +54,16 @@ void soil_carbon_balance(soil_con_struct *soil_con,
                          cell_data_struct *cell,
                          veg_var_struct  *veg_var)
 {
-  extern option_struct options;
-  extern global_param_struct global_param;
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL global_param_struct global_param;
   int i;
   int lidx;
   int Nnodes;
-  double *dZ;
-  double *dZCum;
+  double dZ[MAX_NODES];
+  double dZCum[MAX_NODES];
   double dZTot;
-  double *T;
-  double *w;
+  double T[MAX_NODES];
+  double w[MAX_NODES];
   double tmp_double;
   double b;
   double wtd;
@@ -82,10 +83,6 @@ void soil_carbon_balance(soil_con_struct *soil_con,
   if (soil_con->Zsum_node[i] > dZTot) {
     Nnodes--;
   }
-  dZ = (double*)calloc(Nnodes,sizeof(double));
-  dZCum = (double*)calloc(Nnodes,sizeof(double));
-  T = (double*)calloc(Nnodes,sizeof(double));
-  w = (double*)calloc(Nnodes,sizeof(double));
 
   // Assign node thicknesses and temperatures for subset
   dZTot = 0;
@@ -137,12 +134,5 @@ void soil_carbon_balance(soil_con_struct *soil_con,
   cell->CLitter += veg_var->Litterfall - cell->RhLitter;
   cell->CInter += (1-fAir)*cell->RhLitter*fInter - cell->RhInter;
   cell->CSlow += (1-fAir)*cell->RhLitter*(1-fInter) - cell->RhSlow;
-
-  // Free temporary dynamic arrays
-  free((char *)dZ);
-  free((char *)dZCum);
-  free((char *)T);
-  free((char *)w);
-
 }
 
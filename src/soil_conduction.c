@@ -105,6 +105,58 @@ double soil_conductivity(double moist,
   return (K);
 }
 
+double soil_conductivity_deriv(double moist,
+			       double Wu,
+			       double soil_dens_min,
+			       double bulk_dens_min,
+			       double quartz,
+			       double soil_density,
+			       double bulk_density,
+			       double organic) {
+/**********************************************************************
+  soil_conductivity_deriv			October 2026
+
+  Returns the derivative of soil_conductivity() with respect to the
+  liquid water content Wu (W/m/K per mm/mm), for the analytic Jacobian
+  of the implicit soil heat equation (see fda_heat_eqn()).  Only the
+  frozen soil branch of Johansen's method depends on Wu; the
+  derivative is zero for unfrozen soil and where the conductivity is
+  limited to its dry value.
+**********************************************************************/
+  double Ki = 2.2;      /* thermal conductivity of ice (W/mK) */
+  double Kw = 0.57;     /* thermal conductivity of water (W/mK) */
+  double Ksat;
+  double Kdry;
+  double Kdry_org = 0.05;
+  double Kdry_min;
+  double Ks;
+  double Ks_org = 0.25;
+  double Ks_min;
+  double Sr;
+  double porosity;
+
+  if(moist<=0. || Wu==moist)
+    return (0.);
+
+  Kdry_min = (0.135*bulk_dens_min+64.7)/(soil_dens_min-0.947*bulk_dens_min);
+  Kdry = (1-organic)*Kdry_min + organic*Kdry_org;
+
+  porosity = 1.0 - bulk_density / soil_density;
+  Sr = moist/porosity;
+  if(quartz < .2)
+    Ks_min = pow(7.7,quartz) * pow(3.0,1.0-quartz);
+  else
+    Ks_min = pow(7.7,quartz) * pow(2.2,1.0-quartz);
+  Ks = (1-organic)*Ks_min + organic*Ks_org;
+
+  /* K = (Ksat-Kdry)*Sr+Kdry, with Ksat proportional to (Kw/Ki)^Wu */
+  Ksat = pow(Ks,1.0-porosity) * pow(Ki,porosity-Wu) * pow(Kw,Wu);
+  if((Ksat-Kdry)*Sr+Kdry < Kdry)
+    return (0.);
+
+  return (Sr * Ksat * log(Kw/Ki));
+}
+
 
 double volumetric_heat_capacity(double soil_fract,
                                 double water_fract,
@@ -206,7 +258,7 @@ void set_node_parameters(double   *dz_node,
   2013-Dec-27 Removed QUICK_FS option.					TJB
 **********************************************************************/
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   char   PAST_BOTTOM;
   int    nidx, lidx;
@@ -346,7 +398,7 @@ int distribute_node_moisture_properties(double *moist_node,
   2013-Dec-27 Removed QUICK_FS option.					TJB
 *********************************************************************/
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   char PAST_BOTTOM;
   int nidx, lidx;
@@ -485,7 +537,7 @@ int estimate_layer_ice_content(layer_data_struct *layer,
   2013-Dec-27 Removed QUICK_FS option.					TJB
 **************************************************************/
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   int    nidx, min_nidx, max_nidx;
   int    lidx, frost_area;
@@ -615,7 +667,7 @@ int estimate_layer_ice_content_quick_flux(layer_data_struct *layer,
   2013-Dec-27 Removed QUICK_FS option.					TJB
 ********************************************************************/
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   int    lidx, frost_area;
   double Lsum[MAX_LAYERS+1];
   double tmpT, tmp_fract, tmp_ice;
@@ -701,7 +753,7 @@ void compute_soil_layer_thermal_properties(layer_data_struct *layer,
   2013-Dec-27 Moved SPATIAL_FROST to options_struct.			TJB
 ********************************************************************/
 
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   int    lidx;
   int    frost_area;
   double moist, ice;
@@ -809,3 +861,30 @@ double maximum_unfrozen_water(double T,
   
 }
 
+double maximum_unfrozen_water_deriv(double T,
+                                    double max_moist,
+                                    double bubble,
+                                    double expt) {
+/**********************************************************************
+  maximum_unfrozen_water_deriv			October 2026
+
+  Returns the derivative of maximum_unfrozen_water() with respect to
+  the temperature T (mm/mm per C), for the analytic Jacobian of the
+  implicit soil heat equation (see fda_heat_eqn()).  The derivative is
+  zero where the unfrozen water content is limited to max_moist or 0.
+**********************************************************************/
+
+  double unfrozen;
+  double exponent;
+
+  if ( T < 0. ) {
+    exponent = -(2.0 / (expt - 3.0));
+    unfrozen = max_moist * pow((-Lf * T) / 273.16 / (9.81 * bubble / 100.), exponent);
+    if(unfrozen > 0. && unfrozen < max_moist)
+      return (exponent * unfrozen / T);
+  }
+
+  return (0.);
+
+}
+
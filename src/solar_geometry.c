@@ -0,0 +1,418 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <vicNl.h>
+#include <mtclim_constants_vic.h>
+
+static char vcid[] = "$Id$";
+
+/**********************************************************************
+  solar_geometry				October 2026
+
+  Solar geometry of MTCLIM's radiation algorithm, cached and shared by
+  the grid cells of a run.  For each yearday, MTCLIM steps the hour
+  angle through the day in SRADDT steps to find the daylength, the
+  potential radiation on a flat surface and on the slope, and the
+  fraction of the day's potential radiation that falls in each step
+  (used by mtclim_to_vic() to disaggregate shortwave to hourly).  None
+  of these depend on anything but the site's latitude, slope, aspect
+  and east and west horizons, so they are computed once for each such
+  site and shared by all cells with the same one, instead of being
+  recomputed (with about a million cos(), sin() and pow() calls) for
+  every cell.
+
+  The only part of the hour-angle loop that depends on the cell itself
+  is the transmittance, through the cell's elevation: for it, the
+  optical air mass and top-of-atmosphere radiation of each sunlit step
+  are kept, so that calc_srad_humidity_iterative() can sum the
+  transmittance of the day exactly as the loop did.  The results are
+  the same as those of the full loop.
+
+  Only the steps between the day's first and last sunlit step are
+  stored, so a site takes about 12 MB, where the old per-cell array of
+  366 x 86400 doubles took 253 MB of address space.  Up to
+  MAX_SOLAR_GEOMS sites are cached; the least recently used site that
+  no cell is using is dropped to make room for a new one.  Cells of
+  the same row of a regular grid share a site (VIC sets slope, aspect
+  and horizons to 0), so cells run in file order mostly find their
+  site in the cache.
+
+  With SOLAR_GEOM_PRECISION > 0 the latitude, slope, aspect and
+  horizons are rounded to that many degrees, and the geometry is that
+  of the rounded site, so that nearby cells share it.  This changes
+  the estimated radiation slightly; the default, 0, uses the exact
+  site.
+**********************************************************************/
+
+#define MAX_SOLAR_GEOMS 8
+
+static solar_geom_struct *geom_cache = NULL;
+static int                Ngeoms = 0;
+static long               geom_clock = 0;
+static pthread_mutex_t    geom_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void append_value(double **array,
+                         int      *Nalloc,
+                         int       n,
+                         double    value)
+/**********************************************************************
+  Stores value as element n of *array, which holds *Nalloc elements.
+**********************************************************************/
+{
+  if (n >= *Nalloc) {
+    *Nalloc = *Nalloc ? 2 * *Nalloc : 86400/SRADDT;
+    *array = (double *)realloc(*array, *Nalloc * sizeof(double));
+    if (*array == NULL)
+      nrerror("Memory allocation error in solar_geometry().");
+  }
+  (*array)[n] = value;
+}
+
+static void compute_solar_geometry(solar_geom_struct *g)
+/**********************************************************************
+  Computes the solar geometry of site g, with the hour-angle loop of
+  calc_srad_humidity_iterative() (MTCLIM 4.3).
+**********************************************************************/
+{
+  int i,j;
+  int ami;
+  int tinystep;
+  int tinystepspday;
+  int first, last;
+  int Nradfract, Nsteps;
+  int Nalloc_radfract, Nalloc_am, Nalloc_topa;
+  double *tiny_radfract;
+  double lat,coslat,sinlat,dt,h,dh;
+  double cosslp,sinslp,cosasp,sinasp;
+  double bsg1,bsg2,bsg3;
+  double decl,cosdecl,sindecl,cosegeom,sinegeom,coshss,hss;
+  double sc,dir_beam_topa;
+  double sum_flat_potrad,sum_slope_potrad;
+  double cosh,sinh;
+  double cza,cbsa,coszeh,coszwh;
+  double dir_flat_topa,am;
+
+  /* optical airmass by degrees */
+  double optam[21] = {2.90,3.05,3.21,3.39,3.69,3.82,4.07,4.37,4.72,5.12,5.60,
+		      6.18,6.88,7.77,8.90,10.39,12.44,15.36,19.79,26.96,30.00};
+
+  /* precalculate the transcendentals */
+  lat = g->lat;
+  /* check for (+/-) 90 degrees latitude, throws off daylength calc */
+  lat *= RADPERDEG;
+  if (lat > 1.5707)
+    lat = 1.5707;
+  if (lat < -1.5707)
+    lat = -1.5707;
+  coslat = cos(lat);
+  sinlat = sin(lat);
+  cosslp = cos(g->slp * RADPERDEG);
+  sinslp = sin(g->slp * RADPERDEG);
+  cosasp = cos(g->asp * RADPERDEG);
+  sinasp = sin(g->asp * RADPERDEG);
+  /* cosine of zenith angle for east and west horizons */
+  coszeh = cos(1.570796 - (g->ehoriz * RADPERDEG));
+  coszwh = cos(1.570796 - (g->whoriz * RADPERDEG));
+
+  /* sub-daily time and angular increment information */
+  dt = SRADDT;                /* set timestep */
+  dh = dt / SECPERRAD;        /* calculate hour-angle step */
+  tinystepspday = 86400/SRADDT;
+
+  tiny_radfract = (double *)malloc(tinystepspday * sizeof(double));
+  if (tiny_radfract == NULL)
+    nrerror("Memory allocation error in solar_geometry().");
+  g->radfract = g->am = g->dir_flat_topa = NULL;
+  Nradfract = Nsteps = 0;
+  Nalloc_radfract = Nalloc_am = Nalloc_topa = 0;
+
+  /* begin loop through yeardays */
+  for (i=0 ; i<365 ; i++) {
+    /* calculate cos and sin of declination */
+    decl = MINDECL * cos(((double)i + DAYSOFF) * RADPERDAY);
+    cosdecl = cos(decl);
+    sindecl = sin(decl);
+
+    /* do some precalculations for beam-slope geometry (bsg) */
+    bsg1 = -sinslp * sinasp * cosdecl;
+    bsg2 = (-cosasp * sinslp * sinlat + cosslp * coslat) * cosdecl;
+    bsg3 = (cosasp * sinslp * coslat + cosslp * sinlat) * sindecl;
+
+    /* calculate daylength as a function of lat and decl */
+    cosegeom = coslat * cosdecl;
+    sinegeom = sinlat * sindecl;
+    coshss = -(sinegeom) / cosegeom;
+    if (coshss < -1.0)
+      coshss = -1.0;  /* 24-hr daylight */
+    if (coshss > 1.0)
+      coshss = 1.0;    /* 0-hr daylight */
+    hss = acos(coshss);                /* hour angle at sunset (radians) */
+    /* daylength (seconds) */
+    g->daylength[i] = 2.0 * hss * SECPERRAD;
+    if (g->daylength[i] > 86400)
+      g->daylength[i] = 86400;
+
+    /* solar constant as a function of yearday (W/m^2) */
+    sc = 1368.0 + 45.5*sin((2.0*PI*(double)i/365.25) + 1.7);
+    /* extraterrestrial radiation perpendicular to beam, total over
+       the timestep (J) */
+    dir_beam_topa = sc * dt;
+
+    sum_flat_potrad = 0.0;
+    sum_slope_potrad = 0.0;
+    for (j = 0; j < tinystepspday; j++)
+      tiny_radfract[j] = 0;
+    g->trans_start[i] = Nsteps;
+
+    /* begin sub-daily hour-angle loop, from -hss to hss */
+    for (h=-hss ; h<hss ; h+=dh) {
+      /* precalculate cos and sin of hour angle */
+      cosh = cos(h);
+      sinh = sin(h);
+
+      /* calculate cosine of solar zenith angle */
+      cza = cosegeom * cosh + sinegeom;
+
+      /* calculate cosine of beam-slope angle */
+      cbsa = sinh * bsg1 + cosh * bsg2 + bsg3;
+
+      /* check if sun is above a flat horizon */
+      if (cza > 0.0) {
+	/* potential radiation for this time period, flat surface,
+	   top of atmosphere */
+	dir_flat_topa = dir_beam_topa * cza;
+
+	/* determine optical air mass */
+	am = 1.0/(cza + 0.0000001);
+	if (am > 2.9) {
+	  ami = (int)(acos(cza)/RADPERDEG) - 69;
+	  if (ami < 0)
+	    ami = 0;
+	  if (ami > 20)
+	    ami = 20;
+	  am = optam[ami];
+	}
+
+	/* keep the optical air mass and potential radiation of this
+	   time period for the transmittance of the cell */
+	append_value(&g->am, &Nalloc_am, Nsteps, am);
+	append_value(&g->dir_flat_topa, &Nalloc_topa, Nsteps, dir_flat_topa);
+	Nsteps++;
+
+	/* keep track of total potential radiation on a flat
+	   surface for ideal horizons */
+	sum_flat_potrad += dir_flat_topa;
+
+	/* keep track of whether this time step contributes to
+	   component 1 (direct on slope) */
+	if ((h<0.0 && cza>coszeh && cbsa>0.0) ||
+	    (h>=0.0 && cza>coszwh && cbsa>0.0)) {
+
+	  /* sun between east and west horizons, and direct on
+	     slope. this period contributes to component 1 */
+	  sum_slope_potrad += dir_beam_topa * cbsa;
+	}
+
+      } /* end if sun above ideal horizon */
+      else dir_flat_topa = -1;
+
+      tinystep = (12L * 3600L + h * SECPERRAD)/SRADDT;
+      if (tinystep < 0)
+	tinystep = 0;
+      if (tinystep > tinystepspday-1)
+	tinystep = tinystepspday-1;
+      if (dir_flat_topa > 0)
+	tiny_radfract[tinystep] = dir_flat_topa;
+      else
+	tiny_radfract[tinystep] = 0;
+
+    } /* end of sub-daily hour-angle loop */
+
+    g->trans_n[i] = Nsteps - g->trans_start[i];
+    g->sum_flat_potrad[i] = sum_flat_potrad;
+
+    if (g->daylength[i] && sum_flat_potrad > 0) {
+      for (j = 0; j < tinystepspday; j++)
+	tiny_radfract[j] /= sum_flat_potrad;
+    }
+
+    /* keep the radiation fractions from the first to the last step
+       that has any */
+    for (first = 0; first < tinystepspday && tiny_radfract[first] == 0;
+         first++);
+    for (last = tinystepspday-1; last >= first && tiny_radfract[last] == 0;
+         last--);
+    g->radfract_first[i] = first;
+    g->radfract_start[i] = Nradfract;
+    g->radfract_n[i] = last - first + 1;
+    for (j = first; j <= last; j++)
+      append_value(&g->radfract, &Nalloc_radfract, Nradfract++,
+                   tiny_radfract[j]);
+
+    /* daylight average flux density for a flat surface and the slope */
+    if (g->daylength[i]) {
+      g->flat_potrad[i] = sum_flat_potrad / g->daylength[i];
+      g->slope_potrad[i] = sum_slope_potrad / g->daylength[i];
+    }
+    else {
+      g->flat_potrad[i] = 0.0;
+      g->slope_potrad[i] = 0.0;
+    }
+
+  } /* end of i=365 days loop */
+
+  /* force yearday 366 = yearday 365 */
+  g->daylength[365] = g->daylength[364];
+  g->flat_potrad[365] = g->flat_potrad[364];
+  g->slope_potrad[365] = g->slope_potrad[364];
+  g->sum_flat_potrad[365] = g->sum_flat_potrad[364];
+  g->trans_start[365] = g->trans_start[364];
+  g->trans_n[365] = g->trans_n[364];
+  g->radfract_first[365] = g->radfract_first[364];
+  g->radfract_start[365] = g->radfract_start[364];
+  g->radfract_n[365] = g->radfract_n[364];
+
+  /* release the unused ends of the arrays */
+  if (Nradfract > 0)
+    g->radfract = (double *)realloc(g->radfract, Nradfract * sizeof(double));
+  if (Nsteps > 0) {
+    g->am = (double *)realloc(g->am, Nsteps * sizeof(double));
+    g->dir_flat_topa = (double *)realloc(g->dir_flat_topa,
+                                         Nsteps * sizeof(double));
+  }
+
+  free(tiny_radfract);
+
+}
+
+static void free_solar_geometry(solar_geom_struct *g)
+{
+  free(g->radfract);
+  free(g->am);
+  free(g->dir_flat_topa);
+  free(g);
+}
+
+static void evict_solar_geometries()
+/**********************************************************************
+  Drops the least recently used sites that are not in use, while the
+  cache holds more than MAX_SOLAR_GEOMS.  Called with geom_lock held.
+**********************************************************************/
+{
+  solar_geom_struct **link;
+  solar_geom_struct **lru;
+
+  while (Ngeoms > MAX_SOLAR_GEOMS) {
+    lru = NULL;
+    for (link = &geom_cache; *link != NULL; link = &(*link)->next)
+      if ((*link)->Nusers == 0
+          && (lru == NULL || (*link)->last_used < (*lru)->last_used))
+        lru = link;
+    if (lru == NULL) return;
+    free_solar_geometry(*lru);
+    *lru = (*lru)->next;
+    Ngeoms--;
+  }
+
+}
+
+static solar_geom_struct *find_solar_geometry(solar_geom_struct *key)
+/**********************************************************************
+  Returns the cached site with the key of *key, marked as in use, or
+  NULL.  Called with geom_lock held.
+**********************************************************************/
+{
+  solar_geom_struct *g;
+
+  for (g = geom_cache; g != NULL; g = g->next)
+    if (g->lat == key->lat && g->slp == key->slp && g->asp == key->asp
+        && g->ehoriz == key->ehoriz && g->whoriz == key->whoriz) {
+      g->Nusers++;
+      g->last_used = ++geom_clock;
+      return g;
+    }
+  return NULL;
+
+}
+
+static double round_geometry(double value)
+{
+  extern THREAD_LOCAL option_struct options;
+
+  if (options.SOLAR_GEOM_PRECISION <= 0) return value;
+  return options.SOLAR_GEOM_PRECISION
+         * floor(value / options.SOLAR_GEOM_PRECISION + 0.5);
+}
+
+solar_geom_struct *get_solar_geometry(double lat,
+                                      double slope,
+                                      double aspect,
+                                      double ehoriz,
+                                      double whoriz)
+/**********************************************************************
+  get_solar_geometry				October 2026
+
+  Returns the solar geometry of the site with latitude lat, slope,
+  aspect, and east and west horizons ehoriz and whoriz (degrees),
+  computing it if it is not cached.  It must be released with
+  release_solar_geometry() when the cell is done with it.
+**********************************************************************/
+{
+  solar_geom_struct  key;
+  solar_geom_struct *g;
+  solar_geom_struct *found;
+
+  key.lat = round_geometry(lat);
+  key.slp = round_geometry(slope);
+  key.asp = round_geometry(aspect);
+  key.ehoriz = round_geometry(ehoriz);
+  key.whoriz = round_geometry(whoriz);
+
+  pthread_mutex_lock(&geom_lock);
+  g = find_solar_geometry(&key);
+  pthread_mutex_unlock(&geom_lock);
+  if (g != NULL) return g;
+
+  /* computed without holding the lock, so that other threads can use
+     the cache meanwhile */
+  g = (solar_geom_struct *)malloc(sizeof(solar_geom_struct));
+  if (g == NULL)
+    nrerror("Memory allocation error in get_solar_geometry().");
+  *g = key;
+  compute_solar_geometry(g);
+
+  pthread_mutex_lock(&geom_lock);
+  if ((found = find_solar_geometry(&key)) != NULL) {
+    /* another thread has computed the same site meanwhile */
+    free_solar_geometry(g);
+    g = found;
+  }
+  else {
+    g->Nusers = 1;
+    g->last_used = ++geom_clock;
+    g->next = geom_cache;
+    geom_cache = g;
+    Ngeoms++;
+    evict_solar_geometries();
+  }
+  pthread_mutex_unlock(&geom_lock);
+
+  return g;
+
+}
+
+void release_solar_geometry(solar_geom_struct *g)
+/**********************************************************************
+  release_solar_geometry			October 2026
+
+  Releases a site returned by get_solar_geometry(); it stays cached
+  for the cells that follow.
+**********************************************************************/
+{
+  pthread_mutex_lock(&geom_lock);
+  g->Nusers--;
+  evict_solar_geometries();
+  pthread_mutex_unlock(&geom_lock);
+}
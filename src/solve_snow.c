@@ -138,8 +138,8 @@ double solve_snow(char                 overstory,
 	      global to local and back.					TJB
 *********************************************************************/
 
-  extern option_struct   options;
-  extern veg_lib_struct *veg_lib;
+  extern THREAD_LOCAL option_struct   options;
+  extern THREAD_LOCAL veg_lib_struct *veg_lib;
 
   char                ErrStr[MAXSTRING];
   char                FIRST_SOLN[1];
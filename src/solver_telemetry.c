@@ -0,0 +1,252 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <vicNl.h>
+
+static char vcid[] = "$Id$";
+
+/**********************************************************************
+  solver_telemetry				October 2026
+
+  Telemetry of the iterative solvers (SOLVER_TELEMETRY), so that the
+  cells and seasons in which the solvers are expensive or fail can be
+  found.  Each call of root_brent(), root_solve(), newt_raph(), the
+  explicit soil temperature profile solution of
+  calc_soil_thermal_fluxes(), and solve_lake() is accumulated in the
+  thread's solver_telemetry, per month of the record being simulated
+  (calls made while the model state is initialized count towards the
+  first month).  When a cell has been run, one row per month and solver
+  that was called is appended to the telemetry file, a CSV file with
+  the columns
+
+    gridcel,year,month,solver,calls,iterations,expansions,fallbacks,seconds
+
+  where, for each solver,
+
+    root_brent      iterations = iterations of Brent's method after the
+                    root has been bracketed; expansions = expansions of
+                    the bounds needed to bracket it; fallbacks = calls
+                    that failed (returned ERROR), which the caller
+                    handles with TFALLBACK or by stopping the cell.
+    root_solve      iterations = function evaluations; fallbacks =
+                    calls in which the warm start found no bracket, so
+                    the root was found by root_brent() (and is also
+                    counted there).  With ENERGY_WARM_START = FALSE,
+                    every call is solved by root_brent() and none is
+                    counted as a fallback.
+    newt_raph       iterations = Newton trials; fallbacks = calls that
+                    did not converge, after which the profile is solved
+                    by the explicit method.
+    soil_T_profile  iterations = Newton iterations and sweeps;
+                    fallbacks = Newton solutions redone by sweeps
+                    (EXPLICIT_SOLVER NEWTON) and sweeps stopped at MAXIT
+                    without converging.
+    solve_lake      fallbacks = calls that failed.
+
+  seconds is the wall time spent in the calls, which includes the time
+  spent in the solvers they call in turn (e.g. the root_brent() calls
+  of solve_lake()).
+
+  The rows of a cell are appended with a single write(), so that the
+  threads (NTHREADS) and processes (NPROCS) of a run can share the file
+  without interleaving their rows; the rows of different cells are in
+  the order in which the cells finished.  The telemetry costs two
+  clock readings per solver call while it is enabled, and nothing
+  otherwise.
+**********************************************************************/
+
+#define SOLVER_TELEMETRY_HEADER "# gridcel,year,month,solver,calls,iterations,expansions,fallbacks,seconds\n"
+
+static const char *solver_name[N_SOLVERS] = {
+  "root_brent", "root_solve", "newt_raph", "soil_T_profile", "solve_lake"
+};
+
+int open_solver_telemetry(char filename[],
+                          int  resume)
+/**********************************************************************
+  open_solver_telemetry				October 2026
+
+  Opens the solver telemetry file filename for appending, and returns
+  its file descriptor.  The file is created (or truncated) and given
+  a header, unless resume is TRUE, in which case the rows of the
+  resumed run are appended to it.
+**********************************************************************/
+{
+  int  fd;
+  char ErrStr[MAXSTRING];
+
+  if ((fd = open(filename, O_WRONLY | O_CREAT | O_APPEND
+                 | (resume ? 0 : O_TRUNC), 0666)) < 0) {
+    sprintf(ErrStr, "Unable to open the solver telemetry file %s: %s.",
+            filename, strerror(errno));
+    nrerror(ErrStr);
+  }
+  if (lseek(fd, 0, SEEK_END) == 0
+      && write(fd, SOLVER_TELEMETRY_HEADER,
+               strlen(SOLVER_TELEMETRY_HEADER)) < 0) {
+    sprintf(ErrStr, "Unable to write to the solver telemetry file %s: %s.",
+            filename, strerror(errno));
+    nrerror(ErrStr);
+  }
+
+  return fd;
+
+}
+
+static void end_telemetry_month()
+/**********************************************************************
+  Adds the rows of the month being accumulated to the cell's rows, and
+  starts a new month.
+**********************************************************************/
+{
+  extern THREAD_LOCAL solver_telemetry_struct solver_telemetry;
+
+  solver_telemetry_struct *st = &solver_telemetry;
+  solver_stats_struct     *stats;
+  char                     row[MAXSTRING];
+  size_t                   length;
+  int                      i;
+
+  for (i = 0; i < N_SOLVERS; i++) {
+    stats = &st->solver[i];
+    if (stats->Ncalls == 0) continue;
+    length = sprintf(row, "%d,%d,%d,%s,%ld,%ld,%ld,%ld,%.6f\n",
+                     st->gridcel, st->year, st->month, solver_name[i],
+                     stats->Ncalls, stats->Niter, stats->Nexpand,
+                     stats->Nfallback, stats->seconds);
+    if (st->length + length > st->Nalloc) {
+      st->Nalloc = st->Nalloc ? 2*st->Nalloc : 16*MAXSTRING;
+      st->rows = (char *)realloc(st->rows, st->Nalloc);
+      if (st->rows == NULL)
+        nrerror("Memory allocation error in end_telemetry_month().");
+    }
+    memcpy(st->rows + st->length, row, length);
+    st->length += length;
+  }
+  memset(st->solver, 0, sizeof(st->solver));
+
+}
+
+void start_solver_telemetry(int         gridcel,
+                            dmy_struct *dmy)
+/**********************************************************************
+  start_solver_telemetry			October 2026
+
+  Starts the telemetry of cell gridcel, whose first record has date
+  dmy.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL solver_telemetry_struct solver_telemetry;
+
+  if (!options.SOLVER_TELEMETRY) return;
+
+  solver_telemetry.gridcel = gridcel;
+  solver_telemetry.year = dmy->year;
+  solver_telemetry.month = dmy->month;
+  solver_telemetry.length = 0;
+  memset(solver_telemetry.solver, 0, sizeof(solver_telemetry.solver));
+
+}
+
+void solver_telemetry_month(dmy_struct *dmy)
+/**********************************************************************
+  solver_telemetry_month			October 2026
+
+  Attributes the following solver calls to the month of the record
+  with date dmy.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL solver_telemetry_struct solver_telemetry;
+
+  if (!options.SOLVER_TELEMETRY
+      || (dmy->month == solver_telemetry.month
+          && dmy->year == solver_telemetry.year)) return;
+
+  end_telemetry_month();
+  solver_telemetry.year = dmy->year;
+  solver_telemetry.month = dmy->month;
+
+}
+
+double solver_call_start()
+/**********************************************************************
+  solver_call_start				October 2026
+
+  Returns the start time of a solver call, to be passed to
+  solver_call_end(); 0 if the telemetry is disabled.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+
+  if (!options.SOLVER_TELEMETRY) return 0;
+  return cell_clock();
+
+}
+
+void solver_call_end(int    solver,
+                     double start,
+                     int    Niter,
+                     int    Nexpand,
+                     int    Nfallback)
+/**********************************************************************
+  solver_call_end				October 2026
+
+  Records a call of solver (ST_ROOT_BRENT, ...), started at time start,
+  that took Niter iterations and Nexpand bracket expansions, and needed
+  Nfallback fallbacks.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL solver_telemetry_struct solver_telemetry;
+
+  solver_stats_struct *stats;
+
+  if (!options.SOLVER_TELEMETRY) return;
+
+  stats = &solver_telemetry.solver[solver];
+  stats->Ncalls++;
+  stats->Niter += Niter;
+  stats->Nexpand += Nexpand;
+  stats->Nfallback += Nfallback;
+  stats->seconds += cell_clock() - start;
+
+}
+
+void write_solver_telemetry(int fd)
+/**********************************************************************
+  write_solver_telemetry			October 2026
+
+  Appends the rows of the cell that has just been run to the telemetry
+  file fd.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL solver_telemetry_struct solver_telemetry;
+
+  char ErrStr[MAXSTRING];
+
+  if (!options.SOLVER_TELEMETRY || fd < 0) return;
+
+  end_telemetry_month();
+
+  /* a single write, so that threads and processes sharing the file
+     cannot interleave their rows */
+  if (solver_telemetry.length > 0
+      && write(fd, solver_telemetry.rows, solver_telemetry.length)
+         != (ssize_t)solver_telemetry.length) {
+    sprintf(ErrStr, "Unable to write to the solver telemetry file: %s.",
+            strerror(errno));
+    nrerror(ErrStr);
+  }
+  free(solver_telemetry.rows);
+  solver_telemetry.rows = NULL;
+  solver_telemetry.length = 0;
+  solver_telemetry.Nalloc = 0;
+
+}
@@ -0,0 +1,315 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <vicNl.h>
+
+static char vcid[] = "$Id$";
+
+/**********************************************************************
+  state_index					October 2026
+
+  Index of the cell records of a binary model state file, so that the
+  record of a cell can be found with one seek instead of by skipping
+  all the records before it.  The index is appended to the state file
+  when the file is closed (write_state_index()), behind the last cell
+  record:
+
+    Ncells index entries of STATE_INDEX_ENTRY bytes:
+      bytes 0-3   cell number (gridcel) of the record
+      bytes 4-7   snapshot number of the record (0 in single-snapshot
+                  files)
+      bytes 8-15  byte offset of the record in the file
+    trailer of STATE_INDEX_TRAILER bytes:
+      bytes 0-7   byte offset of the first index entry
+      bytes 8-11  number of entries, Ncells
+      bytes 12-15 format version (STATE_INDEX_VERSION)
+      bytes 16-23 "VICSTIDX"
+
+  Like the rest of the binary state file, the index is written in the
+  byte order of the machine.  A reader that searches the records one
+  by one finds every cell of the file before it reaches the index, so
+  indexed state files can still be read by earlier versions of VIC.
+  State files without an index (older files, and ASCII state files)
+  are still searched record by record.
+
+  A multi-snapshot state file (STATE_SCHEDULE) starts with
+  MULTI_SNAPSHOT_STATE and the number of snapshots in place of the
+  state date, and lists the dates of the snapshots behind Nlayer and
+  Nnode; each of its cell records is preceded by the snapshot number.
+  The offset in the index is that of the record itself, behind the
+  snapshot number, so that a record is read the same way from either
+  kind of file.  Multi-snapshot files can only be read with the index.
+**********************************************************************/
+
+#define STATE_INDEX_MAGIC   "VICSTIDX"
+#define STATE_INDEX_VERSION 1
+#define STATE_INDEX_ENTRY   16       /* bytes per index entry */
+#define STATE_INDEX_TRAILER 24       /* bytes in the trailer */
+#define STATE_HEADER_SIZE   (5*sizeof(int)) /* state date, Nlayer, Nnode */
+
+typedef struct {
+  int       snapshot;
+  int       gridcel;
+  long long offset;
+} state_index_entry_struct;
+
+struct state_index_struct {
+  int                       Ncells;
+  long long                 start;   /* offset of the index in the file */
+  state_index_entry_struct *entry;   /* sorted by snapshot, gridcel, then
+                                        offset */
+};
+
+static int compare_entries(const void *a,
+                           const void *b)
+{
+  const state_index_entry_struct *ea = (const state_index_entry_struct *)a;
+  const state_index_entry_struct *eb = (const state_index_entry_struct *)b;
+
+  if (ea->snapshot != eb->snapshot)
+    return (ea->snapshot < eb->snapshot) ? -1 : 1;
+  if (ea->gridcel != eb->gridcel)
+    return (ea->gridcel < eb->gridcel) ? -1 : 1;
+  if (ea->offset != eb->offset)
+    return (ea->offset < eb->offset) ? -1 : 1;
+  return 0;
+}
+
+static int compare_gridcel(const void *a,
+                           const void *b)
+{
+  const state_index_entry_struct *ea = (const state_index_entry_struct *)a;
+  const state_index_entry_struct *eb = (const state_index_entry_struct *)b;
+
+  if (ea->snapshot != eb->snapshot)
+    return (ea->snapshot > eb->snapshot) - (ea->snapshot < eb->snapshot);
+  return (ea->gridcel > eb->gridcel) - (ea->gridcel < eb->gridcel);
+}
+
+void write_state_index(FILE *statefile,
+                       char  filename[])
+/**********************************************************************
+  write_state_index				October 2026
+
+  Appends the index of its cell records to the binary state file
+  statefile (named filename), which must hold the state file header
+  and complete cell records only.  The records are found by reading
+  the header of each record, which gives the length of the record.
+  If the records do not add up to the length of the file, no index is
+  written, and the file can only be read record by record.
+**********************************************************************/
+{
+  FILE                     *records;
+  state_index_entry_struct *entry;
+  char                      trailer[STATE_INDEX_TRAILER];
+  int                       header[4];
+  int                       snapshot;
+  int                       Nsnapshots;
+  int                       tagged;
+  int                       version;
+  int                       Ncells;
+  int                       Nalloc;
+  int                       i;
+  long long                 offset;
+  long long                 end;
+
+  fflush(statefile);
+  if ((records = fopen(filename, "rb")) == NULL) {
+    fprintf(stderr, "WARNING: Unable to re-open state file %s; it has not been indexed.\n",
+            filename);
+    return;
+  }
+  fseeko(records, 0, SEEK_END);
+  end = ftello(records);
+
+  /* the records of a multi-snapshot file start behind the snapshot
+     dates, and are preceded by their snapshot numbers */
+  offset = STATE_HEADER_SIZE;
+  tagged = FALSE;
+  snapshot = Nsnapshots = 0;
+  if (fseeko(records, 0, SEEK_SET) == 0
+      && fread(header, sizeof(int), 2, records) == 2
+      && header[0] == MULTI_SNAPSHOT_STATE) {
+    Nsnapshots = header[1];
+    offset += (long long)Nsnapshots * 3 * sizeof(int);
+    tagged = TRUE;
+  }
+
+  /* find the start of each cell record */
+  entry = NULL;
+  Ncells = Nalloc = 0;
+  while (offset < end) {
+    if (fseeko(records, (off_t)offset, SEEK_SET) != 0)
+      break;
+    if (tagged) {
+      if (fread(&snapshot, sizeof(int), 1, records) != 1
+          || snapshot < 0 || snapshot >= Nsnapshots)
+        break;
+      offset += sizeof(int);
+    }
+    if (fread(header, sizeof(int), 4, records) != 4
+        || header[3] < 0)
+      break;
+    if (Ncells == Nalloc) {
+      Nalloc = Nalloc ? 2*Nalloc : 1024;
+      entry = (state_index_entry_struct *)realloc(entry,
+                Nalloc*sizeof(state_index_entry_struct));
+      if (entry == NULL)
+        nrerror("Memory allocation error in write_state_index().");
+    }
+    entry[Ncells].snapshot = snapshot;
+    entry[Ncells].gridcel = header[0];
+    entry[Ncells].offset = offset;
+    Ncells++;
+    offset += 4*sizeof(int) + header[3];
+  }
+  fclose(records);
+
+  if (offset != end) {
+    fprintf(stderr, "WARNING: The cell records of state file %s do not match their lengths; the file has not been indexed.\n",
+            filename);
+    free((char *)entry);
+    return;
+  }
+
+  /* append the index and the trailer */
+  fseeko(statefile, 0, SEEK_END);
+  for (i = 0; i < Ncells; i++) {
+    fwrite(&entry[i].gridcel, sizeof(int), 1, statefile);
+    fwrite(&entry[i].snapshot, sizeof(int), 1, statefile);
+    fwrite(&entry[i].offset, sizeof(long long), 1, statefile);
+  }
+  version = STATE_INDEX_VERSION;
+  memcpy(trailer, &end, sizeof(long long));
+  memcpy(trailer + 8, &Ncells, sizeof(int));
+  memcpy(trailer + 12, &version, sizeof(int));
+  memcpy(trailer + 16, STATE_INDEX_MAGIC, 8);
+  fwrite(trailer, 1, STATE_INDEX_TRAILER, statefile);
+  fflush(statefile);
+
+  free((char *)entry);
+
+}
+
+state_index_struct *read_state_index(FILE *init_state)
+/**********************************************************************
+  read_state_index				October 2026
+
+  Reads the index of the binary state file init_state, if it has one,
+  and returns it, or returns NULL if the file has no index (or cannot
+  be positioned from its end, as for gzipped state files).  The file
+  is left at the position it had when read_state_index() was called.
+**********************************************************************/
+{
+  state_index_struct *index;
+  char                trailer[STATE_INDEX_TRAILER];
+  char                entry[STATE_INDEX_ENTRY];
+  int                 version;
+  int                 i;
+  off_t               position;
+  long long           end;
+
+  if ((position = ftello(init_state)) < 0)
+    return NULL;
+
+  index = NULL;
+  if (fseeko(init_state, -STATE_INDEX_TRAILER, SEEK_END) == 0
+      && (end = ftello(init_state)) >= 0
+      && fread(trailer, 1, STATE_INDEX_TRAILER, init_state) == STATE_INDEX_TRAILER
+      && memcmp(trailer + 16, STATE_INDEX_MAGIC, 8) == 0) {
+
+    memcpy(&version, trailer + 12, sizeof(int));
+    if (version != STATE_INDEX_VERSION)
+      nrerror("The index of the model state file was written by an unknown version of VIC.");
+    index = (state_index_struct *)calloc(1, sizeof(state_index_struct));
+    if (index == NULL)
+      nrerror("Memory allocation error in read_state_index().");
+    memcpy(&index->start, trailer, sizeof(long long));
+    memcpy(&index->Ncells, trailer + 8, sizeof(int));
+    if (index->Ncells < 0 || index->start < STATE_HEADER_SIZE
+        || index->start + (long long)index->Ncells * STATE_INDEX_ENTRY != end)
+      nrerror("The index of the model state file is damaged.");
+
+    index->entry = (state_index_entry_struct *)calloc(index->Ncells + 1,
+                     sizeof(state_index_entry_struct));
+    if (index->entry == NULL)
+      nrerror("Memory allocation error in read_state_index().");
+    fseeko(init_state, (off_t)index->start, SEEK_SET);
+    for (i = 0; i < index->Ncells; i++) {
+      if (fread(entry, 1, STATE_INDEX_ENTRY, init_state) != STATE_INDEX_ENTRY)
+        nrerror("The index of the model state file is damaged.");
+      memcpy(&index->entry[i].gridcel, entry, sizeof(int));
+      memcpy(&index->entry[i].snapshot, entry + 4, sizeof(int));
+      memcpy(&index->entry[i].offset, entry + 8, sizeof(long long));
+    }
+    qsort(index->entry, index->Ncells, sizeof(state_index_entry_struct),
+          compare_entries);
+
+  }
+
+  clearerr(init_state);
+  if (fseeko(init_state, position, SEEK_SET) != 0)
+    nrerror("Unable to reposition the model state file.");
+
+  return index;
+
+}
+
+int seek_state_cell(state_index_struct *index,
+                    FILE               *init_state,
+                    int                 snapshot,
+                    int                 cellnum)
+/**********************************************************************
+  seek_state_cell				October 2026
+
+  Positions init_state at the start of the record of cell cellnum in
+  snapshot snapshot (0 for single-snapshot files), using the index of
+  the file.  If the snapshot holds more than one record for the cell,
+  the first one is used, as when the file is searched record by
+  record.  Returns FALSE if the cell is not in the snapshot.
+**********************************************************************/
+{
+  state_index_entry_struct  key;
+  state_index_entry_struct *found;
+
+  key.snapshot = snapshot;
+  key.gridcel = cellnum;
+  key.offset = 0;
+  found = (state_index_entry_struct *)bsearch(&key, index->entry, index->Ncells,
+            sizeof(state_index_entry_struct), compare_gridcel);
+  if (found == NULL)
+    return FALSE;
+  while (found > index->entry && compare_gridcel(found-1, &key) == 0)
+    found--;
+  if (fseeko(init_state, (off_t)found->offset, SEEK_SET) != 0)
+    nrerror("Unable to position the model state file at the record of a cell.");
+
+  return TRUE;
+
+}
+
+long long state_index_start(state_index_struct *index)
+/**********************************************************************
+  state_index_start				October 2026
+
+  Returns the byte offset of the end of the last cell record of the
+  state file, where its index starts.
+**********************************************************************/
+{
+  return index->start;
+}
+
+void free_state_index(state_index_struct **index)
+/**********************************************************************
+  free_state_index				October 2026
+
+  Frees a state file index read by read_state_index().
+**********************************************************************/
+{
+  if (*index == NULL) return;
+  free((char *)(*index)->entry);
+  free((char *)(*index));
+  *index = NULL;
+
+}
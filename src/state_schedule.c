@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vicNl.h>
+
+static char vcid[] = "$Id$";
+
+/**********************************************************************
+  state_schedule				October 2026
+
+  Dates on which the model state is saved.  Without STATE_SCHEDULE, the
+  state is saved once, on the date given by STATEYEAR, STATEMONTH, and
+  STATEDAY.  With STATE_SCHEDULE, the state is saved on each date of
+  the schedule, and all of these snapshots are written to one
+  multi-snapshot state file (see open_state_file()).
+
+  The dates are kept in global->state_date as yyyymmdd, in increasing
+  order; snapshot k of the state file is the state at the end of
+  global->state_date[k].
+**********************************************************************/
+
+static int compare_dates(const void *a,
+                         const void *b)
+{
+  int da = *(const int *)a;
+  int db = *(const int *)b;
+
+  return (da > db) - (da < db);
+}
+
+int parse_state_date(char *str)
+/**********************************************************************
+  parse_state_date				October 2026
+
+  Returns the date str, given as YYYY-MM-DD, as yyyymmdd, or MISSING
+  if str is not a valid date.
+**********************************************************************/
+{
+  int  lastday[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  int  year, month, day;
+  int  lastvalidday;
+  char extra;
+
+  if (sscanf(str, "%d-%d-%d%c", &year, &month, &day, &extra) != 3)
+    return MISSING;
+  if (year < 0 || month < 1 || month > 12)
+    return MISSING;
+  lastvalidday = lastday[month-1];
+  if (month == 2 && (year % 4) == 0 && ((year % 100) != 0 || (year % 400) == 0))
+    lastvalidday = 29;
+  if (day < 1 || day > lastvalidday)
+    return MISSING;
+
+  return year*10000 + month*100 + day;
+}
+
+void parse_state_schedule(char                 cmdstr[],
+                          global_param_struct *global)
+/**********************************************************************
+  parse_state_schedule				October 2026
+
+  Parses a STATE_SCHEDULE line of the global parameter file, which is
+  either a list of dates (YYYY-MM-DD), or MONTHLY followed optionally
+  by a day of the month (default 1).  The dates are appended to the
+  schedule; several STATE_SCHEDULE lines may be given.
+**********************************************************************/
+{
+  char  line[MAXSTRING];
+  char  ErrStr[MAXSTRING];
+  char *token;
+  int   date;
+
+  strcpy(line, cmdstr);
+  strtok(line, " \t\n\r");    /* STATE_SCHEDULE */
+  while ((token = strtok(NULL, " \t\n\r")) != NULL && token[0] != '#') {
+    if (strcasecmp("MONTHLY", token) == 0) {
+      global->state_monthly_day = 1;
+      if ((token = strtok(NULL, " \t\n\r")) != NULL && token[0] != '#') {
+        global->state_monthly_day = atoi(token);
+        if (global->state_monthly_day < 1 || global->state_monthly_day > 31) {
+          sprintf(ErrStr, "The day of the month (%s) given with STATE_SCHEDULE MONTHLY must be between 1 and 31.", token);
+          nrerror(ErrStr);
+        }
+      }
+      break;
+    }
+    if ((date = parse_state_date(token)) == MISSING) {
+      sprintf(ErrStr, "Invalid STATE_SCHEDULE date \"%s\"; dates must be given as YYYY-MM-DD, or the schedule as MONTHLY [day].", token);
+      nrerror(ErrStr);
+    }
+    if (global->Nstate_dates == MAX_STATE_DATES) {
+      sprintf(ErrStr, "STATE_SCHEDULE lists more than %d dates.", MAX_STATE_DATES);
+      nrerror(ErrStr);
+    }
+    global->state_date[global->Nstate_dates++] = date;
+  }
+
+}
+
+static int end_of_day(global_param_struct *global,
+                      dmy_struct          *dmy,
+                      int                  rec)
+/* TRUE if rec is the last time step of its day */
+{
+  return (rec+1 == global->nrecs || dmy[rec+1].day != dmy[rec].day);
+}
+
+void make_state_schedule(global_param_struct *global,
+                         dmy_struct          *dmy)
+/**********************************************************************
+  make_state_schedule				October 2026
+
+  Completes the STATE_SCHEDULE of the simulation described by dmy: adds
+  the monthly dates (for STATE_SCHEDULE MONTHLY; in months that are
+  shorter than the requested day, the last day of the month is used),
+  sorts the dates, and drops duplicates and dates that are not in the
+  simulation period.  Does nothing without STATE_SCHEDULE.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+
+  char ErrStr[MAXSTRING];
+  int  date;
+  int  rec;
+  int  i, n;
+
+  if (!options.STATE_SCHEDULE) return;
+
+  /* add the monthly dates */
+  if (global->state_monthly_day > 0) {
+    for (rec = 0; rec < global->nrecs; rec++) {
+      if (!end_of_day(global, dmy, rec)) continue;
+      if (dmy[rec].day == global->state_monthly_day
+          || (dmy[rec].day < global->state_monthly_day && rec+1 < global->nrecs
+              && dmy[rec+1].month != dmy[rec].month)) {
+        if (global->Nstate_dates == MAX_STATE_DATES) {
+          sprintf(ErrStr, "STATE_SCHEDULE gives more than %d dates in the simulation period.", MAX_STATE_DATES);
+          nrerror(ErrStr);
+        }
+        global->state_date[global->Nstate_dates++] =
+          dmy[rec].year*10000 + dmy[rec].month*100 + dmy[rec].day;
+      }
+    }
+  }
+
+  /* sort, and drop duplicates */
+  qsort(global->state_date, global->Nstate_dates, sizeof(int), compare_dates);
+  for (i = n = 0; i < global->Nstate_dates; i++)
+    if (n == 0 || global->state_date[i] != global->state_date[n-1])
+      global->state_date[n++] = global->state_date[i];
+  global->Nstate_dates = n;
+
+  /* drop the dates on which no state would be saved */
+  for (i = n = 0; i < global->Nstate_dates; i++) {
+    date = global->state_date[i];
+    if (date < dmy[0].year*10000 + dmy[0].month*100 + dmy[0].day
+        || date > dmy[global->nrecs-1].year*10000
+                  + dmy[global->nrecs-1].month*100 + dmy[global->nrecs-1].day)
+      fprintf(stderr, "WARNING: STATE_SCHEDULE date %04d-%02d-%02d is outside the simulation period; no state will be saved for it.\n",
+              date/10000, (date/100)%100, date%100);
+    else
+      global->state_date[n++] = date;
+  }
+  global->Nstate_dates = n;
+
+  if (global->Nstate_dates == 0)
+    nrerror("None of the STATE_SCHEDULE dates is in the simulation period.");
+
+}
+
+int state_snapshot(global_param_struct *global,
+                   dmy_struct          *dmy,
+                   int                  rec)
+/**********************************************************************
+  state_snapshot				October 2026
+
+  Returns the number of the state snapshot to save after time step rec,
+  or -1 if no state is to be saved then.  The state of a date is saved
+  after the last time step of the date.
+**********************************************************************/
+{
+  int  date;
+  int *found;
+
+  if (global->Nstate_dates == 0 || !end_of_day(global, dmy, rec))
+    return -1;
+  date = dmy[rec].year*10000 + dmy[rec].month*100 + dmy[rec].day;
+  found = (int *)bsearch(&date, global->state_date, global->Nstate_dates,
+                         sizeof(int), compare_dates);
+
+  return (found == NULL) ? -1 : (int)(found - global->state_date);
+
+}
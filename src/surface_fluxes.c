@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <vicNl.h>
 #include <math.h>
 
@@ -145,10 +146,17 @@ int surface_fluxes(char                 overstory,
   2014-Mar-28 Removed DIST_PRCP option.					TJB
   2014-Apr-25 Added non-climatological veg parameters.			TJB
   2014-Apr-25 Added partial vegcover fraction.				TJB
+  2026-Oct-18 step_aero_resist, store_gsLayer, LAIlayer, and faPAR are
+	      now stored on the stack instead of being allocated on every
+	      call.  This also fixes a leak of store_gsLayer for the bare
+	      soil tile when CARBON is TRUE.
+  2026-Oct-18 solve_snow() and runoff() are timed by the phase
+	      profiler (PHASE_PROFILE).
 **********************************************************************/
 {
-  extern veg_lib_struct *veg_lib;
-  extern option_struct   options;
+  extern THREAD_LOCAL veg_lib_struct *veg_lib;
+  extern THREAD_LOCAL option_struct   options;
+  double                 phase;
   double                 total_store_moist[3];
   double                 step_store_moist[3];
   int                    MAX_ITER_GRND_CANOPY;
@@ -219,7 +227,8 @@ int surface_fluxes(char                 overstory,
   double                 step_out_snow;
   double                 step_ppt;
   double                 step_prec;
-  double               **step_aero_resist;
+  double                 step_aero_resist_data[N_PET_TYPES][2];
+  double                *step_aero_resist[N_PET_TYPES];
 
   // Quantities that need to be summed or averaged over multiple snow steps
   // energy structure
@@ -308,11 +317,11 @@ int surface_fluxes(char                 overstory,
 
   // Carbon cycling
   double  dryFrac;
-  double *LAIlayer;
-  double *faPAR;
+  double LAIlayer[MAX_CANOPY];
+  double faPAR[MAX_CANOPY];
   int cidx;
   double  store_gc;
-  double *store_gsLayer;
+  double store_gsLayer[MAX_CANOPY];
   double  store_Ci;
   double  store_GPP;
   double  store_Rdark;
@@ -328,7 +337,7 @@ int surface_fluxes(char                 overstory,
     MAX_ITER_GRND_CANOPY = 0;
 
   if (options.CARBON) {
-    store_gsLayer = (double*)calloc(options.Ncanopy,sizeof(double));
+    memset(store_gsLayer, 0, options.Ncanopy*sizeof(double));
   }
 
   /***********************************************************************
@@ -341,9 +350,9 @@ int surface_fluxes(char                 overstory,
   inflow = &(cell->inflow);
   layer = cell->layer;
 
-  step_aero_resist = (double**)calloc(N_PET_TYPES,sizeof(double*));
+  memset(step_aero_resist_data, 0, sizeof(step_aero_resist_data));
   for (p=0; p<N_PET_TYPES; p++) {
-    step_aero_resist[p] = (double*)calloc(2,sizeof(double));
+    step_aero_resist[p] = step_aero_resist_data[p];
   }
 
   /***********************************************************************
@@ -502,8 +511,8 @@ int surface_fluxes(char                 overstory,
 
     // compute LAI and absorbed PAR per canopy layer
     if (options.CARBON && iveg < Nveg) {
-      LAIlayer = (double *)calloc(options.Ncanopy,sizeof(double));
-      faPAR = (double *)calloc(options.Ncanopy,sizeof(double));
+      memset(LAIlayer, 0, options.Ncanopy*sizeof(double));
+      memset(faPAR, 0, options.Ncanopy*sizeof(double));
       /* Compute absorbed PAR per ground area per canopy layer (W/m2)
          normalized to PAR = 1 W, i.e. the canopy albedo in the PAR
          range (alb_total ~ 0.45*alb_par + 0.55*alb_other) */
@@ -527,8 +536,6 @@ int surface_fluxes(char                 overstory,
           veg_var->aPAR += atmos->par[hidx] * faPAR[cidx] / 1e-10;
         }
       }
-      free((char*)LAIlayer);
-      free((char*)faPAR);
     }
 
     // initialize bisection startup
@@ -640,6 +647,7 @@ int surface_fluxes(char                 overstory,
         dryFrac = -1;
 
 	/** Solve snow accumulation, ablation and interception **/
+	phase = phase_start();
 	step_melt = solve_snow(overstory, BareAlbedo, LongUnderOut, 
 			       gp->MIN_RAIN_TEMP, gp->MAX_SNOW_TEMP, 
 			       Tcanopy, Tgrnd, Tair, dp,
@@ -661,6 +669,7 @@ int surface_fluxes(char                 overstory,
 			       iter_layer, &(iter_snow), 
 			       soil_con, 
 			       &(iter_snow_veg_var));
+	phase_end(PH_SOLVE_SNOW, phase);
       
 // iter_snow_energy.sensible + iter_snow_energy.latent + iter_snow_energy.latent_sub + NetShortSnow + NetLongSnow + ( snow_grnd_flux + iter_snow_energy.advection - iter_snow_energy.deltaCC + iter_snow_energy.refreeze_energy + iter_snow_energy.advected_sensible ) * step_snow.coverage
         if ( step_melt == ERROR ) return (ERROR);
@@ -1122,11 +1131,6 @@ int surface_fluxes(char                 overstory,
   for (p=0; p<N_PET_TYPES; p++)
     pot_evap[p] = store_pot_evap[p]/(double)N_steps;
 
-  for (p=0; p<N_PET_TYPES; p++) {
-    free((char *)step_aero_resist[p]);
-  }
-  free((char *)step_aero_resist);
-
   /**********************************************************
     Store carbon cycle variable sums for sub-model time steps
   **********************************************************/
@@ -1145,8 +1149,6 @@ int surface_fluxes(char                 overstory,
     veg_var->Raut     = store_Raut/(double)N_steps;
     veg_var->NPP      = store_NPP/(double)N_steps;
 
-    free((char *)(store_gsLayer));
-
     soil_carbon_balance(soil_con,energy,cell,veg_var);
 
     // Update running total annual NPP
@@ -1160,8 +1162,10 @@ int surface_fluxes(char                 overstory,
 
   (*inflow) = ppt;
 
+  phase = phase_start();
   ErrorFlag = runoff(cell, energy, soil_con, ppt, soil_con->frost_fract,
                      gp->dt, options.Nnode, band, rec, iveg);
+  phase_end(PH_RUNOFF, phase);
 
   return( ErrorFlag );
 
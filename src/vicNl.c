@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+#include <unistd.h>
 #include <vicNl.h>
 #include <global.h>
 
@@ -98,47 +100,80 @@ int main(int argc, char *argv[])
 	      OUTPUT_FORCE condition to avoid memory leak.		TJB
   2014-Mar-28 Removed DIST_PRCP option.					TJB
   2014-Apr-25 Added non-climatological veg parameters.			TJB
+  2026-Oct-18 Moved the per-cell simulation into run_cell().  Added the
+	      NTHREADS option: when NTHREADS > 1, cells are read here but
+	      run by a pool of worker threads (see cell_pool.c).
+  2026-Oct-18 The configuration of the simulation is now stored in a
+	      vic_context_struct, which is passed to run_cell() and to
+	      the worker threads.
+  2026-Oct-18 Added the NPROCS option: when NPROCS > 1, the active cells
+	      are split into NPROCS contiguous shards, each run by a child
+	      process (see fork_shards.c); a process skips the cells
+	      outside its shard.
+  2026-Oct-18 Added the CELL_TIMING_LOG option: the wall time of each
+	      cell is logged, for cost-aware scheduling in later runs.
+  2026-Oct-18 Added the PREFETCH option: when running cells serially,
+	      the next cell's forcings are prepared on a helper thread
+	      while the current cell is simulated (see cell_prefetch.c).
+  2026-Oct-18 The model state and veg_hist of each cell are allocated
+	      from a cell arena, which is reset after the cell (see
+	      cell_arena.c).
+  2026-Oct-18 Added closing of packed forcing files.
+  2026-Oct-18 Binary state files are indexed: the index of the initial
+	      state file is read, and an index is appended to the state
+	      file when it is closed (see state_index.c).
+  2026-Oct-18 Added make_state_schedule(), which completes the dates of
+	      STATE_SCHEDULE once the simulation period is known.
+  2026-Oct-18 Added the cell journal (CELL_JOURNAL): each finished cell
+	      is journaled, and cells finished by an interrupted run are
+	      skipped (see cell_journal.c).
+  2026-Oct-18 Added the solver telemetry file (SOLVER_TELEMETRY), which
+	      is opened here so that the threads and processes of the run
+	      share it.
+  2026-Oct-18 Added the phase profiler (PHASE_PROFILE): the parameter
+	      reads are timed here, and the run's phase totals printed at
+	      the end (see phase_profile.c).
+  2026-Oct-18 The heap allocations of the run are printed at the end,
+	      in vicNl_alloc (see alloc_count.c).
+  2026-Oct-18 With IMPLICIT_JACOBIAN CHECK, the comparison of the
+	      implicit soil temperature solutions is printed at the end.
 **********************************************************************/
 {
 
-  extern veg_lib_struct *veg_lib;
-  extern option_struct options;
-  extern Error_struct Error;
-  extern global_param_struct global_param;
+  extern THREAD_LOCAL veg_lib_struct *veg_lib;
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL global_param_struct global_param;
 
   /** Variable Declarations **/
 
-  char                     NEWCELL;
-  char                     LASTREC;
   char                     MODEL_DONE;
   char                     RUN_MODEL;
-  char                     ErrStr[MAXSTRING];
-  int                      rec, i, j;
-  int                      veg;
-  int                      band;
   int                      Nveg_type;
   int                      cellnum;
-  int                      index;
-  int                      Ncells;
+  int                      first_cell;
+  int                      last_cell;
   int                      startrec;
   int                      ErrorFlag;
-  double                   storage;
-  double                   veg_fract;
-  double                   band_fract;
-  double                   Clake;
+  double                   cell_start;
   dmy_struct              *dmy;
   atmos_data_struct       *atmos;
-  veg_hist_struct        **veg_hist;
   veg_con_struct          *veg_con;
   soil_con_struct          soil_con;
-  all_vars_struct          all_vars;
   filenames_struct         filenames;
   filep_struct             filep;
   lake_con_struct          lake_con;
   out_data_file_struct     *out_data_files;
   out_data_struct          *out_data;
-  save_data_struct         save_data;
+  cell_pool_struct         *cell_pool;
+  cell_prefetch_struct     *cell_prefetch;
+  cell_arena_struct        *cell_arena;
+  vic_context_struct        vic_context;
+  FILE                     *cell_timing_log;
+  double                    run_start;
+  double                    phase;
   
+  run_start = cell_clock();
+
   /** Read Model Options **/
   initialize_global();
   filenames = cmd_proc(argc, argv);
@@ -161,6 +196,7 @@ int main(int argc, char *argv[])
   /** Check and Open Files **/
   check_files(&filep, &filenames);
 
+  Nveg_type = 0;
   if (!options.OUTPUT_FORCE) {
     /** Read Vegetation Library File **/
     veg_lib = read_veglib(filep.veglib,&Nveg_type);
@@ -172,196 +208,202 @@ int main(int argc, char *argv[])
   /** Make Date Data Structure **/
   dmy      = make_dmy(&global_param);
 
+  /** Complete the dates on which to save model state **/
+  make_state_schedule(&global_param, dmy);
+
   /** allocate memory for the atmos_data_struct **/
   alloc_atmos(global_param.nrecs, &atmos);
 
+  /** Open the journal of finished cells if requested **/
+  filep.cell_journal = NULL;
+  if ( strcmp(filenames.cell_journal, "MISSING") != 0 )
+    filep.cell_journal = open_cell_journal(filenames.cell_journal);
+
+  /** Open the solver telemetry file if requested **/
+  filep.solver_telemetry = -1;
+  if ( options.SOLVER_TELEMETRY )
+    filep.solver_telemetry = open_solver_telemetry(filenames.solver_telemetry,
+                                                   cell_journal_resumed(filep.cell_journal));
+
+  /** Split the cells among processes if requested **/
+  first_cell = 0;
+  last_cell = INT_MAX;
+  if ( options.NPROCS > 1 ) {
+    if ( fork_shards(options.NPROCS, &filep, &filenames, &first_cell, &last_cell) ) {
+      /** All shards have finished and their states have been merged **/
+      close_cell_journal(&filep.cell_journal, filenames.cell_journal, TRUE);
+      return EXIT_SUCCESS;
+    }
+  }
+
   /** Initial state **/
   startrec = 0;
+  filep.init_state_index = NULL;
+  filep.statefile = NULL;
   if (!options.OUTPUT_FORCE) {
 
-    if ( options.INIT_STATE ) 
+    if ( options.INIT_STATE ) {
       filep.init_state = check_state_file(filenames.init_state, dmy, 
 					   &global_param, options.Nlayer, 
 					   options.Nnode, &startrec);
+      if ( options.BINARY_STATE_FILE )
+        filep.init_state_index = read_state_index(filep.init_state);
+    }
 
-    /** open state file if model state is to be saved **/
+    /** open state file if model state is to be saved (or re-open the
+        state file of an interrupted run) **/
     if ( options.SAVE_STATE && strcmp( filenames.statefile, "NONE" ) != 0 )
-      filep.statefile = open_state_file(&global_param, filenames, options.Nlayer,
-                                           options.Nnode);
+      filep.statefile = resume_state_file(filep.cell_journal, &global_param,
+                                          filenames, options.Nlayer,
+                                          options.Nnode);
     else filep.statefile = NULL;
 
   } /* !OUTPUT_FORCE */
 
+  /** Store the configuration of the simulation **/
+  save_vic_context(&vic_context, Nveg_type);
+
+  /** Start worker threads if cells are to be run in parallel **/
+  cell_pool = NULL;
+  if ( options.NTHREADS > 1 )
+    cell_pool = start_cell_pool(options.NTHREADS, first_cell, &vic_context, dmy, startrec,
+                                &filep, &filenames, out_data_files, out_data);
+
+  /** Log the run time of each cell if requested (the pool keeps its own log) **/
+  cell_timing_log = NULL;
+  if ( cell_pool == NULL && strcmp(filenames.cell_timing_out, "MISSING") != 0 )
+    cell_timing_log = open_cell_timing(filenames.cell_timing_out);
+
+  /** Prepare the next cell in the background if requested **/
+  cell_prefetch = NULL;
+  if ( cell_pool == NULL && options.PREFETCH )
+    cell_prefetch = start_cell_prefetch(&vic_context, dmy, startrec, &filep,
+                                        &filenames, out_data_files, out_data,
+                                        cell_timing_log);
+
+  /** Otherwise the cells are run here, one after another in one arena **/
+  cell_arena = NULL;
+  if ( cell_pool == NULL && cell_prefetch == NULL )
+    cell_arena = make_cell_arena((size_t)options.CELL_MEMORY_LIMIT << 20);
+
   /************************************
     Run Model for all Active Grid Cells
     ************************************/
   MODEL_DONE = FALSE;
   while(!MODEL_DONE) {
 
-    soil_con = read_soilparam(filep.soilparam, &RUN_MODEL, &MODEL_DONE);
+    phase = phase_start();
+    soil_con = read_soilparam(filep.soilparam, filep.cell_journal, &RUN_MODEL, &MODEL_DONE);
+    phase_end(PH_READ_SOILPARAM, phase);
 
     if(RUN_MODEL) {
 
-      NEWCELL=TRUE;
       cellnum++;
 
+      if ( cellnum >= last_cell ) {
+        /** The remaining cells belong to other processes **/
+        free((char *)soil_con.AreaFract);
+        free((char *)soil_con.BandElev);
+        free((char *)soil_con.Tfactor);
+        free((char *)soil_con.Pfactor);
+        free((char *)soil_con.AboveTreeLine);
+        break;
+      }
+
       if (!options.OUTPUT_FORCE) {
 
         /** Read Grid Cell Vegetation Parameters **/
+        phase = phase_start();
         veg_con = read_vegparam(filep.vegparam, soil_con.gridcel,
                                 Nveg_type);
+        phase_end(PH_READ_VEGPARAM, phase);
         calc_root_fractions(veg_con, &soil_con);
 
         if ( options.LAKES ) 
 	  lake_con = read_lakeparam(filep.lakeparam, soil_con, veg_con);
 
-      } /* !OUTPUT_FORCE */
-
-      /** Build Gridded Filenames, and Open **/
-      make_in_and_outfiles(&filep, &filenames, &soil_con, out_data_files);
-
-      if (options.PRT_HEADER) {
-        /** Write output file headers **/
-        write_header(out_data_files, out_data, dmy, global_param);
-      }
-
-      if (!options.OUTPUT_FORCE) {
-
         /** Read Elevation Band Data if Used **/
         read_snowband(filep.snowband, &soil_con);
 
-        /** Make Top-level Control Structure **/
-        all_vars     = make_all_vars(veg_con[0].vegetat_type_num);
-
-        /** allocate memory for the veg_hist_struct **/
-        alloc_veg_hist(global_param.nrecs, veg_con[0].vegetat_type_num, &veg_hist);
-
       } /* !OUTPUT_FORCE */
 
-      /**************************************************
-         Initialize Meteological Forcing Values That
-         Have not Been Specifically Set
-       **************************************************/
-
-#if VERBOSE
-      fprintf(stderr,"Initializing Forcing Data\n");
-#endif /* VERBOSE */
-
-      initialize_atmos(atmos, dmy, filep.forcing, veg_lib, veg_con, veg_hist,
-		       &soil_con, out_data_files, out_data); 
+      if ( cellnum < first_cell ) {
 
-      if (!options.OUTPUT_FORCE) {
-
-        /**************************************************
-          Initialize Energy Balance and Snow Variables 
-        **************************************************/
-
-#if VERBOSE
-        fprintf(stderr,"Model State Initialization\n");
-#endif /* VERBOSE */
-        ErrorFlag = initialize_model_state(&all_vars, dmy[0], &global_param, filep, 
-			       soil_con.gridcel, veg_con[0].vegetat_type_num,
-			       options.Nnode, 
-			       atmos[0].air_temp[NR],
-			       &soil_con, veg_con, lake_con);
-        if ( ErrorFlag == ERROR ) {
-	  if ( options.CONTINUEONERROR == TRUE ) {
-	    // Handle grid cell solution error
-	    fprintf(stderr, "ERROR: Grid cell %i failed in record %i so the simulation has not finished.  An incomplete output file has been generated, check your inputs before rerunning the simulation.\n", soil_con.gridcel, rec);
-	    break;
-	  } else {
-	    // Else exit program on cell solution error as in previous versions
-	    sprintf(ErrStr, "ERROR: Grid cell %i failed in record %i so the simulation has ended. Check your inputs before rerunning the simulation.\n", soil_con.gridcel, rec);
-	    vicerror(ErrStr);
-	  }
-        }
-      
-#if VERBOSE
-        fprintf(stderr,"Running Model\n");
-#endif /* VERBOSE */
-
-        /** Update Error Handling Structure **/
-        Error.filep = filep;
-        Error.out_data_files = out_data_files;
-
-        /** Initialize the storage terms in the water and energy balances **/
-        /** Sending a negative record number (-global_param.nrecs) to put_data() will accomplish this **/
-	ErrorFlag = put_data(&all_vars, &atmos[0], &soil_con, veg_con, &lake_con, out_data_files, out_data, &save_data, &dmy[0], -global_param.nrecs);
-
-        /******************************************
-	  Run Model in Grid Cell for all Time Steps
-	******************************************/
-
-        for ( rec = startrec ; rec < global_param.nrecs; rec++ ) {
-
-          if ( rec == global_param.nrecs - 1 ) LASTREC = TRUE;
-          else LASTREC = FALSE;
-
-	  /**************************************************
-	    Compute cell physics for 1 timestep
-	  **************************************************/
-	  ErrorFlag = full_energy(cellnum, rec, &atmos[rec], &all_vars, dmy, &global_param, &lake_con, &soil_con, veg_con, veg_hist);
-
-	  /**************************************************
-	    Write cell average values for current time step
-	  **************************************************/
-	  ErrorFlag = put_data(&all_vars, &atmos[rec], &soil_con, veg_con, &lake_con, out_data_files, out_data, &save_data, &dmy[rec], rec);
-
-	  /************************************
-	    Save model state at assigned date
-	    (after the final time step of the assigned date)
-	  ************************************/
-	  if ( filep.statefile != NULL
-	       &&  ( dmy[rec].year == global_param.stateyear
-		     && dmy[rec].month == global_param.statemonth 
-		     && dmy[rec].day == global_param.stateday
-		     && ( rec+1 == global_param.nrecs
-			  || dmy[rec+1].day != global_param.stateday ) ) )
-	    write_model_state(&all_vars, &global_param, veg_con->vegetat_type_num, soil_con.gridcel, &filep, &soil_con, lake_con);
-
-
-          if ( ErrorFlag == ERROR ) {
-            if ( options.CONTINUEONERROR == TRUE ) {
-              // Handle grid cell solution error
-              fprintf(stderr, "ERROR: Grid cell %i failed in record %i so the simulation has not finished.  An incomplete output file has been generated, check your inputs before rerunning the simulation.\n", soil_con.gridcel, rec);
-              break;
-            } else {
-	      // Else exit program on cell solution error as in previous versions
-              sprintf(ErrStr, "ERROR: Grid cell %i failed in record %i so the simulation has ended. Check your inputs before rerunning the simulation.\n", soil_con.gridcel, rec);
-              vicerror(ErrStr);
-	    }
-          }
-
-          NEWCELL=FALSE;
-
-        } /* End Rec Loop */
-
-      } /* !OUTPUT_FORCE */
-
-      close_files(&filep,out_data_files,&filenames); 
-
-      if (!options.OUTPUT_FORCE) {
-
-        free_veg_hist(global_param.nrecs, veg_con[0].vegetat_type_num, &veg_hist);
-        free_all_vars(&all_vars,veg_con[0].vegetat_type_num);
-        free_vegcon(&veg_con);
+        /** The cell belongs to another process; its parameters were read
+            only to keep the parameter files (and veg_lib) in step **/
+        if (!options.OUTPUT_FORCE)
+          free_vegcon(&veg_con);
         free((char *)soil_con.AreaFract);
         free((char *)soil_con.BandElev);
         free((char *)soil_con.Tfactor);
         free((char *)soil_con.Pfactor);
         free((char *)soil_con.AboveTreeLine);
 
-      } /* !OUTPUT_FORCE */
+      }
+      else if ( cell_pool != NULL ) {
+
+        /** Hand the cell over to the worker threads **/
+        if ( submit_cell(cell_pool, cellnum, &soil_con, veg_con, &lake_con) == ERROR )
+          break;
+
+      }
+      else if ( cell_prefetch != NULL ) {
+
+        /** Prepare the cell while the previous one runs **/
+        if ( prefetch_cell(cell_prefetch, cellnum, &soil_con, veg_con, &lake_con) == ERROR )
+          break;
+
+      }
+      else {
+
+        /** Run the cell **/
+        cell_start = cell_clock();
+        ErrorFlag = run_cell(&vic_context, cellnum, &soil_con, veg_con, &lake_con, atmos, dmy,
+                             startrec, &filep, &filenames, out_data_files,
+                             out_data, cell_arena);
+        if ( ErrorFlag == ERROR ) break;
+        if ( filep.cell_journal != NULL )
+          write_cell_journal(filep.cell_journal, soil_con.gridcel, filep.statefile);
+        if ( cell_timing_log != NULL )
+          write_cell_timing(cell_timing_log, soil_con.gridcel, cell_clock() - cell_start,
+                            cell_arena_used(cell_arena));
+        reset_cell_arena(cell_arena);
+
+        if (!options.OUTPUT_FORCE) {
+
+          free_vegcon(&veg_con);
+          free((char *)soil_con.AreaFract);
+          free((char *)soil_con.BandElev);
+          free((char *)soil_con.Tfactor);
+          free((char *)soil_con.Pfactor);
+          free((char *)soil_con.AboveTreeLine);
+
+        } /* !OUTPUT_FORCE */
+
+      }
 
     }	/* End Run Model Condition */
   } 	/* End Grid Loop */
 
+  if ( cell_pool != NULL )
+    finish_cell_pool(&cell_pool);
+  if ( cell_prefetch != NULL )
+    finish_cell_prefetch(&cell_prefetch);
+  if ( cell_timing_log != NULL )
+    fclose(cell_timing_log);
+  if ( cell_arena != NULL )
+    free_cell_arena(&cell_arena);
+
   /** cleanup **/
   free_atmos(global_param.nrecs, &atmos);
   free_dmy(&dmy);
   free_out_data_files(&out_data_files);
   free_out_data(&out_data);
   fclose(filep.soilparam);
+  if ( filep.forcing_pack[0] != NULL )
+    close_forcing_pack(&filep.forcing_pack[0]);
+  if ( filep.forcing_pack[1] != NULL )
+    close_forcing_pack(&filep.forcing_pack[1]);
   if (!options.OUTPUT_FORCE) {
     free_veglib(&veg_lib);
     fclose(filep.vegparam);
@@ -370,12 +412,29 @@ int main(int argc, char *argv[])
       fclose(filep.snowband);
     if (options.LAKES)
       fclose(filep.lakeparam);
-    if ( options.INIT_STATE )
+    if ( options.INIT_STATE ) {
       fclose(filep.init_state);
-    if ( options.SAVE_STATE && strcmp( filenames.statefile, "NONE" ) != 0 )
+      free_state_index(&filep.init_state_index);
+    }
+    if ( options.SAVE_STATE && strcmp( filenames.statefile, "NONE" ) != 0 ) {
+      if ( options.BINARY_STATE_FILE )
+        write_state_index(filep.statefile, filenames.statefile);
       fclose(filep.statefile);
+    }
   } /* !OUTPUT_FORCE */
 
+  if ( filep.solver_telemetry >= 0 )
+    close(filep.solver_telemetry);
+
+  print_phase_profile(cell_clock() - run_start);
+  print_alloc_count();
+  print_jacobian_check();
+
+  /** The run has finished; the shards of an NPROCS run leave the journal
+      to the parent process **/
+  close_cell_journal(&filep.cell_journal, filenames.cell_journal,
+                     options.NPROCS <= 1);
+
   return EXIT_SUCCESS;
 
 }	/* End Main Program */
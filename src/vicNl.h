@@ -124,6 +124,77 @@
   2014-Apr-25 Added non-climatological veg parameter functions.		TJB
   2014-Apr-25 Resurrected calc_veg_displacement() and
 	      calc_veg_roughness().					TJB
+  2026-Oct-18 Added run_cell(), copy_output_list(), copy_out_data_files(),
+	      and the cell pool functions start_cell_pool(), submit_cell(),
+	      and finish_cell_pool() for the NTHREADS option.
+  2026-Oct-18 Added save_vic_context() and bind_vic_context().  Added
+	      vic_context_struct to run_cell() and start_cell_pool().
+  2026-Oct-18 Added fork_shards() for the NPROCS option.  Added
+	      first_cellnum to start_cell_pool().
+  2026-Oct-18 Added cell_clock(), read_cell_timing(),
+	      lookup_cell_timing(), open_cell_timing(), and
+	      write_cell_timing().
+  2026-Oct-18 Added prepare_cell() and simulate_cell(), which make up
+	      run_cell(), and the PREFETCH pipeline functions
+	      start_cell_prefetch(), prefetch_cell(), and
+	      finish_cell_prefetch().
+  2026-Oct-18 Added the output writer functions start_output_writer(),
+	      queue_output(), and finish_output_writer() for the
+	      ASYNC_OUTPUT option.  Added output_writer_struct to put_data().
+  2026-Oct-18 Added on_output_writer().
+  2026-Oct-18 Added the cell arena functions make_cell_arena(),
+	      arena_calloc(), cell_arena_used(), reset_cell_arena(), and
+	      free_cell_arena().  Added cell_arena_struct to
+	      alloc_veg_hist(), make_all_vars(), make_cell_data(),
+	      make_energy_bal(), make_snow_data(), make_veg_var(),
+	      prepare_cell(), simulate_cell(), and run_cell(), and the
+	      cell's memory to write_cell_timing().  Removed
+	      free_all_vars() and free_veg_hist().
+  2026-Oct-18 Added binary_forcing_rec_size() and
+	      decode_binary_forcing().
+  2026-Oct-18 Added parse_ascii_forcing().
+  2026-Oct-18 Added the packed forcing file functions
+	      open_forcing_pack(), find_forcing_pack_cell(),
+	      forcing_pack_cell_length(), read_forcing_pack(),
+	      close_forcing_pack(), forcing_pack_data_start(), and
+	      write_forcing_pack_index(), and binary_forcing_header_size().
+	      Replaced FILE with filep_struct in initialize_atmos(),
+	      read_atmos_data(), and read_forcing_data().
+  2026-Oct-18 Added open_gzip_file().
+  2026-Oct-18 Added the state file index functions write_state_index(),
+	      read_state_index(), seek_state_cell(), state_index_start(),
+	      and free_state_index(); added the index to
+	      read_initial_model_state().
+  2026-Oct-18 Added the state schedule functions parse_state_date(),
+	      parse_state_schedule(), make_state_schedule(), and
+	      state_snapshot(); added the snapshot to seek_state_cell()
+	      and write_model_state().
+  2026-Oct-18 Added the cell journal functions open_cell_journal(),
+	      cell_journal_done(), resume_state_file(),
+	      write_cell_journal(), and close_cell_journal(); added the
+	      cell journal to read_soilparam().
+  2026-Oct-18 Added maximum_unfrozen_water_deriv() and
+	      soil_conductivity_deriv() for the analytic Jacobian of the
+	      implicit soil heat equation; added analytic_jac to the
+	      argument list of newt_raph().
+  2026-Oct-18 Added solve_T_profile_newton().
+  2026-Oct-18 Added root_solve(); func_surf_energy_bal(),
+	      func_canopy_energy_bal() and func_atmos_energy_bal() now
+	      take their inputs in a structure; removed
+	      solve_surf_energy_bal(), solve_canopy_energy_bal() and
+	      solve_atmos_energy_bal().
+  2026-Oct-18 Added the solver telemetry functions
+	      open_solver_telemetry(), start_solver_telemetry(),
+	      solver_telemetry_month(), solver_call_start(),
+	      solver_call_end(), and write_solver_telemetry(); added
+	      cell_journal_resumed().
+  2026-Oct-18 Added the phase profiler functions phase_start(),
+	      phase_end(), export_phase_profile(), import_phase_profile(),
+	      write_phase_profile(), and print_phase_profile().
+  2026-Oct-18 Added print_jacobian_check().
+  2026-Oct-18 Added the allocation counter functions alloc_count_phase()
+	      and print_alloc_count().
+  2026-Oct-18 Removed compress_files().
 ************************************************************************/
 
 #include <math.h>
@@ -133,12 +204,18 @@
 /*** SubRoutine Prototypes ***/
 
 double advected_sensible_heat(double, double, double, double, double);
+void   alloc_count_phase(int);
 void alloc_atmos(int, atmos_data_struct **);
-void alloc_veg_hist(int, int, veg_hist_struct ***);
+void alloc_veg_hist(int, int, veg_hist_struct ***, cell_arena_struct *);
+void  *arena_calloc(cell_arena_struct *, size_t, size_t);
 double arno_evap(layer_data_struct *, double, double, 
 		 double, double, double, double, double, double, double, 
 		 double, double *);
 
+size_t binary_forcing_header_size(const unsigned char *, size_t, int);
+size_t binary_forcing_rec_size(int);
+void   bind_vic_context(vic_context_struct *);
+
 int   CalcAerodynamic(char, double, double, double, double, double,
 	  	       double *, double *, double *, double *, double *);
 double calc_energy_balance_error(int, double, double, double, double, double);
@@ -206,10 +283,16 @@ double canopy_evap(layer_data_struct *,
 		   double, double, double, double, double, 
 		   double *, double *, double *, double *, double *,
                    float *, double *, double, double, double *);
+size_t cell_arena_used(cell_arena_struct *);
+int    cell_journal_done(cell_journal_struct *, int);
+int    cell_journal_resumed(cell_journal_struct *);
+double cell_clock();
 void   check_files(filep_struct *, filenames_struct *);
 FILE  *check_state_file(char *, dmy_struct *, global_param_struct *, int, int, 
                         int *);
+void   close_cell_journal(cell_journal_struct **, char *, int);
 void   close_files(filep_struct *, out_data_file_struct *, filenames_struct *);
+void   close_forcing_pack(forcing_pack_struct **);
 filenames_struct cmd_proc(int argc, char *argv[]);
 void   collect_eb_terms(energy_bal_struct, snow_data_struct, cell_data_struct,
                         int *, int *, int *, int *, int *, double, double, double,
@@ -218,7 +301,6 @@ void   collect_eb_terms(energy_bal_struct, snow_data_struct, cell_data_struct,
 void   collect_wb_terms(cell_data_struct, veg_var_struct, snow_data_struct, lake_var_struct,
                         double, double, double, int, int, double, int, double *,
                         double *, out_data_struct *);
-void   compress_files(char string[]);
 double compute_coszen(double, double, double, dmy_struct);
 void   correct_precip(double *, double, double, double, double);
 void   compute_pot_evap(int, dmy_struct *, int, int, double, double , double, double, double, double **, double *);
@@ -231,9 +313,13 @@ void   compute_soil_layer_thermal_properties(layer_data_struct *, double *,
                                              double *, int);
 void   compute_treeline(atmos_data_struct *, dmy_struct *, double, double *, char *);
 double compute_zwt(soil_con_struct *, int, double);
+out_data_file_struct *copy_out_data_files(out_data_file_struct *);
+out_data_struct *copy_output_list(out_data_struct *);
 out_data_struct *create_output_list();
 
 double darkinhib(double);
+int    decode_binary_forcing(const unsigned char *, size_t, int, int, double **,
+                             double ***);
 void   display_current_settings(int, filenames_struct *, global_param_struct *);
 int  distribute_node_moisture_properties(double *, double *, double *, 
 					 double *, double *, double *,
@@ -256,6 +342,7 @@ double ErrorPrintSnowPackEnergyBalance(double, va_list);
 double error_print_solve_T_profile(double, va_list);
 double error_print_surf_energy_bal(double, va_list);
 double error_solve_T_profile(double Tsurf, ...);
+void   export_phase_profile(phase_profile_struct *);
 double estimate_dew_point(double, double, double, double, double);
 int estimate_layer_ice_content(layer_data_struct *, double *, double *,
 			       double *, double *, double *, double *,
@@ -277,24 +364,31 @@ void   fda_heat_eqn(double *, double *, int, int, ...);
 void   fdjac3(double *, double *, double *, double *, double *,
             void (*vecfunc)(double *, double *, int, int, ...), 
             int);
+void   finish_cell_prefetch(cell_prefetch_struct **);
+void   finish_cell_pool(cell_pool_struct **);
+void   finish_output_writer(output_writer_struct **);
 void   find_0_degree_fronts(energy_bal_struct *, double *, double *, int);
 layer_data_struct find_average_layer(layer_data_struct *, layer_data_struct *,
 				     double, double);
+int    find_forcing_pack_cell(forcing_pack_struct *, int, double, double);
+size_t forcing_pack_cell_length(forcing_pack_struct *, int);
+size_t forcing_pack_data_start(int);
+int    fork_shards(int, filep_struct *, filenames_struct *, int *, int *);
 void   free_atmos(int nrecs, atmos_data_struct **atmos);
-void   free_all_vars(all_vars_struct *, int);
+void   free_cell_arena(cell_arena_struct **);
 void   free_dmy(dmy_struct **dmy);
-void   free_veg_hist(int nrecs, int nveg, veg_hist_struct ***veg_hist);
 void   free_vegcon(veg_con_struct **);
 void   free_veglib(veg_lib_struct **);
 void   free_out_data_files(out_data_file_struct **);
 void   free_out_data(out_data_struct **);
+void   free_state_index(state_index_struct **);
 int    full_energy(int, int, atmos_data_struct *, all_vars_struct *,
 		   dmy_struct *, global_param_struct *, lake_con_struct *,
                    soil_con_struct *, veg_con_struct *, veg_hist_struct **);
-double func_atmos_energy_bal(double, va_list);
+double func_atmos_energy_bal(double, void *);
 double func_atmos_moist_bal(double, va_list);
-double func_canopy_energy_bal(double, va_list);
-double func_surf_energy_bal(double, va_list);
+double func_canopy_energy_bal(double, void *);
+double func_surf_energy_bal(double, void *);
 double get_dist(double, double, double, double);
 void   get_force_type(char *, int, int *);
 global_param_struct get_global_param(filenames_struct *, FILE *);
@@ -305,8 +399,9 @@ void   hermite(int, double *, double *, double *, double *, double *);
 double hiTinhib(double);
 void   HourlyT(int, int, int *, double *, int *, double *, double *);
 
+void   import_phase_profile(phase_profile_struct *);
 void   init_output_list(out_data_struct *, int, char *, int, float);
-void   initialize_atmos(atmos_data_struct *, dmy_struct *, FILE **,
+void   initialize_atmos(atmos_data_struct *, dmy_struct *, filep_struct *,
 			veg_lib_struct *, veg_con_struct *, veg_hist_struct **,
 			soil_con_struct *, out_data_file_struct *, out_data_struct *);
 void   initialize_global();
@@ -323,18 +418,22 @@ void   initialize_veg( veg_var_struct **, veg_con_struct *,
 void   latent_heat_from_snow(double, double, double, double, double, 
                              double, double, double *, double *, 
                              double *, double *, double *);
+double lookup_cell_timing(int, cell_timing_struct *, int);
 double linear_interp(double,double,double,double,double);
 
-cell_data_struct **make_cell_data(int, int);
-all_vars_struct make_all_vars(int);
+cell_data_struct **make_cell_data(int, int, cell_arena_struct *);
+all_vars_struct make_all_vars(int, cell_arena_struct *);
+cell_arena_struct *make_cell_arena(size_t);
 dmy_struct *make_dmy(global_param_struct *);
-energy_bal_struct **make_energy_bal(int);
+energy_bal_struct **make_energy_bal(int, cell_arena_struct *);
 void make_in_and_outfiles(filep_struct *, filenames_struct *, 
 			  soil_con_struct *, out_data_file_struct *);
-snow_data_struct **make_snow_data(int);
-veg_var_struct **make_veg_var(int);
+void   make_state_schedule(global_param_struct *, dmy_struct *);
+snow_data_struct **make_snow_data(int, cell_arena_struct *);
+veg_var_struct **make_veg_var(int, cell_arena_struct *);
 void   MassRelease(double *,double *,double *,double *);
 double maximum_unfrozen_water(double, double, double, double);
+double maximum_unfrozen_water_deriv(double, double, double, double);
 double modify_Ksat(double);
 void mtclim_wrapper(int, int, double, double, double, double,
                       double, double, double, double,
@@ -343,25 +442,46 @@ void mtclim_wrapper(int, int, double, double, double, double,
 
 double new_snow_density(double);
 int    newt_raph(void (*vecfunc)(double *, double *, int, int, ...), 
-               double *, int);
+               double *, int, int);
 void   nrerror(char *);
 
+int    on_output_writer(output_writer_struct *);
+
 FILE  *open_file(char string[], char type[]);
+cell_journal_struct *open_cell_journal(char *);
+FILE  *open_gzip_file(char filename[], char type[], int level);
+forcing_pack_struct *open_forcing_pack(char *, int);
 FILE  *open_state_file(global_param_struct *, filenames_struct, int, int);
+int    open_solver_telemetry(char *, int);
 
 void parse_output_info(filenames_struct *, FILE *, out_data_file_struct **, out_data_struct *);
+int    parse_state_date(char *);
+void   parse_state_schedule(char *, global_param_struct *);
+void   phase_end(int, double);
+double phase_start();
 double penman(double, double, double, double, double, double, double);
 void photosynth(char, double, double, double, double, double, double,
                 double, double, double, char *, double *, double *,
                 double *, double *, double *);
+int    prefetch_cell(cell_prefetch_struct *, int, soil_con_struct *,
+                     veg_con_struct *, lake_con_struct *);
+void   prepare_cell(soil_con_struct *, veg_con_struct *, atmos_data_struct *,
+                    dmy_struct *, filep_struct *, filenames_struct *,
+                    out_data_file_struct *, out_data_struct *,
+                    veg_hist_struct ***, cell_arena_struct *);
 void   prepare_full_energy(int, int, int, all_vars_struct *, 
 			   soil_con_struct *, double *, double *); 
+int    parse_ascii_forcing(const char *, const char *, int, int, int,
+                           double **, double ***);
 int    put_data(all_vars_struct *, atmos_data_struct *,
 		soil_con_struct *, veg_con_struct *,
                 lake_con_struct *, out_data_file_struct *,
-		out_data_struct *, save_data_struct *,
+		out_data_struct *, output_writer_struct *, save_data_struct *,
  	        dmy_struct *, int); 
 void print_all_vars(all_vars_struct *all);
+void   print_alloc_count();
+void   print_jacobian_check();
+void print_phase_profile(double);
 void print_atmos_data(atmos_data_struct *atmos, size_t nr);
 void print_cell_data(cell_data_struct *cell, size_t nlayers, size_t nfrost,
                              size_t npet);
@@ -388,27 +508,51 @@ void print_veg_con(veg_con_struct *vcon, size_t nroots, char blowing, char lake,
                             char carbon, size_t ncanopy);
 void print_veg_lib(veg_lib_struct *vlib, char carbon);
 void print_veg_var(veg_var_struct *vvar, size_t ncanopy);
-void   read_atmos_data(FILE *, global_param_struct, int, int, double **, double ***);
-double **read_forcing_data(FILE **, global_param_struct, double ****);
-void   read_initial_model_state(FILE *, all_vars_struct *, 
+void   queue_output(output_writer_struct *, out_data_struct *, dmy_struct *);
+FILE  *open_cell_timing(char *);
+void   read_atmos_data(filep_struct *, global_param_struct, int, int, double **, double ***);
+double **read_forcing_data(filep_struct *, global_param_struct, double ****);
+void   read_forcing_pack(forcing_pack_struct *, int, size_t, size_t,
+                         unsigned char *);
+int    read_cell_timing(char *, cell_timing_struct **);
+void   read_initial_model_state(FILE *, state_index_struct *, all_vars_struct *, 
 				global_param_struct *, int, int, int, 
 				soil_con_struct *, lake_con_struct);
 void   read_snowband(FILE *, soil_con_struct *);
-soil_con_struct read_soilparam(FILE *, char *, char *);
+state_index_struct *read_state_index(FILE *);
+soil_con_struct read_soilparam(FILE *, cell_journal_struct *, char *, char *);
 veg_lib_struct *read_veglib(FILE *, int *);
 veg_con_struct *read_vegparam(FILE *, int, int);
+void   reset_cell_arena(cell_arena_struct *);
+FILE  *resume_state_file(cell_journal_struct *, global_param_struct *,
+                        filenames_struct, int, int);
 void   redistribute_moisture(layer_data_struct *, double *, double *,
 			     double *, double *, double *, int);
 double root_brent(double, double, char *, double (*Function)(double, va_list), ...);
+double root_solve(double, double, double, char *,
+                  double (*Function)(double, void *), void *, int *);
+int    run_cell(vic_context_struct *, int, soil_con_struct *, veg_con_struct *, lake_con_struct *,
+                atmos_data_struct *, dmy_struct *, int, filep_struct *,
+                filenames_struct *, out_data_file_struct *, out_data_struct *,
+                cell_arena_struct *);
 int    runoff(cell_data_struct *, energy_bal_struct *, soil_con_struct *,
               double, double *, int, int, int, int, int);
 
+void   save_vic_context(vic_context_struct *, int);
+int    seek_state_cell(state_index_struct *, FILE *, int, int);
 void set_max_min_hour(double *, int, int *, int *);
 void set_node_parameters(double *, double *, double *, double *, double *, double *,
 			 double *, double *, double *, double *, double *,
 			 double *, double *, int, int, char);
 out_data_file_struct *set_output_defaults(out_data_struct *);
 int set_output_var(out_data_file_struct *, int, int, out_data_struct *, char *, int, char *, int, float);
+int    simulate_cell(int, soil_con_struct *, veg_con_struct *, lake_con_struct *,
+                     atmos_data_struct *, dmy_struct *, int, filep_struct *,
+                     filenames_struct *, out_data_file_struct *,
+                     out_data_struct *, veg_hist_struct **,
+                     cell_arena_struct *);
+long long state_index_start(state_index_struct *);
+int    state_snapshot(global_param_struct *, dmy_struct *, int);
 double snow_albedo(double, double, double, double, double, double, int, char);
 double snow_density(snow_data_struct *, double, double, double, double, double);
 int    snow_intercept(double, double, double, double, double, double,
@@ -430,10 +574,26 @@ int    snow_melt(double, double, double, double, double *, double, double *, dou
                  double *, double *, double *, double *, double *, double *, 
                  int, int, int, int, snow_data_struct *, soil_con_struct *);
 double SnowPackEnergyBalance(double, va_list);
+cell_prefetch_struct *start_cell_prefetch(vic_context_struct *, dmy_struct *, int,
+                                          filep_struct *, filenames_struct *,
+                                          out_data_file_struct *, out_data_struct *,
+                                          FILE *);
+void   start_solver_telemetry(int, dmy_struct *);
+cell_pool_struct *start_cell_pool(int, int, vic_context_struct *, dmy_struct *, int, filep_struct *,
+                                  filenames_struct *, out_data_file_struct *,
+                                  out_data_struct *);
+output_writer_struct *start_output_writer(out_data_file_struct *, out_data_struct *,
+                                          int);
+int    submit_cell(cell_pool_struct *, int, soil_con_struct *,
+                   veg_con_struct *, lake_con_struct *);
 void   soil_carbon_balance(soil_con_struct *, energy_bal_struct *,
                            cell_data_struct *, veg_var_struct *);
 double soil_conductivity(double, double, double, double, double, double, double, double);
+double soil_conductivity_deriv(double, double, double, double, double, double, double, double);
 double soil_thermal_eqn(double, va_list);
+void   solver_call_end(int, double, int, int, int);
+double solver_call_start();
+void   solver_telemetry_month(dmy_struct *);
 double solve_snow(char, double, double, double, double, double,
                   double, double, double, double, double, double,
                   double *, double *, double *, double *, double *,
@@ -447,15 +607,14 @@ double solve_snow(char, double, double, double, double, double,
                   layer_data_struct *,
                   snow_data_struct *, soil_con_struct *,
                   veg_var_struct *);
-double solve_atmos_energy_bal(double Tcanopy, ...);
 double solve_atmos_moist_bal(double , ...);
-double solve_canopy_energy_bal(double Tfoliage, ...);
-double solve_surf_energy_bal(double Tsurf, ...);
 int    solve_T_profile(double *, double *, char *, int *, double *, double *,double *, 
 		       double *, double, double *, double *, double *,
 		       double *, double *, double *, double *, double, double *,
 		       int, int *, int, int, int, int);
-
+int    solve_T_profile_newton(int, double *, double *, double *, double *, double *,
+			      double *, double *, double *, double *, double *, double *,
+			      double *, int, int, int, double, int *);
 int   solve_T_profile_implicit(double *, double *, char *, int *, double *, double *, double *,
 			       double *, double, double *, double *, double *,
 			       double *, double *, double *, double *, double, int, int *,
@@ -489,13 +648,19 @@ void   vicerror(char *);
 double volumetric_heat_capacity(double,double,double,double);
 
 void wrap_compute_zwt(soil_con_struct *, cell_data_struct *);
+void write_cell_journal(cell_journal_struct *, int, FILE *);
+void write_cell_timing(FILE *, int, double, size_t);
 void write_data(out_data_file_struct *, out_data_struct *, dmy_struct *, int);
 void write_forcing_file(atmos_data_struct *, int, out_data_file_struct *, out_data_struct *);
+void write_forcing_pack_index(FILE *, int, int, forcing_pack_cell_struct *);
 void write_header(out_data_file_struct *, out_data_struct *, dmy_struct *, global_param_struct);
 void write_layer(layer_data_struct *, int, int, 
                  double *, double *);
 void write_model_state(all_vars_struct *, global_param_struct *, int, 
-		       int, filep_struct *, soil_con_struct *, lake_con_struct);
+		       int, int, filep_struct *, soil_con_struct *, lake_con_struct);
+void write_phase_profile(int);
+void write_solver_telemetry(int);
+void write_state_index(FILE *, char *);
 void write_vegvar(veg_var_struct *, int);
 
 void zero_output_list(out_data_struct *);
@@ -148,6 +148,41 @@
   2014-Apr-25 Added partial vegcover fraction.				TJB
   2014-May-05 Moved constants CLOSURE, RSMAX, and VPDMINFACTOR from
 	      penman.c to here.						TJB
+  2026-Oct-18 Added NTHREADS option, THREAD_LOCAL storage class, and
+	      cell_pool_struct for the thread-parallel cell driver.
+  2026-Oct-18 Made NR and NF thread-local.  Added vic_context_struct.
+  2026-Oct-18 Added NPROCS option.
+  2026-Oct-18 Added CELL_SCHEDULE option, cell_timing and cell_timing_out
+	      file names, and cell_timing_struct.
+  2026-Oct-18 Added PREFETCH option and cell_prefetch_struct.
+  2026-Oct-18 Added ASYNC_OUTPUT option, OUTPUT_RING_RECS, and
+	      output_writer_struct; added output_writer to Error_struct.
+  2026-Oct-18 Added record buffer to out_data_file_struct.
+  2026-Oct-18 Added MAX_CANOPY.
+  2026-Oct-18 Added CELL_MEMORY_LIMIT option and cell_arena_struct.
+  2026-Oct-18 Added PACKED forcing file format, forcing_pack_struct,
+	      forcing_pack_cell_struct, and forcing_pack and forcing_cell
+	      to filep_struct.
+  2026-Oct-18 Added output file compression types, and compress to
+	      out_data_file_struct.
+  2026-Oct-18 Added state_index_struct, and init_state_index to
+	      filep_struct.
+  2026-Oct-18 Added STATE_SCHEDULE option, MAX_STATE_DATES, and the
+	      state schedule and initial state snapshot to
+	      global_param_struct.
+  2026-Oct-18 Added cell_journal_struct, cell_journal to filep_struct,
+	      and the cell_journal file name.
+  2026-Oct-18 Added EXPLICIT_SOLVER option and soil_T_iter_struct.
+  2026-Oct-18 Added surf_energy_bal_args_struct,
+	      canopy_energy_bal_args_struct and atmos_energy_bal_args_struct.
+  2026-Oct-18 Added SOLVER_TELEMETRY option, solver_telemetry to
+	      filep_struct, the solver_telemetry file name, and
+	      solver_stats_struct and solver_telemetry_struct.
+  2026-Oct-18 Added PHASE_PROFILE option and phase_profile_struct.
+  2026-Oct-18 Added SOLAR_GEOM_PRECISION option.
+  2026-Oct-18 Added ALLOC_SETUP and ALLOC_TIME_STEP.
+  2026-Oct-18 Added IMPLICIT_JACOBIAN option.
+  2026-Oct-18 Added ENERGY_WARM_START option.
 *********************************************************************/
 #include <snow.h>
 
@@ -171,9 +206,13 @@
 #define MAX_LAYERS     3       /* maximum number of soil moisture layers */
 #define MAX_NODES      50      /* maximum number of soil thermal nodes */
 #define MAX_BANDS      10      /* maximum number of snow bands */
+#define MAX_STATE_DATES 1200   /* maximum number of dates in STATE_SCHEDULE */
+#define MULTI_SNAPSHOT_STATE -1 /* stored in place of the year at the start
+                                  of a multi-snapshot state file */
 #define MAX_FRONTS     3       /* maximum number of freezing and thawing front depths to store */
 #define MAX_FROST_AREAS 10     /* maximum number of frost sub-areas */
 #define MAX_LAKE_NODES 20      /* maximum number of lake thermal nodes */
+#define MAX_CANOPY     10      /* maximum number of canopy layers (CARBON) */
 #define MAX_ZWTVMOIST  11      /* maximum number of points in water table vs moisture curve for each soil layer; should include points at lower and upper boundaries of the layer */
 
 /***** Number of iterations to use in solving the surface energy balance.
@@ -185,6 +224,8 @@
 /***** Met file formats *****/
 #define ASCII 1
 #define BINARY 2
+#define PACKED 3	/* binary records of all cells in one file; see
+			   forcing_pack.c */
 
 /***** Snow Density parametrizations *****/
 #define DENS_BRAS   0
@@ -244,6 +285,22 @@
 #define RC_JARVIS 0
 #define RC_PHOTO  1
 
+/***** Solvers of the explicit soil temperature profile (IMPLICIT = FALSE) *****/
+#define ES_GAUSS_SEIDEL 0
+#define ES_NEWTON       1
+
+/***** Jacobians of the implicit soil temperature profile (IMPLICIT = TRUE) *****/
+#define IJ_FD       0
+#define IJ_ANALYTIC 1
+#define IJ_CHECK    2
+
+/***** Grid cell scheduling orders (NTHREADS > 1) *****/
+#define SCHED_FILE_ORDER    0
+#define SCHED_LONGEST_FIRST 1
+
+/***** Number of output records buffered by the output writer (ASYNC_OUTPUT) *****/
+#define OUTPUT_RING_RECS 256
+
 /***** Photosynthesis parametrizations *****/
 #define PS_FARQUHAR 1
 #define PS_MONTEITH 2
@@ -667,6 +724,12 @@ extern char ref_veg_ref_crop[];
 #define AGG_TYPE_MIN     4 /* minimum value over agg interval */
 #define AGG_TYPE_SUM     5 /* sum over agg interval */
 
+/***** Output file compression types *****/
+#define OUT_COMPRESS_DEFAULT   0 /* as given by the COMPRESS option */
+#define OUT_COMPRESS_NONE      1 /* not compressed */
+#define OUT_COMPRESS_GZIP      2 /* gzip, zlib level 6 */
+#define OUT_COMPRESS_GZIP_FAST 3 /* gzip, zlib level 1 (faster, larger files) */
+
 /***** Codes for displaying version information *****/
 #define DISP_VERSION 1
 #define DISP_COMPILE_TIME 2
@@ -676,34 +739,84 @@ extern char ref_veg_ref_crop[];
 /***** VIC model version *****/
 extern char *version;
 
+/***** Storage class of the model's global variables.  Each thread
+       gets its own copy, set from a vic_context_struct by
+       bind_vic_context(); all declarations of such a variable must
+       carry it. *****/
+#define THREAD_LOCAL __thread
+
 /* global variables */
-extern int NR;			/* array index for atmos struct that indicates
+extern THREAD_LOCAL int NR;			/* array index for atmos struct that indicates
 				   the model step avarage or sum */
-extern int NF;			/* array index loop counter limit for atmos
+extern THREAD_LOCAL int NF;			/* array index loop counter limit for atmos
 				   struct that indicates the SNOW_STEP values */
 
 /***** Data Structures *****/
 
 /** file structures **/
+
+/********************************************************
+  Packed forcing file (FORCE_FORMAT PACKED) opened for
+  reading; its contents are private to forcing_pack.c.
+  ********************************************************/
+typedef struct forcing_pack_struct forcing_pack_struct;
+
+/********************************************************
+  Index entry of one grid cell in a packed forcing file.
+  ********************************************************/
 typedef struct {
+  int    gridcel;       /* grid cell number */
+  double lat;           /* grid cell latitude */
+  double lng;           /* grid cell longitude */
+  size_t offset;        /* byte offset of the cell's first record */
+  size_t length;        /* bytes of records of the cell */
+} forcing_pack_cell_struct;
+
+/********************************************************
+  Index of the cell records of a binary model state
+  file; its contents are private to state_index.c.
+  ********************************************************/
+typedef struct state_index_struct state_index_struct;
+
+/********************************************************
+  Journal of the grid cells that a run has finished
+  (CELL_JOURNAL); its contents are private to
+  cell_journal.c.
+  ********************************************************/
+typedef struct cell_journal_struct cell_journal_struct;
+
+typedef struct {
+  cell_journal_struct *cell_journal; /* journal of finished cells, or NULL */
   FILE *forcing[2];     /* atmospheric forcing data files */
+  forcing_pack_struct *forcing_pack[2]; /* packed forcing files
+                           (FORCE_FORMAT PACKED), or NULL */
+  int   forcing_cell[2]; /* index of the current cell in forcing_pack */
   FILE *globalparam;    /* global parameters file */
   FILE *init_state;     /* initial model state file */
+  state_index_struct *init_state_index; /* index of init_state, or NULL
+                           if it has none */
   FILE *lakeparam;      /* lake parameter file */
   FILE *snowband;       /* snow elevation band data file */
   FILE *soilparam;      /* soil parameters for all grid cells */
   FILE *statefile;      /* output model state file */
   FILE *veglib;         /* vegetation parameters for all vege types */
   FILE *vegparam;       /* fractional coverage info for grid cell */
+  int   solver_telemetry; /* solver telemetry file (SOLVER_TELEMETRY), or -1 */
 } filep_struct;
 
 typedef struct {
+  char  cell_journal[MAXSTRING]; /* journal of finished cells */
+  char  cell_timing[MAXSTRING]; /* per-cell run time log from a previous run */
+  char  cell_timing_out[MAXSTRING]; /* per-cell run time log written by this
+                                   process; differs from cell_timing only
+                                   in the shards of an NPROCS run */
   char  forcing[2][MAXSTRING];  /* atmospheric forcing data file names */
   char  f_path_pfx[2][MAXSTRING];  /* path and prefix for atmospheric forcing data file names */
   char  global[MAXSTRING];      /* global control file name */
   char  init_state[MAXSTRING];  /* initial model state file name */
   char  lakeparam[MAXSTRING];   /* lake model constants file */
   char  result_dir[MAXSTRING];  /* directory where results will be written */
+  char  solver_telemetry[MAXSTRING]; /* solver telemetry file */
   char  snowband[MAXSTRING];    /* snow band parameter file name */
   char  soil[MAXSTRING];        /* soil parameter file name */
   char  statefile[MAXSTRING];   /* name of file in which to store model state */
@@ -754,6 +867,11 @@ typedef struct {
 			      vegetation from higher elevations */
   char   CONTINUEONERROR;/* TRUE = VIC will continue to run after a cell has an error */
   char   CORRPREC;       /* TRUE = correct precipitation for gage undercatch */
+  char   ENERGY_WARM_START; /* TRUE = root_solve() searches for the
+                               surface, canopy and canopy air temperatures
+                               from their values in the previous time step;
+                               FALSE = it brackets them between fixed bounds
+                               with root_brent() */
   char   EQUAL_AREA;     /* TRUE = RESOLUTION stores grid cell area in km^2;
 			    FALSE = RESOLUTION stores grid cell side length in degrees */
   char   EXP_TRANS;      /* TRUE = Uses grid transform for exponential node 
@@ -765,6 +883,18 @@ typedef struct {
                             "GF_410"  = use formulas from VIC 4.1.0 */
   char   IMPLICIT;       /* TRUE = Use implicit solution when computing 
 			    soil thermal fluxes */
+  char   EXPLICIT_SOLVER; /* solver of the explicit soil temperature profile
+                             (IMPLICIT = FALSE):
+                             ES_GAUSS_SEIDEL = node-by-node sweeps;
+                             ES_NEWTON = damped Newton iteration on the
+                             whole (tridiagonal) profile */
+  char   IMPLICIT_JACOBIAN; /* Jacobian of the implicit soil temperature
+                               profile (IMPLICIT = TRUE):
+                               IJ_FD = forward differences;
+                               IJ_ANALYTIC = analytic;
+                               IJ_CHECK = forward differences, and the
+                               profile is also solved with the analytic
+                               Jacobian for comparison */
   char   JULY_TAVG_SUPPLIED; /* If TRUE and COMPUTE_TREELINE is also true,
 			        then average July air temperature will be read
 			        from soil file and used in calculating treeline */
@@ -805,6 +935,9 @@ typedef struct {
 			    snow model */
   int    SNOW_STEP;      /* Time step in hours to use when solving the 
 			    snow model */
+  float  SOLAR_GEOM_PRECISION; /* Precision [degrees] to which the latitude,
+			    slope, aspect and horizons of a cell are rounded
+			    for MTCLIM's solar geometry; 0 = exact */
   int    SPATIAL_FROST;  /* TRUE = use a uniform distribution to simulate the
                             spatial distribution of soil frost; FALSE = assume
                             that the entire grid cell is frozen uniformly. */
@@ -850,9 +983,36 @@ typedef struct {
   char   BINARY_STATE_FILE; /* TRUE = model state file is binary (default) */
   char   INIT_STATE;     /* TRUE = initialize model state from file */
   char   SAVE_STATE;     /* TRUE = save state file */       
+  char   STATE_SCHEDULE; /* TRUE = save the model state on each date of the
+                            state schedule, in one multi-snapshot state file */
+
+  // run control options
+  int    NTHREADS;       /* Number of threads over which to distribute the
+                            grid cells; 1 = run serially (default) */
+  int    NPROCS;         /* Number of processes (shards of the soil parameter
+                            file) over which to distribute the grid cells;
+                            1 = single process (default) */
+  char   CELL_SCHEDULE;  /* SCHED_FILE_ORDER = worker threads take cells in
+                            the order of the soil parameter file (default);
+                            SCHED_LONGEST_FIRST = all cells are read first,
+                            then run in order of decreasing estimated cost */
+  char   PREFETCH;       /* TRUE = when running cells serially, prepare the
+                            forcings of the next cell on a helper thread
+                            while the current cell is simulated */
+  int    CELL_MEMORY_LIMIT; /* Maximum memory (MB) that one grid cell may
+                            take from its cell arena; 0 = no limit
+                            (default) */
+  char   SOLVER_TELEMETRY; /* TRUE = record the calls of the iterative
+                            solvers per cell and month (see
+                            solver_telemetry.c) */
+  char   PHASE_PROFILE;  /* TRUE = time the phases of each cell's run and
+                            print them per cell and per run (see
+                            phase_profile.c) */
 
   // output options
   char   ALMA_OUTPUT;    /* TRUE = output variables are in ALMA-compliant units; FALSE = standard VIC units */
+  char   ASYNC_OUTPUT;   /* TRUE = output records are written by a separate
+                            writer thread while the cell is simulated */
   char   BINARY_OUTPUT;  /* TRUE = output files are in binary, not ASCII */
   char   COMPRESS;       /* TRUE = Compress all output files */
   char   MOISTFRACT;     /* TRUE = output soil moisture as fractional moisture content */
@@ -921,6 +1081,15 @@ typedef struct {
   int    stateday;   /* Day of the simulation at which to save model state */
   int    statemonth; /* Month of the simulation at which to save model state */
   int    stateyear;  /* Year of the simulation at which to save model state */
+  int    Nstate_dates; /* Number of dates on which to save model state */
+  int    state_date[MAX_STATE_DATES]; /* Dates on which to save model state
+                        (yyyymmdd), in increasing order */
+  int    state_monthly_day; /* Day of each month on which to save model state
+                        (STATE_SCHEDULE MONTHLY); 0 = not monthly */
+  int    init_state_date; /* Date of the snapshot to read from a multi-snapshot
+                        initial state file (yyyymmdd), or MISSING */
+  int    init_state_snapshot; /* Number of that snapshot in the initial state
+                        file; -1 = single-snapshot file */
 } global_param_struct;
 
 /***********************************************************
@@ -1456,8 +1625,18 @@ typedef struct {
 		                (a variable's id number is its index in the out_data array).
 		                The order of the id numbers in the varid array
 		                is the order in which the variables will be written. */
+  char		compress;    /* compression of the file (OUT_COMPRESS_*) */
+  char		*buf;        /* buffer in which write_data() assembles one record */
+  size_t	bufsize;     /* size of buf (bytes) */
 } out_data_file_struct;
 
+/********************************************************
+  Writer thread that writes a cell's output records while
+  the cell is simulated (ASYNC_OUTPUT); its contents are
+  private to output_writer.c.
+  ********************************************************/
+typedef struct output_writer_struct output_writer_struct;
+
 /********************************************************
   This structure holds all variables needed for the error
   handling routines.
@@ -1470,9 +1649,341 @@ typedef struct {
   int                rec;
   out_data_struct   *out_data;
   out_data_file_struct    *out_data_files;
+  output_writer_struct    *output_writer;
   snow_data_struct  *snow;
   soil_con_struct    soil_con;
   veg_con_struct    *veg_con;
   veg_var_struct    *veg_var;
 } Error_struct;
 
+/********************************************************
+  This structure holds the configuration of one simulation:
+  everything that get_global_param() and read_veglib() set
+  up before the first cell is run.  bind_vic_context()
+  installs a context in the calling thread's copies of the
+  model globals, so that simulations with different
+  contexts can run concurrently on different threads.
+  ********************************************************/
+typedef struct {
+  option_struct        options;      /* model options */
+  global_param_struct  global_param; /* simulation dates and time steps */
+  param_set_struct     param_set;    /* forcing file configuration */
+  veg_lib_struct      *veg_lib;      /* vegetation library */
+  int                  Nveg_type;    /* number of classes in veg_lib */
+  int                  NR;           /* see NR above */
+  int                  NF;           /* see NF above */
+} vic_context_struct;
+
+/********************************************************
+  Pool of worker threads that run grid cells in parallel
+  (NTHREADS > 1); its contents are private to cell_pool.c.
+  ********************************************************/
+typedef struct cell_pool_struct cell_pool_struct;
+
+/********************************************************
+  Two-stage pipeline that prepares the next grid cell's
+  forcings while the current cell is simulated (PREFETCH);
+  its contents are private to cell_prefetch.c.
+  ********************************************************/
+typedef struct cell_prefetch_struct cell_prefetch_struct;
+
+/********************************************************
+  Memory arena holding the structures allocated for one
+  grid cell's run; its contents are private to
+  cell_arena.c.
+  ********************************************************/
+typedef struct cell_arena_struct cell_arena_struct;
+
+/********************************************************
+  Run time of one grid cell, as recorded in the cell
+  timing log (CELL_TIMING_LOG).
+  ********************************************************/
+typedef struct {
+  int    gridcel;  /* grid cell number */
+  double seconds;  /* wall time of the cell's run */
+} cell_timing_struct;
+
+/********************************************************
+  Iteration counts of the explicit soil temperature
+  profile solutions of a grid cell (see
+  calc_soil_thermal_fluxes()), reported at the end of
+  the cell's run.
+  ********************************************************/
+typedef struct {
+  long Nsolutions; /* number of profile solutions */
+  long Niter;      /* Newton iterations (NEWTON) or sweeps (GAUSS_SEIDEL) */
+  long Nfallback;  /* Newton solutions that were redone by sweeps */
+  long Nsweeps;    /* sweeps of these redone solutions */
+} soil_T_iter_struct;
+
+/********************************************************
+  Arguments of func_surf_energy_bal(), the surface energy
+  balance solved by calc_surf_energy_bal() for the soil
+  surface temperature.
+  ********************************************************/
+typedef struct {
+  /* general model terms */
+  int                 rec;
+  int                 nrecs;
+  int                 month;
+  int                 VEG;
+  int                 veg_class;
+  int                 iveg;
+  double              delta_t;
+
+  /* soil layer terms */
+  double              Cs1;
+  double              Cs2;
+  double              D1;
+  double              D2;
+  double              T1_old;
+  double              T2;
+  double              Ts_old;
+  double             *Told_node;
+  double              bubble;
+  double              dp;
+  double              expt;
+  double              ice0;
+  double              kappa1;
+  double              kappa2;
+  double              max_moist;
+  double              moist;
+  float              *root;
+  double             *CanopLayerBnd;
+
+  /* meteorological forcing terms */
+  int                 UnderStory;
+  int                 overstory;
+  double              NetShortBare;
+  double              NetShortGrnd;
+  double              NetShortSnow;
+  double              Tair;
+  double              atmos_density;
+  double              atmos_pressure;
+  double              emissivity;
+  double              LongBareIn;
+  double              LongSnowIn;
+  double              surf_atten;
+  double              vp;
+  double              vpd;
+  double              shortwave;
+  double              Catm;
+  double             *dryFrac;
+  double             *Wdew;
+  double             *displacement;
+  double             *ra;
+  double             *Ra_used;
+  double              rainfall;
+  double             *ref_height;
+  double             *roughness;
+  double             *wind;
+
+  /* latent heat terms */
+  double              Le;
+
+  /* snowpack terms */
+  double              Advection;
+  double              OldTSurf;
+  double              TPack;
+  double              Tsnow_surf;
+  double              kappa_snow;
+  double              melt_energy;
+  double              snow_coverage;
+  double              snow_density;
+  double              snow_swq;
+  double              snow_water;
+  double             *deltaCC;
+  double             *refreeze_energy;
+  double             *vapor_flux;
+  double             *blowing_flux;
+  double             *surface_flux;
+
+  /* soil node terms */
+  int                 Nnodes;
+  double             *Cs_node;
+  double             *T_node;
+  double             *Tnew_node;
+  char               *Tnew_fbflag;
+  int                *Tnew_fbcount;
+  double             *alpha;
+  double             *beta;
+  double             *bubble_node;
+  double             *Zsum_node;
+  double             *expt_node;
+  double             *gamma;
+  double             *ice_node;
+  double             *kappa_node;
+  double             *max_moist_node;
+  double             *moist_node;
+
+  /* model structures */
+  soil_con_struct    *soil_con;
+  layer_data_struct  *layer;
+  veg_var_struct     *veg_var;
+
+  /* control flags */
+  int                 INCLUDE_SNOW;
+  int                 NOFLUX;
+  int                 EXP_TRANS;
+  int                 SNOWING;
+  int                *FIRST_SOLN;
+
+  /* returned energy balance terms */
+  double             *NetLongBare;
+  double             *NetLongSnow;
+  double             *T1;
+  double             *deltaH;
+  double             *fusion;
+  double             *grnd_flux;
+  double             *latent_heat;
+  double             *latent_heat_sub;
+  double             *sensible_heat;
+  double             *snow_flux;
+  double             *store_error;
+} surf_energy_bal_args_struct;
+
+/********************************************************
+  Arguments of func_canopy_energy_bal(), the canopy energy
+  balance solved by snow_intercept() for the foliage
+  temperature.
+  ********************************************************/
+typedef struct {
+  /* General Model Parameters */
+  int                 band;
+  int                 month;
+  int                 rec;
+  double              delta_t;
+  double              elevation;
+  double             *Wmax;
+  double             *Wcr;
+  double             *Wpwp;
+  double             *depth;
+  double             *frost_fract;
+
+  /* Atmospheric Condition and Forcings */
+  double              AirDens;
+  double              EactAir;
+  double              Press;
+  double              Le;
+  double              Tcanopy;
+  double              Vpd;
+  double              shortwave;
+  double              Catm;
+  double             *dryFrac;
+  double             *Evap;
+  double             *Ra;
+  double             *Ra_used;
+  double              Rainfall;
+  double             *Wind;
+
+  /* Vegetation Terms */
+  int                 UnderStory;
+  int                 iveg;
+  int                 veg_class;
+  double             *displacement;
+  double             *ref_height;
+  double             *roughness;
+  float              *root;
+  double             *CanopLayerBnd;
+
+  /* Water Flux Terms */
+  double              IntRain;
+  double              IntSnow;
+  double             *Wdew;
+  layer_data_struct  *layer;
+  veg_var_struct     *veg_var;
+
+  /* Energy Flux Terms */
+  double              LongOverIn;
+  double              LongUnderOut;
+  double              NetShortOver;
+  double             *AdvectedEnergy;
+  double             *LatentHeat;
+  double             *LatentHeatSub;
+  double             *LongOverOut;
+  double             *NetLongOver;
+  double             *NetRadiation;
+  double             *RefreezeEnergy;
+  double             *SensibleHeat;
+  double             *VaporMassFlux;
+} canopy_energy_bal_args_struct;
+
+/********************************************************
+  Arguments of func_atmos_energy_bal(), the atmospheric
+  energy balance solved by calc_atmos_energy_bal() for
+  the canopy air temperature.
+  ********************************************************/
+typedef struct {
+  double              LatentHeat;
+  double              NetRadiation;
+  double              Ra;
+  double              Tair;
+  double              atmos_density;
+  double              InSensible;
+  double             *SensibleHeat;
+} atmos_energy_bal_args_struct;
+
+/********************************************************
+  Calls of the iterative solvers made while running a
+  grid cell, accumulated per month and written to the
+  solver telemetry file (SOLVER_TELEMETRY); see
+  solver_telemetry.c.
+  ********************************************************/
+#define ST_ROOT_BRENT 0 /* root_brent() */
+#define ST_ROOT_SOLVE 1 /* root_solve() */
+#define ST_NEWT_RAPH  2 /* newt_raph() */
+#define ST_SOIL_T     3 /* explicit soil temperature profile
+                           (calc_soil_thermal_fluxes()) */
+#define ST_SOLVE_LAKE 4 /* solve_lake() */
+#define N_SOLVERS     5
+
+typedef struct {
+  long   Ncalls;    /* number of calls */
+  long   Niter;     /* iterations of these calls */
+  long   Nexpand;   /* bracket expansions */
+  long   Nfallback; /* failures handled by a fallback */
+  double seconds;   /* wall time spent in these calls */
+} solver_stats_struct;
+
+typedef struct {
+  int    gridcel;   /* cell being run */
+  int    year;      /* month being accumulated */
+  int    month;
+  solver_stats_struct solver[N_SOLVERS]; /* calls made in this month */
+  char  *rows;      /* rows of the cell's earlier months */
+  size_t length;    /* length of rows */
+  size_t Nalloc;    /* allocated length of rows */
+} solver_telemetry_struct;
+
+/********************************************************
+  Wall time spent in the phases of running grid cells
+  (PHASE_PROFILE); see phase_profile.c.  Phases listed
+  after a phase and marked with its name are part of it.
+  ********************************************************/
+#define PH_READ_SOILPARAM  0  /* read_soilparam() */
+#define PH_READ_VEGPARAM   1  /* read_vegparam() */
+#define PH_INIT_ATMOS      2  /* initialize_atmos() */
+#define PH_FORCING_READ    3  /*   read_forcing_data() (initialize_atmos) */
+#define PH_MTCLIM          4  /*   mtclim_wrapper() (initialize_atmos) */
+#define PH_INIT_STATE      5  /* initialize_model_state() */
+#define PH_FULL_ENERGY     6  /* full_energy() */
+#define PH_SURFACE_FLUXES  7  /*   surface_fluxes() (full_energy) */
+#define PH_SOLVE_SNOW      8  /*     solve_snow() (surface_fluxes) */
+#define PH_RUNOFF          9  /*     runoff() (surface_fluxes) */
+#define PH_SOLVE_LAKE     10  /*   solve_lake() (full_energy) */
+#define PH_PUT_DATA       11  /* put_data() */
+#define PH_WRITE_DATA     12  /*   write_data() (put_data, or the output
+                                   writer thread with ASYNC_OUTPUT) */
+#define N_PHASES          13
+
+typedef struct {
+  long   calls[N_PHASES];   /* number of times each phase was run */
+  double seconds[N_PHASES]; /* wall time spent in each phase */
+} phase_profile_struct;
+
+/********************************************************
+  Phases of the allocation counter (vicNl_alloc); see
+  alloc_count.c.
+  ********************************************************/
+#define ALLOC_SETUP     0  /* everything but the time steps */
+#define ALLOC_TIME_STEP 1  /* full_energy() and put_data() */
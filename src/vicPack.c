@@ -0,0 +1,349 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <vicNl.h>
+#include <global.h>
+
+static char vcid[] = "$Id$";
+
+static void pack_usage(char *temp)
+{
+  fprintf(stderr,"Usage: %s -g<global_parameter_file> -o<packed_forcing_file> [-f<forcing_file_number>]\n",temp);
+  fprintf(stderr,"  g: read the soil parameter file name, the forcing file names and\n");
+  fprintf(stderr,"       formats, and GRID_DECIMAL from <global_parameter_file>.\n");
+  fprintf(stderr,"  o: write the forcings of all active grid cells to <packed_forcing_file>.\n");
+  fprintf(stderr,"  f: pack forcing file 1 (FORCING1, the default) or 2 (FORCING2).\n");
+}
+
+static int read_cell_list(char                      *soilname,
+                          forcing_pack_cell_struct **cell)
+/* Find the active cells of the soil parameter file, as read_soilparam()
+   does, and return their number; their gridcel, lat, and lng are
+   stored in *cell. */
+{
+  FILE  *soilparam;
+  char   line[MAXSTRING];
+  int    flag;
+  int    Ncells;
+  int    Nalloc;
+  float  lat;
+  float  lng;
+
+  soilparam = open_file(soilname, "r");
+  *cell = NULL;
+  Ncells = Nalloc = 0;
+  while ( fscanf(soilparam, "%d", &flag) != EOF ) {
+    if ( fgets(line, MAXSTRING, soilparam) == NULL ) break;
+    if ( !flag ) continue;
+    if ( Ncells == Nalloc ) {
+      Nalloc = Nalloc ? 2*Nalloc : 1024;
+      *cell = (forcing_pack_cell_struct *)realloc(*cell, Nalloc*sizeof(forcing_pack_cell_struct));
+      if ( *cell == NULL )
+        nrerror("Memory allocation error in vicPack.");
+    }
+    if ( sscanf(line, "%d %f %f", &(*cell)[Ncells].gridcel, &lat, &lng) != 3 )
+      nrerror("Unable to read the grid cell number, latitude, and longitude from the soil parameter file.");
+    (*cell)[Ncells].lat = lat;
+    (*cell)[Ncells].lng = lng;
+    Ncells++;
+  }
+  fclose(soilparam);
+
+  return Ncells;
+
+}
+
+static unsigned char *read_rest(FILE   *infile,
+                                size_t *nbytes)
+/* Read infile from its current position to the end. */
+{
+  unsigned char *buf;
+  size_t         size;
+  size_t         n;
+
+  size = 1 << 20;
+  *nbytes = 0;
+  if ( (buf = (unsigned char *)malloc(size + 1)) == NULL )
+    nrerror("Memory allocation error in vicPack.");
+  while ( (n = fread(buf + *nbytes, 1, size - *nbytes, infile)) > 0 ) {
+    *nbytes += n;
+    if ( *nbytes == size ) {
+      size *= 2;
+      if ( (buf = (unsigned char *)realloc(buf, size + 1)) == NULL )
+        nrerror("Memory allocation error in vicPack.");
+    }
+  }
+
+  return buf;
+
+}
+
+static size_t encode_ascii(char           *filename,
+                           unsigned char  *text,
+                           size_t          nbytes,
+                           int             line,
+                           int             file_num,
+                           unsigned char **records)
+/* Parse the ASCII forcing file text, which starts on line line of the
+   file, and encode its records as in a binary forcing file, with the
+   SIGNED/UNSIGNED and multiplier of each FORCE_TYPE and the byte order
+   FORCE_ENDIAN; return the number of bytes of records. */
+{
+  extern THREAD_LOCAL param_set_struct param_set;
+
+  double         **forcing_data;
+  double        ***veg_hist_data;
+  double           value;
+  double           scaled_value;
+  double           lower;
+  double           upper;
+  char             ErrStr[MAXSTRING];
+  unsigned char   *dst;
+  unsigned short   scaled;
+  size_t           recsize;
+  int              Nrecs;
+  int              rec;
+  int              i, j;
+  int              type;
+  int              col;
+  force_type_struct *force_type;
+
+  /* one record per line at most */
+  Nrecs = 1;
+  for ( dst = text; dst < text + nbytes; dst++ )
+    if ( *dst == '\n' ) Nrecs++;
+
+  forcing_data = (double **)calloc(N_FORCING_TYPES, sizeof(double *));
+  veg_hist_data = (double ***)calloc(N_FORCING_TYPES, sizeof(double **));
+  if ( forcing_data == NULL || veg_hist_data == NULL )
+    nrerror("Memory allocation error in vicPack.");
+  for ( i = 0; i < param_set.N_TYPES[file_num]; i++ ) {
+    type = param_set.FORCE_INDEX[file_num][i];
+    if ( type != ALBEDO && type != LAI_IN && type != VEGCOVER )
+      forcing_data[type] = (double *)calloc(Nrecs, sizeof(double));
+    else {
+      veg_hist_data[type] = (double **)calloc(param_set.TYPE[type].N_ELEM, sizeof(double *));
+      for ( j = 0; j < param_set.TYPE[type].N_ELEM; j++ )
+        veg_hist_data[type][j] = (double *)calloc(Nrecs, sizeof(double));
+    }
+  }
+
+  Nrecs = parse_ascii_forcing((char *)text, (char *)text + nbytes, line, file_num,
+                              Nrecs, forcing_data, veg_hist_data);
+
+  recsize = binary_forcing_rec_size(file_num);
+  if ( (*records = (unsigned char *)malloc((size_t)Nrecs * recsize + 1)) == NULL )
+    nrerror("Memory allocation error in vicPack.");
+  for ( rec = 0; rec < Nrecs; rec++ ) {
+    dst = *records + (size_t)rec * recsize;
+    col = 0;
+    for ( i = 0; i < param_set.N_TYPES[file_num]; i++ ) {
+      type = param_set.FORCE_INDEX[file_num][i];
+      force_type = &param_set.TYPE[type];
+      lower = force_type->SIGNED ? -32768 : 0;
+      upper = force_type->SIGNED ? 32767 : 65535;
+      for ( j = 0; j < force_type->N_ELEM; j++, col++, dst += 2 ) {
+        if ( type != ALBEDO && type != LAI_IN && type != VEGCOVER )
+          value = forcing_data[type][rec];
+        else
+          value = veg_hist_data[type][j][rec];
+        scaled_value = floor(value * force_type->multiplier + 0.5);
+        if ( !(scaled_value >= lower && scaled_value <= upper) ) {
+          snprintf(ErrStr, sizeof(ErrStr), "%s, record %d, column %d: %g does not fit in a%s short with multiplier %g; check the FORCE_TYPE lines of the global parameter file.",
+                   filename, rec+1, col+1, value,
+                   force_type->SIGNED ? " signed" : "n unsigned",
+                   force_type->multiplier);
+          nrerror(ErrStr);
+        }
+        scaled = (unsigned short)(int)scaled_value;
+        if ( param_set.FORCE_ENDIAN[file_num] == BIG ) {
+          dst[0] = (unsigned char)(scaled >> 8);
+          dst[1] = (unsigned char)(scaled & 0xFF);
+        }
+        else {
+          dst[0] = (unsigned char)(scaled & 0xFF);
+          dst[1] = (unsigned char)(scaled >> 8);
+        }
+      }
+    }
+  }
+
+  for ( i = 0; i < N_FORCING_TYPES; i++ ) {
+    free((char *)forcing_data[i]);
+    if ( veg_hist_data[i] != NULL ) {
+      for ( j = 0; j < param_set.TYPE[i].N_ELEM; j++ )
+        free((char *)veg_hist_data[i][j]);
+      free((char *)veg_hist_data[i]);
+    }
+  }
+  free((char *)forcing_data);
+  free((char *)veg_hist_data);
+
+  return (size_t)Nrecs * recsize;
+
+}
+
+/** Main Program **/
+
+int main(int argc, char *argv[])
+/**********************************************************************
+	vicPack.c		October 2026
+
+  Converts the per-cell forcing files of a simulation into a packed
+  forcing file (see forcing_pack.c), which holds the forcings of all
+  active cells of the soil parameter file in one file.
+
+  The simulation is described by its global parameter file: the soil
+  parameter file lists the cells, and FORCING1 (or FORCING2), N_TYPES,
+  FORCE_TYPE, FORCE_FORMAT, FORCE_ENDIAN, and GRID_DECIMAL name and
+  describe the per-cell forcing files, as for a run of vicNl.  The
+  records of binary files are copied as they are, without the file
+  header.  ASCII files are encoded as scaled shorts in the byte order
+  FORCE_ENDIAN, using the SIGNED/UNSIGNED flag and multiplier given on
+  each FORCE_TYPE line, which must then be present.
+
+  To run the model from the packed file, set FORCING1 (or FORCING2) to
+  its name and FORCE_FORMAT to PACKED, and (for files converted from
+  ASCII) keep the SIGNED/UNSIGNED flags and multipliers.
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL param_set_struct param_set;
+  extern THREAD_LOCAL global_param_struct global_param;
+  extern char *optarg;
+
+  char                      ErrStr[MAXSTRING];
+  char                      packname[MAXSTRING];
+  char                      forcename[MAXSTRING];
+  int                       optchar;
+  int                       file_num;
+  int                       Ncells;
+  int                       line;
+  int                       i;
+  long                      start;
+  size_t                    nbytes;
+  size_t                    header;
+  size_t                    recsize;
+  size_t                    offset;
+  unsigned char            *data;
+  unsigned char            *records;
+  unsigned char            *p;
+  filenames_struct          filenames;
+  filep_struct              filep;
+  forcing_pack_cell_struct *cell;
+  FILE                     *infile;
+  FILE                     *packfile;
+
+  /** Read command line **/
+  strcpy(filenames.global, "MISSING");
+  strcpy(packname, "MISSING");
+  file_num = 0;
+  while ( (optchar = getopt(argc, argv, "g:o:f:")) != EOF ) {
+    switch ( (char)optchar ) {
+    case 'g':
+      strcpy(filenames.global, optarg);
+      break;
+    case 'o':
+      strcpy(packname, optarg);
+      break;
+    case 'f':
+      file_num = atoi(optarg) - 1;
+      if ( file_num != 0 && file_num != 1 ) {
+        pack_usage(argv[0]);
+        exit(1);
+      }
+      break;
+    default:
+      pack_usage(argv[0]);
+      exit(1);
+    }
+  }
+  if ( strcmp(filenames.global, "MISSING") == 0 || strcmp(packname, "MISSING") == 0 ) {
+    pack_usage(argv[0]);
+    exit(1);
+  }
+
+  /** Read Global Control File **/
+  initialize_global();
+  filep.globalparam = open_file(filenames.global, "r");
+  global_param = get_global_param(&filenames, filep.globalparam);
+  fclose(filep.globalparam);
+
+  if ( file_num == 1 && strcasecmp(filenames.f_path_pfx[1], "MISSING") == 0 )
+    nrerror("The global parameter file does not define FORCING2.");
+  if ( param_set.FORCE_FORMAT[file_num] == PACKED ) {
+    snprintf(ErrStr, sizeof(ErrStr), "Forcing file %d is already packed (FORCE_FORMAT PACKED); set FORCE_FORMAT to the format of the per-cell files.", file_num+1);
+    nrerror(ErrStr);
+  }
+  recsize = binary_forcing_rec_size(file_num);
+
+  /** Find the cells to pack **/
+  Ncells = read_cell_list(filenames.soil, &cell);
+  if ( Ncells == 0 )
+    nrerror("No active grid cells in the soil parameter file.");
+
+  /** Write each cell's records after room for the header and index **/
+  if ( (packfile = fopen(packname, "wb")) == NULL ) {
+    snprintf(ErrStr, sizeof(ErrStr), "Unable to open %.1000s for writing.", packname);
+    nrerror(ErrStr);
+  }
+  offset = forcing_pack_data_start(Ncells);
+  fseek(packfile, (long)offset, SEEK_SET);
+
+  for ( i = 0; i < Ncells; i++ ) {
+    if (snprintf(forcename, sizeof(forcename), "%s%.*f_%.*f",
+                 filenames.f_path_pfx[file_num],
+                 options.GRID_DECIMAL, cell[i].lat,
+                 options.GRID_DECIMAL, cell[i].lng) >= (int)sizeof(forcename))
+      nrerror("Forcing file name too long.");
+    if ( param_set.FORCE_FORMAT[file_num] == BINARY ) {
+      infile = open_file(forcename, "rb");
+      data = read_rest(infile, &nbytes);
+      header = binary_forcing_header_size(data, nbytes, file_num);
+      if ( header > nbytes ) header = nbytes;
+      records = data + header;
+      nbytes = (nbytes - header) / recsize * recsize;
+    }
+    else {
+      /* open_file() skips the header lines of ASCII files */
+      infile = open_file(forcename, "r");
+      start = ftell(infile);
+      rewind(infile);
+      data = read_rest(infile, &nbytes);
+      if ( start < 0 || (size_t)start > nbytes ) start = 0;
+      for ( line = 1, p = data; p < data + start; p++ )
+        if ( *p == '\n' ) line++;
+      nbytes = encode_ascii(forcename, data + start, nbytes - start, line,
+                            file_num, &records);
+      free((char *)data);
+      data = records;
+    }
+    fclose(infile);
+
+    if ( nbytes > 0 && fwrite(records, 1, nbytes, packfile) != nbytes ) {
+      snprintf(ErrStr, sizeof(ErrStr), "Unable to write to %.1000s.", packname);
+      nrerror(ErrStr);
+    }
+    free((char *)data);
+    cell[i].offset = offset;
+    cell[i].length = nbytes;
+    offset += nbytes;
+  }
+
+  /** Write the header and index **/
+  rewind(packfile);
+  write_forcing_pack_index(packfile, file_num, Ncells, cell);
+  if ( fclose(packfile) != 0 ) {
+    snprintf(ErrStr, sizeof(ErrStr), "Unable to write to %.1000s.", packname);
+    nrerror(ErrStr);
+  }
+  fprintf(stderr, "Packed forcing file %d of %d grid cells into %s (%lu bytes).\n",
+          file_num+1, Ncells, packname, (unsigned long)offset);
+
+  free((char *)cell);
+
+  return EXIT_SUCCESS;
+
+}
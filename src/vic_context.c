@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <vicNl.h>
+
+static char vcid[] = "$Id$";
+
+void save_vic_context(vic_context_struct *ctx,
+                      int                 Nveg_type)
+/**********************************************************************
+  save_vic_context				October 2026
+
+  This routine stores the calling thread's model configuration (the
+  globals options, global_param, param_set, veg_lib, NR, and NF) in
+  ctx.  It is called once the global parameter file and the veg
+  library have been read.
+
+  Modifications:
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL global_param_struct global_param;
+  extern THREAD_LOCAL param_set_struct param_set;
+  extern THREAD_LOCAL veg_lib_struct *veg_lib;
+  extern THREAD_LOCAL int NR, NF;
+
+  ctx->options      = options;
+  ctx->global_param = global_param;
+  ctx->param_set    = param_set;
+  ctx->veg_lib      = veg_lib;
+  ctx->Nveg_type    = Nveg_type;
+  ctx->NR           = NR;
+  ctx->NF           = NF;
+
+}
+
+void bind_vic_context(vic_context_struct *ctx)
+/**********************************************************************
+  bind_vic_context				October 2026
+
+  This routine installs the model configuration stored in ctx in the
+  calling thread's copies of the model globals.  All model routines
+  called afterwards by this thread use this configuration, so that
+  threads bound to different contexts can simulate different model
+  configurations at the same time.
+
+  Modifications:
+**********************************************************************/
+{
+  extern THREAD_LOCAL option_struct options;
+  extern THREAD_LOCAL global_param_struct global_param;
+  extern THREAD_LOCAL param_set_struct param_set;
+  extern THREAD_LOCAL veg_lib_struct *veg_lib;
+  extern THREAD_LOCAL int NR, NF;
+
+  options      = ctx->options;
+  global_param = ctx->global_param;
+  param_set    = ctx->param_set;
+  veg_lib      = ctx->veg_lib;
+  NR           = ctx->NR;
+  NF           = ctx->NF;
+
+}
@@ -18,10 +18,14 @@ void vicerror(char error_text[])
               out_data and out_data_files structures.xi			TJB
   2006-Oct-16 Merged infiles and outfiles structs into filep_struct.	TJB
   2012-Jan-16 Removed LINK_DEBUG code					BN
+  2026-Oct-18 Write any output records still queued to the output
+	      writer (ASYNC_OUTPUT) before closing the output files.
+  2026-Oct-18 Do not drain the output writer if the error occurred on
+	      the writer thread itself, which would wait for itself.
 **********************************************************************/
 {
-        extern option_struct options;
-	extern Error_struct Error;
+        extern THREAD_LOCAL option_struct options;
+	extern THREAD_LOCAL Error_struct Error;
         filenames_struct fnames;
 	void _exit();
 
@@ -30,6 +34,9 @@ void vicerror(char error_text[])
 	fprintf(stderr,"VIC model run-time error...\n");
 	fprintf(stderr,"%s\n",error_text);
 	fprintf(stderr,"...now writing output files...\n");
+	if (Error.output_writer != NULL
+	    && !on_output_writer(Error.output_writer))
+	  finish_output_writer(&(Error.output_writer));
         close_files(&(Error.filep), Error.out_data_files, &fnames);
 	fprintf(stderr,"...now exiting to system...\n");
         fflush(stdout);
@@ -1,9 +1,90 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <vicNl.h>
 
 static char vcid[] = "$Id$";
 
+static void alloc_record_buffer(out_data_file_struct *outf,
+                                out_data_struct      *out_data)
+/* Size an output file's record buffer from the variables in the file:
+   exactly one record for binary output, or an estimate of one record
+   for ASCII output (grown by the append functions if needed). */
+{
+  extern THREAD_LOCAL option_struct options;
+  int    var_idx;
+  int    Nelem;
+  size_t size;
+
+  size = 4*sizeof(int);
+  Nelem = 0;
+  for (var_idx = 0; var_idx < outf->nvars; var_idx++) {
+    Nelem += out_data[outf->varid[var_idx]].nelem;
+    if (out_data[outf->varid[var_idx]].type == OUT_TYPE_CHAR)
+      size += out_data[outf->varid[var_idx]].nelem * sizeof(char);
+    else if (out_data[outf->varid[var_idx]].type == OUT_TYPE_SINT)
+      size += out_data[outf->varid[var_idx]].nelem * sizeof(short int);
+    else if (out_data[outf->varid[var_idx]].type == OUT_TYPE_USINT)
+      size += out_data[outf->varid[var_idx]].nelem * sizeof(unsigned short int);
+    else if (out_data[outf->varid[var_idx]].type == OUT_TYPE_INT)
+      size += out_data[outf->varid[var_idx]].nelem * sizeof(int);
+    else if (out_data[outf->varid[var_idx]].type == OUT_TYPE_FLOAT)
+      size += out_data[outf->varid[var_idx]].nelem * sizeof(float);
+    else if (out_data[outf->varid[var_idx]].type == OUT_TYPE_DOUBLE)
+      size += out_data[outf->varid[var_idx]].nelem * sizeof(double);
+  }
+  if (!options.BINARY_OUTPUT)
+    size = 32 + 24*(size_t)Nelem;
+
+  outf->buf = (char *)malloc(size);
+  if (outf->buf == NULL)
+    nrerror("Memory allocation error in write_data().");
+  outf->bufsize = size;
+
+}
+
+static void grow_record_buffer(out_data_file_struct *outf,
+                               size_t                size)
+{
+  outf->bufsize = 2*size;
+  outf->buf = (char *)realloc(outf->buf, outf->bufsize);
+  if (outf->buf == NULL)
+    nrerror("Memory allocation error in write_data().");
+}
+
+static size_t append_record_value(out_data_file_struct *outf,
+                                  size_t                len,
+                                  char                 *format,
+                                  double                value)
+/* Append one formatted value to the ASCII record in outf's buffer,
+   which holds len characters, and return the new length. */
+{
+  int n;
+
+  n = snprintf(outf->buf + len, outf->bufsize - len, format, value);
+  if (len + n >= outf->bufsize) {
+    grow_record_buffer(outf, len + n + 1);
+    n = snprintf(outf->buf + len, outf->bufsize - len, format, value);
+  }
+
+  return len + n;
+
+}
+
+static size_t append_record_chars(out_data_file_struct *outf,
+                                  size_t                len,
+                                  char                 *chars,
+                                  size_t                n)
+/* Append n characters to the ASCII record in outf's buffer. */
+{
+  if (len + n >= outf->bufsize)
+    grow_record_buffer(outf, len + n + 1);
+  memcpy(outf->buf + len, chars, n);
+
+  return len + n;
+
+}
+
 void write_data(out_data_file_struct *out_data_files,
 		out_data_struct *out_data,
 		dmy_struct      *dmy,
@@ -78,19 +159,31 @@ void write_data(out_data_file_struct *out_data_files,
 	      aggregation of output variables.				TJB
   2012-Jan-16 Removed LINK_DEBUG code					BN
   2013-Dec-27 Moved OUTPUT_FORCE to options_struct.			TJB
+  2026-Oct-18 Each output record is now assembled in a buffer that
+	      belongs to its output file (allocated on the first record)
+	      and written with a single fwrite(), instead of allocating
+	      six scratch arrays per record and writing each variable
+	      separately.
+  2026-Oct-18 Timed by the phase profiler (PHASE_PROFILE).
 **********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
+  double              phase;
   int                 file_idx;
   int                 var_idx;
   int                 elem_idx;
-  int                 ptr_idx;
-  char               *tmp_cptr;
-  short int          *tmp_siptr;
-  unsigned short int *tmp_usiptr;
-  int                *tmp_iptr;
-  float              *tmp_fptr;
-  double             *tmp_dptr;
+  int                 date[4];
+  int                 Ndate;
+  size_t              len;
+  out_data_file_struct *outf;
+  out_data_struct    *var;
+  char               *ptr;
+  char                tmp_c;
+  short int           tmp_si;
+  unsigned short int  tmp_usi;
+  int                 tmp_i;
+  float               tmp_f;
+  double              tmp_d;
 
   /***************************************************************
     Write output files using default VIC ASCII or BINARY formats
@@ -100,129 +193,116 @@ void write_data(out_data_file_struct *out_data_files,
       www.hydro.washington.edu/Lettenmaier/Models/VIC/VIChome.html
   ***************************************************************/
 
-  if(options.BINARY_OUTPUT) {  // BINARY
-
-    // Initialize pointers
-    tmp_cptr = (char *)calloc(N_OUTVAR_TYPES*options.Nlayer*options.SNOW_BAND,sizeof(char));
-    tmp_siptr = (short int *)calloc(N_OUTVAR_TYPES*options.Nlayer*options.SNOW_BAND,sizeof(short int));
-    tmp_usiptr = (unsigned short int *)calloc(N_OUTVAR_TYPES*options.Nlayer*options.SNOW_BAND,sizeof(unsigned short int));
-    tmp_iptr = (int *)calloc(N_OUTVAR_TYPES*options.Nlayer*options.SNOW_BAND,sizeof(int));
-    tmp_fptr = (float *)calloc(N_OUTVAR_TYPES*options.Nlayer*options.SNOW_BAND,sizeof(float));
-    tmp_dptr = (double *)calloc(N_OUTVAR_TYPES*options.Nlayer*options.SNOW_BAND,sizeof(double));
+  phase = phase_start();
 
-    // Time
-    tmp_iptr[0] = dmy->year;
-    tmp_iptr[1] = dmy->month;
-    tmp_iptr[2] = dmy->day;
-    tmp_iptr[3] = dmy->hour;
+  // Time (forcing output records have no date, and dmy is NULL)
+  if (options.OUTPUT_FORCE)
+    Ndate = 0;
+  else {
+    date[0] = dmy->year;
+    date[1] = dmy->month;
+    date[2] = dmy->day;
+    date[3] = dmy->hour;
+    if (dt < 24)
+      Ndate = 4;  // year, month, day, and hour
+    else
+      Ndate = 3;  // only year, month, and day
+  }
 
-    // Loop over output files
-    for (file_idx = 0; file_idx < options.Noutfiles; file_idx++) {
+  // Loop over output files
+  for (file_idx = 0; file_idx < options.Noutfiles; file_idx++) {
 
-      if (!options.OUTPUT_FORCE) {
+    outf = &out_data_files[file_idx];
+    if (outf->buf == NULL)
+      alloc_record_buffer(outf, out_data);
 
-        // Write the date
-        if (dt < 24) {
-          // Write year, month, day, and hour
-          fwrite(tmp_iptr, sizeof(int), 4, out_data_files[file_idx].fh);
-        }
-        else {
-          // Only write year, month, and day
-          fwrite(tmp_iptr, sizeof(int), 3, out_data_files[file_idx].fh);
-        }
+    if(options.BINARY_OUTPUT) {  // BINARY
 
-      }
+      // Write the date
+      ptr = outf->buf;
+      memcpy(ptr, date, Ndate*sizeof(int));
+      ptr += Ndate*sizeof(int);
 
       // Loop over this output file's data variables
-      for (var_idx = 0; var_idx < out_data_files[file_idx].nvars; var_idx++) {
+      for (var_idx = 0; var_idx < outf->nvars; var_idx++) {
+        var = &out_data[outf->varid[var_idx]];
         // Loop over this variable's elements
-        ptr_idx = 0;
-        if (out_data[out_data_files[file_idx].varid[var_idx]].type == OUT_TYPE_CHAR) {
-          for (elem_idx = 0; elem_idx < out_data[out_data_files[file_idx].varid[var_idx]].nelem; elem_idx++) {
-            tmp_cptr[ptr_idx++] = (char)out_data[out_data_files[file_idx].varid[var_idx]].aggdata[elem_idx];
+        if (var->type == OUT_TYPE_CHAR) {
+          for (elem_idx = 0; elem_idx < var->nelem; elem_idx++) {
+            tmp_c = (char)var->aggdata[elem_idx];
+            memcpy(ptr, &tmp_c, sizeof(char));
+            ptr += sizeof(char);
           }
-          fwrite(tmp_cptr, sizeof(char), ptr_idx, out_data_files[file_idx].fh);
         }
-        else if (out_data[out_data_files[file_idx].varid[var_idx]].type == OUT_TYPE_SINT) {
-          for (elem_idx = 0; elem_idx < out_data[out_data_files[file_idx].varid[var_idx]].nelem; elem_idx++) {
-            tmp_siptr[ptr_idx++] = (short int)out_data[out_data_files[file_idx].varid[var_idx]].aggdata[elem_idx];
+        else if (var->type == OUT_TYPE_SINT) {
+          for (elem_idx = 0; elem_idx < var->nelem; elem_idx++) {
+            tmp_si = (short int)var->aggdata[elem_idx];
+            memcpy(ptr, &tmp_si, sizeof(short int));
+            ptr += sizeof(short int);
           }
-          fwrite(tmp_siptr, sizeof(short int), ptr_idx, out_data_files[file_idx].fh);
         }
-        else if (out_data[out_data_files[file_idx].varid[var_idx]].type == OUT_TYPE_USINT) {
-          for (elem_idx = 0; elem_idx < out_data[out_data_files[file_idx].varid[var_idx]].nelem; elem_idx++) {
-            tmp_usiptr[ptr_idx++] = (unsigned short int)out_data[out_data_files[file_idx].varid[var_idx]].aggdata[elem_idx];
+        else if (var->type == OUT_TYPE_USINT) {
+          for (elem_idx = 0; elem_idx < var->nelem; elem_idx++) {
+            tmp_usi = (unsigned short int)var->aggdata[elem_idx];
+            memcpy(ptr, &tmp_usi, sizeof(unsigned short int));
+            ptr += sizeof(unsigned short int);
           }
-          fwrite(tmp_usiptr, sizeof(unsigned short int), ptr_idx, out_data_files[file_idx].fh);
         }
-        else if (out_data[out_data_files[file_idx].varid[var_idx]].type == OUT_TYPE_INT) {
-          for (elem_idx = 0; elem_idx < out_data[out_data_files[file_idx].varid[var_idx]].nelem; elem_idx++) {
-            tmp_iptr[ptr_idx++] = (int)out_data[out_data_files[file_idx].varid[var_idx]].aggdata[elem_idx];
+        else if (var->type == OUT_TYPE_INT) {
+          for (elem_idx = 0; elem_idx < var->nelem; elem_idx++) {
+            tmp_i = (int)var->aggdata[elem_idx];
+            memcpy(ptr, &tmp_i, sizeof(int));
+            ptr += sizeof(int);
           }
-          fwrite(tmp_iptr, sizeof(int), ptr_idx, out_data_files[file_idx].fh);
         }
-        else if (out_data[out_data_files[file_idx].varid[var_idx]].type == OUT_TYPE_FLOAT) {
-          for (elem_idx = 0; elem_idx < out_data[out_data_files[file_idx].varid[var_idx]].nelem; elem_idx++) {
-            tmp_fptr[ptr_idx++] = (float)out_data[out_data_files[file_idx].varid[var_idx]].aggdata[elem_idx];
+        else if (var->type == OUT_TYPE_FLOAT) {
+          for (elem_idx = 0; elem_idx < var->nelem; elem_idx++) {
+            tmp_f = (float)var->aggdata[elem_idx];
+            memcpy(ptr, &tmp_f, sizeof(float));
+            ptr += sizeof(float);
           }
-          fwrite(tmp_fptr, sizeof(float), ptr_idx, out_data_files[file_idx].fh);
         }
-        else if (out_data[out_data_files[file_idx].varid[var_idx]].type == OUT_TYPE_DOUBLE) {
-          for (elem_idx = 0; elem_idx < out_data[out_data_files[file_idx].varid[var_idx]].nelem; elem_idx++) {
-            tmp_dptr[ptr_idx++] = (double)out_data[out_data_files[file_idx].varid[var_idx]].aggdata[elem_idx];
+        else if (var->type == OUT_TYPE_DOUBLE) {
+          for (elem_idx = 0; elem_idx < var->nelem; elem_idx++) {
+            tmp_d = (double)var->aggdata[elem_idx];
+            memcpy(ptr, &tmp_d, sizeof(double));
+            ptr += sizeof(double);
           }
-          fwrite(tmp_dptr, sizeof(double), ptr_idx, out_data_files[file_idx].fh);
         }
       }
+      len = ptr - outf->buf;
 
     }
 
-    // Free the arrays
-    free((char *)tmp_cptr);
-    free((char *)tmp_siptr);
-    free((char *)tmp_usiptr);
-    free((char *)tmp_iptr);
-    free((char *)tmp_fptr);
-    free((char *)tmp_dptr);
-
-  }
-
-  else {  // ASCII
+    else {  // ASCII
 
-    // Loop over output files
-    for (file_idx = 0; file_idx < options.Noutfiles; file_idx++) {
-
-      if (!options.OUTPUT_FORCE) {
-
-        // Write the date
-        if (dt < 24) {
-          // Write year, month, day, and hour
-          fprintf(out_data_files[file_idx].fh, "%04i\t%02i\t%02i\t%02i\t",
-                  dmy->year, dmy->month, dmy->day, dmy->hour);
-        }
-        else {
-          // Only write year, month, and day
-          fprintf(out_data_files[file_idx].fh, "%04i\t%02i\t%02i\t",
-                  dmy->year, dmy->month, dmy->day);
-        }
-
-      }
+      // Write the date
+      len = 0;
+      if (Ndate == 4)
+        len = sprintf(outf->buf, "%04i\t%02i\t%02i\t%02i\t",
+                      date[0], date[1], date[2], date[3]);
+      else if (Ndate == 3)
+        len = sprintf(outf->buf, "%04i\t%02i\t%02i\t",
+                      date[0], date[1], date[2]);
 
       // Loop over this output file's data variables
-      for (var_idx = 0; var_idx < out_data_files[file_idx].nvars; var_idx++) {
+      for (var_idx = 0; var_idx < outf->nvars; var_idx++) {
+        var = &out_data[outf->varid[var_idx]];
         // Loop over this variable's elements
-        for (elem_idx = 0; elem_idx < out_data[out_data_files[file_idx].varid[var_idx]].nelem; elem_idx++) {
-          if (!(var_idx == 0 && elem_idx == 0)) {
-            fprintf(out_data_files[file_idx].fh, "\t ");
-          }
-          fprintf(out_data_files[file_idx].fh, out_data[out_data_files[file_idx].varid[var_idx]].format, out_data[out_data_files[file_idx].varid[var_idx]].aggdata[elem_idx]);
+        for (elem_idx = 0; elem_idx < var->nelem; elem_idx++) {
+          if (!(var_idx == 0 && elem_idx == 0))
+            len = append_record_chars(outf, len, "\t ", 2);
+          len = append_record_value(outf, len, var->format, var->aggdata[elem_idx]);
         }
       }
-      fprintf(out_data_files[file_idx].fh, "\n");
+      len = append_record_chars(outf, len, "\n", 1);
 
     }
 
+    fwrite(outf->buf, 1, len, outf->fh);
+
   }
 
-}
+  phase_end(PH_WRITE_DATA, phase);
 
+}
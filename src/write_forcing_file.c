@@ -31,8 +31,8 @@ void write_forcing_file(atmos_data_struct *atmos,
   2014-Apr-02 Fixed uninitialized dummy variables.					TJB
 **********************************************************************/
 {
-  extern global_param_struct global_param;
-  extern option_struct options;
+  extern THREAD_LOCAL global_param_struct global_param;
+  extern THREAD_LOCAL option_struct options;
 
   int                 rec, i, j, v;
   short int          *tmp_siptr;
@@ -22,7 +22,7 @@ void write_header(out_data_file_struct *out_data_files,
 
 **********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
   int                 file_idx;
   int                 var_idx;
   int                 elem_idx;
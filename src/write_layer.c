@@ -22,7 +22,7 @@ void write_layer(layer_data_struct *layer,
   2013-Dec-27 Moved SPATIAL_FROST to options_struct.			TJB
 **********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   int index;
   double layer_moist;
@@ -10,6 +10,7 @@ void write_model_state(all_vars_struct    *all_vars,
 		       global_param_struct *gp,
 		       int                  Nveg,
 		       int                  cellnum,
+		       int                  snapshot,
 		       filep_struct        *filep,
 		       soil_con_struct     *soil_con,
 		       lake_con_struct      lake_con)
@@ -77,9 +78,12 @@ void write_model_state(all_vars_struct    *all_vars,
   2013-Dec-26 Removed EXCESS_ICE option.				TJB
   2013-Dec-27 Moved SPATIAL_FROST to options_struct.			TJB
   2014-Mar-28 Removed DIST_PRCP option.					TJB
+  2026-Oct-18 Added snapshot.  In a multi-snapshot state file
+	      (STATE_SCHEDULE), each cell record is preceded by the number
+	      of its snapshot.
 *********************************************************************/
 {
-  extern option_struct options;
+  extern THREAD_LOCAL option_struct options;
 
   double tmpval;
   int    veg;
@@ -106,6 +110,8 @@ void write_model_state(all_vars_struct    *all_vars,
   lake_var = all_vars->lake_var;
  
   /* write cell information */
+  if ( options.STATE_SCHEDULE )
+    fwrite( &snapshot, sizeof(int), 1, filep->statefile );
   if ( options.BINARY_STATE_FILE ) {
     fwrite( &cellnum, sizeof(int), 1, filep->statefile );
     fwrite( &Nveg, sizeof(int), 1, filep->statefile );
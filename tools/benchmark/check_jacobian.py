@@ -0,0 +1,111 @@
+#!/usr/bin/env python
+"""
+check_jacobian.py - checks the analytic Jacobian of the implicit soil
+temperature solver against the finite-difference one.
+
+Runs vicNl on the frozen_soil configuration of the synthetic domain in
+<domain> (generated first by make_bench_domain.py if needed) with
+IMPLICIT_JACOBIAN CHECK, under which every implicit soil temperature
+profile is solved with both Jacobians from the same start, and reads
+the comparison printed at the end of the run.  The check is run for
+each of the grid variants below.  It fails (exit status 1) if, in any
+variant, the largest difference between two profiles that converged
+with both Jacobians exceeds TOL, or if no profile was compared.
+
+Variants:
+  default      the frozen_soil configuration (EXP_TRANS TRUE)
+  linear       EXP_TRANS FALSE
+  noflux       NOFLUX TRUE
+
+Options:
+  -n NCELLS  cells of a generated domain (default 10)
+  -y YEARS   years of a generated domain (default 2)
+  -t TOL     largest accepted difference, C (default 0.001)
+  -o LINE    global parameter file line added to every variant; may be
+             given more than once
+
+usage: check_jacobian.py [options] <vicNl> <domain>
+"""
+
+import getopt
+import os
+import re
+import subprocess
+import sys
+
+import run_bench
+
+VARIANTS = [('default', []), ('linear', ['EXP_TRANS FALSE']),
+            ('noflux', ['NOFLUX TRUE'])]
+
+
+def read_check(log):
+    """Returns the profiles compared, converged with both Jacobians, and
+    differing by more than the tolerance of vicNl, and the largest
+    difference, printed in log, or None."""
+    with open(log) as f:
+        text = f.read()
+    m = re.search(r'Implicit Jacobian check: (\d+) .*\n'
+                  r'\s*converged with both: (\d+);.*\n'
+                  r'\s*largest difference: ([0-9.eE+-]+) C; '
+                  r'profiles differing by more than [0-9.eE+-]+ C: (\d+)',
+                  text)
+    if m is None:
+        return None
+    return int(m.group(1)), int(m.group(2)), int(m.group(4)), \
+        float(m.group(3))
+
+
+def main(argv):
+    ncells, years, tol = 10, 2, 1e-3
+    extra = []
+    try:
+        opts, args = getopt.getopt(argv, 'n:y:t:o:h')
+    except getopt.GetoptError as e:
+        sys.exit(str(e))
+    for o, a in opts:
+        if o == '-n':
+            ncells = int(a)
+        elif o == '-y':
+            years = int(a)
+        elif o == '-t':
+            tol = float(a)
+        elif o == '-o':
+            extra.append(a)
+        else:
+            sys.exit(__doc__)
+    if len(args) != 2:
+        sys.exit(__doc__)
+    vicnl = os.path.abspath(args[0])
+    root = os.path.abspath(args[1])
+
+    if not os.path.exists(os.path.join(root, 'domain.info')):
+        make = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                            'make_bench_domain.py')
+        status = subprocess.call([sys.executable, make, '-n', str(ncells),
+                                  '-y', str(years), root])
+        if status != 0:
+            sys.exit('make_bench_domain.py failed')
+
+    print('Implicit Jacobian check: %s, tolerance %g C' % (vicnl, tol))
+    print('%-10s %10s %10s %10s %14s' % ('variant', 'profiles', 'converged',
+                                         'over tol', 'max diff (C)'))
+    failed = False
+    for name, lines in VARIANTS:
+        seconds, dt, log = run_bench.run_config(
+            vicnl, root, 'frozen_soil',
+            extra + lines + ['IMPLICIT_JACOBIAN CHECK'], 1)
+        counts = read_check(log)
+        if counts is None:
+            sys.exit('%s: no Jacobian check in %s' % (name, log))
+        solves, both, over, maxdiff = counts
+        ok = both > 0 and maxdiff <= tol
+        print('%-10s %10d %10d %10d %14.6f %s'
+              % (name, solves, both, over, maxdiff, 'ok' if ok else 'FAILED'))
+        sys.stdout.flush()
+        failed = failed or not ok
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
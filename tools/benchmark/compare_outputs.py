@@ -0,0 +1,414 @@
+#!/usr/bin/env python
+"""
+compare_outputs.py - checks that two sets of VIC output files agree.
+
+Compares the output files (fluxes, snow, fdepth, ...) of two runs, e.g.
+of the model before and after a performance change, written to the
+directories <dir1> and <dir2> by write_data().  Each file of <dir1> is
+compared with the file of the same name in <dir2> (a gzipped file, with
+suffix .gz, matches the same file uncompressed).  For each variable of
+each file, i.e. of each cell, the maximum absolute and relative
+differences are reported, with the first record in which the values
+differ by more than the tolerance:
+
+  |v2 - v1| > ATOL + RTOL * |v1|
+
+The relative difference is |v2 - v1| / |v1| (where v1 is 0 and v2 is
+not, it is reported as inf).  A summary per variable over all cells
+follows.  The exit status is 0 if all files agree within the tolerance,
+and 1 otherwise.
+
+ASCII files are read as columns of numbers; the variable names are
+taken from the file's header (PRT_HEADER TRUE), or else from the
+global parameter file given with -g, or else the columns are numbered.
+Other files in the directories whose lines have different numbers of
+values (e.g. state files written to the result directory) are compared
+byte by byte.
+Binary files (BINARY_OUTPUT TRUE) are decoded with the type and
+multiplier of each variable, taken from the file's header, or else
+from the global parameter file (-g), which is then required: the
+variables of its OUTFILE and OUTVAR lines, or the default output files
+(set_output_defaults.c) if it has none.  Binary files are assumed to
+have the byte order of this machine.
+
+Options:
+  -a ATOL    absolute tolerance (default 0)
+  -r RTOL    relative tolerance (default 0)
+  -g FILE    global parameter file of the runs
+  -p PREFIX  only compare files whose names start with PREFIX; may be
+             given more than once
+  -v         report all variables, not only those that differ
+
+usage: compare_outputs.py [options] <dir1> <dir2>
+"""
+
+import getopt
+import gzip
+import math
+import os
+import struct
+import sys
+
+# out_data types (OUT_TYPE_ in vicNl_def.h): struct format and size
+OUT_TYPE_INT = 4
+OUT_TYPE_FLOAT = 5
+TYPES = {1: 'b', 2: 'h', 3: 'H', 4: 'i', 5: 'f', 6: 'd'}
+TYPE_NAMES = {'OUT_TYPE_CHAR': 1, 'OUT_TYPE_SINT': 2, 'OUT_TYPE_USINT': 3,
+              'OUT_TYPE_INT': 4, 'OUT_TYPE_FLOAT': 5, 'OUT_TYPE_DOUBLE': 6}
+
+MAX_FRONTS = 3
+
+
+class NotOutputFile(ValueError):
+    """Raised for a file that is not a table of output records."""
+
+# variables with more than one element (see output_list_utils.c), and
+# the option that gives their number of elements
+LAYER_VARS = ['OUT_SMLIQFRAC', 'OUT_SMFROZFRAC', 'OUT_SOIL_ICE',
+              'OUT_SOIL_LIQ', 'OUT_SOIL_MOIST', 'OUT_SOIL_TEMP']
+NODE_VARS = ['OUT_SOIL_TNODE', 'OUT_SOIL_TNODE_WL', 'OUT_SOILT_FBFLAG']
+FRONT_VARS = ['OUT_FDEPTH', 'OUT_TDEPTH']
+
+# the default output files of set_output_defaults.c; each variable is
+# (name, condition), where condition is None or a test of the options
+FE = lambda o: o['FULL_ENERGY'] or o['FROZEN_SOIL']
+DEFAULT_FILES = [
+    ('fluxes', None, [
+        ('OUT_PREC', None), ('OUT_EVAP', None), ('OUT_RUNOFF', None),
+        ('OUT_BASEFLOW', None), ('OUT_WDEW', None), ('OUT_SOIL_LIQ', None),
+        ('OUT_RAD_TEMP', FE), ('OUT_NET_SHORT', None), ('OUT_R_NET', None),
+        ('OUT_LATENT', FE), ('OUT_EVAP_CANOP', None),
+        ('OUT_TRANSP_VEG', None), ('OUT_EVAP_BARE', None),
+        ('OUT_SUB_CANOP', None), ('OUT_SUB_SNOW', None),
+        ('OUT_SENSIBLE', FE), ('OUT_GRND_FLUX', FE), ('OUT_DELTAH', FE),
+        ('OUT_FUSION', FE), ('OUT_AERO_RESIST', None),
+        ('OUT_SURF_TEMP', None), ('OUT_ALBEDO', None),
+        ('OUT_REL_HUMID', None), ('OUT_IN_LONG', None),
+        ('OUT_AIR_TEMP', None), ('OUT_WIND', None)]),
+    ('snow', None, [
+        ('OUT_SWE', None), ('OUT_SNOW_DEPTH', None),
+        ('OUT_SNOW_CANOPY', None), ('OUT_SNOW_COVER', None),
+        ('OUT_ADVECTION', FE), ('OUT_DELTACC', FE), ('OUT_SNOW_FLUX', FE),
+        ('OUT_RFRZ_ENERGY', FE), ('OUT_MELT_ENERGY', FE),
+        ('OUT_ADV_SENS', FE), ('OUT_LATENT_SUB', FE),
+        ('OUT_SNOW_SURF_TEMP', FE), ('OUT_SNOW_PACK_TEMP', FE),
+        ('OUT_SNOW_MELT', FE),
+        ('OUT_SUB_BLOWING', lambda o: o['BLOWING']),
+        ('OUT_SUB_SURFACE', lambda o: o['BLOWING']),
+        ('OUT_SUB_SNOW', lambda o: o['BLOWING'])]),
+    ('fdepth', lambda o: o['FROZEN_SOIL'], [
+        ('OUT_FDEPTH', None), ('OUT_TDEPTH', None), ('OUT_SOIL_MOIST', None),
+        ('OUT_SURF_FROST_FRAC', None)]),
+    ('snowband', lambda o: o['PRT_SNOW_BAND'], [
+        ('OUT_SWE_BAND', None), ('OUT_SNOW_DEPTH_BAND', None),
+        ('OUT_SNOW_CANOPY_BAND', None),
+        ('OUT_ADVECTION_BAND', lambda o: o['FULL_ENERGY']),
+        ('OUT_DELTACC_BAND', lambda o: o['FULL_ENERGY']),
+        ('OUT_SNOW_FLUX_BAND', lambda o: o['FULL_ENERGY']),
+        ('OUT_RFRZ_ENERGY_BAND', lambda o: o['FULL_ENERGY']),
+        ('OUT_NET_SHORT_BAND', None), ('OUT_NET_LONG_BAND', None),
+        ('OUT_ALBEDO_BAND', None), ('OUT_LATENT_BAND', None),
+        ('OUT_SENSIBLE_BAND', None), ('OUT_GRND_FLUX_BAND', None)]),
+    ('lake', lambda o: o['LAKES'], [
+        ('OUT_LAKE_ICE_TEMP', None), ('OUT_LAKE_ICE_HEIGHT', None),
+        ('OUT_LAKE_ICE_FRACT', None), ('OUT_LAKE_DEPTH', None),
+        ('OUT_LAKE_SURF_AREA', None), ('OUT_LAKE_VOLUME', None),
+        ('OUT_LAKE_SURF_TEMP', None), ('OUT_LAKE_EVAP', None)]),
+]
+FORCE_FILE = ('full_data', [
+    ('OUT_PREC', 3, 40), ('OUT_AIR_TEMP', 2, 100), ('OUT_SHORTWAVE', 3, 50),
+    ('OUT_LONGWAVE', 3, 80), ('OUT_DENSITY', 3, 100),
+    ('OUT_PRESSURE', 3, 100), ('OUT_VP', 2, 100), ('OUT_WIND', 3, 100)])
+
+
+def read_global(path):
+    """Returns the output layout of the global parameter file path: a
+    dictionary of file prefix to [(column name, type, mult)]."""
+    opts = {'NLAYER': 3, 'NODES': 3, 'SNOW_BAND': 1, 'TIME_STEP': 24,
+            'OUT_STEP': 0, 'FULL_ENERGY': False, 'FROZEN_SOIL': False,
+            'BLOWING': False, 'PRT_SNOW_BAND': False, 'LAKES': False,
+            'OUTPUT_FORCE': False}
+    outfiles = []
+    with open(path) as f:
+        for line in f:
+            fields = line.split('#')[0].split()
+            if len(fields) < 2:
+                continue
+            key = fields[0].upper()
+            if key in ('NLAYER', 'NODES', 'SNOW_BAND', 'TIME_STEP',
+                       'OUT_STEP'):
+                opts[key] = int(fields[1])
+            elif key in ('FULL_ENERGY', 'FROZEN_SOIL', 'BLOWING',
+                         'PRT_SNOW_BAND', 'OUTPUT_FORCE'):
+                opts[key] = fields[1].upper() == 'TRUE'
+            elif key == 'LAKES':
+                opts[key] = fields[1].upper() != 'FALSE'
+            elif key == 'OUTFILE':
+                outfiles.append((fields[1], []))
+            elif key == 'OUTVAR':
+                # OUTVAR name [format [type [mult]]]
+                vtype, mult = OUT_TYPE_FLOAT, 1.
+                if len(fields) > 3 and fields[3] != '*':
+                    vtype = TYPE_NAMES[fields[3].upper()]
+                if len(fields) > 4 and fields[4] != '*':
+                    mult = float(fields[4])
+                outfiles[-1][1].append((fields[1], vtype, mult))
+
+    out_dt = opts['OUT_STEP'] or opts['TIME_STEP']
+    if opts['OUTPUT_FORCE']:
+        date = []
+        if not outfiles:
+            outfiles = [FORCE_FILE]
+    else:
+        date = ['YEAR', 'MONTH', 'DAY'] + (['HOUR'] if out_dt < 24 else [])
+        if not outfiles:
+            for prefix, cond, variables in DEFAULT_FILES:
+                if cond is None or cond(opts):
+                    outfiles.append((prefix, [
+                        (name, OUT_TYPE_FLOAT, 1.) for name, vcond in variables
+                        if vcond is None or vcond(opts)]))
+
+    layout = {}
+    for prefix, variables in outfiles:
+        columns = [(name, OUT_TYPE_INT, 1.) for name in date]
+        for name, vtype, mult in variables:
+            if name in LAYER_VARS:
+                nelem = opts['NLAYER']
+            elif name in NODE_VARS:
+                nelem = opts['NODES']
+            elif name in FRONT_VARS and opts['FROZEN_SOIL']:
+                nelem = MAX_FRONTS
+            elif name.endswith('_BAND'):
+                nelem = opts['SNOW_BAND']
+            else:
+                nelem = 1
+            if nelem > 1:
+                columns += [('%s_%d' % (name, i), vtype, mult)
+                            for i in range(nelem)]
+            else:
+                columns.append((name, vtype, mult))
+        layout[prefix] = columns
+    return layout
+
+
+def file_layout(name, layout):
+    """Returns the layout of output file name (prefix_lat_lng)."""
+    if layout is None:
+        return None
+    for prefix in sorted(layout, key=len, reverse=True):
+        if name.startswith(prefix + '_'):
+            return layout[prefix]
+    return None
+
+
+def open_file(path):
+    if path.endswith('.gz'):
+        return gzip.open(path, 'rb')
+    return open(path, 'rb')
+
+
+def read_binary(data, columns):
+    """Returns the column names and records of a binary output file."""
+    start = 0
+    if data[:8] == b'\xff' * 8:
+        # header of write_header.c; its Nvars counts variables, not
+        # elements, so the entries are read up to the end of the header
+        nbytes = struct.unpack('=H', data[8:10])[0]
+        pos = 40
+        columns = []
+        while pos < nbytes:
+            length = struct.unpack('=B', data[pos:pos + 1])[0]
+            name = data[pos + 1:pos + 1 + length].decode()
+            vtype, mult = struct.unpack('=bf', data[pos + 1 + length:
+                                                   pos + 6 + length])
+            columns.append((name, vtype, mult))
+            pos += 6 + length
+        start = nbytes
+    elif columns is None:
+        raise ValueError('binary file without header: use -g')
+
+    fmt = '=' + ''.join(TYPES[vtype] for name, vtype, mult in columns)
+    size = struct.calcsize(fmt)
+    if (len(data) - start) % size != 0:
+        raise ValueError('size does not match %d variables'
+                         % len(columns))
+    mults = [mult if mult else 1. for name, vtype, mult in columns]
+    records = []
+    for pos in range(start, len(data), size):
+        values = struct.unpack(fmt, data[pos:pos + size])
+        records.append([v / m for v, m in zip(values, mults)])
+    return [name for name, vtype, mult in columns], records
+
+
+def read_ascii(data, columns):
+    """Returns the column names and records of an ASCII output file."""
+    names = None
+    records = []
+    for line in data.decode().splitlines():
+        if line.startswith('#'):
+            fields = line[1:].split()
+            if fields and not fields[0].endswith(':'):
+                names = fields
+            continue
+        if line.strip():
+            records.append([float(x) for x in line.split()])
+    ncols = len(records[0]) if records else 0
+    if any(len(record) != ncols for record in records):
+        raise NotOutputFile('lines of different lengths')
+    if names is None or len(names) != ncols:
+        if columns is not None and len(columns) == ncols:
+            names = [name for name, vtype, mult in columns]
+        else:
+            names = ['column_%d' % (i + 1) for i in range(ncols)]
+    return names, records
+
+
+def read_output(path, columns, binary):
+    with open_file(path) as f:
+        data = f.read()
+    if binary:
+        return read_binary(data, columns)
+    return read_ascii(data, columns)
+
+
+def is_binary(path):
+    # binary files hold unprintable bytes (at least the zero bytes of
+    # the date fields); ASCII files are printable text
+    with open_file(path) as f:
+        data = f.read(4096)
+    return any(c < 9 or 13 < c < 32 or c > 126 for c in bytearray(data))
+
+
+def record_date(names, record):
+    date = [int(v) for n, v in zip(names, record)
+            if n in ('YEAR', 'MONTH', 'DAY', 'HOUR')]
+    if len(date) >= 3:
+        return '%04d-%02d-%02d' % tuple(date[:3]) + \
+            (' %02d' % date[3] if len(date) > 3 else '')
+    return ''
+
+
+def compare_file(name, path1, path2, layout, atol, rtol):
+    """Returns [(variable, max abs diff, max rel diff, first divergent
+    record, its date)] for the output files path1 and path2, or raises
+    ValueError if they cannot be compared."""
+    columns = file_layout(name, layout)
+    binary = is_binary(path1)
+    names1, records1 = read_output(path1, columns, binary)
+    names2, records2 = read_output(path2, columns, binary)
+    if names1 != names2:
+        raise ValueError('the files have different variables')
+    if len(records1) != len(records2):
+        raise ValueError('the files have %d and %d records'
+                         % (len(records1), len(records2)))
+
+    result = []
+    for j, var in enumerate(names1):
+        max_abs, max_rel, first = 0., 0., None
+        for i in range(len(records1)):
+            v1, v2 = records1[i][j], records2[i][j]
+            if v1 == v2 or (math.isnan(v1) and math.isnan(v2)):
+                continue
+            diff = abs(v2 - v1)
+            rel = diff / abs(v1) if v1 != 0 else float('inf')
+            if math.isnan(diff):
+                diff = rel = float('inf')
+            max_abs = max(max_abs, diff)
+            max_rel = max(max_rel, rel)
+            if first is None and diff > atol + rtol * abs(v1):
+                first = i
+        date = record_date(names1, records1[first]) if first is not None \
+            else ''
+        result.append((var, max_abs, max_rel, first, date))
+    return result
+
+
+def main(argv):
+    atol, rtol = 0., 0.
+    layout = None
+    prefixes = []
+    verbose = False
+    try:
+        opts, args = getopt.getopt(argv, 'a:r:g:p:vh')
+    except getopt.GetoptError as e:
+        sys.exit(str(e))
+    for o, a in opts:
+        if o == '-a':
+            atol = float(a)
+        elif o == '-r':
+            rtol = float(a)
+        elif o == '-g':
+            layout = read_global(a)
+        elif o == '-p':
+            prefixes.append(a)
+        elif o == '-v':
+            verbose = True
+        else:
+            sys.exit(__doc__)
+    if len(args) != 2:
+        sys.exit(__doc__)
+    dir1, dir2 = args
+
+    def base(name):
+        return name[:-3] if name.endswith('.gz') else name
+    files2 = dict((base(n), n) for n in os.listdir(dir2))
+    names = sorted(n for n in os.listdir(dir1)
+                   if not prefixes or
+                   any(n.startswith(p) for p in prefixes))
+
+    failed = False
+    summary = {}
+    print('%-36s %-24s %12s %12s  %s' % ('file', 'variable', 'max abs',
+                                         'max rel', 'first divergent record'))
+    for name in names:
+        if base(name) not in files2:
+            print('%-36s missing in %s' % (base(name), dir2))
+            failed = True
+            continue
+        path1 = os.path.join(dir1, name)
+        path2 = os.path.join(dir2, files2.pop(base(name)))
+        try:
+            result = compare_file(base(name), path1, path2, layout, atol,
+                                  rtol)
+        except NotOutputFile as e:
+            with open_file(path1) as f1, open_file(path2) as f2:
+                same = f1.read() == f2.read()
+            print('%-36s not an output file (%s): %s' % (
+                base(name), e, 'identical' if same else 'DIFFERENT'))
+            failed = failed or not same
+            continue
+        except ValueError as e:
+            print('%-36s %s' % (base(name), e))
+            failed = True
+            continue
+        for var, max_abs, max_rel, first, date in result:
+            s = summary.setdefault(var, [0., 0., 0, 0])
+            s[0] = max(s[0], max_abs)
+            s[1] = max(s[1], max_rel)
+            s[2] += 1
+            if first is not None:
+                s[3] += 1
+                failed = True
+            if first is not None or verbose:
+                print('%-36s %-24s %12.6g %12.6g  %s' % (
+                    base(name), var, max_abs, max_rel,
+                    '-' if first is None else '%d %s' % (first + 1, date)))
+    for name in sorted(files2):
+        if not prefixes or any(name.startswith(p) for p in prefixes):
+            print('%-36s missing in %s' % (name, dir1))
+            failed = True
+
+    print('\n%-24s %12s %12s %16s' % ('variable', 'max abs', 'max rel',
+                                      'files differing'))
+    for var in sorted(summary):
+        s = summary[var]
+        if s[3] or verbose:
+            print('%-24s %12.6g %12.6g %9d of %-4d' % (var, s[0], s[1],
+                                                      s[3], s[2]))
+    print('\n%s (atol %g, rtol %g)' % ('DIFFERENT' if failed else 'EQUIVALENT',
+                                       atol, rtol))
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
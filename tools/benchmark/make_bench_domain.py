@@ -0,0 +1,273 @@
+#!/usr/bin/env python
+"""
+make_bench_domain.py - generates a synthetic VIC domain for benchmarks.
+
+Writes soil, vegetation library, vegetation parameter, snow band and lake
+parameter files, and binary daily forcing files (PREC, TMAX, TMIN, WIND
+as scaled shorts), for NCELLS cells and YEARS years starting in 1990,
+plus one global parameter file global.<config>.txt per standard
+configuration (see CONFIGS) and a file domain.info with the size of the
+domain, which run_bench.py reads.  The parameters are drawn from a
+random generator seeded with SEED, so the same arguments always give
+the same domain.
+
+usage: make_bench_domain.py [-n NCELLS] [-y YEARS] [-s SEED] <outdir>
+"""
+
+import math
+import os
+import random
+import struct
+import sys
+import getopt
+
+# The standard benchmark configurations.
+CONFIGS = {
+    # name: (global-file options, needs snow bands, needs lakes, needs photo)
+    'water_balance': ({'TIME_STEP': 24, 'SNOW_STEP': 3,
+                       'FULL_ENERGY': 'FALSE', 'FROZEN_SOIL': 'FALSE'},
+                      False, False, False),
+    'full_energy':   ({'TIME_STEP': 3, 'SNOW_STEP': 3,
+                       'FULL_ENERGY': 'TRUE', 'FROZEN_SOIL': 'FALSE'},
+                      False, False, False),
+    'frozen_soil':   ({'TIME_STEP': 3, 'SNOW_STEP': 3,
+                       'FULL_ENERGY': 'TRUE', 'FROZEN_SOIL': 'TRUE',
+                       'IMPLICIT': 'TRUE', 'QUICK_FLUX': 'FALSE',
+                       'NODES': 10},
+                      False, False, False),
+    'lakes':         ({'TIME_STEP': 3, 'SNOW_STEP': 3,
+                       'FULL_ENERGY': 'TRUE', 'FROZEN_SOIL': 'FALSE'},
+                      False, True, False),
+    'carbon':        ({'TIME_STEP': 3, 'SNOW_STEP': 3,
+                       'FULL_ENERGY': 'TRUE', 'FROZEN_SOIL': 'FALSE',
+                       'CARBON': 'TRUE', 'RC_MODE': 'RC_PHOTO',
+                       'VEGLIB_PHOTO': 'TRUE'},
+                      False, False, True),
+    'snow_band10':   ({'TIME_STEP': 3, 'SNOW_STEP': 3,
+                       'FULL_ENERGY': 'TRUE', 'FROZEN_SOIL': 'FALSE'},
+                      True, False, False),
+}
+
+NLAYER = 3
+NBANDS = 10
+GRID_DECIMAL = 4
+
+
+def cell_coords(i):
+    # cells of a 1/8 degree grid, 40 to a row
+    lat = 44.0 + 0.125 * (i // 40) + 0.0625
+    lng = -120.0 + 0.125 * (i % 40) + 0.0625
+    return lat, lng
+
+
+def coord_str(x):
+    return ('%%.%df' % GRID_DECIMAL) % x
+
+
+def write_veglib(path, photo):
+    # class overstory rarc rmin LAI[12] albedo[12] rough[12] displ[12]
+    # wind_h RGL rad_atten wind_atten trunk_ratio [photo params]
+    classes = [
+        # class, overstory, rarc, rmin, lai, albedo, rough, displ, wind_h, RGL
+        (1, 1, 60.0, 250.0, 3.4, 0.12, 1.48, 8.04, 20.0, 30.0),
+        (2, 0, 2.0, 120.0, 2.2, 0.20, 0.12, 0.67, 2.0, 100.0),
+        (3, 0, 2.0, 100.0, 1.6, 0.20, 0.04, 0.20, 2.0, 100.0),
+    ]
+    with open(path, 'w') as f:
+        f.write('#Class\tOvrStry\tRarc\tRmin\tLAI\tALB\tROU\tDIS\tWIND_H\tRGL\t'
+                'RAD_ATN\tWIND_ATN\tTRUNK_RATIO\tCOMMENT\n')
+        for c in classes:
+            cls, ov, rarc, rmin, lai, alb, rou, dis, wh, rgl = c
+            fields = [cls, ov, rarc, rmin]
+            for m in range(12):
+                season = 0.5 + 0.5 * math.sin(math.pi * (m - 3) / 6.0)
+                fields.append('%.2f' % max(0.2, lai * (0.4 + 0.6 * season)))
+            fields += ['%.2f' % alb] * 12
+            fields += ['%.2f' % rou] * 12
+            fields += ['%.2f' % dis] * 12
+            fields += [wh, rgl, 0.5, 0.5, 0.2]
+            if photo:
+                fields += ['C3', '0.00006', '0.00012', '0', '1', '0.7', '0.5']
+            f.write('\t'.join(str(x) for x in fields) + '\tclass%d\n' % cls)
+
+
+def soil_line(i, rnd, lat, lng, elev, fs_active):
+    depth = [0.1, 0.3, 1.5]
+    bulk = [1350.0, 1400.0, 1450.0]
+    dens = 2685.0
+    max_moist = [d * (1.0 - b / dens) * 1000.0 for d, b in zip(depth, bulk)]
+    init = ['%.2f' % (0.6 * m) for m in max_moist]
+    f = [1, i + 1, coord_str(lat), coord_str(lng),
+         '%.3f' % rnd.uniform(0.05, 0.4),        # b_infilt
+         '%.4f' % rnd.uniform(0.001, 0.01),      # Ds
+         '%.2f' % rnd.uniform(5.0, 20.0),        # Dsmax
+         '%.2f' % rnd.uniform(0.7, 0.9),         # Ws
+         2]                                      # c
+    f += [11.0] * NLAYER                          # expt
+    f += ['%.1f' % rnd.uniform(100.0, 800.0)] * NLAYER  # Ksat
+    f += [-999] * NLAYER                          # phi_s
+    f += init                                     # init_moist
+    f += ['%.1f' % elev]
+    f += depth
+    f += ['%.2f' % (10.0 - 0.1 * (lat - 44.0) * 10.0)]  # avg_T
+    f += [4.0]                                    # dp
+    f += [20.0, 20.0, 20.0]                       # bubble
+    f += [0.5, 0.5, 0.5]                          # quartz
+    f += bulk
+    f += [dens] * NLAYER
+    f += ['%.1f' % (lng / 15.0)]                  # off_gmt
+    f += [0.7] * NLAYER                           # Wcr_FRACT
+    f += [0.4] * NLAYER                           # Wpwp_FRACT
+    f += [0.001, 0.0005, '%.1f' % rnd.uniform(400.0, 1200.0)]
+    f += [0.02] * NLAYER                          # resid_moist
+    f += [fs_active]
+    return '\t'.join(str(x) for x in f) + '\n'
+
+
+def write_forcing(path, rnd, ndays, elev):
+    # daily PREC (unsigned*40), TMAX, TMIN, WIND (signed*100)
+    recs = []
+    tbase = 8.0 - 0.0065 * (elev - 500.0)
+    for d in range(ndays):
+        season = math.sin(2.0 * math.pi * (d % 365 - 105) / 365.0)
+        tavg = tbase + 14.0 * season + rnd.gauss(0.0, 3.0)
+        rng = 8.0 + 3.0 * rnd.random()
+        prec = rnd.expovariate(0.25) if rnd.random() < 0.35 else 0.0
+        wind = max(0.5, rnd.gauss(3.0, 1.2))
+        recs.append(struct.pack('<Hhhh',
+                                min(65535, int(prec * 40 + 0.5)),
+                                int(round((tavg + rng / 2) * 100)),
+                                int(round((tavg - rng / 2) * 100)),
+                                int(round(wind * 100))))
+    with open(path, 'wb') as f:
+        f.write(b''.join(recs))
+
+
+def write_global(path, name, opts, root, years, bands, lakes, photo):
+    lines = [
+        ('NLAYER', NLAYER), ('NODES', opts.get('NODES', 3)),
+        ('TIME_STEP', opts['TIME_STEP']), ('SNOW_STEP', opts['SNOW_STEP']),
+        ('STARTYEAR', 1990), ('STARTMONTH', 1), ('STARTDAY', 1),
+        ('STARTHOUR', 0), ('ENDYEAR', 1990 + years - 1), ('ENDMONTH', 12),
+        ('ENDDAY', 31),
+        ('FULL_ENERGY', opts['FULL_ENERGY']),
+        ('FROZEN_SOIL', opts['FROZEN_SOIL']),
+    ]
+    for k in ('IMPLICIT', 'QUICK_FLUX', 'CARBON', 'RC_MODE', 'VEGLIB_PHOTO'):
+        if k in opts:
+            lines.append((k, opts[k]))
+    lines += [
+        ('FORCING1', os.path.join(root, 'forcing', 'data_')),
+        ('FORCE_FORMAT', 'BINARY'), ('FORCE_ENDIAN', 'LITTLE'),
+        ('N_TYPES', 4),
+        ('FORCE_TYPE', 'PREC\tUNSIGNED\t40'),
+        ('FORCE_TYPE', 'TMAX\tSIGNED\t100'),
+        ('FORCE_TYPE', 'TMIN\tSIGNED\t100'),
+        ('FORCE_TYPE', 'WIND\tSIGNED\t100'),
+        ('FORCE_DT', 24), ('FORCEYEAR', 1990), ('FORCEMONTH', 1),
+        ('FORCEDAY', 1), ('FORCEHOUR', 0), ('GRID_DECIMAL', GRID_DECIMAL),
+        ('WIND_H', 10.0), ('MEASURE_H', 2.0),
+        ('SOIL', os.path.join(root, 'soil.txt')),
+        ('VEGLIB', os.path.join(root, 'veglib_photo.txt' if photo
+                                else 'veglib.txt')),
+        ('VEGPARAM', os.path.join(root, 'lake_vegparam.txt' if lakes
+                                  else 'vegparam.txt')),
+        ('ROOT_ZONES', 3),
+        ('SNOW_BAND', '%d\t%s' % (NBANDS, os.path.join(root, 'snowbands.txt'))
+         if bands else 1),
+    ]
+    if lakes:
+        lines.append(('LAKES', os.path.join(root, 'lakeparam.txt')))
+    lines += [
+        ('RESULT_DIR', os.path.join(root, 'results', name)),
+        ('OUT_STEP', 0), ('SKIPYEAR', 0), ('COMPRESS', 'FALSE'),
+        ('BINARY_OUTPUT', 'FALSE'), ('ALMA_OUTPUT', 'FALSE'),
+        ('MOISTFRACT', 'FALSE'), ('PRT_HEADER', 'FALSE'),
+        ('PRT_SNOW_BAND', 'FALSE'),
+    ]
+    with open(path, 'w') as f:
+        f.write('# synthetic benchmark configuration: %s\n' % name)
+        for k, v in lines:
+            f.write('%s\t%s\n' % (k, v))
+
+
+def main(argv):
+    ncells, years, seed = 10, 2, 1
+    try:
+        opts, args = getopt.getopt(argv, 'n:y:s:h')
+    except getopt.GetoptError as e:
+        sys.exit(str(e))
+    for o, a in opts:
+        if o == '-n':
+            ncells = int(a)
+        elif o == '-y':
+            years = int(a)
+        elif o == '-s':
+            seed = int(a)
+        else:
+            sys.exit(__doc__)
+    if len(args) != 1:
+        sys.exit(__doc__)
+    root = os.path.abspath(args[0])
+    rnd = random.Random(seed)
+    for d in ['forcing', 'results'] + ['results/' + c for c in CONFIGS]:
+        if not os.path.isdir(os.path.join(root, d)):
+            os.makedirs(os.path.join(root, d))
+
+    ndays = 0
+    for y in range(1990, 1990 + years):
+        leap = (y % 4 == 0 and y % 100 != 0) or y % 400 == 0
+        ndays += 366 if leap else 365
+
+    write_veglib(os.path.join(root, 'veglib.txt'), False)
+    write_veglib(os.path.join(root, 'veglib_photo.txt'), True)
+
+    soil = open(os.path.join(root, 'soil.txt'), 'w')
+    veg = open(os.path.join(root, 'vegparam.txt'), 'w')
+    lveg = open(os.path.join(root, 'lake_vegparam.txt'), 'w')
+    band = open(os.path.join(root, 'snowbands.txt'), 'w')
+    lake = open(os.path.join(root, 'lakeparam.txt'), 'w')
+    for i in range(ncells):
+        lat, lng = cell_coords(i)
+        elev = rnd.uniform(200.0, 2500.0)
+        fs_active = 1 if elev > 1200.0 else 0
+        soil.write(soil_line(i, rnd, lat, lng, elev, fs_active))
+
+        nveg = 1 + i % 3
+        cv = [round(0.9 / nveg, 4)] * nveg
+        tiles = ['%d\t%.4f\t0.10\t0.10\t1.00\t0.65\t0.50\t0.25'
+                 % (1 + t, cv[t]) for t in range(nveg)]
+        veg.write('%d\t%d\n' % (i + 1, nveg))
+        veg.write(''.join(t + '\n' for t in tiles))
+        # lake config: extra wetland tile holding the lake
+        lveg.write('%d\t%d\n' % (i + 1, nveg + 1))
+        ltiles = ['%d\t%.4f\t0.10\t0.10\t1.00\t0.65\t0.50\t0.25'
+                  % (1 + t, round(0.8 / nveg, 4)) for t in range(nveg)]
+        ltiles.append('3\t0.1000\t0.10\t0.10\t1.00\t0.65\t0.50\t0.25')
+        lveg.write(''.join(t + '\n' for t in ltiles))
+        lake.write('%d\t%d\t10\t0.5\t0.1\t2.0\t0.1\n' % (i + 1, nveg))
+        lake.write('8.0\t0.05\n')
+
+        step = 100.0
+        elevs = [elev + step * (b - (NBANDS - 1) / 2.0) for b in range(NBANDS)]
+        fr = ['%.4f' % (1.0 / NBANDS)] * NBANDS
+        band.write('%d\t%s\t%s\t%s\n' % (i + 1, '\t'.join(fr),
+                                         '\t'.join('%.1f' % e for e in elevs),
+                                         '\t'.join(fr)))
+
+        write_forcing(os.path.join(root, 'forcing', 'data_%s_%s'
+                                   % (coord_str(lat), coord_str(lng))),
+                      rnd, ndays, elev)
+    for f in (soil, veg, lveg, band, lake):
+        f.close()
+
+    for name, (opts, bands, lakes, photo) in sorted(CONFIGS.items()):
+        write_global(os.path.join(root, 'global.%s.txt' % name), name, opts,
+                     root, years, bands, lakes, photo)
+    with open(os.path.join(root, 'domain.info'), 'w') as f:
+        f.write('NCELLS\t%d\nYEARS\t%d\nNDAYS\t%d\n' % (ncells, years, ndays))
+    print('wrote %d cells x %d years to %s' % (ncells, years, root))
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])
@@ -0,0 +1,163 @@
+#!/usr/bin/env python
+"""
+run_bench.py - runs the VIC reference benchmarks.
+
+Runs vicNl on the synthetic domain in <domain> (generated first by
+make_bench_domain.py if <domain>/domain.info does not exist) under each
+of the standard configurations, and reports for each the wall time of
+the run, cells/second and timesteps/second, where a timestep is one
+model time step (TIME_STEP) of one cell.  With -r, each configuration
+is run REPEATS times and the fastest run is reported.
+
+Options:
+  -n NCELLS  cells of a generated domain (default 10)
+  -y YEARS   years of a generated domain (default 2)
+  -c CONFIGS comma-separated configurations to run (default: all of
+             water_balance, full_energy, frozen_soil, lakes, carbon,
+             snow_band10)
+  -r REPEATS runs of each configuration (default 1)
+  -o LINE    global parameter file line added to every configuration,
+             e.g. -o "NTHREADS 4"; may be given more than once
+  -a         also report the heap allocations of the time steps, as
+             printed by vicNl_alloc (make vicNl_alloc; see alloc_count.c)
+
+The log of the last run of each configuration is kept in
+<domain>/results/<config>.log.
+
+usage: run_bench.py [options] <vicNl> <domain>
+"""
+
+import getopt
+import os
+import re
+import subprocess
+import sys
+import time
+
+CONFIGS = ['water_balance', 'full_energy', 'frozen_soil', 'lakes', 'carbon',
+           'snow_band10']
+
+
+def read_info(path):
+    info = {}
+    with open(path) as f:
+        for line in f:
+            key, value = line.split()
+            info[key] = int(value)
+    return info
+
+
+def time_step(path):
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) > 1 and fields[0] == 'TIME_STEP':
+                return int(fields[1])
+    sys.exit('%s: no TIME_STEP' % path)
+
+
+def read_allocs(log):
+    """Returns the allocations in setup and in the time steps, and the
+    number of time steps, printed by vicNl_alloc in log, or None."""
+    with open(log) as f:
+        for line in f:
+            m = re.match(r'Heap allocations: (\d+) in setup, (\d+) in (\d+) '
+                         r'time steps', line)
+            if m:
+                return tuple(int(x) for x in m.groups())
+    return None
+
+
+def run_config(vicnl, root, name, extra, repeats):
+    result_dir = os.path.join(root, 'results', name)
+    global_file = os.path.join(root, 'results', 'global.%s.txt' % name)
+    with open(os.path.join(root, 'global.%s.txt' % name)) as f:
+        text = f.read()
+    with open(global_file, 'w') as f:
+        f.write(text + ''.join(line + '\n' for line in extra))
+    log = os.path.join(root, 'results', '%s.log' % name)
+
+    best = None
+    for r in range(repeats):
+        for old in os.listdir(result_dir):
+            os.remove(os.path.join(result_dir, old))
+        start = time.time()
+        with open(log, 'w') as f:
+            status = subprocess.call([vicnl, '-g', global_file], stdout=f,
+                                     stderr=subprocess.STDOUT)
+        seconds = time.time() - start
+        if status != 0:
+            sys.exit('%s failed (exit status %d), see %s' % (name, status, log))
+        if best is None or seconds < best:
+            best = seconds
+    return best, time_step(global_file), log
+
+
+def main(argv):
+    ncells, years, repeats = 10, 2, 1
+    configs = CONFIGS
+    extra = []
+    allocs = False
+    try:
+        opts, args = getopt.getopt(argv, 'n:y:c:r:o:ah')
+    except getopt.GetoptError as e:
+        sys.exit(str(e))
+    for o, a in opts:
+        if o == '-n':
+            ncells = int(a)
+        elif o == '-y':
+            years = int(a)
+        elif o == '-c':
+            configs = a.split(',')
+        elif o == '-r':
+            repeats = int(a)
+        elif o == '-o':
+            extra.append(a)
+        elif o == '-a':
+            allocs = True
+        else:
+            sys.exit(__doc__)
+    if len(args) != 2:
+        sys.exit(__doc__)
+    vicnl = os.path.abspath(args[0])
+    root = os.path.abspath(args[1])
+    for name in configs:
+        if name not in CONFIGS:
+            sys.exit('unknown configuration %s' % name)
+
+    info_file = os.path.join(root, 'domain.info')
+    if not os.path.exists(info_file):
+        make = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                            'make_bench_domain.py')
+        status = subprocess.call([sys.executable, make, '-n', str(ncells),
+                                  '-y', str(years), root])
+        if status != 0:
+            sys.exit('make_bench_domain.py failed')
+    info = read_info(info_file)
+
+    print('VIC benchmark: %s, %d cells x %d years%s'
+          % (vicnl, info['NCELLS'], info['YEARS'],
+             ''.join(', ' + line for line in extra)))
+    print('%-14s %10s %12s %14s%s' % ('config', 'seconds', 'cells/s',
+                                      'timesteps/s',
+                                      ' %12s %12s' % ('setup allocs',
+                                                      'allocs/step')
+                                      if allocs else ''))
+    for name in configs:
+        seconds, dt, log = run_config(vicnl, root, name, extra, repeats)
+        steps = info['NCELLS'] * info['NDAYS'] * 24 // dt
+        line = ('%-14s %10.2f %12.2f %14.0f'
+                % (name, seconds, info['NCELLS'] / seconds, steps / seconds))
+        if allocs:
+            counts = read_allocs(log)
+            if counts is None:
+                sys.exit('%s: no allocation counts in %s (run vicNl_alloc)'
+                         % (name, log))
+            setup, in_steps, nsteps = counts
+            line += ' %12d %12.3f' % (setup, float(in_steps) / max(nsteps, 1))
+        print(line)
+        sys.stdout.flush()
+
+
+if __name__ == '__main__':
+    main(sys.argv[1:])